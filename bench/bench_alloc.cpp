@@ -0,0 +1,119 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include "bench_harness.h"
+
+using namespace Cute;
+
+#define CHURN_SLOTS 4096
+#define CHURN_OPS (4 * 1024 * 1024)
+
+// Mostly small sizes with the occasional bigger one, roughly what Array, hash tables and strings ask for.
+static size_t s_churn_size(BenchRng* rng)
+{
+	uint32_t r = rng->next();
+	if ((r & 15) == 0) return 1024 + (r >> 8) % (16 * CF_KB);
+	return 8 + (r >> 8) % 256;
+}
+
+struct Churn
+{
+	uint64_t seed;
+	uint64_t sum;
+};
+
+// Randomly allocates into or frees from a fixed set of slots, so the live set hovers around half the slots.
+static int s_churn(void* udata)
+{
+	Churn* churn = (Churn*)udata;
+	BenchRng rng;
+	rng.state ^= churn->seed;
+	void** slots = (void**)cf_calloc(sizeof(void*), CHURN_SLOTS);
+	uint64_t sum = 0;
+	for (int i = 0; i < CHURN_OPS; ++i) {
+		uint32_t slot = rng.next() % CHURN_SLOTS;
+		if (slots[slot]) {
+			sum += *(uint8_t*)slots[slot];
+			cf_free(slots[slot]);
+			slots[slot] = NULL;
+		} else {
+			slots[slot] = cf_alloc(s_churn_size(&rng));
+			*(uint8_t*)slots[slot] = (uint8_t)i;
+		}
+	}
+	for (int i = 0; i < CHURN_SLOTS; ++i) cf_free(slots[i]);
+	cf_free(slots);
+	churn->sum = sum;
+	return 0;
+}
+
+// Growing many small arrays one element at a time, which reallocs through every size class.
+static void s_bench_realloc()
+{
+	const int array_count = 1024;
+	const int push_count = 256;
+	Array<int>* arrays = (Array<int>*)cf_calloc(sizeof(Array<int>), array_count);
+	uint64_t start = cf_get_ticks();
+	for (int j = 0; j < push_count; ++j) {
+		for (int i = 0; i < array_count; ++i) {
+			arrays[i].add(j);
+		}
+	}
+	for (int i = 0; i < array_count; ++i) {
+		bench_sink(arrays[i].last());
+		arrays[i].~Array<int>();
+	}
+	bench_report("Array push, 1024 arrays x 256 ints", bench_seconds(start), (int64_t)array_count * push_count);
+	cf_free(arrays);
+}
+
+// Resident memory for a large number of small live objects.
+static void s_bench_rss()
+{
+	const int count = 1024 * 1024;
+	void** objects = (void**)cf_alloc(sizeof(void*) * count);
+	BenchRng rng;
+	size_t before = bench_rss();
+	for (int i = 0; i < count; ++i) {
+		size_t size = 24 + rng.next() % 41;
+		objects[i] = cf_alloc(size);
+		CF_MEMSET(objects[i], 0, size);
+	}
+	size_t after = bench_rss();
+	for (int i = 0; i < count; ++i) cf_free(objects[i]);
+	cf_free(objects);
+	if (before && after) {
+		bench_report_bytes("RSS growth, 1M live objects of 24-64 bytes", after - before);
+	} else {
+		printf("  %-52s %10s\n", "RSS growth, 1M live objects of 24-64 bytes", "n/a");
+	}
+}
+
+/* Throughput of cf_alloc/cf_free under whichever allocator is installed, single and multi-threaded. */
+BENCH(bench_alloc)
+{
+	int thread_counts[] = { 1, 4, 8 };
+	for (int t = 0; t < (int)CF_ARRAY_SIZE(thread_counts); ++t) {
+		int thread_count = thread_counts[t];
+		Churn churn[8];
+		CF_Thread* threads[8];
+		uint64_t start = cf_get_ticks();
+		for (int i = 0; i < thread_count; ++i) {
+			churn[i] = { (uint64_t)i * 7919, 0 };
+			threads[i] = cf_thread_create(s_churn, "churn", churn + i);
+		}
+		for (int i = 0; i < thread_count; ++i) {
+			cf_thread_wait(threads[i]);
+			bench_sink(churn[i].sum);
+		}
+		char name[64];
+		snprintf(name, sizeof(name), "Random alloc/free churn, %d thread%s", thread_count, thread_count > 1 ? "s" : "");
+		bench_report(name, bench_seconds(start), (int64_t)CHURN_OPS * thread_count);
+	}
+	s_bench_realloc();
+	s_bench_rss();
+}
@@ -0,0 +1,120 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include "bench_harness.h"
+
+#define MAP_KEYS_PER_THREAD (256 * 1024)
+#define MAP_LOOKUPS_PER_THREAD (1024 * 1024)
+
+// What sharing a table between threads took before: one htbl behind one mutex.
+struct LockedMap
+{
+	CF_Mutex lock;
+	htbl uint64_t* table;
+};
+
+struct MapWorker
+{
+	CF_ConcurrentMap* map;
+	LockedMap* locked;
+	int thread_index;
+	int thread_count;
+	uint64_t sum;
+};
+
+// Each thread inserts its own range of keys.
+static int s_map_insert(void* udata)
+{
+	MapWorker* worker = (MapWorker*)udata;
+	uint64_t first = (uint64_t)worker->thread_index * MAP_KEYS_PER_THREAD;
+	for (uint64_t i = first; i < first + MAP_KEYS_PER_THREAD; ++i) {
+		cf_concurrent_map_set(worker->map, bench_key(i), &i);
+	}
+	return 0;
+}
+
+static int s_locked_insert(void* udata)
+{
+	MapWorker* worker = (MapWorker*)udata;
+	LockedMap* locked = worker->locked;
+	uint64_t first = (uint64_t)worker->thread_index * MAP_KEYS_PER_THREAD;
+	for (uint64_t i = first; i < first + MAP_KEYS_PER_THREAD; ++i) {
+		cf_mutex_lock(&locked->lock);
+		hset(locked->table, bench_key(i), i);
+		cf_mutex_unlock(&locked->lock);
+	}
+	return 0;
+}
+
+// Every thread looks up random keys from the whole map, including the ones other threads inserted.
+static int s_map_lookup(void* udata)
+{
+	MapWorker* worker = (MapWorker*)udata;
+	BenchRng rng;
+	rng.state ^= (uint64_t)(worker->thread_index + 1) * 7919;
+	uint32_t key_count = (uint32_t)(MAP_KEYS_PER_THREAD * worker->thread_count);
+	uint64_t sum = 0;
+	for (int i = 0; i < MAP_LOOKUPS_PER_THREAD; ++i) {
+		uint64_t item = 0;
+		cf_concurrent_map_get(worker->map, bench_key(rng.next() % key_count), &item);
+		sum += item;
+	}
+	worker->sum = sum;
+	return 0;
+}
+
+static int s_locked_lookup(void* udata)
+{
+	MapWorker* worker = (MapWorker*)udata;
+	LockedMap* locked = worker->locked;
+	BenchRng rng;
+	rng.state ^= (uint64_t)(worker->thread_index + 1) * 7919;
+	uint32_t key_count = (uint32_t)(MAP_KEYS_PER_THREAD * worker->thread_count);
+	uint64_t sum = 0;
+	for (int i = 0; i < MAP_LOOKUPS_PER_THREAD; ++i) {
+		uint64_t key = bench_key(rng.next() % key_count);
+		cf_mutex_lock(&locked->lock);
+		sum += hget(locked->table, key);
+		cf_mutex_unlock(&locked->lock);
+	}
+	worker->sum = sum;
+	return 0;
+}
+
+static void s_run(const char* label, int thread_count, CF_ThreadFn insert_fn, CF_ThreadFn lookup_fn, CF_ConcurrentMap* map, LockedMap* locked)
+{
+	MapWorker workers[BENCH_MAX_THREADS];
+	for (int i = 0; i < thread_count; ++i) workers[i] = { map, locked, i, thread_count, 0 };
+	char name[64];
+
+	double seconds = bench_threads(thread_count, insert_fn, workers, sizeof(MapWorker));
+	snprintf(name, sizeof(name), "%s insert, %d thread%s", label, thread_count, thread_count > 1 ? "s" : "");
+	bench_report(name, seconds, (int64_t)MAP_KEYS_PER_THREAD * thread_count);
+
+	seconds = bench_threads(thread_count, lookup_fn, workers, sizeof(MapWorker));
+	for (int i = 0; i < thread_count; ++i) bench_sink(workers[i].sum);
+	snprintf(name, sizeof(name), "%s lookup, %d thread%s", label, thread_count, thread_count > 1 ? "s" : "");
+	bench_report(name, seconds, (int64_t)MAP_LOOKUPS_PER_THREAD * thread_count);
+}
+
+/* Insert and lookup throughput of CF_ConcurrentMap against a mutex-guarded htbl at 1, 4 and 16 threads. */
+BENCH(bench_concurrent_map)
+{
+	int thread_counts[] = { 1, 4, 16 };
+	for (int t = 0; t < (int)CF_ARRAY_SIZE(thread_counts); ++t) {
+		int thread_count = thread_counts[t];
+
+		LockedMap locked = { cf_make_mutex(), NULL };
+		s_run("htbl + mutex", thread_count, s_locked_insert, s_locked_lookup, NULL, &locked);
+		hfree(locked.table);
+		cf_destroy_mutex(&locked.lock);
+
+		CF_ConcurrentMap* map = cf_make_concurrent_map(sizeof(uint64_t), 0);
+		s_run("CF_ConcurrentMap", thread_count, s_map_insert, s_map_lookup, map, NULL);
+		cf_destroy_concurrent_map(map);
+	}
+}
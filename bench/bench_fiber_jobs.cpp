@@ -0,0 +1,135 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include "bench_harness.h"
+
+#define CHAIN_COUNT 16
+#define CHAIN_DEPTH 400
+#define CHAIN_ROUNDS 10
+#define LOADER_COUNT 8
+#define LOADER_IO_MS 2
+#define BUSY_JOB_COUNT 2000
+#define BUSY_JOB_STEPS 20000
+
+// Each link starts the next one and waits for it, so a whole chain is waiting at once until the last link finishes. On a plain
+// job system every wait nests on the worker's stack, on a fiber job system each waiting link is parked on its own fiber.
+struct ChainLink
+{
+	CF_JobSystem* system;
+	int depth;
+};
+
+static void s_chain_link(void* udata)
+{
+	ChainLink* link = (ChainLink*)udata;
+	if (!link->depth) return;
+	ChainLink next = { link->system, link->depth - 1 };
+	cf_job_wait(link->system, cf_job_run(link->system, s_chain_link, &next));
+}
+
+static CF_JobSystem* s_make_system(bool fibers, int thread_count)
+{
+	// Room for every link of every chain to be in flight at once.
+	int max_jobs = CHAIN_COUNT * (CHAIN_DEPTH + 1) + BUSY_JOB_COUNT;
+	return fibers ? cf_make_fiber_job_system(thread_count, max_jobs, 0, 0) : cf_make_job_system(thread_count, max_jobs);
+}
+
+static void s_bench_chains(bool fibers, int thread_count)
+{
+	CF_JobSystem* system = s_make_system(fibers, thread_count);
+	ChainLink roots[CHAIN_COUNT];
+	CF_Job jobs[CHAIN_COUNT];
+	uint64_t start = cf_get_ticks();
+	for (int r = 0; r < CHAIN_ROUNDS; ++r) {
+		for (int i = 0; i < CHAIN_COUNT; ++i) {
+			roots[i] = { system, CHAIN_DEPTH };
+			jobs[i] = cf_job_run(system, s_chain_link, roots + i);
+		}
+		for (int i = 0; i < CHAIN_COUNT; ++i) cf_job_wait(system, jobs[i]);
+	}
+	char name[64];
+	snprintf(name, sizeof(name), "%s, 16 chains of 400 links, %d thread%s", fibers ? "Fiber" : "Plain", thread_count, thread_count > 1 ? "s" : "");
+	bench_report(name, bench_seconds(start), (int64_t)CHAIN_COUNT * (CHAIN_DEPTH + 1) * CHAIN_ROUNDS);
+	cf_destroy_job_system(system);
+}
+
+// A handful of loader jobs wait on I/O finishing on another thread while a pile of busy jobs keeps every worker occupied. With
+// fibers the loaders finish as soon as their I/O does, without them the loaders have to wait their turn behind busy jobs.
+struct Loaders
+{
+	CF_JobSystem* system;
+	CF_AtomicInt pending_io;
+	CF_AtomicInt done;
+	uint64_t start;
+	double done_seconds;
+};
+
+static void s_loader(void* udata)
+{
+	Loaders* loaders = (Loaders*)udata;
+	cf_job_wait_counter(loaders->system, &loaders->pending_io, 0);
+	if (cf_atomic_add(&loaders->done, 1) == LOADER_COUNT - 1) {
+		loaders->done_seconds = bench_seconds(loaders->start);
+	}
+}
+
+static int s_io_thread(void* udata)
+{
+	Loaders* loaders = (Loaders*)udata;
+	cf_sleep(LOADER_IO_MS);
+	cf_atomic_set(&loaders->pending_io, 0);
+	return 0;
+}
+
+static void s_busy(void* udata)
+{
+	float x = (float)(uintptr_t)udata;
+	for (int i = 0; i < BUSY_JOB_STEPS; ++i) x = x * 0.999f + 0.5f;
+	bench_sink((uint64_t)x);
+}
+
+static void s_bench_loaders(bool fibers, int thread_count)
+{
+	CF_JobSystem* system = s_make_system(fibers, thread_count);
+	Loaders loaders;
+	loaders.system = system;
+	loaders.pending_io = cf_atomic_zero();
+	loaders.done = cf_atomic_zero();
+	cf_atomic_set(&loaders.pending_io, 1);
+	loaders.done_seconds = 0;
+	CF_Job* jobs = (CF_Job*)cf_alloc(sizeof(CF_Job) * (LOADER_COUNT + BUSY_JOB_COUNT));
+
+	loaders.start = cf_get_ticks();
+	CF_Thread* io = cf_thread_create(s_io_thread, "bench io", &loaders);
+	for (int i = 0; i < LOADER_COUNT; ++i) jobs[i] = cf_job_run(system, s_loader, &loaders);
+	for (int i = 0; i < BUSY_JOB_COUNT; ++i) jobs[LOADER_COUNT + i] = cf_job_run(system, s_busy, (void*)(uintptr_t)i);
+	for (int i = 0; i < LOADER_COUNT + BUSY_JOB_COUNT; ++i) cf_job_wait(system, jobs[i]);
+	double seconds = bench_seconds(loaders.start);
+	cf_thread_wait(io);
+
+	char name[64];
+	snprintf(name, sizeof(name), "%s, loaders done, %d thread%s", fibers ? "Fiber" : "Plain", thread_count, thread_count > 1 ? "s" : "");
+	printf("  %-52s %10.2f ms\n", name, loaders.done_seconds * 1e3);
+	snprintf(name, sizeof(name), "%s, loaders + busy jobs done, %d thread%s", fibers ? "Fiber" : "Plain", thread_count, thread_count > 1 ? "s" : "");
+	printf("  %-52s %10.2f ms\n", name, seconds * 1e3);
+	cf_free(jobs);
+	cf_destroy_job_system(system);
+}
+
+/* Deep chains of jobs waiting on each other, and jobs waiting on I/O behind busy work, on plain and fiber job systems. */
+BENCH(bench_fiber_jobs)
+{
+	int thread_counts[] = { 1, 4, 16 };
+	for (int t = 0; t < (int)CF_ARRAY_SIZE(thread_counts); ++t) {
+		s_bench_chains(false, thread_counts[t]);
+		s_bench_chains(true, thread_counts[t]);
+	}
+	for (int t = 0; t < (int)CF_ARRAY_SIZE(thread_counts); ++t) {
+		s_bench_loaders(false, thread_counts[t]);
+		s_bench_loaders(true, thread_counts[t]);
+	}
+}
@@ -0,0 +1,112 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include "bench_harness.h"
+
+using namespace Cute;
+
+#define FRAME_COUNT 2000
+#define ALLOCS_PER_FRAME 1000
+
+// Scratch allocations made over a frame, all freed at the end of it.
+static void s_bench_scratch()
+{
+	void** ptrs = (void**)cf_alloc(sizeof(void*) * ALLOCS_PER_FRAME);
+	BenchRng rng;
+	uint64_t start = cf_get_ticks();
+	for (int f = 0; f < FRAME_COUNT; ++f) {
+		for (int i = 0; i < ALLOCS_PER_FRAME; ++i) {
+			size_t size = 16 + rng.next() % 241;
+			ptrs[i] = cf_alloc(size);
+			*(uint8_t*)ptrs[i] = (uint8_t)i;
+		}
+		for (int i = 0; i < ALLOCS_PER_FRAME; ++i) {
+			bench_sink(*(uint8_t*)ptrs[i]);
+			cf_free(ptrs[i]);
+		}
+	}
+	bench_report("Scratch, cf_alloc + cf_free", bench_seconds(start), (int64_t)FRAME_COUNT * ALLOCS_PER_FRAME);
+
+	rng = BenchRng();
+	start = cf_get_ticks();
+	for (int f = 0; f < FRAME_COUNT; ++f) {
+		cf_frame_reset();
+		for (int i = 0; i < ALLOCS_PER_FRAME; ++i) {
+			size_t size = 16 + rng.next() % 241;
+			ptrs[i] = cf_frame_alloc(size);
+			*(uint8_t*)ptrs[i] = (uint8_t)i;
+		}
+		for (int i = 0; i < ALLOCS_PER_FRAME; ++i) {
+			bench_sink(*(uint8_t*)ptrs[i]);
+		}
+	}
+	bench_report("Scratch, cf_frame_alloc", bench_seconds(start), (int64_t)FRAME_COUNT * ALLOCS_PER_FRAME);
+	cf_free(ptrs);
+}
+
+// A handful of temporary lists built up each frame, such as query results.
+static void s_bench_lists()
+{
+	const int list_count = 16;
+	const int list_size = 200;
+	uint64_t start = cf_get_ticks();
+	for (int f = 0; f < FRAME_COUNT; ++f) {
+		for (int l = 0; l < list_count; ++l) {
+			Array<int> list;
+			for (int i = 0; i < list_size; ++i) list.add(i);
+			bench_sink(list.last());
+		}
+	}
+	bench_report("Temporary list, Array", bench_seconds(start), (int64_t)FRAME_COUNT * list_count * list_size);
+
+	start = cf_get_ticks();
+	for (int f = 0; f < FRAME_COUNT; ++f) {
+		cf_frame_reset();
+		for (int l = 0; l < list_count; ++l) {
+			FrameArray<int> list;
+			for (int i = 0; i < list_size; ++i) list.add(i);
+			bench_sink(list.last());
+		}
+	}
+	bench_report("Temporary list, FrameArray", bench_seconds(start), (int64_t)FRAME_COUNT * list_count * list_size);
+}
+
+// Formatting labels to draw, the most common frame-lifetime string.
+static void s_bench_format()
+{
+	const int label_count = 200;
+	uint64_t start = cf_get_ticks();
+	for (int f = 0; f < FRAME_COUNT; ++f) {
+		for (int i = 0; i < label_count; ++i) {
+			char* s = NULL;
+			sfmt(s, "HP: %d/%d", i, f);
+			bench_sink((uint64_t)slen(s));
+			sfree(s);
+		}
+	}
+	bench_report("Labels, sfmt + sfree", bench_seconds(start), (int64_t)FRAME_COUNT * label_count);
+
+	start = cf_get_ticks();
+	for (int f = 0; f < FRAME_COUNT; ++f) {
+		cf_frame_reset();
+		for (int i = 0; i < label_count; ++i) {
+			char* s = cf_frame_sfmt("HP: %d/%d", i, f);
+			bench_sink((uint64_t)CF_STRLEN(s));
+		}
+	}
+	bench_report("Labels, cf_frame_sfmt", bench_seconds(start), (int64_t)FRAME_COUNT * label_count);
+}
+
+/* Per-frame temporaries through the general heap versus the frame allocator. */
+BENCH(bench_frame_alloc)
+{
+	s_bench_scratch();
+	s_bench_lists();
+	s_bench_format();
+	cf_frame_reset();
+	cf_frame_reset();
+}
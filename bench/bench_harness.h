@@ -0,0 +1,62 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+#ifndef _CRT_SECURE_NO_WARNINGS
+#	define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include <cute.h>
+#include <stdio.h>
+
+// Declares a benchmark. Each one is listed in bench/main.cpp with `RUN_BENCH`.
+#define BENCH(name) void name()
+
+// Results are folded into here so the optimizer can't throw the measured work away.
+extern volatile uint64_t g_bench_sink;
+
+// Folds `value` into the sink. Written out longhand since compound assignment to a volatile is deprecated in C++20.
+inline void bench_sink(uint64_t value) { g_bench_sink = g_bench_sink + value; }
+
+// Seconds elapsed since `start`, a value previously returned by `cf_get_ticks`.
+double bench_seconds(uint64_t start);
+
+// Prints nanoseconds per operation and millions of operations per second.
+void bench_report(const char* name, double seconds, int64_t ops);
+
+// Upper bound on `thread_count` for `bench_threads`.
+#define BENCH_MAX_THREADS 16
+
+// Runs `fn` on `thread_count` threads at once, handing thread `i` the pointer `(char*)udata + i * stride`. Returns
+// the seconds elapsed until the last thread finishes.
+double bench_threads(int thread_count, CF_ThreadFn fn, void* udata, size_t stride);
+
+// Resident set size of the whole process in bytes, or 0 on platforms without support.
+size_t bench_rss();
+
+// Prints a byte count in megabytes.
+void bench_report_bytes(const char* name, size_t bytes);
+
+// Small xorshift generator, so runs are repeatable and don't depend on the CRT's rand.
+struct BenchRng
+{
+	uint64_t state = 0x9E3779B97F4A7C15ull;
+	uint32_t next() { state ^= state << 13; state ^= state >> 7; state ^= state << 17; return (uint32_t)state; }
+};
+
+// Scrambles `i` with splitmix64's finalizer. It's a bijection, so distinct inputs always give distinct keys.
+inline uint64_t bench_key(uint64_t i)
+{
+	uint64_t z = i + 0x9E3779B97F4A7C15ull;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+#endif // BENCH_HARNESS_H
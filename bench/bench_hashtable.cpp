@@ -0,0 +1,130 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include "bench_harness.h"
+
+// The backend is picked when CF is built. Configure once with CF_FRAMEWORK_SWISS_HASHTABLE ON and once with it OFF
+// to compare the two, the option is forwarded to this target so the report says which one ran.
+#ifdef CF_SWISS_HASHTABLE
+#	define HASHTABLE_BACKEND "Swiss table"
+#else
+#	define HASHTABLE_BACKEND "default"
+#endif
+
+// Small tables are built and torn down repeatedly, so every size does at least this much work.
+#define HASHTABLE_MIN_OPS (4 * 1024 * 1024)
+
+static void s_bench_size(int key_count, const char* size_name)
+{
+	uint64_t* keys = (uint64_t*)cf_alloc(sizeof(uint64_t) * key_count);
+	uint64_t* misses = (uint64_t*)cf_alloc(sizeof(uint64_t) * key_count);
+	BenchRng rng;
+	for (int i = 0; i < key_count; ++i) keys[i] = bench_key((uint64_t)i);
+	for (int i = 0; i < key_count; ++i) misses[i] = bench_key((uint64_t)key_count + i);
+	int rounds = key_count < HASHTABLE_MIN_OPS ? HASHTABLE_MIN_OPS / key_count : 1;
+	int64_t ops = (int64_t)key_count * rounds;
+	char name[64];
+
+	// Inserting into an empty table, growth included.
+	htbl uint64_t* table = NULL;
+	uint64_t start = cf_get_ticks();
+	for (int r = 0; r < rounds; ++r) {
+		hfree(table);
+		table = NULL;
+		for (int i = 0; i < key_count; ++i) hset(table, keys[i], (uint64_t)i);
+	}
+	snprintf(name, sizeof(name), "Insert, %s keys", size_name);
+	bench_report(name, bench_seconds(start), ops);
+
+	// Lookups in a random order, so large tables miss the cache the way they would in a game.
+	int* order = (int*)cf_alloc(sizeof(int) * key_count);
+	for (int i = 0; i < key_count; ++i) order[i] = i;
+	for (int i = key_count - 1; i > 0; --i) {
+		int j = (int)(rng.next() % (uint32_t)(i + 1));
+		int t = order[i];
+		order[i] = order[j];
+		order[j] = t;
+	}
+	uint64_t sum = 0;
+	start = cf_get_ticks();
+	for (int r = 0; r < rounds; ++r) {
+		for (int i = 0; i < key_count; ++i) sum += hget(table, keys[order[i]]);
+	}
+	snprintf(name, sizeof(name), "Lookup hit, %s keys", size_name);
+	bench_report(name, bench_seconds(start), ops);
+
+	start = cf_get_ticks();
+	for (int r = 0; r < rounds; ++r) {
+		for (int i = 0; i < key_count; ++i) sum += hhas(table, misses[i]);
+	}
+	snprintf(name, sizeof(name), "Lookup miss, %s keys", size_name);
+	bench_report(name, bench_seconds(start), ops);
+	bench_sink(sum);
+
+	// Deleting every key, refilling the table between rounds so each round starts full.
+	double seconds = 0;
+	for (int r = 0; r < rounds; ++r) {
+		if (r) {
+			for (int i = 0; i < key_count; ++i) hset(table, keys[i], (uint64_t)i);
+		}
+		start = cf_get_ticks();
+		for (int i = 0; i < key_count; ++i) hdel(table, keys[order[i]]);
+		seconds += bench_seconds(start);
+	}
+	bench_sink((uint64_t)hcount(table));
+	snprintf(name, sizeof(name), "Delete, %s keys", size_name);
+	bench_report(name, seconds, ops);
+
+	hfree(table);
+	cf_free(order);
+	cf_free(misses);
+	cf_free(keys);
+}
+
+// A loop of hget against hget_many, looking up random keys in a table far larger than L2.
+static void s_bench_batch()
+{
+	const int key_count = 4 * 1024 * 1024;
+	const int batch_count = 1024;
+	const int lookup_count = 8 * 1024 * 1024;
+	htbl uint64_t* table = NULL;
+	for (int i = 0; i < key_count; ++i) hset(table, bench_key((uint64_t)i), (uint64_t)i);
+	uint64_t* batch = (uint64_t*)cf_alloc(sizeof(uint64_t) * lookup_count);
+	uint64_t* out = (uint64_t*)cf_alloc(sizeof(uint64_t) * batch_count);
+	BenchRng rng;
+	for (int i = 0; i < lookup_count; ++i) batch[i] = bench_key(rng.next() % (uint32_t)key_count);
+
+	uint64_t sum = 0;
+	uint64_t start = cf_get_ticks();
+	for (int base = 0; base < lookup_count; base += batch_count) {
+		for (int i = 0; i < batch_count; ++i) out[i] = hget(table, batch[base + i]);
+		sum += out[batch_count - 1];
+	}
+	bench_report("Loop of hget, 4M keys, batches of 1024", bench_seconds(start), lookup_count);
+
+	start = cf_get_ticks();
+	for (int base = 0; base < lookup_count; base += batch_count) {
+		hget_many(table, batch + base, batch_count, out);
+		sum += out[batch_count - 1];
+	}
+	bench_report("hget_many, 4M keys, batches of 1024", bench_seconds(start), lookup_count);
+	bench_sink(sum);
+
+	cf_free(out);
+	cf_free(batch);
+	hfree(table);
+}
+
+/* Insert, lookup and delete on the htbl API at 1K, 100K and 10M keys, then batched lookups. */
+BENCH(bench_hashtable)
+{
+	printf("  Backend: %s\n", HASHTABLE_BACKEND);
+	s_bench_size(1000, "1K");
+	s_bench_size(100 * 1000, "100K");
+	s_bench_size(10 * 1000 * 1000, "10M");
+	s_bench_batch();
+}
@@ -0,0 +1,97 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include "bench_harness.h"
+
+using namespace Cute;
+
+#define STACK_ITERS (4 * 1024 * 1024)
+
+// A short-lived stack that only ever holds a few elements, built and torn down each time.
+template <typename Stack>
+static void s_bench_short_lived(const char* name)
+{
+	BenchRng rng;
+	uint64_t start = cf_get_ticks();
+	for (int i = 0; i < STACK_ITERS; ++i) {
+		Stack stack;
+		int depth = 1 + (int)(rng.next() & 3);
+		for (int j = 0; j < depth; ++j) stack.add(cf_make_color_rgba_f((float)j, 0, 0, 1));
+		bench_sink((uint64_t)stack.last().r);
+	}
+	bench_report(name, bench_seconds(start), STACK_ITERS);
+}
+
+// A long-lived stack pushed and popped around some work, the way draw state is.
+template <typename Stack>
+static void s_bench_push_pop(const char* name)
+{
+	Stack stack = { cf_color_white() };
+	uint64_t start = cf_get_ticks();
+	for (int i = 0; i < STACK_ITERS; ++i) {
+		stack.add(cf_make_color_rgba_f((float)(i & 7), 0, 0, 1));
+		bench_sink((uint64_t)stack.last().r);
+		stack.pop();
+	}
+	bench_report(name, bench_seconds(start), STACK_ITERS);
+}
+
+// The draw API's own state stacks. These need a GPU device, so they're skipped when a hidden window can't be made,
+// in which case the synthetic loops above are the stand-in.
+static void s_bench_draw_stacks()
+{
+	CF_Result result = cf_make_app("bench", 0, 0, 0, 64, 64, CF_APP_OPTIONS_HIDDEN_BIT | CF_APP_OPTIONS_NO_AUDIO_BIT | CF_APP_OPTIONS_FILE_SYSTEM_DONT_DEFAULT_MOUNT_BIT, NULL);
+	if (cf_is_error(result)) {
+		printf("  %-52s %s (%s)\n", "cf_draw_push/pop_*", "skipped", result.details);
+		return;
+	}
+
+	uint64_t start = cf_get_ticks();
+	for (int i = 0; i < STACK_ITERS; ++i) {
+		cf_draw_push_color(cf_make_color_rgba_f((float)(i & 7), 0, 0, 1));
+		bench_sink((uint64_t)cf_draw_peek_color().r);
+		cf_draw_pop_color();
+	}
+	bench_report("cf_draw_push_color/cf_draw_pop_color", bench_seconds(start), STACK_ITERS);
+
+	// Pushing the layer already on top records no draw command, so this measures the stack alone.
+	int layer = cf_draw_peek_layer();
+	start = cf_get_ticks();
+	for (int i = 0; i < STACK_ITERS; ++i) {
+		cf_draw_push_layer(layer);
+		bench_sink((uint64_t)cf_draw_peek_layer());
+		cf_draw_pop_layer();
+	}
+	bench_report("cf_draw_push_layer/cf_draw_pop_layer", bench_seconds(start), STACK_ITERS);
+
+	// Nested pushes a few deep, the way a scene usually sets up state around groups of draws.
+	start = cf_get_ticks();
+	for (int i = 0; i < STACK_ITERS; i += 4) {
+		cf_draw_push_layer(layer);
+		cf_draw_push_color(cf_color_red());
+		cf_draw_push_antialias(true);
+		cf_draw_push_color(cf_color_blue());
+		bench_sink((uint64_t)cf_draw_peek_color().b);
+		cf_draw_pop_color();
+		cf_draw_pop_antialias();
+		cf_draw_pop_color();
+		cf_draw_pop_layer();
+	}
+	bench_report("Nested color/antialias/layer pushes, per push", bench_seconds(start), STACK_ITERS);
+
+	cf_destroy_app();
+}
+
+/* Array versus InlineArray for the small stacks used by the draw API, then the draw API's stacks themselves. */
+BENCH(bench_inline_array)
+{
+	s_bench_short_lived<Array<CF_Color>>("Short-lived stack of 1-4, Array");
+	s_bench_short_lived<InlineArray<CF_Color, 4>>("Short-lived stack of 1-4, InlineArray<4>");
+	s_bench_push_pop<Array<CF_Color>>("Persistent stack push/pop, Array");
+	s_bench_push_pop<InlineArray<CF_Color, 4>>("Persistent stack push/pop, InlineArray<4>");
+	s_bench_draw_stacks();
+}
@@ -0,0 +1,170 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include "bench_harness.h"
+
+#define INTERN_NAME_COUNT (20 * 1000)
+#define INTERN_CALLS_PER_THREAD (512 * 1024)
+
+// The intern table as it was before sharding: one htbl keyed by hash, behind one read/write lock.
+struct RwInternTable
+{
+	htbl cf_intern_t** interns;
+	CF_Arena arena;
+	CF_ReadWriteLock lock;
+};
+
+static const char* s_rw_intern(RwInternTable* table, const char* start, int len)
+{
+	uint64_t hash = cf_fnv1a(start, len);
+	cf_intern_t* intern = NULL;
+	cf_read_lock(&table->lock);
+	if (table->interns) intern = hget(table->interns, hash);
+	cf_read_unlock(&table->lock);
+	for (cf_intern_t* i = intern; i; i = i->next) {
+		if (len == i->len && !CF_STRNCMP(i->string, start, len)) {
+			return i->string;
+		}
+	}
+
+	cf_intern_t* list = intern;
+	cf_write_lock(&table->lock);
+	intern = (cf_intern_t*)cf_arena_alloc(&table->arena, (int)sizeof(cf_intern_t) + len + 1);
+	hset(table->interns, hash, intern);
+	intern->cookie = CF_INTERN_COOKIE;
+	intern->len = len;
+	intern->string = (char*)(intern + 1);
+	CF_MEMCPY((char*)intern->string, start, len);
+	((char*)intern->string)[len] = 0;
+	intern->next = list;
+	cf_write_unlock(&table->lock);
+	return intern->string;
+}
+
+// Names shaped like what games intern: asset paths, component and event names.
+struct InternNames
+{
+	char* text;
+	int offsets[INTERN_NAME_COUNT];
+	int lengths[INTERN_NAME_COUNT];
+};
+
+static void s_make_names(InternNames* names)
+{
+	const char* words[] = { "player", "enemy", "bullet", "door", "chest", "tile", "particle", "button", "health", "score", "camera", "light" };
+	const char* formats[] = { "assets/sprites/%s_%d.ase", "component.%s.%d", "on_%s_%d_changed", "%s%d" };
+	names->text = (char*)cf_alloc(INTERN_NAME_COUNT * 48);
+	int offset = 0;
+	for (int i = 0; i < INTERN_NAME_COUNT; ++i) {
+		const char* format = formats[i % CF_ARRAY_SIZE(formats)];
+		const char* word = words[(i / CF_ARRAY_SIZE(formats)) % CF_ARRAY_SIZE(words)];
+		int len = snprintf(names->text + offset, 48, format, word, i);
+		names->offsets[i] = offset;
+		names->lengths[i] = len;
+		offset += len + 1;
+	}
+}
+
+// Zipf distributed picks, so a few hot names make up most calls and a long tail shows up now and then.
+static void s_make_picks(int* picks, int count, uint64_t seed)
+{
+	static double cdf[INTERN_NAME_COUNT];
+	double total = 0;
+	for (int i = 0; i < INTERN_NAME_COUNT; ++i) cdf[i] = (total += 1.0 / (i + 1));
+	BenchRng rng;
+	rng.state ^= seed;
+	for (int i = 0; i < count; ++i) {
+		double u = (double)rng.next() / 4294967296.0 * total;
+		int lo = 0, hi = INTERN_NAME_COUNT - 1;
+		while (lo < hi) {
+			int mid = (lo + hi) / 2;
+			if (cdf[mid] < u) lo = mid + 1;
+			else hi = mid;
+		}
+		picks[i] = lo;
+	}
+}
+
+struct InternWorker
+{
+	const InternNames* names;
+	const int* picks;
+	RwInternTable* rw;
+	uint64_t sum;
+};
+
+static int s_intern_worker(void* udata)
+{
+	InternWorker* worker = (InternWorker*)udata;
+	uint64_t sum = 0;
+	for (int i = 0; i < INTERN_CALLS_PER_THREAD; ++i) {
+		int name = worker->picks[i];
+		const char* start = worker->names->text + worker->names->offsets[name];
+		sum += (uintptr_t)cf_sintern_range(start, start + worker->names->lengths[name]);
+	}
+	worker->sum = sum;
+	return 0;
+}
+
+static int s_rw_intern_worker(void* udata)
+{
+	InternWorker* worker = (InternWorker*)udata;
+	uint64_t sum = 0;
+	for (int i = 0; i < INTERN_CALLS_PER_THREAD; ++i) {
+		int name = worker->picks[i];
+		sum += (uintptr_t)s_rw_intern(worker->rw, worker->names->text + worker->names->offsets[name], worker->names->lengths[name]);
+	}
+	worker->sum = sum;
+	return 0;
+}
+
+static void s_run(const char* label, int thread_count, CF_ThreadFn fn, InternWorker* workers)
+{
+	char name[64];
+	int64_t ops = (int64_t)INTERN_CALLS_PER_THREAD * thread_count;
+	// The first pass inserts every name it meets, the second only finds names that are already there.
+	double seconds = bench_threads(thread_count, fn, workers, sizeof(InternWorker));
+	snprintf(name, sizeof(name), "%s, first pass, %d thread%s", label, thread_count, thread_count > 1 ? "s" : "");
+	bench_report(name, seconds, ops);
+	seconds = bench_threads(thread_count, fn, workers, sizeof(InternWorker));
+	snprintf(name, sizeof(name), "%s, second pass, %d thread%s", label, thread_count, thread_count > 1 ? "s" : "");
+	bench_report(name, seconds, ops);
+	for (int i = 0; i < thread_count; ++i) bench_sink(workers[i].sum);
+}
+
+/* sintern against the old global read/write locked table, many threads interning Zipf distributed names. */
+BENCH(bench_intern)
+{
+	InternNames* names = (InternNames*)cf_alloc(sizeof(InternNames));
+	s_make_names(names);
+	int* picks = (int*)cf_alloc(sizeof(int) * INTERN_CALLS_PER_THREAD * BENCH_MAX_THREADS);
+	for (int i = 0; i < BENCH_MAX_THREADS; ++i) {
+		s_make_picks(picks + i * INTERN_CALLS_PER_THREAD, INTERN_CALLS_PER_THREAD, (uint64_t)(i + 1) * 104729);
+	}
+
+	int thread_counts[] = { 1, 4, 16 };
+	for (int t = 0; t < (int)CF_ARRAY_SIZE(thread_counts); ++t) {
+		int thread_count = thread_counts[t];
+		InternWorker workers[BENCH_MAX_THREADS];
+
+		RwInternTable rw = { NULL, cf_make_arena(8, CF_MB), cf_make_rw_lock() };
+		for (int i = 0; i < thread_count; ++i) workers[i] = { names, picks + i * INTERN_CALLS_PER_THREAD, &rw, 0 };
+		s_run("htbl + rw lock", thread_count, s_rw_intern_worker, workers);
+		hfree(rw.interns);
+		cf_destroy_arena(&rw.arena);
+		cf_destroy_rw_lock(&rw.lock);
+
+		cf_sinuke_intern_table();
+		for (int i = 0; i < thread_count; ++i) workers[i] = { names, picks + i * INTERN_CALLS_PER_THREAD, NULL, 0 };
+		s_run("sintern", thread_count, s_intern_worker, workers);
+		cf_sinuke_intern_table();
+	}
+
+	cf_free(picks);
+	cf_free(names->text);
+	cf_free(names);
+}
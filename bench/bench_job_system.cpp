@@ -0,0 +1,185 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include "bench_harness.h"
+
+#define TINY_JOB_COUNT 4000
+#define TINY_JOB_ROUNDS 25
+#define TREE_LEAF_COUNT 4096
+#define TREE_LEAF_SIZE 64
+#define TREE_NODE_COUNT (TREE_LEAF_COUNT * 2 - 1)
+#define TREE_ROUNDS 10
+#define FIB_N 22
+#define FIB_ROUNDS 10
+
+// Each task bumps its own counter, so the only cost measured is getting tasks to threads and back.
+static void s_tiny(void* udata)
+{
+	++*(int*)udata;
+}
+
+static void s_bench_tiny(int thread_count)
+{
+	int* counters = (int*)cf_calloc(sizeof(int), TINY_JOB_COUNT);
+	char name[64];
+
+	CF_Threadpool* pool = cf_make_threadpool(thread_count);
+	uint64_t start = cf_get_ticks();
+	for (int r = 0; r < TINY_JOB_ROUNDS; ++r) {
+		for (int i = 0; i < TINY_JOB_COUNT; ++i) cf_threadpool_add_task(pool, s_tiny, counters + i);
+		cf_threadpool_kick_and_wait(pool);
+	}
+	snprintf(name, sizeof(name), "Threadpool, tiny tasks, %d thread%s", thread_count, thread_count > 1 ? "s" : "");
+	bench_report(name, bench_seconds(start), (int64_t)TINY_JOB_COUNT * TINY_JOB_ROUNDS);
+	cf_destroy_threadpool(pool);
+
+	CF_JobSystem* system = cf_make_job_system(thread_count, 0);
+	CF_Job* jobs = (CF_Job*)cf_alloc(sizeof(CF_Job) * TINY_JOB_COUNT);
+	start = cf_get_ticks();
+	for (int r = 0; r < TINY_JOB_ROUNDS; ++r) {
+		for (int i = 0; i < TINY_JOB_COUNT; ++i) jobs[i] = cf_job_run(system, s_tiny, counters + i);
+		for (int i = 0; i < TINY_JOB_COUNT; ++i) cf_job_wait(system, jobs[i]);
+	}
+	snprintf(name, sizeof(name), "Job system, tiny jobs, %d thread%s", thread_count, thread_count > 1 ? "s" : "");
+	bench_report(name, bench_seconds(start), (int64_t)TINY_JOB_COUNT * TINY_JOB_ROUNDS);
+	cf_free(jobs);
+	cf_destroy_job_system(system);
+
+	bench_sink((uint64_t)counters[TINY_JOB_COUNT - 1]);
+	cf_free(counters);
+}
+
+// A reduction over a binary tree, stored as an implicit heap with the leaves at the end. Each leaf sums a small chunk of items
+// and each inner node adds up its two children.
+struct TreeNode
+{
+	int64_t value;
+	const int* items;
+	const TreeNode* a;
+	const TreeNode* b;
+};
+
+static void s_tree_leaf(void* udata)
+{
+	TreeNode* node = (TreeNode*)udata;
+	int64_t sum = 0;
+	for (int i = 0; i < TREE_LEAF_SIZE; ++i) sum += node->items[i];
+	node->value = sum;
+}
+
+static void s_tree_join(void* udata)
+{
+	TreeNode* node = (TreeNode*)udata;
+	node->value = node->a->value + node->b->value;
+}
+
+static void s_bench_tree(int thread_count, TreeNode* nodes)
+{
+	char name[64];
+
+	// The threadpool has no dependencies, so it runs the tree one level at a time, from the leaves up.
+	CF_Threadpool* pool = cf_make_threadpool(thread_count);
+	uint64_t start = cf_get_ticks();
+	for (int r = 0; r < TREE_ROUNDS; ++r) {
+		for (int i = TREE_LEAF_COUNT - 1; i < TREE_NODE_COUNT; ++i) cf_threadpool_add_task(pool, s_tree_leaf, nodes + i);
+		cf_threadpool_kick_and_wait(pool);
+		for (int first = TREE_LEAF_COUNT / 2 - 1; first >= 0; first = (first - 1) / 2) {
+			for (int i = first; i < first * 2 + 1; ++i) cf_threadpool_add_task(pool, s_tree_join, nodes + i);
+			cf_threadpool_kick_and_wait(pool);
+			if (!first) break;
+		}
+	}
+	snprintf(name, sizeof(name), "Threadpool, tree by level, %d thread%s", thread_count, thread_count > 1 ? "s" : "");
+	bench_report(name, bench_seconds(start), (int64_t)TREE_NODE_COUNT * TREE_ROUNDS);
+	bench_sink((uint64_t)nodes[0].value);
+	cf_destroy_threadpool(pool);
+
+	// Every inner node runs after its two children, as soon as both are done.
+	CF_JobSystem* system = cf_make_job_system(thread_count, TREE_NODE_COUNT);
+	CF_Job* jobs = (CF_Job*)cf_alloc(sizeof(CF_Job) * TREE_NODE_COUNT);
+	start = cf_get_ticks();
+	for (int r = 0; r < TREE_ROUNDS; ++r) {
+		for (int i = TREE_LEAF_COUNT - 1; i < TREE_NODE_COUNT; ++i) jobs[i] = cf_job_run(system, s_tree_leaf, nodes + i);
+		for (int i = TREE_LEAF_COUNT - 2; i >= 0; --i) jobs[i] = cf_job_run_after(system, s_tree_join, nodes + i, jobs + i * 2 + 1, 2);
+		cf_job_wait(system, jobs[0]);
+	}
+	snprintf(name, sizeof(name), "Job system, tree by dependency, %d thread%s", thread_count, thread_count > 1 ? "s" : "");
+	bench_report(name, bench_seconds(start), (int64_t)TREE_NODE_COUNT * TREE_ROUNDS);
+	bench_sink((uint64_t)nodes[0].value);
+	cf_free(jobs);
+	cf_destroy_job_system(system);
+}
+
+// Recursive fib where each call hands one half off as a job and waits on it, the fork-join pattern a threadpool can't run at all.
+struct Fib
+{
+	CF_JobSystem* system;
+	int n;
+	int result;
+};
+
+static void s_fib_job(void* udata)
+{
+	Fib* fib = (Fib*)udata;
+	if (fib->n < 2) {
+		fib->result = fib->n;
+		return;
+	}
+	Fib a = { fib->system, fib->n - 1, 0 };
+	Fib b = { fib->system, fib->n - 2, 0 };
+	CF_Job job = cf_job_run(fib->system, s_fib_job, &a);
+	s_fib_job(&b);
+	cf_job_wait(fib->system, job);
+	fib->result = a.result + b.result;
+}
+
+static void s_bench_fib(int thread_count)
+{
+	// Every call with n >= 2 starts one job, which works out to fib(n + 1) - 1 jobs.
+	int a = 0, b = 1;
+	for (int i = 0; i < FIB_N + 1; ++i) {
+		int t = a + b;
+		a = b;
+		b = t;
+	}
+	int job_count = a - 1;
+
+	CF_JobSystem* system = cf_make_job_system(thread_count, 0);
+	uint64_t start = cf_get_ticks();
+	for (int r = 0; r < FIB_ROUNDS; ++r) {
+		Fib fib = { system, FIB_N, 0 };
+		s_fib_job(&fib);
+		bench_sink((uint64_t)fib.result);
+	}
+	char name[64];
+	snprintf(name, sizeof(name), "Job system, nested fib(%d), %d thread%s", FIB_N, thread_count, thread_count > 1 ? "s" : "");
+	bench_report(name, bench_seconds(start), (int64_t)job_count * FIB_ROUNDS);
+	cf_destroy_job_system(system);
+}
+
+/* CF_JobSystem against CF_Threadpool on many tiny jobs and a reduction tree, plus nested fork-join, at 1, 4 and 16 threads. */
+BENCH(bench_job_system)
+{
+	int* items = (int*)cf_alloc(sizeof(int) * TREE_LEAF_COUNT * TREE_LEAF_SIZE);
+	for (int i = 0; i < TREE_LEAF_COUNT * TREE_LEAF_SIZE; ++i) items[i] = i;
+	TreeNode* nodes = (TreeNode*)cf_calloc(sizeof(TreeNode), TREE_NODE_COUNT);
+	for (int i = 0; i < TREE_LEAF_COUNT - 1; ++i) {
+		nodes[i].a = nodes + i * 2 + 1;
+		nodes[i].b = nodes + i * 2 + 2;
+	}
+	for (int i = 0; i < TREE_LEAF_COUNT; ++i) nodes[TREE_LEAF_COUNT - 1 + i].items = items + i * TREE_LEAF_SIZE;
+
+	int thread_counts[] = { 1, 4, 16 };
+	for (int t = 0; t < (int)CF_ARRAY_SIZE(thread_counts); ++t) {
+		s_bench_tiny(thread_counts[t]);
+		s_bench_tree(thread_counts[t], nodes);
+		s_bench_fib(thread_counts[t]);
+	}
+
+	cf_free(nodes);
+	cf_free(items);
+}
@@ -0,0 +1,169 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include "bench_harness.h"
+
+#define POOL_ELEMENT_SIZE 64
+#define POOL_ELEMENT_COUNT 1024
+#define POOL_BATCH 64
+#define POOL_OPS (2 * 1024 * 1024)
+
+// The memory pool as it was before it went thread-safe: one intrusive free list, here guarded by a single mutex.
+struct LockedPoolBlock
+{
+	LockedPoolBlock* next;
+};
+
+struct LockedPool
+{
+	CF_Mutex lock;
+	void* free_list;
+	LockedPoolBlock* blocks;
+};
+
+static void s_locked_pool_grow(LockedPool* pool)
+{
+	LockedPoolBlock* block = (LockedPoolBlock*)cf_alloc(sizeof(LockedPoolBlock) + POOL_ELEMENT_SIZE * POOL_ELEMENT_COUNT);
+	block->next = pool->blocks;
+	pool->blocks = block;
+	uint8_t* memory = (uint8_t*)(block + 1);
+	for (int i = 0; i < POOL_ELEMENT_COUNT; ++i) {
+		void* element = memory + POOL_ELEMENT_SIZE * i;
+		*(void**)element = pool->free_list;
+		pool->free_list = element;
+	}
+}
+
+static void* s_locked_pool_alloc(LockedPool* pool)
+{
+	cf_mutex_lock(&pool->lock);
+	if (!pool->free_list) s_locked_pool_grow(pool);
+	void* element = pool->free_list;
+	pool->free_list = *(void**)element;
+	cf_mutex_unlock(&pool->lock);
+	return element;
+}
+
+static void s_locked_pool_free(LockedPool* pool, void* element)
+{
+	cf_mutex_lock(&pool->lock);
+	*(void**)element = pool->free_list;
+	pool->free_list = element;
+	cf_mutex_unlock(&pool->lock);
+}
+
+static void s_locked_pool_destroy(LockedPool* pool)
+{
+	LockedPoolBlock* block = pool->blocks;
+	while (block) {
+		LockedPoolBlock* next = block->next;
+		cf_free(block);
+		block = next;
+	}
+	cf_destroy_mutex(&pool->lock);
+}
+
+struct PoolWorker
+{
+	LockedPool* locked;
+	CF_MemoryPool* pool;
+	int ops;
+	uint64_t sum;
+};
+
+// Each thread allocates a batch of elements, touches them, then frees the batch, over and over.
+static int s_locked_pool_worker(void* udata)
+{
+	PoolWorker* worker = (PoolWorker*)udata;
+	void* batch[POOL_BATCH];
+	uint64_t sum = 0;
+	for (int i = 0; i < worker->ops; i += POOL_BATCH) {
+		for (int j = 0; j < POOL_BATCH; ++j) {
+			batch[j] = s_locked_pool_alloc(worker->locked);
+			((uint64_t*)batch[j])[1] = (uint64_t)j;
+		}
+		for (int j = 0; j < POOL_BATCH; ++j) {
+			sum += ((uint64_t*)batch[j])[1];
+			s_locked_pool_free(worker->locked, batch[j]);
+		}
+	}
+	worker->sum = sum;
+	return 0;
+}
+
+static int s_pool_worker(void* udata)
+{
+	PoolWorker* worker = (PoolWorker*)udata;
+	void* batch[POOL_BATCH];
+	uint64_t sum = 0;
+	for (int i = 0; i < worker->ops; i += POOL_BATCH) {
+		for (int j = 0; j < POOL_BATCH; ++j) {
+			batch[j] = cf_memory_pool_alloc(worker->pool);
+			((uint64_t*)batch[j])[1] = (uint64_t)j;
+		}
+		for (int j = 0; j < POOL_BATCH; ++j) {
+			sum += ((uint64_t*)batch[j])[1];
+			cf_memory_pool_free(worker->pool, batch[j]);
+		}
+	}
+	worker->sum = sum;
+	return 0;
+}
+
+// Time for cf_memory_pool_trim to hand back the blocks of a pool that grew large and then emptied out.
+static void s_bench_trim()
+{
+	const int count = 1024 * 1024;
+	CF_MemoryPool* pool = cf_make_memory_pool(POOL_ELEMENT_SIZE, POOL_ELEMENT_COUNT, 8);
+	void** elements = (void**)cf_alloc(sizeof(void*) * count);
+	for (int i = 0; i < count; ++i) {
+		elements[i] = cf_memory_pool_alloc(pool);
+		CF_MEMSET(elements[i], 0, POOL_ELEMENT_SIZE);
+	}
+	for (int i = 0; i < count; ++i) cf_memory_pool_free(pool, elements[i]);
+	cf_free(elements);
+
+	uint64_t start = cf_get_ticks();
+	int released = cf_memory_pool_trim(pool);
+	double seconds = bench_seconds(start);
+	printf("  %-52s %10.2f ms %10d blocks\n", "cf_memory_pool_trim, 1M freed 64-byte elements", seconds * 1e3, released);
+
+	// Trimming a pool that has nothing to give back is the common case when it's called every so often.
+	start = cf_get_ticks();
+	released = cf_memory_pool_trim(pool);
+	printf("  %-52s %10.2f ms %10d blocks\n", "cf_memory_pool_trim, already trimmed", bench_seconds(start) * 1e3, released);
+	cf_destroy_memory_pool(pool);
+}
+
+/* Mutex-guarded free list against the magazine pool at 1, 4 and 16 threads, plus the cost of a trim. */
+BENCH(bench_memory_pool)
+{
+	int thread_counts[] = { 1, 4, 16 };
+	for (int t = 0; t < (int)CF_ARRAY_SIZE(thread_counts); ++t) {
+		int thread_count = thread_counts[t];
+		int64_t ops = (int64_t)POOL_OPS * thread_count;
+		PoolWorker workers[BENCH_MAX_THREADS];
+		char name[64];
+
+		LockedPool locked = { cf_make_mutex(), NULL, NULL };
+		for (int i = 0; i < thread_count; ++i) workers[i] = { &locked, NULL, POOL_OPS, 0 };
+		double seconds = bench_threads(thread_count, s_locked_pool_worker, workers, sizeof(PoolWorker));
+		for (int i = 0; i < thread_count; ++i) bench_sink(workers[i].sum);
+		s_locked_pool_destroy(&locked);
+		snprintf(name, sizeof(name), "Free list + mutex, %d thread%s", thread_count, thread_count > 1 ? "s" : "");
+		bench_report(name, seconds, ops);
+
+		CF_MemoryPool* pool = cf_make_memory_pool(POOL_ELEMENT_SIZE, POOL_ELEMENT_COUNT, 8);
+		for (int i = 0; i < thread_count; ++i) workers[i] = { NULL, pool, POOL_OPS, 0 };
+		seconds = bench_threads(thread_count, s_pool_worker, workers, sizeof(PoolWorker));
+		for (int i = 0; i < thread_count; ++i) bench_sink(workers[i].sum);
+		cf_destroy_memory_pool(pool);
+		snprintf(name, sizeof(name), "CF_MemoryPool, %d thread%s", thread_count, thread_count > 1 ? "s" : "");
+		bench_report(name, seconds, ops);
+	}
+	s_bench_trim();
+}
@@ -0,0 +1,106 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include "bench_harness.h"
+
+#define LOOP_ITEM_COUNT (256 * 1024)
+// Each case does about this many steps in total, spread over as many rounds as it takes.
+#define LOOP_TOTAL_STEPS (64 * 1024 * 1024)
+// The hand-chunked threadpool splits the range into this many tasks per thread.
+#define LOOP_CHUNKS_PER_THREAD 4
+
+// `steps` dependent multiply-adds per item, or for an uneven loop, anywhere from none up to twice that depending on the index.
+struct LoopBody
+{
+	float* items;
+	int steps;
+	bool uneven;
+};
+
+static CF_INLINE int s_steps_for(const LoopBody* body, int i)
+{
+	return body->uneven ? (int)((int64_t)body->steps * 2 * i / LOOP_ITEM_COUNT) : body->steps;
+}
+
+static void s_loop(int begin, int end, void* udata)
+{
+	LoopBody* body = (LoopBody*)udata;
+	for (int i = begin; i < end; ++i) {
+		float x = body->items[i];
+		int steps = s_steps_for(body, i);
+		for (int s = 0; s < steps; ++s) x = x * 0.999f + 0.5f;
+		body->items[i] = x;
+	}
+}
+
+struct LoopChunk
+{
+	LoopBody* body;
+	int begin;
+	int end;
+};
+
+static void s_loop_chunk(void* udata)
+{
+	LoopChunk* chunk = (LoopChunk*)udata;
+	s_loop(chunk->begin, chunk->end, chunk->body);
+}
+
+static void s_bench_cost(const char* label, int steps, bool uneven)
+{
+	LoopBody body = { (float*)cf_calloc(sizeof(float), LOOP_ITEM_COUNT), steps, uneven };
+	int rounds = cf_max(1, LOOP_TOTAL_STEPS / (LOOP_ITEM_COUNT * steps));
+	int64_t ops = (int64_t)LOOP_ITEM_COUNT * rounds;
+	// Enough items per chunk to be worth handing to another thread, roughly 4K steps of work.
+	int min_batch = cf_max(1, 4096 / steps);
+	char name[64];
+
+	uint64_t start = cf_get_ticks();
+	for (int r = 0; r < rounds; ++r) s_loop(0, LOOP_ITEM_COUNT, &body);
+	snprintf(name, sizeof(name), "Serial, %s", label);
+	bench_report(name, bench_seconds(start), ops);
+
+	int thread_counts[] = { 1, 4, 16 };
+	for (int t = 0; t < (int)CF_ARRAY_SIZE(thread_counts); ++t) {
+		int thread_count = thread_counts[t];
+
+		CF_JobSystem* system = cf_make_job_system(thread_count, 0);
+		start = cf_get_ticks();
+		for (int r = 0; r < rounds; ++r) cf_parallel_for(system, LOOP_ITEM_COUNT, min_batch, s_loop, &body);
+		snprintf(name, sizeof(name), "cf_parallel_for, %s, %d thread%s", label, thread_count, thread_count > 1 ? "s" : "");
+		bench_report(name, bench_seconds(start), ops);
+		cf_destroy_job_system(system);
+
+		// Equal sized chunks handed out up front, the way a loop was split over a threadpool before cf_parallel_for.
+		CF_Threadpool* pool = cf_make_threadpool(thread_count);
+		int chunk_count = thread_count * LOOP_CHUNKS_PER_THREAD;
+		LoopChunk chunks[BENCH_MAX_THREADS * LOOP_CHUNKS_PER_THREAD];
+		for (int i = 0; i < chunk_count; ++i) {
+			chunks[i] = { &body, (int)((int64_t)LOOP_ITEM_COUNT * i / chunk_count), (int)((int64_t)LOOP_ITEM_COUNT * (i + 1) / chunk_count) };
+		}
+		start = cf_get_ticks();
+		for (int r = 0; r < rounds; ++r) {
+			for (int i = 0; i < chunk_count; ++i) cf_threadpool_add_task(pool, s_loop_chunk, chunks + i);
+			cf_threadpool_kick_and_wait(pool);
+		}
+		snprintf(name, sizeof(name), "Threadpool chunks, %s, %d thread%s", label, thread_count, thread_count > 1 ? "s" : "");
+		bench_report(name, bench_seconds(start), ops);
+		cf_destroy_threadpool(pool);
+	}
+
+	bench_sink((uint64_t)body.items[LOOP_ITEM_COUNT - 1]);
+	cf_free(body.items);
+}
+
+/* A loop over 256K items run serially, with cf_parallel_for, and hand-chunked over a threadpool, from cheap to costly items. */
+BENCH(bench_parallel_for)
+{
+	s_bench_cost("1 step per item", 1, false);
+	s_bench_cost("16 steps per item", 16, false);
+	s_bench_cost("256 steps per item", 256, false);
+	s_bench_cost("uneven, 0-512 steps", 256, true);
+}
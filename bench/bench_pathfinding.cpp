@@ -0,0 +1,156 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include "bench_harness.h"
+
+#define PATH_BATCH_THREADS 4
+
+// Scattered blocked cells plus long walls with gaps, so searches have to wind around obstacles instead of heading straight
+// for the goal. Vertical walls every 64 columns and horizontal walls every 96 rows, each with a 4 cell gap every 48 cells.
+static CF_PathGrid* s_make_map(int size, int density, uint64_t seed)
+{
+	CF_PathGrid* grid = cf_make_path_grid(size, size);
+	BenchRng rng;
+	rng.state ^= seed;
+	for (int y = 0; y < size; ++y) {
+		for (int x = 0; x < size; ++x) {
+			if ((int)(rng.next() % 100) < density) cf_path_grid_set_blocked(grid, x, y, true);
+		}
+	}
+	for (int x = 32; x < size; x += 64) {
+		for (int y = 0; y < size; ++y) {
+			if (y % 48 >= 4) cf_path_grid_set_blocked(grid, x, y, true);
+		}
+	}
+	for (int y = 48; y < size; y += 96) {
+		for (int x = 0; x < size; ++x) {
+			if ((x + 24) % 48 >= 4) cf_path_grid_set_blocked(grid, x, y, true);
+		}
+	}
+	return grid;
+}
+
+static CF_PathPoint s_random_open_cell(const CF_PathGrid* grid, BenchRng* rng)
+{
+	int w = cf_path_grid_width(grid), h = cf_path_grid_height(grid);
+	CF_PathPoint p;
+	do {
+		p.x = (int)(rng->next() % (uint32_t)w);
+		p.y = (int)(rng->next() % (uint32_t)h);
+	} while (cf_path_grid_is_blocked(grid, p.x, p.y));
+	return p;
+}
+
+// Random start and goal pairs, the same ones for every kind of search on a map.
+static CF_PathRequest* s_make_requests(const CF_PathGrid* grid, int count)
+{
+	CF_PathRequest* requests = (CF_PathRequest*)cf_alloc(sizeof(CF_PathRequest) * count);
+	BenchRng rng;
+	for (int i = 0; i < count; ++i) {
+		requests[i] = { };
+		requests[i].start = s_random_open_cell(grid, &rng);
+		requests[i].goal = s_random_open_cell(grid, &rng);
+	}
+	return requests;
+}
+
+static void s_report_ms_per_query(const char* name, double seconds, int query_count)
+{
+	printf("  %-52s %10.2f ms/query\n", name, seconds * 1e3 / query_count);
+}
+
+static void s_bench_map(int size, int density, int query_count)
+{
+	CF_PathGrid* grid = s_make_map(size, density, (uint64_t)size * 31 + density);
+	CF_PathRequest* requests = s_make_requests(grid, query_count);
+	CF_PathContext* ctx = cf_make_path_context(grid);
+	char name[64];
+	uint64_t sum = 0;
+
+	uint64_t start = cf_get_ticks();
+	for (int i = 0; i < query_count; ++i) sum += cf_path_find(ctx, requests + i);
+	snprintf(name, sizeof(name), "JPS, %dx%d, %d%% blocked", size, size, density);
+	s_report_ms_per_query(name, bench_seconds(start), query_count);
+
+	for (int i = 0; i < query_count; ++i) requests[i].astar_only = true;
+	start = cf_get_ticks();
+	for (int i = 0; i < query_count; ++i) sum += cf_path_find(ctx, requests + i);
+	snprintf(name, sizeof(name), "A*, %dx%d, %d%% blocked", size, size, density);
+	s_report_ms_per_query(name, bench_seconds(start), query_count);
+	for (int i = 0; i < query_count; ++i) requests[i].astar_only = false;
+
+	// The calling thread searches too, so there's one more context than pool threads.
+	CF_Threadpool* pool = cf_make_threadpool(PATH_BATCH_THREADS);
+	CF_PathContext* contexts[PATH_BATCH_THREADS + 1];
+	for (int i = 0; i < PATH_BATCH_THREADS + 1; ++i) contexts[i] = cf_make_path_context(grid);
+	start = cf_get_ticks();
+	cf_path_find_batch(contexts, PATH_BATCH_THREADS + 1, pool, requests, query_count);
+	snprintf(name, sizeof(name), "JPS batch, %dx%d, %d%% blocked, %d threads", size, size, density, PATH_BATCH_THREADS + 1);
+	s_report_ms_per_query(name, bench_seconds(start), query_count);
+	for (int i = 0; i < query_count; ++i) sum += requests[i].found;
+	for (int i = 0; i < PATH_BATCH_THREADS + 1; ++i) cf_destroy_path_context(contexts[i]);
+	cf_destroy_threadpool(pool);
+	bench_sink(sum);
+
+	cf_destroy_path_context(ctx);
+	cf_free(requests);
+	cf_destroy_path_grid(grid);
+}
+
+// Building a hierarchy, searching it, and keeping it up to date as single cells are toggled, the way a game edits its map.
+static void s_bench_hierarchy(int size, int density, int cluster_size, int query_count)
+{
+	CF_PathGrid* grid = s_make_map(size, density, (uint64_t)size * 31 + density);
+	CF_PathRequest* requests = s_make_requests(grid, query_count);
+	CF_PathContext* ctx = cf_make_path_context(grid);
+	char name[64];
+	uint64_t sum = 0;
+
+	uint64_t start = cf_get_ticks();
+	CF_PathHierarchy* hierarchy = cf_make_path_hierarchy(grid, cluster_size);
+	snprintf(name, sizeof(name), "Hierarchy build, %dx%d, %d%% blocked, cluster %d", size, size, density, cluster_size);
+	printf("  %-52s %10.2f ms\n", name, bench_seconds(start) * 1e3);
+
+	start = cf_get_ticks();
+	for (int i = 0; i < query_count; ++i) sum += cf_path_find_hierarchical(ctx, hierarchy, requests + i);
+	snprintf(name, sizeof(name), "Hierarchical, %dx%d, %d%% blocked, cluster %d", size, size, density, cluster_size);
+	s_report_ms_per_query(name, bench_seconds(start), query_count);
+
+	// Each edit dirties one cluster, or two along an edge, which are rebuilt before the next edit.
+	const int edit_count = 200;
+	BenchRng rng;
+	double seconds = 0;
+	for (int i = 0; i < edit_count; ++i) {
+		int x = (int)(rng.next() % (uint32_t)size), y = (int)(rng.next() % (uint32_t)size);
+		cf_path_grid_set_blocked(grid, x, y, !cf_path_grid_is_blocked(grid, x, y));
+		start = cf_get_ticks();
+		sum += cf_path_hierarchy_update(hierarchy);
+		seconds += bench_seconds(start);
+	}
+	snprintf(name, sizeof(name), "Edit rebuild, %dx%d, %d%% blocked, cluster %d", size, size, density, cluster_size);
+	printf("  %-52s %10.2f us/edit\n", name, seconds * 1e6 / edit_count);
+	bench_sink(sum);
+
+	cf_destroy_path_hierarchy(hierarchy);
+	cf_destroy_path_context(ctx);
+	cf_free(requests);
+	cf_destroy_path_grid(grid);
+}
+
+/* Query latency of JPS, plain A* and batched JPS on 512x512 and 2048x2048 grids, sparse and dense, then hierarchical searches. */
+BENCH(bench_pathfinding)
+{
+	int densities[] = { 2, 15 };
+	for (int d = 0; d < (int)CF_ARRAY_SIZE(densities); ++d) {
+		s_bench_map(512, densities[d], 200);
+		s_bench_map(2048, densities[d], 20);
+	}
+	for (int d = 0; d < (int)CF_ARRAY_SIZE(densities); ++d) {
+		s_bench_hierarchy(1024, densities[d], 16, 200);
+		s_bench_hierarchy(1024, densities[d], 32, 200);
+	}
+}
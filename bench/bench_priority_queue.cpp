@@ -0,0 +1,120 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include "bench_harness.h"
+
+#include <cute_priority_queue.h>
+
+using namespace Cute;
+
+#define QUEUE_ITEM_COUNT (200 * 1000)
+#define QUEUE_ROUNDS 10
+
+// An 8 byte payload, about what a search stores per open node.
+struct QueueItem
+{
+	int node;
+	int parent;
+};
+
+static void s_make_costs(float* costs, int count)
+{
+	BenchRng rng;
+	for (int i = 0; i < count; ++i) costs[i] = (float)(rng.next() % 100000) * 0.01f;
+}
+
+// Pushing every item and then draining the queue.
+static void s_bench_push_pop(const float* costs)
+{
+	uint64_t sum = 0;
+	PriorityQueue<QueueItem> q;
+	uint64_t start = cf_get_ticks();
+	for (int r = 0; r < QUEUE_ROUNDS; ++r) {
+		for (int i = 0; i < QUEUE_ITEM_COUNT; ++i) q.push_min({ i, i - 1 }, costs[i]);
+		QueueItem item;
+		while (q.pop_min(&item)) sum += (uint64_t)item.node;
+	}
+	bench_report("PriorityQueue push_min + pop_min, 200K items", bench_seconds(start), (int64_t)QUEUE_ITEM_COUNT * QUEUE_ROUNDS);
+
+	IndexedPriorityQueue<QueueItem> iq;
+	start = cf_get_ticks();
+	for (int r = 0; r < QUEUE_ROUNDS; ++r) {
+		for (int i = 0; i < QUEUE_ITEM_COUNT; ++i) iq.push({ i, i - 1 }, costs[i]);
+		QueueItem item;
+		while (iq.pop(&item)) sum += (uint64_t)item.node;
+	}
+	bench_report("IndexedPriorityQueue push + pop, 200K items", bench_seconds(start), (int64_t)QUEUE_ITEM_COUNT * QUEUE_ROUNDS);
+	bench_sink(sum);
+}
+
+// The A* pattern: a push, a decrease_key on an item already queued, and a pop every third step. PriorityQueue has
+// no decrease_key, so it pushes a duplicate and skips stale entries as they're popped, the usual workaround.
+// Costs are non-negative, a queued cost of -1 marks an item that was already popped.
+static void s_bench_decrease_key(const float* costs)
+{
+	int* handles = (int*)cf_alloc(sizeof(int) * QUEUE_ITEM_COUNT);
+	float* queued = (float*)cf_alloc(sizeof(float) * QUEUE_ITEM_COUNT);
+	uint64_t sum = 0;
+
+	PriorityQueue<QueueItem> q;
+	uint64_t start = cf_get_ticks();
+	for (int r = 0; r < QUEUE_ROUNDS; ++r) {
+		for (int i = 0; i < QUEUE_ITEM_COUNT; ++i) {
+			q.push_min({ i, i - 1 }, costs[i]);
+			queued[i] = costs[i];
+			int j = (int)(costs[(i * 7) % QUEUE_ITEM_COUNT] * 100.0f) % (i + 1);
+			if (queued[j] >= 0) {
+				queued[j] *= 0.5f;
+				q.push_min({ j, i }, queued[j]);
+			}
+			if (i % 3 == 2) {
+				QueueItem item;
+				float cost;
+				while (q.pop_min(&item, &cost) && cost != queued[item.node]) {}
+				queued[item.node] = -1.0f;
+				sum += (uint64_t)item.node;
+			}
+		}
+		QueueItem item;
+		while (q.pop_min(&item)) sum += (uint64_t)item.node;
+	}
+	bench_report("PriorityQueue with duplicate pushes, 200K items", bench_seconds(start), (int64_t)QUEUE_ITEM_COUNT * QUEUE_ROUNDS);
+
+	IndexedPriorityQueue<QueueItem> iq;
+	start = cf_get_ticks();
+	for (int r = 0; r < QUEUE_ROUNDS; ++r) {
+		for (int i = 0; i < QUEUE_ITEM_COUNT; ++i) {
+			handles[i] = iq.push({ i, i - 1 }, costs[i]);
+			int j = (int)(costs[(i * 7) % QUEUE_ITEM_COUNT] * 100.0f) % (i + 1);
+			if (iq.contains(handles[j]) && iq.value(handles[j]).node == j) {
+				iq.decrease_key(handles[j], iq.cost(handles[j]) * 0.5f);
+			}
+			if (i % 3 == 2) {
+				QueueItem item;
+				iq.pop(&item);
+				sum += (uint64_t)item.node;
+			}
+		}
+		QueueItem item;
+		while (iq.pop(&item)) sum += (uint64_t)item.node;
+	}
+	bench_report("IndexedPriorityQueue with decrease_key, 200K items", bench_seconds(start), (int64_t)QUEUE_ITEM_COUNT * QUEUE_ROUNDS);
+	bench_sink(sum);
+
+	cf_free(queued);
+	cf_free(handles);
+}
+
+/* PriorityQueue against IndexedPriorityQueue on random float costs, plain and with decrease_key. */
+BENCH(bench_priority_queue)
+{
+	float* costs = (float*)cf_alloc(sizeof(float) * QUEUE_ITEM_COUNT);
+	s_make_costs(costs, QUEUE_ITEM_COUNT);
+	s_bench_push_pop(costs);
+	s_bench_decrease_key(costs);
+	cf_free(costs);
+}
@@ -0,0 +1,176 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include "bench_harness.h"
+
+#include <thread>
+
+#define QUEUE_CAPACITY 1024
+#define QUEUE_ITEMS_PER_PRODUCER (1024 * 1024)
+#define QUEUE_SINGLE_THREAD_OPS (8 * 1024 * 1024)
+
+// What handing items between threads took before the lock-free queues: a ring buffer behind a mutex.
+struct LockedQueue
+{
+	CF_Mutex lock;
+	uint64_t items[QUEUE_CAPACITY];
+	int head;
+	int count;
+};
+
+static bool s_locked_push(LockedQueue* queue, uint64_t item)
+{
+	cf_mutex_lock(&queue->lock);
+	bool pushed = queue->count < QUEUE_CAPACITY;
+	if (pushed) queue->items[(queue->head + queue->count++) % QUEUE_CAPACITY] = item;
+	cf_mutex_unlock(&queue->lock);
+	return pushed;
+}
+
+static bool s_locked_pop(LockedQueue* queue, uint64_t* item)
+{
+	cf_mutex_lock(&queue->lock);
+	bool popped = queue->count > 0;
+	if (popped) {
+		*item = queue->items[queue->head];
+		queue->head = (queue->head + 1) % QUEUE_CAPACITY;
+		--queue->count;
+	}
+	cf_mutex_unlock(&queue->lock);
+	return popped;
+}
+
+// Producers push their own run of items and consumers pop an equal share, yielding whenever the queue is full or empty.
+struct QueueWorker
+{
+	CF_SPSCQueue* spsc;
+	CF_MPMCQueue* mpmc;
+	LockedQueue* locked;
+	bool producer;
+	int count;
+	uint64_t sum;
+};
+
+static int s_spsc_worker(void* udata)
+{
+	QueueWorker* worker = (QueueWorker*)udata;
+	uint64_t sum = 0;
+	for (int i = 0; i < worker->count; ++i) {
+		uint64_t item = (uint64_t)i;
+		if (worker->producer) {
+			while (!cf_spsc_queue_push(worker->spsc, &item)) std::this_thread::yield();
+		} else {
+			while (!cf_spsc_queue_pop(worker->spsc, &item)) std::this_thread::yield();
+			sum += item;
+		}
+	}
+	worker->sum = sum;
+	return 0;
+}
+
+static int s_mpmc_worker(void* udata)
+{
+	QueueWorker* worker = (QueueWorker*)udata;
+	uint64_t sum = 0;
+	for (int i = 0; i < worker->count; ++i) {
+		uint64_t item = (uint64_t)i;
+		if (worker->producer) {
+			while (!cf_mpmc_queue_push(worker->mpmc, &item)) std::this_thread::yield();
+		} else {
+			while (!cf_mpmc_queue_pop(worker->mpmc, &item)) std::this_thread::yield();
+			sum += item;
+		}
+	}
+	worker->sum = sum;
+	return 0;
+}
+
+static int s_locked_worker(void* udata)
+{
+	QueueWorker* worker = (QueueWorker*)udata;
+	uint64_t sum = 0;
+	for (int i = 0; i < worker->count; ++i) {
+		uint64_t item = (uint64_t)i;
+		if (worker->producer) {
+			while (!s_locked_push(worker->locked, item)) std::this_thread::yield();
+		} else {
+			while (!s_locked_pop(worker->locked, &item)) std::this_thread::yield();
+			sum += item;
+		}
+	}
+	worker->sum = sum;
+	return 0;
+}
+
+// Runs `pair_count` producers and as many consumers, the producers first in `workers`.
+static void s_run(const char* label, int pair_count, CF_ThreadFn fn, CF_SPSCQueue* spsc, CF_MPMCQueue* mpmc, LockedQueue* locked)
+{
+	QueueWorker workers[BENCH_MAX_THREADS];
+	for (int i = 0; i < pair_count * 2; ++i) workers[i] = { spsc, mpmc, locked, i < pair_count, QUEUE_ITEMS_PER_PRODUCER, 0 };
+	double seconds = bench_threads(pair_count * 2, fn, workers, sizeof(QueueWorker));
+	for (int i = pair_count; i < pair_count * 2; ++i) bench_sink(workers[i].sum);
+	char name[64];
+	snprintf(name, sizeof(name), "%s, %d producer%s / %d consumer%s", label, pair_count, pair_count > 1 ? "s" : "", pair_count, pair_count > 1 ? "s" : "");
+	bench_report(name, seconds, (int64_t)QUEUE_ITEMS_PER_PRODUCER * pair_count);
+}
+
+// A push straight followed by a pop on one thread, the cost of the queue operations with no other thread touching the cache lines.
+static void s_bench_single_thread(CF_SPSCQueue* spsc, CF_MPMCQueue* mpmc, LockedQueue* locked)
+{
+	uint64_t sum = 0;
+	uint64_t start = cf_get_ticks();
+	for (int i = 0; i < QUEUE_SINGLE_THREAD_OPS; ++i) {
+		uint64_t item = (uint64_t)i;
+		cf_spsc_queue_push(spsc, &item);
+		cf_spsc_queue_pop(spsc, &item);
+		sum += item;
+	}
+	bench_report("CF_SPSCQueue push + pop, 1 thread", bench_seconds(start), QUEUE_SINGLE_THREAD_OPS);
+
+	start = cf_get_ticks();
+	for (int i = 0; i < QUEUE_SINGLE_THREAD_OPS; ++i) {
+		uint64_t item = (uint64_t)i;
+		cf_mpmc_queue_push(mpmc, &item);
+		cf_mpmc_queue_pop(mpmc, &item);
+		sum += item;
+	}
+	bench_report("CF_MPMCQueue push + pop, 1 thread", bench_seconds(start), QUEUE_SINGLE_THREAD_OPS);
+
+	start = cf_get_ticks();
+	for (int i = 0; i < QUEUE_SINGLE_THREAD_OPS; ++i) {
+		uint64_t item = (uint64_t)i;
+		s_locked_push(locked, item);
+		s_locked_pop(locked, &item);
+		sum += item;
+	}
+	bench_report("Ring + mutex push + pop, 1 thread", bench_seconds(start), QUEUE_SINGLE_THREAD_OPS);
+	bench_sink(sum);
+}
+
+/* CF_SPSCQueue and CF_MPMCQueue against a mutex-guarded ring, from one producer and consumer up to eight of each. */
+BENCH(bench_queue)
+{
+	CF_SPSCQueue* spsc = cf_make_spsc_queue(sizeof(uint64_t), QUEUE_CAPACITY);
+	CF_MPMCQueue* mpmc = cf_make_mpmc_queue(sizeof(uint64_t), QUEUE_CAPACITY);
+	LockedQueue* locked = (LockedQueue*)cf_calloc(sizeof(LockedQueue), 1);
+	locked->lock = cf_make_mutex();
+
+	s_bench_single_thread(spsc, mpmc, locked);
+
+	// A single producer and consumer is the only case the SPSC queue supports.
+	s_run("CF_SPSCQueue", 1, s_spsc_worker, spsc, NULL, NULL);
+	int pair_counts[] = { 1, 2, 4, 8 };
+	for (int p = 0; p < (int)CF_ARRAY_SIZE(pair_counts); ++p) {
+		s_run("CF_MPMCQueue", pair_counts[p], s_mpmc_worker, NULL, mpmc, NULL);
+		s_run("Ring + mutex", pair_counts[p], s_locked_worker, NULL, NULL, locked);
+	}
+
+	cf_destroy_mutex(&locked->lock);
+	cf_free(locked);
+	cf_destroy_mpmc_queue(mpmc);
+	cf_destroy_spsc_queue(spsc);
+}
@@ -0,0 +1,82 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include "bench_harness.h"
+
+using namespace Cute;
+
+#define ENTITY_COUNT (256 * 1024)
+#define UPDATE_COUNT 100
+
+struct EntityName
+{
+	char text[32];
+};
+
+// A typical fat game object, where most fields aren't touched by the movement update.
+struct Entity
+{
+	v2 position;
+	v2 velocity;
+	float rotation;
+	CF_Color color;
+	int id;
+	EntityName name;
+};
+
+static void s_bench_aos()
+{
+	Array<Entity> entities;
+	entities.ensure_capacity(ENTITY_COUNT);
+	for (int i = 0; i < ENTITY_COUNT; ++i) {
+		Entity& e = entities.add();
+		e.position = V2((float)i, 0);
+		e.velocity = V2(1, (float)(i & 15));
+		e.rotation = 0;
+		e.color = cf_color_white();
+		e.id = i;
+	}
+
+	// Raw pointers in both loops, since operator[] always runs its bounds assert.
+	uint64_t start = cf_get_ticks();
+	for (int u = 0; u < UPDATE_COUNT; ++u) {
+		Entity* e = entities.data();
+		for (int i = 0; i < entities.count(); ++i) {
+			e[i].position += e[i].velocity * (1.0f / 60.0f);
+		}
+	}
+	bench_report("Movement update, Array of structs", bench_seconds(start), (int64_t)ENTITY_COUNT * UPDATE_COUNT);
+	bench_sink((uint64_t)entities.last().position.x);
+}
+
+static void s_bench_soa()
+{
+	// Same fields as `Entity`, one column each.
+	SoA<v2, v2, float, CF_Color, int, EntityName> entities;
+	for (int i = 0; i < ENTITY_COUNT; ++i) {
+		entities.add(V2((float)i, 0), V2(1, (float)(i & 15)), 0.0f, cf_color_white(), i, EntityName());
+	}
+
+	uint64_t start = cf_get_ticks();
+	for (int u = 0; u < UPDATE_COUNT; ++u) {
+		Span<v2> positions = entities.column<0>();
+		v2* p = positions.begin();
+		v2* v = entities.column<1>().begin();
+		for (int i = 0; i < positions.count(); ++i) {
+			p[i] += v[i] * (1.0f / 60.0f);
+		}
+	}
+	bench_report("Movement update, SoA columns", bench_seconds(start), (int64_t)ENTITY_COUNT * UPDATE_COUNT);
+	bench_sink((uint64_t)entities.get<0>(ENTITY_COUNT - 1).x);
+}
+
+/* Looping over one field of many objects, array of structs versus structure of arrays. */
+BENCH(bench_soa)
+{
+	s_bench_aos();
+	s_bench_soa();
+}
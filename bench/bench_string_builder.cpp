@@ -0,0 +1,127 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include "bench_harness.h"
+
+#define DOCUMENT_SIZE (10 * CF_MB)
+#define DOCUMENT_LINES 256
+#define DOCUMENT_PATH "/bench_string_builder.txt"
+
+// A handful of JSON-ish lines, cycled through to build a document.
+static char s_lines[DOCUMENT_LINES][64];
+
+static void s_make_lines()
+{
+	for (int i = 0; i < DOCUMENT_LINES; ++i) {
+		snprintf(s_lines[i], sizeof(s_lines[i]), "{ \"id\": %d, \"name\": \"entity_%d\", \"x\": %d.5 },\n", i * 37, i, i % 100);
+	}
+}
+
+static void s_report_ms(const char* name, double seconds)
+{
+	printf("  %-52s %10.2f ms\n", name, seconds * 1e3);
+}
+
+// Appending prebuilt lines, the case where only the growth strategy differs.
+static void s_bench_append()
+{
+	int calls = 0;
+	char* s = NULL;
+	uint64_t start = cf_get_ticks();
+	while (slen(s) < DOCUMENT_SIZE) sappend(s, s_lines[calls++ % DOCUMENT_LINES]);
+	bench_report("sappend, 10MB document", bench_seconds(start), calls);
+	bench_sink((uint64_t)slen(s));
+	sfree(s);
+
+	calls = 0;
+	CF_StringBuilder* sb = cf_make_string_builder(0);
+	start = cf_get_ticks();
+	while (cf_string_builder_len(sb) < DOCUMENT_SIZE) cf_string_builder_append(sb, s_lines[calls++ % DOCUMENT_LINES]);
+	bench_report("cf_string_builder_append, 10MB document", bench_seconds(start), calls);
+	bench_sink((uint64_t)cf_string_builder_len(sb));
+	cf_destroy_string_builder(sb);
+}
+
+// Formatting each line as it's appended, where the formatting itself is most of the work.
+static void s_bench_fmt()
+{
+	int calls = 0;
+	char* s = NULL;
+	uint64_t start = cf_get_ticks();
+	while (slen(s) < DOCUMENT_SIZE) {
+		sfmt_append(s, "{ \"id\": %d, \"name\": \"entity_%d\", \"x\": %f },\n", calls * 37, calls, calls * 0.5f);
+		++calls;
+	}
+	bench_report("sfmt_append, 10MB document", bench_seconds(start), calls);
+	bench_sink((uint64_t)slen(s));
+	sfree(s);
+
+	calls = 0;
+	CF_StringBuilder* sb = cf_make_string_builder(0);
+	start = cf_get_ticks();
+	while (cf_string_builder_len(sb) < DOCUMENT_SIZE) {
+		cf_string_builder_fmt(sb, "{ \"id\": %d, \"name\": \"entity_%d\", \"x\": %f },\n", calls * 37, calls, calls * 0.5f);
+		++calls;
+	}
+	bench_report("cf_string_builder_fmt, 10MB document", bench_seconds(start), calls);
+	bench_sink((uint64_t)cf_string_builder_len(sb));
+	cf_destroy_string_builder(sb);
+}
+
+static CF_StringBuilder* s_make_document()
+{
+	CF_StringBuilder* sb = cf_make_string_builder(0);
+	for (int i = 0; cf_string_builder_len(sb) < DOCUMENT_SIZE; ++i) cf_string_builder_append(sb, s_lines[i % DOCUMENT_LINES]);
+	return sb;
+}
+
+// Getting a finished document out: one contiguous string, or streamed straight to a file chunk by chunk.
+static void s_bench_output()
+{
+	CF_StringBuilder* sb = s_make_document();
+	uint64_t start = cf_get_ticks();
+	bench_sink((uint64_t)cf_string_builder_c_str(sb)[0]);
+	s_report_ms("cf_string_builder_c_str, 10MB document", bench_seconds(start));
+	cf_destroy_string_builder(sb);
+
+	CF_Result result = cf_fs_init(NULL);
+	if (!cf_is_error(result)) result = cf_fs_set_write_directory(cf_fs_get_base_directory());
+	if (cf_is_error(result)) {
+		printf("  %-52s %s (%s)\n", "cf_string_builder_write", "skipped", result.details);
+		cf_fs_destroy();
+		return;
+	}
+
+	sb = s_make_document();
+	CF_File* file = cf_fs_open_file_for_write(DOCUMENT_PATH);
+	start = cf_get_ticks();
+	cf_string_builder_write(sb, file);
+	cf_fs_close(file);
+	s_report_ms("cf_string_builder_write, 10MB document", bench_seconds(start));
+	cf_destroy_string_builder(sb);
+
+	sb = s_make_document();
+	file = cf_fs_open_file_for_write(DOCUMENT_PATH);
+	start = cf_get_ticks();
+	const char* text = cf_string_builder_c_str(sb);
+	cf_fs_write(file, text, (size_t)cf_string_builder_len(sb));
+	cf_fs_close(file);
+	s_report_ms("cf_string_builder_c_str + cf_fs_write, 10MB document", bench_seconds(start));
+	cf_destroy_string_builder(sb);
+
+	cf_fs_remove(DOCUMENT_PATH);
+	cf_fs_destroy();
+}
+
+/* Building a 10MB document with sappend/sfmt_append against CF_StringBuilder, then writing it out. */
+BENCH(bench_string_builder)
+{
+	s_make_lines();
+	s_bench_append();
+	s_bench_fmt();
+	s_bench_output();
+}
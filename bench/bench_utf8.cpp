@@ -0,0 +1,105 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include "bench_harness.h"
+
+#define PARAGRAPH_SIZE (32 * CF_KB)
+#define DECODE_PASSES 2000
+#define LAYOUT_PASSES 20
+
+// Builds a paragraph of roughly PARAGRAPH_SIZE bytes by cycling through `words`.
+static char* s_make_paragraph(const char** words, int word_count)
+{
+	char* s = NULL;
+	for (int i = 0; slen(s) < PARAGRAPH_SIZE; ++i) {
+		sappend(s, words[i % word_count]);
+		sappend(s, (i % 13) == 12 ? "\n" : " ");
+	}
+	return s;
+}
+
+static void s_report_bytes_per_second(const char* name, double seconds, int64_t bytes)
+{
+	printf("  %-52s %10.2f GB/s\n", name, (double)bytes / seconds / 1e9);
+}
+
+static void s_bench_decode(const char* label, const char* text)
+{
+	int len = slen(text);
+	const char* end = text + len;
+	char name[64];
+	uint64_t sum = 0;
+
+	// The decoders are out of line, so their work can't be optimized away. Each loop only touches one result
+	// per call, keeping the cost of consuming codepoints out of the comparison.
+	uint64_t start = cf_get_ticks();
+	for (int pass = 0; pass < DECODE_PASSES; ++pass) {
+		const char* p = text;
+		while (p < end) {
+			int cp;
+			p = cf_decode_UTF8(p, &cp);
+			sum += (uint64_t)cp;
+		}
+	}
+	snprintf(name, sizeof(name), "cf_decode_UTF8 loop, %s", label);
+	s_report_bytes_per_second(name, bench_seconds(start), (int64_t)len * DECODE_PASSES);
+
+	int cps[256];
+	start = cf_get_ticks();
+	for (int pass = 0; pass < DECODE_PASSES; ++pass) {
+		const char* p = text;
+		while (p < end) {
+			int count;
+			p = cf_decode_UTF8_bulk(p, (int)(end - p), cps, (int)CF_ARRAY_SIZE(cps), &count);
+			sum += (uint64_t)cps[count - 1];
+		}
+	}
+	snprintf(name, sizeof(name), "cf_decode_UTF8_bulk, %s", label);
+	s_report_bytes_per_second(name, bench_seconds(start), (int64_t)len * DECODE_PASSES);
+	bench_sink(sum);
+}
+
+// Measuring a paragraph with the default font, which lays out the whole text. Needs a GPU device, so it's skipped
+// when a hidden window can't be made.
+static void s_bench_layout(const char* ascii, const char* cjk)
+{
+	CF_Result result = cf_make_app("bench", 0, 0, 0, 64, 64, CF_APP_OPTIONS_HIDDEN_BIT | CF_APP_OPTIONS_NO_AUDIO_BIT | CF_APP_OPTIONS_FILE_SYSTEM_DONT_DEFAULT_MOUNT_BIT, NULL);
+	if (cf_is_error(result)) {
+		printf("  %-52s %s (%s)\n", "cf_text_size", "skipped", result.details);
+		return;
+	}
+	const char* texts[] = { ascii, cjk };
+	const char* labels[] = { "cf_text_size, mostly ASCII paragraph", "cf_text_size, CJK paragraph" };
+	for (int t = 0; t < (int)CF_ARRAY_SIZE(texts); ++t) {
+		uint64_t start = cf_get_ticks();
+		for (int pass = 0; pass < LAYOUT_PASSES; ++pass) {
+			bench_sink((uint64_t)cf_text_size(texts[t], -1).x);
+		}
+		s_report_bytes_per_second(labels[t], bench_seconds(start), (int64_t)slen(texts[t]) * LAYOUT_PASSES);
+	}
+	cf_destroy_app();
+}
+
+/* Per-codepoint cf_decode_UTF8 against cf_decode_UTF8_bulk on long paragraphs, then text layout when possible. */
+BENCH(bench_utf8)
+{
+	const char* ascii_words[] = { "The", "quick", "brown", "fox", "jumps", "over", "the", "lazy", "dog,", "and", "then", "naps." };
+	const char* mixed_words[] = { "The", "café", "served", "crème", "brûlée", "to", "a", "naïve", "visitor", "—", "delicious!", "😀" };
+	const char* cjk_words[] = { "日本語の", "テキストと", "中文字符", "混在的", "段落。", "한국어", "문장도", "함께", "표시됩니다." };
+	char* ascii = s_make_paragraph(ascii_words, (int)CF_ARRAY_SIZE(ascii_words));
+	char* mixed = s_make_paragraph(mixed_words, (int)CF_ARRAY_SIZE(mixed_words));
+	char* cjk = s_make_paragraph(cjk_words, (int)CF_ARRAY_SIZE(cjk_words));
+
+	s_bench_decode("ASCII", ascii);
+	s_bench_decode("mostly ASCII", mixed);
+	s_bench_decode("CJK", cjk);
+	s_bench_layout(mixed, cjk);
+
+	sfree(cjk);
+	sfree(mixed);
+	sfree(ascii);
+}
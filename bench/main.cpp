@@ -0,0 +1,126 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include "bench_harness.h"
+
+#include <string.h>
+
+#ifdef _WIN32
+#	ifndef WIN32_LEAN_AND_MEAN
+#		define WIN32_LEAN_AND_MEAN
+#	endif
+#	include <windows.h>
+#	include <psapi.h>
+#elif defined(__linux__)
+#	include <unistd.h>
+#endif
+
+volatile uint64_t g_bench_sink;
+
+double bench_seconds(uint64_t start)
+{
+	return (double)(cf_get_ticks() - start) / (double)cf_get_tick_frequency();
+}
+
+void bench_report(const char* name, double seconds, int64_t ops)
+{
+	printf("  %-52s %10.2f ns/op %10.2f Mops/s\n", name, seconds * 1e9 / (double)ops, (double)ops / seconds / 1e6);
+}
+
+double bench_threads(int thread_count, CF_ThreadFn fn, void* udata, size_t stride)
+{
+	CF_ASSERT(thread_count > 0 && thread_count <= BENCH_MAX_THREADS);
+	CF_Thread* threads[BENCH_MAX_THREADS];
+	uint64_t start = cf_get_ticks();
+	for (int i = 0; i < thread_count; ++i) {
+		threads[i] = cf_thread_create(fn, "bench", (char*)udata + i * stride);
+	}
+	for (int i = 0; i < thread_count; ++i) {
+		cf_thread_wait(threads[i]);
+	}
+	return bench_seconds(start);
+}
+
+size_t bench_rss()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+	return (size_t)counters.WorkingSetSize;
+#elif defined(__linux__)
+	FILE* fp = fopen("/proc/self/statm", "r");
+	if (!fp) return 0;
+	long pages = 0, resident = 0;
+	int read = fscanf(fp, "%ld %ld", &pages, &resident);
+	fclose(fp);
+	if (read != 2) return 0;
+	return (size_t)resident * (size_t)sysconf(_SC_PAGESIZE);
+#else
+	return 0;
+#endif
+}
+
+void bench_report_bytes(const char* name, size_t bytes)
+{
+	printf("  %-52s %10.2f MB\n", name, (double)bytes / (double)CF_MB);
+}
+
+BENCH(bench_alloc);
+BENCH(bench_frame_alloc);
+BENCH(bench_inline_array);
+BENCH(bench_soa);
+BENCH(bench_memory_pool);
+BENCH(bench_hashtable);
+BENCH(bench_concurrent_map);
+BENCH(bench_intern);
+BENCH(bench_string_builder);
+BENCH(bench_utf8);
+BENCH(bench_priority_queue);
+BENCH(bench_pathfinding);
+BENCH(bench_job_system);
+BENCH(bench_parallel_for);
+BENCH(bench_fiber_jobs);
+BENCH(bench_queue);
+
+#define RUN_BENCH(name) if (!filter || strstr(#name, filter)) { printf("%s\n", #name); name(); printf("\n"); }
+
+// Usage: benchmarks [--small-allocator] [filter]
+// Only benchmarks whose name contains `filter` are run. Run once with and once without `--small-allocator`
+// to compare allocators, since the allocator can't be swapped once anything has been allocated.
+int main(int argc, char* argv[])
+{
+	const char* filter = NULL;
+	bool small_allocator = false;
+	for (int i = 1; i < argc; ++i) {
+		if (!strcmp(argv[i], "--small-allocator")) {
+			small_allocator = true;
+		} else {
+			filter = argv[i];
+		}
+	}
+	if (small_allocator) cf_allocator_override(cf_small_allocator());
+	printf("Allocator: %s\n\n", small_allocator ? "small" : "default");
+
+	RUN_BENCH(bench_alloc);
+	RUN_BENCH(bench_frame_alloc);
+	RUN_BENCH(bench_inline_array);
+	RUN_BENCH(bench_soa);
+	RUN_BENCH(bench_memory_pool);
+	RUN_BENCH(bench_hashtable);
+	RUN_BENCH(bench_concurrent_map);
+	RUN_BENCH(bench_intern);
+	RUN_BENCH(bench_string_builder);
+	RUN_BENCH(bench_utf8);
+	RUN_BENCH(bench_priority_queue);
+	RUN_BENCH(bench_pathfinding);
+	RUN_BENCH(bench_job_system);
+	RUN_BENCH(bench_parallel_for);
+	RUN_BENCH(bench_fiber_jobs);
+	RUN_BENCH(bench_queue);
+
+	return 0;
+}
@@ -33,6 +33,7 @@
 #include "cute_base64.h"
 #include "cute_clipboard.h"
 #include "cute_color.h"
+#include "cute_concurrent_map.h"
 #include "cute_multithreading.h"
 #include "cute_coroutine.h"
 #include "cute_defer.h"
@@ -40,16 +41,21 @@
 #include "cute_draw.h"
 #include "cute_file_system.h"
 #include "cute_graphics.h"
+#include "cute_handle_table.h"
 #include "cute_hashtable.h"
 #include "cute_https.h"
 #include "cute_image.h"
 #include "cute_input.h"
+#include "cute_job_system.h"
 #include "cute_joypad.h"
 #include "cute_json.h"
 #include "cute_math.h"
 #include "cute_networking.h"
 #include "cute_noise.h"
+#include "cute_pathfinding.h"
 #include "cute_png_cache.h"
+#include "cute_profile.h"
+#include "cute_queue.h"
 #include "cute_rnd.h"
 #include "cute_sprite.h"
 #include "cute_string.h"
@@ -62,6 +62,21 @@ CF_API void CF_CALL cf_allocator_override(CF_Allocator allocator);
  */
 CF_API void CF_CALL cf_allocator_restore_default();
 
+/**
+ * @function cf_small_allocator
+ * @category allocator
+ * @brief    Returns a size-class allocator tuned for many small allocations, ready to pass to `cf_allocator_override`.
+ * @remarks  Allocations up to 1024 bytes are rounded up to one of a handful of size classes. Each thread keeps its own cache
+ *           of free blocks per size class, so the common case of alloc/free takes no locks at all. Caches exchange batches of
+ *           blocks with a shared central free list when they run dry or grow too large. Larger allocations go straight to
+ *           `malloc`. Memory for small blocks is never returned to the operating system, it's only recycled.
+ *
+ *           This allocator is opt-in. Since it can't free pointers from any other allocator you must call
+ *           `cf_allocator_override(cf_small_allocator())` before any other CF function, typically the first line of `main`.
+ * @related  CF_Allocator cf_allocator_override cf_allocator_restore_default cf_small_allocator
+ */
+CF_API CF_Allocator CF_CALL cf_small_allocator();
+
 /**
  * @function cf_alloc
  * @category allocator
@@ -207,6 +222,47 @@ CF_API void CF_CALL cf_arena_free(CF_Arena* arena, int ptr);
  */
 CF_API void CF_CALL cf_arena_reset(CF_Arena* arena);
 
+/**
+ * @struct   CF_ArenaMarker
+ * @category allocator
+ * @brief    A savepoint within a `CF_Arena`, see `cf_arena_save`.
+ * @related  CF_ArenaMarker cf_arena_save cf_arena_restore
+ */
+typedef struct CF_ArenaMarker
+{
+	/* @member The arena's allocation pointer when the marker was made. */
+	char* ptr;
+
+	/* @member The arena's block index when the marker was made. */
+	int block_index;
+} CF_ArenaMarker;
+// @end
+
+/**
+ * @function cf_arena_save
+ * @category allocator
+ * @brief    Records the current position of the arena.
+ * @param    arena         The arena to save.
+ * @return   Returns a marker to later pass to `cf_arena_restore`.
+ * @remarks  Use this to grab temporary memory from an arena and release it all in O(1), for example within a recursive
+ *           algorithm. Markers can be nested, but must be restored in Last-In-First-Out (LIFO) order. In C++ see
+ *           `ArenaScope`, which restores automatically at the end of a scope.
+ * @related  CF_ArenaMarker cf_arena_save cf_arena_restore cf_arena_reset
+ */
+CF_API CF_ArenaMarker CF_CALL cf_arena_save(const CF_Arena* arena);
+
+/**
+ * @function cf_arena_restore
+ * @category allocator
+ * @brief    Frees everything allocated from the arena since `marker` was saved.
+ * @param    arena         The arena to restore.
+ * @param    marker        A marker from `cf_arena_save`.
+ * @remarks  Works across any number of internal blocks. Blocks are kept around and reused by later allocations. Restoring
+ *           invalidates any markers saved after `marker`.
+ * @related  CF_ArenaMarker cf_arena_save cf_arena_restore cf_arena_reset
+ */
+CF_API void CF_CALL cf_arena_restore(CF_Arena* arena, CF_ArenaMarker marker);
+
 /**
  * @function cf_destroy_arena
  * @category allocator
@@ -216,6 +272,86 @@ CF_API void CF_CALL cf_arena_reset(CF_Arena* arena);
  */
 CF_API void CF_CALL cf_destroy_arena(CF_Arena* arena);
 
+//--------------------------------------------------------------------------------------------------
+// Virtual memory arena.
+
+/**
+ * @struct   CF_VirtualArena
+ * @category allocator
+ * @brief    An arena that reserves a large range of virtual address space up front, and commits physical pages on demand.
+ * @remarks  Unlike `CF_Arena` there is no block size -- all allocations come from a single contiguous range, so any size
+ *           can be allocated (up to the reservation) and pointers are stable. Reserving address space is nearly free,
+ *           physical memory is only used for pages actually touched.
+ * @related  CF_VirtualArena cf_make_virtual_arena cf_virtual_arena_alloc cf_virtual_arena_reset cf_destroy_virtual_arena
+ */
+typedef struct CF_VirtualArena
+{
+	/* @member The start of the reserved address range. */
+	char* base;
+
+	/* @member The next allocation begins here. */
+	char* ptr;
+
+	/* @member Everything below here is committed and safe to touch. */
+	char* commit_end;
+
+	/* @member The end of the reserved address range. */
+	char* reserve_end;
+
+	/* @member Number of bytes to keep committed when `cf_virtual_arena_reset` is called. */
+	size_t retain_size;
+
+	/* @member Alignment of each allocation. */
+	int alignment;
+} CF_VirtualArena;
+// @end
+
+/**
+ * @function cf_make_virtual_arena
+ * @category allocator
+ * @brief    Reserves a range of virtual address space for an arena.
+ * @param    alignment     An alignment boundary, must be a power of two no larger than 256.
+ * @param    reserve_size  The maximum number of bytes the arena can ever hand out, rounded up to a multiple of the page
+ *                         size. This can be very large, such as several gigabytes on 64-bit platforms.
+ * @param    retain_size   Number of bytes to keep committed across calls to `cf_virtual_arena_reset`. Anything above this
+ *                         watermark is returned to the OS on reset.
+ * @return   Returns the arena. `base` is `NULL` if the reservation failed.
+ * @remarks  On platforms without virtual memory (such as the web) the whole reservation is allocated up front.
+ * @related  CF_VirtualArena cf_make_virtual_arena cf_virtual_arena_alloc cf_virtual_arena_reset cf_destroy_virtual_arena
+ */
+CF_API CF_VirtualArena CF_CALL cf_make_virtual_arena(int alignment, size_t reserve_size, size_t retain_size);
+
+/**
+ * @function cf_virtual_arena_alloc
+ * @category allocator
+ * @brief    Allocates a block of memory aligned along a byte boundary.
+ * @param    arena         The arena to allocate from.
+ * @param    size          The size of the allocation.
+ * @return   Returns an aligned pointer of `size` bytes, or `NULL` if the reservation is exhausted.
+ * @remarks  This is a pointer bump, plus an occasional call into the OS to commit more pages.
+ * @related  CF_VirtualArena cf_make_virtual_arena cf_virtual_arena_alloc cf_virtual_arena_reset cf_destroy_virtual_arena
+ */
+CF_API void* CF_CALL cf_virtual_arena_alloc(CF_VirtualArena* arena, size_t size);
+
+/**
+ * @function cf_virtual_arena_reset
+ * @category allocator
+ * @brief    Frees all allocations from the arena at once.
+ * @param    arena         The arena to reset.
+ * @remarks  The first `retain_size` bytes stay committed for reuse, and any committed pages above that are decommitted.
+ * @related  CF_VirtualArena cf_make_virtual_arena cf_virtual_arena_alloc cf_virtual_arena_reset cf_destroy_virtual_arena
+ */
+CF_API void CF_CALL cf_virtual_arena_reset(CF_VirtualArena* arena);
+
+/**
+ * @function cf_destroy_virtual_arena
+ * @category allocator
+ * @brief    Releases the reserved address range and all committed memory.
+ * @param    arena         The arena to destroy.
+ * @related  CF_VirtualArena cf_make_virtual_arena cf_virtual_arena_alloc cf_virtual_arena_reset cf_destroy_virtual_arena
+ */
+CF_API void CF_CALL cf_destroy_virtual_arena(CF_VirtualArena* arena);
+
 //--------------------------------------------------------------------------------------------------
 // Memory pool allocator.
 
@@ -230,7 +366,10 @@ typedef struct CF_MemoryPool CF_MemoryPool;
 
  * @param    alignment      An alignment boundary, must be a power of two.
  * @return   Returns a memory pool pointer.
- * @related  cf_destroy_memory_pool cf_memory_pool_alloc cf_memory_pool_free
+ * @remarks  Memory pools are thread-safe. Each thread caches a few free elements of its own, so allocating and freeing
+ *           from many threads at once (such as from jobs) rarely contends. The pool grows by `element_count` elements
+ *           at a time, and only gives memory back to the system on `cf_memory_pool_trim` or `cf_destroy_memory_pool`.
+ * @related  cf_destroy_memory_pool cf_memory_pool_alloc cf_memory_pool_free cf_memory_pool_trim
  */
 CF_API CF_MemoryPool* CF_CALL cf_make_memory_pool(int element_size, int element_count, int alignment);
 
@@ -239,7 +378,8 @@ CF_API CF_MemoryPool* CF_CALL cf_make_memory_pool(int element_size, int element_
  * @category allocator
  * @brief    Destroys a memory pool.
  * @param    pool           The pool to destroy.
- * @related  cf_make_memory_pool cf_memory_pool_alloc cf_memory_pool_free
+ * @remarks  No other thread may be using the pool while it's destroyed.
+ * @related  cf_make_memory_pool cf_memory_pool_alloc cf_memory_pool_free cf_memory_pool_trim
  */
 CF_API void CF_CALL cf_destroy_memory_pool(CF_MemoryPool* pool);
 
@@ -263,6 +403,221 @@ CF_API void* CF_CALL cf_memory_pool_alloc(CF_MemoryPool* pool);
  */
 CF_API void CF_CALL cf_memory_pool_free(CF_MemoryPool* pool, void* element);
 
+/**
+ * @function cf_memory_pool_trim
+ * @category allocator
+ * @brief    Returns every internal block with no live elements back to the system.
+ * @param    pool           The pool.
+ * @return   Returns the number of blocks released.
+ * @remarks  Safe to call while other threads use the pool, though elements other threads have cached or are
+ *           in the middle of allocating are counted as in-use, so their blocks are kept. This is a relatively slow
+ *           operation meant to be called occasionally, such as after unloading a level.
+ * @related  cf_make_memory_pool cf_destroy_memory_pool cf_memory_pool_alloc cf_memory_pool_free cf_memory_pool_trim
+ */
+CF_API int CF_CALL cf_memory_pool_trim(CF_MemoryPool* pool);
+
+//--------------------------------------------------------------------------------------------------
+// Frame allocator.
+
+/**
+ * @function cf_frame_alloc
+ * @category allocator
+ * @brief    Allocates scratch memory that lives until the end of the current frame.
+ * @param    size           The size of the allocation.
+ * @return   Returns a 16-byte aligned pointer of `size` bytes.
+ * @remarks  Memory from this function must *not* be free'd. Each thread owns its own frame arena, so no locking is
+ *           performed. Frame memory is recycled in bulk by `cf_frame_reset`, which happens automatically at the top of
+ *           `cf_app_update`. It stays valid until the second reset after it was allocated, so it may be read during the
+ *           next frame but never beyond that. Great for temporary vertex lists, formatted strings, query results, and other
+ *           short-lived data that would otherwise churn through `cf_alloc` and `cf_free` each frame.
+ * @related  cf_frame_alloc cf_frame_reset cf_frame_sfmt
+ */
+CF_API void* CF_CALL cf_frame_alloc(size_t size);
+
+/**
+ * @function cf_frame_reset
+ * @category allocator
+ * @brief    Recycles all memory handed out by `cf_frame_alloc`, on all threads.
+ * @remarks  This is called for you at the top of `cf_app_update`, so you only need to call this yourself if you're running
+ *           a custom loop. Memory from the frame just ended stays valid until the following reset; anything older is
+ *           recycled. Each thread lazily recycles its own frame memory the next time it calls `cf_frame_alloc`.
+ * @related  cf_frame_alloc cf_frame_reset cf_frame_sfmt
+ */
+CF_API void CF_CALL cf_frame_reset();
+
+//--------------------------------------------------------------------------------------------------
+// Memory tracking.
+
+/**
+ * @enum     CF_MemoryTag
+ * @category allocator
+ * @brief    Subsystems allocations are attributed to, for memory tracking and per-subsystem allocators.
+ * @remarks  Memory tracking is a compile-time option, see `cf_memory_tracking_enabled`. Each tag can also be given its own
+ *           allocator, see `cf_allocator_override_tag`.
+ * @related  CF_MemoryTag cf_memory_tag_to_string CF_MemoryStats cf_memory_stats cf_memory_push_tag cf_memory_pop_tag cf_allocator_override_tag
+ */
+#define CF_MEMORY_TAG_DEFS \
+	/* @entry Anything not attributed to a specific subsystem, including all of your own allocations by default. */ \
+	CF_ENUM(MEMORY_TAG_GENERAL,        0) \
+	/* @entry The draw API, spritebatch and font rendering. */ \
+	CF_ENUM(MEMORY_TAG_DRAW,           1) \
+	/* @entry Decoded png images and their animations. */ \
+	CF_ENUM(MEMORY_TAG_PNG_CACHE,      2) \
+	/* @entry Loaded aseprite files, their sprites and animations. */ \
+	CF_ENUM(MEMORY_TAG_ASEPRITE_CACHE, 3) \
+	/* @entry Audio sources and the mixer. */ \
+	CF_ENUM(MEMORY_TAG_AUDIO,          4) \
+	/* @entry Networking clients and servers. */ \
+	CF_ENUM(MEMORY_TAG_NET,            5) \
+	/* @entry JSON documents. */ \
+	CF_ENUM(MEMORY_TAG_JSON,           6) \
+	/* @entry Dynamic strings and the string intern table. */ \
+	CF_ENUM(MEMORY_TAG_STRING,         7) \
+	/* @entry The number of memory tags. */ \
+	CF_ENUM(MEMORY_TAG_COUNT,          8) \
+	/* @end */
+
+typedef enum CF_MemoryTag
+{
+	#define CF_ENUM(K, V) CF_##K = V,
+	CF_MEMORY_TAG_DEFS
+	#undef CF_ENUM
+} CF_MemoryTag;
+
+/**
+ * @function cf_memory_tag_to_string
+ * @category allocator
+ * @brief    Convert an enum `CF_MemoryTag` to a c-style string.
+ * @param    tag          The tag to convert to a string.
+ * @related  CF_MemoryTag cf_memory_tag_to_string CF_MemoryStats cf_memory_stats
+ */
+CF_INLINE const char* cf_memory_tag_to_string(CF_MemoryTag tag)
+{
+	switch (tag) {
+	#define CF_ENUM(K, V) case CF_##K: return CF_STRINGIZE(CF_##K);
+	CF_MEMORY_TAG_DEFS
+	#undef CF_ENUM
+	default: return NULL;
+	}
+}
+
+/**
+ * @struct   CF_MemoryStats
+ * @category allocator
+ * @brief    Memory usage counters for a single `CF_MemoryTag`.
+ * @remarks  All counters are zero if memory tracking is disabled, see `cf_memory_tracking_enabled`. Sizes are the sizes
+ *           requested by the caller, and do not include any allocator overhead.
+ * @related  CF_MemoryTag CF_MemoryStats cf_memory_stats cf_memory_reset_peak cf_memory_dump_leaks
+ */
+typedef struct CF_MemoryStats
+{
+	/* @member Number of bytes currently allocated. */
+	int64_t live_bytes;
+
+	/* @member Number of allocations not yet free'd. */
+	int64_t live_allocations;
+
+	/* @member The highest `live_bytes` has been since startup, or since the last call to `cf_memory_reset_peak`. */
+	int64_t peak_bytes;
+
+	/* @member Total number of allocations ever made, including ones already free'd. */
+	int64_t total_allocations;
+} CF_MemoryStats;
+// @end
+
+/**
+ * @function cf_memory_tracking_enabled
+ * @category allocator
+ * @brief    Returns true if CF was built with memory tracking enabled.
+ * @remarks  Memory tracking is turned on by building CF with the CMake option `CF_FRAMEWORK_MEMORY_TRACKING`. When enabled
+ *           `cf_alloc`, `cf_free`, `cf_calloc`, `cf_realloc` and `cf_aligned_alloc` attribute each allocation to a
+ *           `CF_MemoryTag`, at the cost of a 16-byte header per allocation and a couple relaxed atomic adds. This is
+ *           intended to be cheap enough to leave on in release builds.
+ * @related  CF_MemoryTag CF_MemoryStats cf_memory_stats cf_memory_tracking_enabled cf_memory_dump_leaks
+ */
+CF_API bool CF_CALL cf_memory_tracking_enabled();
+
+/**
+ * @function cf_memory_stats
+ * @category allocator
+ * @brief    Returns memory usage counters for a tag.
+ * @param    tag          The subsystem to query.
+ * @remarks  Counters are updated from all threads, so the returned values are a snapshot and may be very slightly out of
+ *           sync with each other.
+ * @related  CF_MemoryTag CF_MemoryStats cf_memory_stats cf_memory_reset_peak cf_memory_dump_leaks
+ */
+CF_API CF_MemoryStats CF_CALL cf_memory_stats(CF_MemoryTag tag);
+
+/**
+ * @function cf_memory_reset_peak
+ * @category allocator
+ * @brief    Resets `peak_bytes` for a tag to the current `live_bytes`.
+ * @param    tag          The subsystem to reset.
+ * @remarks  Useful for measuring the high-water mark of a particular level or scene.
+ * @related  CF_MemoryTag CF_MemoryStats cf_memory_stats cf_memory_reset_peak
+ */
+CF_API void CF_CALL cf_memory_reset_peak(CF_MemoryTag tag);
+
+/**
+ * @function cf_memory_push_tag
+ * @category allocator
+ * @brief    Attributes all allocations on the calling thread to `tag` until the matching `cf_memory_pop_tag`.
+ * @param    tag          The subsystem to attribute allocations to.
+ * @remarks  Tags nest and are tracked per-thread. Allocations made while a tag is active are routed to that tag's allocator,
+ *           if one was registered with `cf_allocator_override_tag`, and counted under that tag if memory tracking is enabled.
+ * @related  CF_MemoryTag cf_memory_push_tag cf_memory_pop_tag cf_memory_stats cf_allocator_override_tag
+ */
+CF_API void CF_CALL cf_memory_push_tag(CF_MemoryTag tag);
+
+/**
+ * @function cf_memory_pop_tag
+ * @category allocator
+ * @brief    Restores the tag that was active before the last call to `cf_memory_push_tag`.
+ * @related  CF_MemoryTag cf_memory_push_tag cf_memory_pop_tag cf_memory_stats
+ */
+CF_API void CF_CALL cf_memory_pop_tag();
+
+/**
+ * @function cf_allocator_override_tag
+ * @category allocator
+ * @brief    Routes all allocations for one subsystem to a custom allocator.
+ * @param    tag          The subsystem to route, see `CF_MemoryTag`.
+ * @param    allocator    The allocator to use. All four function pointers must be set. `udata` is handed back to each of them.
+ * @remarks  Useful for giving a subsystem its own arena or pool, or a budget it can't exceed. Budgets are up to your allocator:
+ *           return `NULL` when over budget. Allocations are routed by the tag active when they were made, and are always
+ *           free'd (or reallocated) by the allocator that made them, no matter which tag is active at the time. Tags without
+ *           an override use the allocator from `cf_allocator_override`.
+ *
+ *           Once any tag has been overridden every allocation carries a 16-byte header recording its tag, the same header
+ *           used by memory tracking. Unless memory tracking is enabled this must be called before the first allocation, typically
+ *           near the top of `main`. Calling it any later asserts and leaves the tag's allocator unchanged, since the pointers
+ *           handed out so far have no header. A tag's allocator may be changed or restored at any time, since each allocation
+ *           records the allocator that made it. Up to 63 distinct allocators can be registered over the life of the program.
+ * @related  CF_Allocator CF_MemoryTag cf_allocator_override cf_allocator_override_tag cf_allocator_restore_default_tag
+ */
+CF_API void CF_CALL cf_allocator_override_tag(CF_MemoryTag tag, CF_Allocator allocator);
+
+/**
+ * @function cf_allocator_restore_default_tag
+ * @category allocator
+ * @brief    Routes a subsystem's allocations back to the allocator from `cf_allocator_override`.
+ * @param    tag          The subsystem to restore.
+ * @remarks  Allocations the tag already made with its custom allocator are still free'd by that allocator.
+ * @related  CF_Allocator CF_MemoryTag cf_allocator_override cf_allocator_override_tag cf_allocator_restore_default_tag
+ */
+CF_API void CF_CALL cf_allocator_restore_default_tag(CF_MemoryTag tag);
+
+/**
+ * @function cf_memory_dump_leaks
+ * @category allocator
+ * @brief    Prints every tag with live allocations to stderr.
+ * @return   Returns the total number of live allocations across all tags.
+ * @remarks  This is called for you at the end of `cf_destroy_app`. Does nothing and returns zero if memory tracking is
+ *           disabled.
+ * @related  CF_MemoryTag CF_MemoryStats cf_memory_stats cf_memory_dump_leaks
+ */
+CF_API int CF_CALL cf_memory_dump_leaks();
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
@@ -284,10 +639,80 @@ CF_INLINE void arena_free(CF_Arena* arena, int size) { cf_arena_free(arena, size
 CF_INLINE void arena_reset(CF_Arena* arena) { cf_arena_reset(arena); }
 CF_INLINE void destroy_arena(CF_Arena* arena) { cf_destroy_arena(arena); }
 
+using ArenaMarker = CF_ArenaMarker;
+
+CF_INLINE ArenaMarker arena_save(const CF_Arena* arena) { return cf_arena_save(arena); }
+CF_INLINE void arena_restore(CF_Arena* arena, ArenaMarker marker) { cf_arena_restore(arena, marker); }
+
+/**
+ * Saves the position of an arena, and restores it when going out of scope. Everything allocated from the arena
+ * in between is free'd in O(1).
+ *
+ * Example:
+ *
+ *     void triangulate(CF_Arena* arena, ...)
+ *     {
+ *         ArenaScope scratch(arena);
+ *         int* indices = (int*)arena_alloc(arena, sizeof(int) * count);
+ *         ...
+ *     } // indices are free'd here.
+ */
+struct ArenaScope
+{
+	CF_INLINE ArenaScope(CF_Arena* arena) : m_arena(arena), m_marker(cf_arena_save(arena)) { }
+	CF_INLINE ~ArenaScope() { cf_arena_restore(m_arena, m_marker); }
+
+	CF_INLINE void* alloc(int size) { return cf_arena_alloc(m_arena, size); }
+
+private:
+	ArenaScope(const ArenaScope&) = delete;
+	ArenaScope& operator=(const ArenaScope&) = delete;
+
+	CF_Arena* m_arena;
+	ArenaMarker m_marker;
+};
+
+using VirtualArena = CF_VirtualArena;
+
+CF_INLINE VirtualArena make_virtual_arena(int alignment, size_t reserve_size, size_t retain_size) { return cf_make_virtual_arena(alignment, reserve_size, retain_size); }
+CF_INLINE void* virtual_arena_alloc(VirtualArena* arena, size_t size) { return cf_virtual_arena_alloc(arena, size); }
+CF_INLINE void virtual_arena_reset(VirtualArena* arena) { cf_virtual_arena_reset(arena); }
+CF_INLINE void destroy_virtual_arena(VirtualArena* arena) { cf_destroy_virtual_arena(arena); }
+
 CF_INLINE CF_MemoryPool* make_memory_pool(int element_size, int element_count, int alignment) { return cf_make_memory_pool(element_size, element_count, alignment); }
 CF_INLINE void destroy_memory_pool(CF_MemoryPool* pool) { cf_destroy_memory_pool(pool); }
 CF_INLINE void* memory_pool_alloc(CF_MemoryPool* pool) { return cf_memory_pool_alloc(pool); }
 CF_INLINE void memory_pool_free(CF_MemoryPool* pool, void* element) { return cf_memory_pool_free(pool, element); }
+CF_INLINE int memory_pool_trim(CF_MemoryPool* pool) { return cf_memory_pool_trim(pool); }
+
+CF_INLINE void* frame_alloc(size_t size) { return cf_frame_alloc(size); }
+CF_INLINE void frame_reset() { cf_frame_reset(); }
+
+using MemoryTag = CF_MemoryTag;
+#define CF_ENUM(K, V) CF_INLINE constexpr MemoryTag K = CF_##K;
+CF_MEMORY_TAG_DEFS
+#undef CF_ENUM
+
+CF_INLINE const char* to_string(MemoryTag tag)
+{
+	switch (tag) {
+	#define CF_ENUM(K, V) case CF_##K: return #K;
+	CF_MEMORY_TAG_DEFS
+	#undef CF_ENUM
+	default: return NULL;
+	}
+}
+
+using MemoryStats = CF_MemoryStats;
+
+CF_INLINE bool memory_tracking_enabled() { return cf_memory_tracking_enabled(); }
+CF_INLINE MemoryStats memory_stats(MemoryTag tag) { return cf_memory_stats(tag); }
+CF_INLINE void memory_reset_peak(MemoryTag tag) { cf_memory_reset_peak(tag); }
+CF_INLINE void memory_push_tag(MemoryTag tag) { cf_memory_push_tag(tag); }
+CF_INLINE void memory_pop_tag() { cf_memory_pop_tag(); }
+CF_INLINE int memory_dump_leaks() { return cf_memory_dump_leaks(); }
+CF_INLINE void allocator_override_tag(MemoryTag tag, CF_Allocator allocator) { cf_allocator_override_tag(tag, allocator); }
+CF_INLINE void allocator_restore_default_tag(MemoryTag tag) { cf_allocator_restore_default_tag(tag); }
 
 }
 
@@ -675,6 +675,329 @@ const T& Array<T>::last() const
 	return *(m_ptr + m_count - 1);
 }
 
+/**
+ * A growable array allocated from the per-frame allocator (see `cf_frame_alloc`).
+ *
+ * Has the same API as `Array`, but never frees its memory. Instead all of its storage is recycled in
+ * bulk by `cf_frame_reset` at the top of the next `cf_app_update`. Must not be kept across frames.
+ */
+template <typename T>
+struct FrameArray
+{
+	FrameArray() { }
+	FrameArray(CF_InitializerList<T> list) { ensure_capacity((int)list.size()); for (const T* i = list.begin(); i < list.end(); ++i) add(*i); }
+	FrameArray(int capacity) { ensure_capacity(capacity); }
+	FrameArray(const FrameArray<T>& other) { ensure_capacity(other.m_count); for (int i = 0; i < other.m_count; ++i) add(other.m_ptr[i]); }
+	~FrameArray() { clear(); }
+
+	T& add() { ensure_capacity(m_count + 1); return *CF_PLACEMENT_NEW(m_ptr + m_count++) T(); }
+	T& add(const T& item) { ensure_capacity(m_count + 1); return *CF_PLACEMENT_NEW(m_ptr + m_count++) T(item); }
+	T& add(T&& item) { ensure_capacity(m_count + 1); return *CF_PLACEMENT_NEW(m_ptr + m_count++) T(cf_move(item)); }
+	T pop() { CF_ASSERT(m_count > 0); T val = cf_move(m_ptr[m_count - 1]); m_ptr[--m_count].~T(); return val; }
+	void unordered_remove(int index) { m_ptr[index].~T(); if (index != --m_count) m_ptr[index] = cf_move(m_ptr[m_count]); }
+	void clear() { CF_ARRAY_CLEAR(); }
+	void ensure_capacity(int num_elements);
+	void set_count(int count) { ensure_capacity(count); for (int i = m_count; i < count; ++i) CF_PLACEMENT_NEW(m_ptr + i) T(); for (int i = count; i < m_count; ++i) m_ptr[i].~T(); m_count = count; }
+
+	int capacity() const { return m_capacity; }
+	int count() const { return m_count; }
+	int size() const { return m_count; }
+	bool empty() const { return m_count == 0; }
+
+	T* begin() { return m_ptr; }
+	const T* begin() const { return m_ptr; }
+	T* end() { return m_ptr + m_count; }
+	const T* end() const { return m_ptr + m_count; }
+
+	T& operator[](int index) { CF_ASSERT(index >= 0 && index < m_count); return m_ptr[index]; }
+	const T& operator[](int index) const { CF_ASSERT(index >= 0 && index < m_count); return m_ptr[index]; }
+
+	FrameArray<T>& operator=(const FrameArray<T>& rhs) { clear(); ensure_capacity(rhs.m_count); for (int i = 0; i < rhs.m_count; ++i) add(rhs.m_ptr[i]); return *this; }
+
+	T& last() { return *(m_ptr + m_count - 1); }
+	const T& last() const { return *(m_ptr + m_count - 1); }
+
+	T* data() { return m_ptr; }
+	const T* data() const { return m_ptr; }
+
+private:
+	int m_capacity = 0;
+	int m_count = 0;
+	T* m_ptr = NULL;
+};
+
+template <typename T>
+void FrameArray<T>::ensure_capacity(int num_elements)
+{
+	if (num_elements > m_capacity) {
+		int capacity = m_capacity ? m_capacity : 8;
+		while (capacity < num_elements) {
+			capacity *= 2;
+		}
+		// The old buffer is simply abandoned, it's recycled along with the rest of the frame memory.
+		T* new_ptr = (T*)cf_frame_alloc(sizeof(T) * capacity);
+		for (int i = 0; i < m_count; ++i) {
+			CF_PLACEMENT_NEW(new_ptr + i) T(cf_move(m_ptr[i]));
+			m_ptr[i].~T();
+		}
+		m_ptr = new_ptr;
+		m_capacity = capacity;
+	}
+}
+
+/**
+ * A growable array that stores up to `N` elements inline, only spilling over onto the heap beyond that.
+ *
+ * Has the same API as `Array`. Useful for small stacks or lists that almost always hold just a handful of
+ * elements, where allocating on the first `add` costs more than the work being done. Moving an InlineArray
+ * moves each inline element, so keep `N` small.
+ */
+template <typename T, int N>
+struct InlineArray
+{
+	static_assert(N > 0, "InlineArray needs room for at least one element.");
+
+	InlineArray() { }
+	InlineArray(CF_InitializerList<T> list) { ensure_capacity((int)list.size()); for (const T* i = list.begin(); i < list.end(); ++i) add(*i); }
+	InlineArray(const InlineArray<T, N>& other) { ensure_capacity(other.m_count); for (int i = 0; i < other.m_count; ++i) add(other.m_ptr[i]); }
+	InlineArray(InlineArray<T, N>&& other) { steal(other); }
+	InlineArray(int capacity) { ensure_capacity(capacity); }
+	~InlineArray() { clear(); if (!is_inline()) cf_free(m_ptr); }
+
+	T& add() { ensure_capacity(m_count + 1); return *CF_PLACEMENT_NEW(m_ptr + m_count++) T(); }
+	T& add(const T& item) { ensure_capacity(m_count + 1); return *CF_PLACEMENT_NEW(m_ptr + m_count++) T(item); }
+	T& add(T&& item) { ensure_capacity(m_count + 1); return *CF_PLACEMENT_NEW(m_ptr + m_count++) T(cf_move(item)); }
+	T pop() { CF_ASSERT(m_count > 0); T val = cf_move(m_ptr[m_count - 1]); m_ptr[--m_count].~T(); return val; }
+	void unordered_remove(int index) { m_ptr[index].~T(); if (index != --m_count) { CF_PLACEMENT_NEW(m_ptr + index) T(cf_move(m_ptr[m_count])); m_ptr[m_count].~T(); } }
+	void clear() { CF_ARRAY_CLEAR(); }
+	void ensure_capacity(int num_elements);
+	void ensure_count(int count) { ensure_capacity(count); for (int i = m_count; i < count; ++i) CF_PLACEMENT_NEW(m_ptr + i) T(); if (m_count < count) m_count = count; }
+	void set_count(int count) { ensure_capacity(count); for (int i = m_count; i < count; ++i) CF_PLACEMENT_NEW(m_ptr + i) T(); for (int i = count; i < m_count; ++i) m_ptr[i].~T(); m_count = count; }
+	void reverse() { for (T *a = m_ptr, *b = m_ptr + m_count - 1; a < b; ++a, --b) { T t = cf_move(*a); *a = cf_move(*b); *b = cf_move(t); } }
+
+	int capacity() const { return m_capacity; }
+	int count() const { return m_count; }
+	int size() const { return m_count; }
+	bool empty() const { return m_count == 0; }
+	bool is_inline() const { return m_ptr == (const T*)m_buffer; }
+
+	T* begin() { return m_ptr; }
+	const T* begin() const { return m_ptr; }
+	T* end() { return m_ptr + m_count; }
+	const T* end() const { return m_ptr + m_count; }
+
+	T& operator[](int index) { CF_ASSERT(index >= 0 && index < m_count); return m_ptr[index]; }
+	const T& operator[](int index) const { CF_ASSERT(index >= 0 && index < m_count); return m_ptr[index]; }
+
+	T* operator+(int index) { CF_ASSERT(index >= 0 && index < m_count); return m_ptr + index; }
+	const T* operator+(int index) const { CF_ASSERT(index >= 0 && index < m_count); return m_ptr + index; }
+
+	InlineArray<T, N>& operator=(const InlineArray<T, N>& rhs) { if (this != &rhs) { clear(); ensure_capacity(rhs.m_count); for (int i = 0; i < rhs.m_count; ++i) add(rhs.m_ptr[i]); } return *this; }
+	InlineArray<T, N>& operator=(InlineArray<T, N>&& rhs) { if (this != &rhs) { this->~InlineArray<T, N>(); m_ptr = (T*)m_buffer; m_capacity = N; m_count = 0; steal(rhs); } return *this; }
+
+	T& last() { return *(m_ptr + m_count - 1); }
+	const T& last() const { return *(m_ptr + m_count - 1); }
+
+	T* data() { return m_ptr; }
+	const T* data() const { return m_ptr; }
+
+private:
+	int m_capacity = N;
+	int m_count = 0;
+	T* m_ptr = (T*)m_buffer;
+	alignas(T) char m_buffer[sizeof(T) * N];
+
+	// Expects this array to be empty and inline. Heap storage is taken over as-is, inline elements are moved one-by-one.
+	void steal(InlineArray<T, N>& other)
+	{
+		if (other.is_inline()) {
+			for (int i = 0; i < other.m_count; ++i) {
+				CF_PLACEMENT_NEW(m_ptr + i) T(cf_move(other.m_ptr[i]));
+			}
+			m_count = other.m_count;
+			other.clear();
+		} else {
+			m_ptr = other.m_ptr;
+			m_capacity = other.m_capacity;
+			m_count = other.m_count;
+			other.m_ptr = (T*)other.m_buffer;
+			other.m_capacity = N;
+			other.m_count = 0;
+		}
+	}
+};
+
+template <typename T, int N>
+void InlineArray<T, N>::ensure_capacity(int num_elements)
+{
+	if (num_elements > m_capacity) {
+		int capacity = m_capacity * 2;
+		while (capacity < num_elements) {
+			capacity *= 2;
+		}
+		T* new_ptr = (T*)cf_alloc(sizeof(T) * capacity);
+		for (int i = 0; i < m_count; ++i) {
+			CF_PLACEMENT_NEW(new_ptr + i) T(cf_move(m_ptr[i]));
+			m_ptr[i].~T();
+		}
+		if (!is_inline()) cf_free(m_ptr);
+		m_ptr = new_ptr;
+		m_capacity = capacity;
+	}
+}
+
+/**
+ * A non-owning view of `count` contiguous elements, such as one column of a `SoA`.
+ */
+template <typename T>
+struct Span
+{
+	Span() { }
+	Span(T* ptr, int count) : m_ptr(ptr), m_count(count) { }
+
+	int count() const { return m_count; }
+	int size() const { return m_count; }
+	bool empty() const { return m_count == 0; }
+
+	T* begin() const { return m_ptr; }
+	T* end() const { return m_ptr + m_count; }
+
+	T& operator[](int index) const { CF_ASSERT(index >= 0 && index < m_count); return m_ptr[index]; }
+
+	T* data() const { return m_ptr; }
+
+private:
+	T* m_ptr = NULL;
+	int m_count = 0;
+};
+
+template <int I, typename T, typename... Ts>
+struct CF_SoATypeAt { using type = typename CF_SoATypeAt<I - 1, Ts...>::type; };
+
+template <typename T, typename... Ts>
+struct CF_SoATypeAt<0, T, Ts...> { using type = T; };
+
+/**
+ * A growable structure-of-arrays, storing each of `Ts` in its own tightly packed column.
+ *
+ * Rows are added all at once with `add` and removed with `remove`, which moves the last row into the hole
+ * (swap-and-pop), so row order is not stable. Columns grow just like `Array`. Loops over a single column with
+ * `column<I>()` only touch that column's memory, which is great for the cache and easy for compilers to vectorize.
+ *
+ *     SoA<v2, v2> bodies; // Positions and velocities.
+ *     bodies.add(V2(0, 0), V2(1, 0));
+ *     Span<v2> p = bodies.column<0>();
+ *     Span<v2> v = bodies.column<1>();
+ *     for (int i = 0; i < bodies.count(); ++i) p[i] += v[i] * dt;
+ */
+template <typename... Ts>
+struct SoA
+{
+	static_assert(sizeof...(Ts) > 0, "SoA needs at least one column.");
+
+	template <int I>
+	using Type = typename CF_SoATypeAt<I, Ts...>::type;
+
+	SoA() { }
+	SoA(int capacity) { ensure_capacity(capacity); }
+	SoA(const SoA<Ts...>& other) { *this = other; }
+	SoA(SoA<Ts...>&& other) { steal(other); }
+	~SoA() { clear(); for (int i = 0; i < (int)sizeof...(Ts); ++i) cf_free(m_columns[i]); }
+
+	int add() { ensure_capacity(m_count + 1); int i = 0; (CF_PLACEMENT_NEW((Ts*)m_columns[i++] + m_count) Ts(), ...); return m_count++; }
+	int add(const Ts&... items) { ensure_capacity(m_count + 1); int i = 0; (CF_PLACEMENT_NEW((Ts*)m_columns[i++] + m_count) Ts(items), ...); return m_count++; }
+	void remove(int index) { CF_ASSERT(index >= 0 && index < m_count); --m_count; int i = 0; (s_remove<Ts>(m_columns[i++], index, m_count), ...); }
+	void clear() { int i = 0; (s_destroy<Ts>(m_columns[i++], m_count), ...); m_count = 0; }
+	void ensure_capacity(int num_elements);
+
+	int capacity() const { return m_capacity; }
+	int count() const { return m_count; }
+	int size() const { return m_count; }
+	bool empty() const { return m_count == 0; }
+
+	template <int I> Type<I>* data() { return (Type<I>*)m_columns[I]; }
+	template <int I> const Type<I>* data() const { return (const Type<I>*)m_columns[I]; }
+	template <int I> Span<Type<I>> column() { return Span<Type<I>>(data<I>(), m_count); }
+	template <int I> Span<const Type<I>> column() const { return Span<const Type<I>>(data<I>(), m_count); }
+	template <int I> Type<I>& get(int index) { CF_ASSERT(index >= 0 && index < m_count); return data<I>()[index]; }
+	template <int I> const Type<I>& get(int index) const { CF_ASSERT(index >= 0 && index < m_count); return data<I>()[index]; }
+
+	SoA<Ts...>& operator=(const SoA<Ts...>& rhs);
+	SoA<Ts...>& operator=(SoA<Ts...>&& rhs) { if (this != &rhs) { this->~SoA<Ts...>(); steal(rhs); } return *this; }
+
+private:
+	int m_capacity = 0;
+	int m_count = 0;
+	void* m_columns[sizeof...(Ts)] = { };
+
+	void steal(SoA<Ts...>& other) { m_capacity = other.m_capacity; m_count = other.m_count; for (int i = 0; i < (int)sizeof...(Ts); ++i) m_columns[i] = other.m_columns[i]; CF_MEMSET(&other, 0, sizeof(other)); }
+
+	template <typename T>
+	static void s_regrow(void** column, int count, int capacity)
+	{
+		T* old_ptr = (T*)*column;
+		T* new_ptr = (T*)cf_alloc(sizeof(T) * capacity);
+		for (int i = 0; i < count; ++i) {
+			CF_PLACEMENT_NEW(new_ptr + i) T(cf_move(old_ptr[i]));
+			old_ptr[i].~T();
+		}
+		cf_free(old_ptr);
+		*column = new_ptr;
+	}
+
+	template <typename T>
+	static void s_remove(void* column, int index, int last)
+	{
+		T* ptr = (T*)column;
+		if (index != last) {
+			ptr[index].~T();
+			CF_PLACEMENT_NEW(ptr + index) T(cf_move(ptr[last]));
+		}
+		ptr[last].~T();
+	}
+
+	template <typename T>
+	static void s_destroy(void* column, int count)
+	{
+		T* ptr = (T*)column;
+		for (int i = 0; i < count; ++i) ptr[i].~T();
+	}
+
+	template <typename T>
+	static void s_copy(void* column, const void* other, int count)
+	{
+		T* ptr = (T*)column;
+		const T* other_ptr = (const T*)other;
+		for (int i = 0; i < count; ++i) CF_PLACEMENT_NEW(ptr + i) T(other_ptr[i]);
+	}
+};
+
+template <typename... Ts>
+void SoA<Ts...>::ensure_capacity(int num_elements)
+{
+	if (num_elements > m_capacity) {
+		int capacity = m_capacity ? m_capacity : 8;
+		while (capacity < num_elements) {
+			capacity *= 2;
+		}
+		int i = 0;
+		(s_regrow<Ts>(m_columns + i++, m_count, capacity), ...);
+		m_capacity = capacity;
+	}
+}
+
+template <typename... Ts>
+SoA<Ts...>& SoA<Ts...>::operator=(const SoA<Ts...>& rhs)
+{
+	if (this == &rhs) return *this;
+	clear();
+	ensure_capacity(rhs.m_count);
+	int i = 0;
+	((s_copy<Ts>(m_columns[i], rhs.m_columns[i], rhs.m_count), ++i), ...);
+	m_count = rhs.m_count;
+	return *this;
+}
+
 }
 
 #endif // CF_CPP
@@ -0,0 +1,161 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#ifndef CF_CONCURRENT_MAP_H
+#define CF_CONCURRENT_MAP_H
+
+#include "cute_defines.h"
+
+//--------------------------------------------------------------------------------------------------
+// C API
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @struct   CF_ConcurrentMap
+ * @category hash
+ * @brief    An opaque {key, item} map which can be safely read and written from many threads at once.
+ * @remarks  Keys are `uint64_t`, just like `htbl`. Items are plain old data of a fixed size, copied in and out of the map by value.
+ *           Internally the map is split into a number of shards, each a separate hashtable with its own read/write lock. Threads
+ *           touching different shards never wait on each other, and any number of threads can read the same shard at once.
+ * @related  CF_ConcurrentMap cf_make_concurrent_map cf_destroy_concurrent_map cf_concurrent_map_set cf_concurrent_map_get
+ */
+typedef struct CF_ConcurrentMap CF_ConcurrentMap;
+// @end
+
+/**
+ * @function cf_make_concurrent_map
+ * @category hash
+ * @brief    Returns a new concurrent map.
+ * @param    item_size    The size of each item in bytes.
+ * @param    shard_count  The number of shards to split the map into, rounded up to a power of two. Pass zero for a default based on
+ *                        the number of cores.
+ * @remarks  More shards means less contention between threads, at the cost of some memory. Free it with `cf_destroy_concurrent_map`.
+ * @related  CF_ConcurrentMap cf_make_concurrent_map cf_destroy_concurrent_map
+ */
+CF_API CF_ConcurrentMap* CF_CALL cf_make_concurrent_map(int item_size, int shard_count);
+
+/**
+ * @function cf_destroy_concurrent_map
+ * @category hash
+ * @brief    Frees a map created by `cf_make_concurrent_map`.
+ * @param    map          The map.
+ * @remarks  No other threads may be using the map.
+ * @related  CF_ConcurrentMap cf_make_concurrent_map cf_destroy_concurrent_map
+ */
+CF_API void CF_CALL cf_destroy_concurrent_map(CF_ConcurrentMap* map);
+
+/**
+ * @function cf_concurrent_map_set
+ * @category hash
+ * @brief    Sets the item for `key`, adding it if it doesn't exist yet.
+ * @param    map          The map.
+ * @param    key          The key.
+ * @param    item         Pointer to the item to copy into the map.
+ * @related  CF_ConcurrentMap cf_concurrent_map_set cf_concurrent_map_add cf_concurrent_map_get cf_concurrent_map_remove
+ */
+CF_API void CF_CALL cf_concurrent_map_set(CF_ConcurrentMap* map, uint64_t key, const void* item);
+
+/**
+ * @function cf_concurrent_map_add
+ * @category hash
+ * @brief    Adds an item for `key` only if it doesn't exist yet.
+ * @param    map          The map.
+ * @param    key          The key.
+ * @param    item         Pointer to the item to copy into the map. If `key` already exists the existing item is copied into `item` instead.
+ * @return   Returns true if the item was added, or false if `key` already existed.
+ * @remarks  The check and insert happen atomically, so when many threads race to add the same key exactly one of them wins, and
+ *           the others all receive the winner's item. This is the usual way to implement a shared cache.
+ * @related  CF_ConcurrentMap cf_concurrent_map_set cf_concurrent_map_add cf_concurrent_map_get cf_concurrent_map_remove
+ */
+CF_API bool CF_CALL cf_concurrent_map_add(CF_ConcurrentMap* map, uint64_t key, void* item);
+
+/**
+ * @function cf_concurrent_map_get
+ * @category hash
+ * @brief    Fetches a copy of the item for `key`.
+ * @param    map          The map.
+ * @param    key          The key.
+ * @param    out_item     Written with a copy of the item if found. Can be `NULL` to only check if `key` exists.
+ * @return   Returns true if `key` was found.
+ * @remarks  Items are copied out, rather than returning a pointer, since other threads may move or remove the item at any time.
+ * @related  CF_ConcurrentMap cf_concurrent_map_set cf_concurrent_map_add cf_concurrent_map_get cf_concurrent_map_remove
+ */
+CF_API bool CF_CALL cf_concurrent_map_get(CF_ConcurrentMap* map, uint64_t key, void* out_item);
+
+/**
+ * @function cf_concurrent_map_remove
+ * @category hash
+ * @brief    Removes the item for `key`.
+ * @param    map          The map.
+ * @param    key          The key.
+ * @return   Returns true if `key` was found and removed.
+ * @related  CF_ConcurrentMap cf_concurrent_map_set cf_concurrent_map_add cf_concurrent_map_get cf_concurrent_map_remove
+ */
+CF_API bool CF_CALL cf_concurrent_map_remove(CF_ConcurrentMap* map, uint64_t key);
+
+/**
+ * @function cf_concurrent_map_count
+ * @category hash
+ * @brief    Returns the number of items in the map.
+ * @param    map          The map.
+ * @remarks  Each shard is counted one after another, so if other threads are modifying the map the result is only approximate.
+ * @related  CF_ConcurrentMap cf_concurrent_map_count cf_concurrent_map_clear
+ */
+CF_API int CF_CALL cf_concurrent_map_count(CF_ConcurrentMap* map);
+
+/**
+ * @function cf_concurrent_map_clear
+ * @category hash
+ * @brief    Removes all items from the map.
+ * @param    map          The map.
+ * @related  CF_ConcurrentMap cf_concurrent_map_count cf_concurrent_map_clear
+ */
+CF_API void CF_CALL cf_concurrent_map_clear(CF_ConcurrentMap* map);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+//--------------------------------------------------------------------------------------------------
+// C++ API
+
+#ifdef CF_CPP
+
+namespace Cute
+{
+
+// A {key, item} map safe to use from many threads at once, see `CF_ConcurrentMap`.
+// Items are copied in and out by value, and must be plain old data.
+template <typename T>
+struct ConcurrentMap
+{
+	ConcurrentMap(int shard_count = 0) { m_map = cf_make_concurrent_map(sizeof(T), shard_count); }
+	ConcurrentMap(const ConcurrentMap<T>& other) = delete;
+	~ConcurrentMap() { cf_destroy_concurrent_map(m_map); }
+
+	void set(uint64_t key, const T& item) { cf_concurrent_map_set(m_map, key, &item); }
+	bool add(uint64_t key, T* item) { return cf_concurrent_map_add(m_map, key, item); }
+	bool get(uint64_t key, T* out) const { return cf_concurrent_map_get(m_map, key, out); }
+	bool has(uint64_t key) const { return cf_concurrent_map_get(m_map, key, NULL); }
+	bool remove(uint64_t key) { return cf_concurrent_map_remove(m_map, key); }
+	int count() const { return cf_concurrent_map_count(m_map); }
+	void clear() { cf_concurrent_map_clear(m_map); }
+
+	ConcurrentMap<T>& operator=(const ConcurrentMap<T>& rhs) = delete;
+
+private:
+	CF_ConcurrentMap* m_map;
+};
+
+}
+
+#endif // CF_CPP
+
+#endif // CF_CONCURRENT_MAP_H
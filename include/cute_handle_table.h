@@ -0,0 +1,325 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#ifndef CF_HANDLE_TABLE_H
+#define CF_HANDLE_TABLE_H
+
+#include "cute_defines.h"
+
+//--------------------------------------------------------------------------------------------------
+// C API
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @typedef  CF_Handle
+ * @category handle
+ * @brief    An opaque 64-bit id for an object, made by `cf_handle_allocator_alloc`.
+ * @remarks  Handles are generational: once a handle is free'd its slot can be recycled, but the old handle is never confused
+ *           with the new one. Use `cf_handle_allocator_is_handle_valid` to check if a handle is still alive. The value zero
+ *           is never a valid handle, see `CF_INVALID_HANDLE`.
+ * @related  CF_Handle CF_INVALID_HANDLE CF_HandleTable cf_make_handle_allocator cf_handle_allocator_alloc cf_handle_allocator_get_index
+ */
+typedef uint64_t CF_Handle;
+// @end
+
+/**
+ * @function CF_INVALID_HANDLE
+ * @category handle
+ * @brief    A handle value that is never returned by `cf_handle_allocator_alloc`.
+ * @remarks  Useful as a "null" handle for uninitialized members.
+ * @related  CF_Handle CF_INVALID_HANDLE cf_handle_allocator_alloc cf_handle_allocator_is_handle_valid
+ */
+#define CF_INVALID_HANDLE (0)
+
+/**
+ * @struct   CF_HandleTable
+ * @category handle
+ * @brief    An opaque table mapping `CF_Handle`'s to indices, with O(1) alloc, free and lookup.
+ * @remarks  The usual pattern is to keep your objects packed tightly in an array, and store the array index for each object in
+ *           the table. When an object moves within the array (for example removing with swap-and-pop), call
+ *           `cf_handle_allocator_update_index`. Outside code only ever holds on to handles, which stay valid no matter how
+ *           often the objects move. In C++ see `SlotMap`, which does all of this for you.
+ * @related  CF_Handle CF_HandleTable cf_make_handle_allocator cf_destroy_handle_allocator cf_handle_allocator_alloc cf_handle_allocator_free
+ */
+typedef struct CF_HandleTable CF_HandleTable;
+// @end
+
+/**
+ * @function cf_make_handle_allocator
+ * @category handle
+ * @brief    Returns a new handle table.
+ * @param    initial_capacity  The number of handles to make room for up-front. The table grows as needed.
+ * @remarks  Free it with `cf_destroy_handle_allocator` when done.
+ * @related  CF_Handle CF_HandleTable cf_make_handle_allocator cf_destroy_handle_allocator cf_handle_allocator_alloc
+ */
+CF_API CF_HandleTable* CF_CALL cf_make_handle_allocator(int initial_capacity);
+
+/**
+ * @function cf_destroy_handle_allocator
+ * @category handle
+ * @brief    Frees a handle table created by `cf_make_handle_allocator`.
+ * @param    table        The table.
+ * @related  CF_Handle CF_HandleTable cf_make_handle_allocator cf_destroy_handle_allocator
+ */
+CF_API void CF_CALL cf_destroy_handle_allocator(CF_HandleTable* table);
+
+/**
+ * @function cf_handle_allocator_alloc
+ * @category handle
+ * @brief    Returns a new handle mapped to `index`.
+ * @param    table        The table.
+ * @param    index        An index of your choosing, typically where the object lives in an array.
+ * @param    type         An optional type tag of your choosing, up to 15 bits. Fetch it later with `cf_handle_allocator_get_type`.
+ * @remarks  Free'd slots are recycled first-in-first-out, which spreads generations out across the table and delays wrapping.
+ *           The table grows if it's full.
+ * @related  CF_Handle CF_HandleTable cf_handle_allocator_alloc cf_handle_allocator_free cf_handle_allocator_get_index
+ */
+CF_API CF_Handle CF_CALL cf_handle_allocator_alloc(CF_HandleTable* table, uint32_t index, uint16_t type);
+
+/**
+ * @function cf_handle_allocator_get_index
+ * @category handle
+ * @brief    Returns the index mapped to a handle.
+ * @param    table        The table.
+ * @param    handle       A valid handle, see `cf_handle_allocator_is_handle_valid`.
+ * @related  CF_Handle CF_HandleTable cf_handle_allocator_get_index cf_handle_allocator_update_index cf_handle_allocator_is_handle_valid
+ */
+CF_API uint32_t CF_CALL cf_handle_allocator_get_index(const CF_HandleTable* table, CF_Handle handle);
+
+/**
+ * @function cf_handle_allocator_get_type
+ * @category handle
+ * @brief    Returns the type passed to `cf_handle_allocator_alloc` for a handle.
+ * @param    table        The table.
+ * @param    handle       A valid handle, see `cf_handle_allocator_is_handle_valid`.
+ * @related  CF_Handle CF_HandleTable cf_handle_allocator_alloc cf_handle_allocator_get_type
+ */
+CF_API uint16_t CF_CALL cf_handle_allocator_get_type(const CF_HandleTable* table, CF_Handle handle);
+
+/**
+ * @function cf_handle_allocator_is_handle_valid
+ * @category handle
+ * @brief    Returns true if `handle` was allocated from this table and has not yet been free'd.
+ * @param    table        The table.
+ * @param    handle       Any handle, including stale ones or `CF_INVALID_HANDLE`.
+ * @related  CF_Handle CF_HandleTable cf_handle_allocator_alloc cf_handle_allocator_free cf_handle_allocator_is_handle_valid
+ */
+CF_API bool CF_CALL cf_handle_allocator_is_handle_valid(const CF_HandleTable* table, CF_Handle handle);
+
+/**
+ * @function cf_handle_allocator_update_index
+ * @category handle
+ * @brief    Changes the index mapped to a handle.
+ * @param    table        The table.
+ * @param    handle       A valid handle, see `cf_handle_allocator_is_handle_valid`.
+ * @param    index        The new index.
+ * @remarks  Call this whenever the object a handle refers to moves around in memory.
+ * @related  CF_Handle CF_HandleTable cf_handle_allocator_get_index cf_handle_allocator_update_index
+ */
+CF_API void CF_CALL cf_handle_allocator_update_index(CF_HandleTable* table, CF_Handle handle, uint32_t index);
+
+/**
+ * @function cf_handle_allocator_free
+ * @category handle
+ * @brief    Frees a handle, invalidating it.
+ * @param    table        The table.
+ * @param    handle       A valid handle, see `cf_handle_allocator_is_handle_valid`.
+ * @related  CF_Handle CF_HandleTable cf_handle_allocator_alloc cf_handle_allocator_free cf_handle_allocator_is_handle_valid
+ */
+CF_API void CF_CALL cf_handle_allocator_free(CF_HandleTable* table, CF_Handle handle);
+
+/**
+ * @function cf_handle_allocator_clear
+ * @category handle
+ * @brief    Frees all handles at once, invalidating them.
+ * @param    table        The table.
+ * @related  CF_Handle CF_HandleTable cf_handle_allocator_alloc cf_handle_allocator_free cf_handle_allocator_clear
+ */
+CF_API void CF_CALL cf_handle_allocator_clear(CF_HandleTable* table);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+//--------------------------------------------------------------------------------------------------
+// C++ API
+
+#ifdef CF_CPP
+
+#include "cute_array.h"
+
+namespace Cute
+{
+
+using Handle = CF_Handle;
+using HandleTable = CF_HandleTable;
+
+CF_INLINE HandleTable* make_handle_allocator(int initial_capacity) { return cf_make_handle_allocator(initial_capacity); }
+CF_INLINE void destroy_handle_allocator(HandleTable* table) { cf_destroy_handle_allocator(table); }
+CF_INLINE Handle handle_allocator_alloc(HandleTable* table, uint32_t index, uint16_t type = 0) { return cf_handle_allocator_alloc(table, index, type); }
+CF_INLINE uint32_t handle_allocator_get_index(const HandleTable* table, Handle handle) { return cf_handle_allocator_get_index(table, handle); }
+CF_INLINE uint16_t handle_allocator_get_type(const HandleTable* table, Handle handle) { return cf_handle_allocator_get_type(table, handle); }
+CF_INLINE bool handle_allocator_is_handle_valid(const HandleTable* table, Handle handle) { return cf_handle_allocator_is_handle_valid(table, handle); }
+CF_INLINE void handle_allocator_update_index(HandleTable* table, Handle handle, uint32_t index) { cf_handle_allocator_update_index(table, handle, index); }
+CF_INLINE void handle_allocator_free(HandleTable* table, Handle handle) { cf_handle_allocator_free(table, handle); }
+CF_INLINE void handle_allocator_clear(HandleTable* table) { cf_handle_allocator_clear(table); }
+
+// Stores items tightly packed in an array, handing out generational handles to refer to them.
+// Add, remove and lookup are all O(1), and items can be iterated over densely like an array.
+// Removing an item moves the last item into its place, so the order of items is not stable.
+// Items may not store references/pointers to themselves or other items, store handles instead.
+template <typename T>
+struct SlotMap
+{
+	SlotMap() : SlotMap(32) { }
+	SlotMap(int capacity);
+	SlotMap(SlotMap<T>&& other);
+	SlotMap(const SlotMap<T>& other) = delete;
+	~SlotMap();
+
+	Handle add(const T& item, uint16_t type = 0);
+	Handle add(T&& item, uint16_t type = 0);
+	void remove(Handle handle);
+	void clear();
+
+	T* get(Handle handle);
+	const T* get(Handle handle) const;
+	bool has(Handle handle) const { return m_table && cf_handle_allocator_is_handle_valid(m_table, handle); }
+	uint16_t type(Handle handle) const { CF_ASSERT(m_table); return m_table ? cf_handle_allocator_get_type(m_table, handle) : 0; }
+
+	int count() const { return m_items.count(); }
+	T* items() { return m_items.data(); }
+	const T* items() const { return m_items.data(); }
+	const Handle* handles() const { return m_handles.data(); }
+
+	T* begin() { return m_items.begin(); }
+	const T* begin() const { return m_items.begin(); }
+	T* end() { return m_items.end(); }
+	const T* end() const { return m_items.end(); }
+
+	T& operator[](int index) { return m_items[index]; }
+	const T& operator[](int index) const { return m_items[index]; }
+
+	SlotMap<T>& operator=(SlotMap<T>&& rhs);
+	SlotMap<T>& operator=(const SlotMap<T>& rhs) = delete;
+
+private:
+	// NULL after being moved from, and lazily recreated by `add`.
+	HandleTable* m_table = NULL;
+	Array<T> m_items;
+	Array<Handle> m_handles;
+
+	HandleTable* lazy_table();
+};
+
+// -------------------------------------------------------------------------------------------------
+
+template <typename T>
+SlotMap<T>::SlotMap(int capacity)
+	: m_items(capacity)
+	, m_handles(capacity)
+{
+	m_table = cf_make_handle_allocator(capacity);
+}
+
+template <typename T>
+SlotMap<T>::SlotMap(SlotMap<T>&& other)
+	: m_items(cf_move(other.m_items))
+	, m_handles(cf_move(other.m_handles))
+{
+	m_table = other.m_table;
+	other.m_table = NULL;
+}
+
+template <typename T>
+SlotMap<T>::~SlotMap()
+{
+	if (m_table) cf_destroy_handle_allocator(m_table);
+	m_table = NULL;
+}
+
+template <typename T>
+HandleTable* SlotMap<T>::lazy_table()
+{
+	if (!m_table) m_table = cf_make_handle_allocator(32);
+	return m_table;
+}
+
+template <typename T>
+Handle SlotMap<T>::add(const T& item, uint16_t type)
+{
+	Handle handle = cf_handle_allocator_alloc(lazy_table(), (uint32_t)m_items.count(), type);
+	m_items.add(item);
+	m_handles.add(handle);
+	return handle;
+}
+
+template <typename T>
+Handle SlotMap<T>::add(T&& item, uint16_t type)
+{
+	Handle handle = cf_handle_allocator_alloc(lazy_table(), (uint32_t)m_items.count(), type);
+	m_items.add(cf_move(item));
+	m_handles.add(handle);
+	return handle;
+}
+
+template <typename T>
+void SlotMap<T>::remove(Handle handle)
+{
+	if (!has(handle)) return;
+	int index = (int)cf_handle_allocator_get_index(m_table, handle);
+	int last = m_items.count() - 1;
+	if (index != last) {
+		cf_handle_allocator_update_index(m_table, m_handles[last], (uint32_t)index);
+	}
+	m_items.unordered_remove(index);
+	m_handles.unordered_remove(index);
+	cf_handle_allocator_free(m_table, handle);
+}
+
+template <typename T>
+void SlotMap<T>::clear()
+{
+	m_items.clear();
+	m_handles.clear();
+	if (m_table) cf_handle_allocator_clear(m_table);
+}
+
+template <typename T>
+T* SlotMap<T>::get(Handle handle)
+{
+	if (!has(handle)) return NULL;
+	return m_items.data() + cf_handle_allocator_get_index(m_table, handle);
+}
+
+template <typename T>
+const T* SlotMap<T>::get(Handle handle) const
+{
+	if (!has(handle)) return NULL;
+	return m_items.data() + cf_handle_allocator_get_index(m_table, handle);
+}
+
+template <typename T>
+SlotMap<T>& SlotMap<T>::operator=(SlotMap<T>&& rhs)
+{
+	if (this == &rhs) return *this;
+	if (m_table) cf_destroy_handle_allocator(m_table);
+	m_items = cf_move(rhs.m_items);
+	m_handles = cf_move(rhs.m_handles);
+	m_table = rhs.m_table;
+	rhs.m_table = NULL;
+	return *this;
+}
+
+}
+
+#endif // CF_CPP
+
+#endif // CF_HANDLE_TABLE_H
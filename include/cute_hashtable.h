@@ -44,7 +44,7 @@
  *           on typed pointers, there's no actual hashtable struct type. It can get really annoying to sometimes forget if a pointer is an
  *           array, a hashtable, or just a pointer. This macro can be used to markup the type to make it much more clear for function
  *           parameters or struct member definitions. It's saying "Hey, I'm a hashtable!" to mitigate this downside.
- * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hhas hdel hclear hkeys hitems hswap hsize hcount hfree
+ * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hget_many hset_many hhas hdel hclear hkeys hitems hswap hsize hcount hfree
  */
 #define htbl
 
@@ -66,7 +66,7 @@
  * @remarks  If the item does not exist in the table it is added. The pointer returned is not stable. Internally the table can be resized,
  *           invalidating _all_ pointers to any elements within the table. Therefor, no items may store pointers to themselves or other items.
  *           Indices however, are totally fine.
- * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hhas hdel hclear hkeys hitems hswap hsize hcount hfree
+ * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hget_many hset_many hhas hdel hclear hkeys hitems hswap hsize hcount hfree
  */
 #define hset(h, k, ...) cf_hashtable_set(h, k, (__VA_ARGS__))
 
@@ -88,7 +88,7 @@
  * @remarks  This function works the same as `hset`. If the item already exists in the table, it's simply updated to a new value.
  *           The pointer returned is not stable. Internally the table can be resized, invalidating _all_ pointers to any elements
  *           within the table. Therefor, no items may store pointers to themselves or other items. Indices however, are totally fine.
- * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hhas hdel hclear hkeys hitems hswap hsize hcount hfree
+ * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hget_many hset_many hhas hdel hclear hkeys hitems hswap hsize hcount hfree
  */
 #define hadd(h, k, ...) cf_hashtable_add(h, k, (__VA_ARGS__))
 
@@ -109,7 +109,7 @@
  * @remarks  Items are returned by value, not pointer. If the item doesn't exist a zero'd out item is instead returned. If you want to get a pointer
  *           (so you can see if it's `NULL` in case the item didn't exist, then use `hget_ptr`). You can also call `hhas` for a bool. This function does
  *           the same as `hfind`.
- * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hhas hdel hclear hkeys hitems hswap hsize hcount hfree
+ * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hget_many hset_many hhas hdel hclear hkeys hitems hswap hsize hcount hfree
  */
 #define hget(h, k) cf_hashtable_get(h, k)
 
@@ -130,7 +130,7 @@
  * @remarks  Items are returned by value, not pointer. If the item doesn't exist a zero'd out item is instead returned. If you want to get a pointer
  *           (so you can see if it's `NULL` in case the item didn't exist, then use `hfind_ptr`). You can also call `hhas` for a bool. This function does
  *           the same as `hget`.
- * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hhas hdel hclear hkeys hitems hswap hsize hcount hfree
+ * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hget_many hset_many hhas hdel hclear hkeys hitems hswap hsize hcount hfree
  */
 #define hfind(h, k) cf_hashtable_find(h, k)
 
@@ -150,7 +150,7 @@
  *     hfree(table);
  * @return   Returns a pointer to an item. Returns `NULL` if not found.
  * @remarks  If you want to fetch an item by value, you can use `hget` or `hfind`. Does the same thing as `hfind_ptr`.
- * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hhas hdel hclear hkeys hitems hswap hsize hcount hfree
+ * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hget_many hset_many hhas hdel hclear hkeys hitems hswap hsize hcount hfree
  */
 #define hget_ptr(h, k) cf_hashtable_get_ptr(h, k)
 
@@ -170,10 +170,57 @@
  *     hfree(table);
  * @return   Returns a pointer to an item. Returns `NULL` if not found.
  * @remarks  If you want to fetch an item by value, you can use `hget` or `hfind`. Does the same thing as `hget_ptr`.
- * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hhas hdel hclear hkeys hitems hswap hsize hcount hfree
+ * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hget_many hset_many hhas hdel hclear hkeys hitems hswap hsize hcount hfree
  */
 #define hfind_ptr(h, k) cf_hashtable_find_ptr(h, k)
 
+/**
+ * @function hget_many
+ * @category hash
+ * @brief    Fetches the items for a whole array of keys at once.
+ * @param    h        The hashtable. Can be `NULL`. Needs to be a pointer to the type of items in the table.
+ * @param    keys     Pointer to an array of `uint64_t` keys to lookup.
+ * @param    count    The number of keys in `keys`.
+ * @param    out      Pointer to an array of at least `count` items to write results into.
+ * @example > Fetch a batch of items from a hashtable.
+ *     htbl int* table = NULL;
+ *     hset(table, 1, 10);
+ *     hset(table, 2, 20);
+ *     uint64_t keys[3] = { 1, 2, 3 };
+ *     int items[3];
+ *     hget_many(table, keys, 3, items);
+ *     CF_ASSERT(items[0] == 10);
+ *     CF_ASSERT(items[1] == 20);
+ *     CF_ASSERT(items[2] == 0);
+ *     hfree(table);
+ * @remarks  Works like calling `hget` once per key, writing each item by value into `out`. Items that don't exist are zero'd out.
+ *           Keys are hashed a few at a time and their slots prefetched before any are looked up, so the cache misses of a large
+ *           table overlap instead of being paid one after another. Prefer this over a loop of `hget` for big batches of keys.
+ * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hget_many hset_many hhas hdel hclear hkeys hitems hswap hsize hcount hfree
+ */
+#define hget_many(h, keys, count, out) cf_hashtable_get_many(h, keys, count, out)
+
+/**
+ * @function hset_many
+ * @category hash
+ * @brief    Add's a whole array of {key, item} pairs at once.
+ * @param    h        The hashtable. Can be `NULL`. Needs to be a pointer to the type of items in the table.
+ * @param    keys     Pointer to an array of `uint64_t` keys.
+ * @param    items    Pointer to an array of `count` items, one for each key.
+ * @param    count    The number of {key, item} pairs.
+ * @example > Set a batch of items into a hashtable.
+ *     htbl int* table = NULL;
+ *     uint64_t keys[3] = { 1, 2, 3 };
+ *     int items[3] = { 10, 20, 30 };
+ *     hset_many(table, keys, items, 3);
+ *     CF_ASSERT(hget(table, 3) == 30);
+ *     hfree(table);
+ * @remarks  Works like calling `hset` once per pair, in order, so a key repeated within the batch keeps the last item. Keys are hashed
+ *           and their slots prefetched a few at a time ahead of insertion, see `hget_many`.
+ * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hget_many hset_many hhas hdel hclear hkeys hitems hswap hsize hcount hfree
+ */
+#define hset_many(h, keys, items, count) cf_hashtable_set_many(h, keys, items, count)
+
 /**
  * @function hhas
  * @category hash
@@ -186,7 +233,7 @@
  *     CF_ASSERT(hhas(table, 10));
  *     hfree(table);
  * @return   Returns true if the item was found, false otherwise.
- * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hhas hdel hclear hkeys hitems hswap hsize hcount hfree
+ * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hget_many hset_many hhas hdel hclear hkeys hitems hswap hsize hcount hfree
  */
 #define hhas(h, k) cf_hashtable_has(h, k)
 
@@ -202,7 +249,7 @@
  *     hdel(table, 10);
  *     hfree(table);
  * @remarks  Asserts if the item does not exist.
- * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hhas hdel hclear hkeys hitems hswap hsize hcount hfree
+ * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hget_many hset_many hhas hdel hclear hkeys hitems hswap hsize hcount hfree
  */
 #define hdel(h, k) cf_hashtable_del(h, k)
 
@@ -212,7 +259,7 @@
  * @brief    Clears the hashtable.
  * @param    h        The hashtable. Can be `NULL`. Needs to be a pointer to the type of items in the table.
  * @remarks  The count of items will now be zero. Does not free any memory. Call `hfree` when you are done.
- * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hhas hdel hclear hkeys hitems hswap hsize hcount hfree
+ * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hget_many hset_many hhas hdel hclear hkeys hitems hswap hsize hcount hfree
  */
 #define hclear(h) cf_hashtable_clear(h)
 
@@ -230,7 +277,7 @@
  *         // ...
  *     }
  * @remarks  The keys are type `uint64_t`.
- * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hhas hdel hclear hkeys hitems hswap hsize hcount hfree
+ * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hget_many hset_many hhas hdel hclear hkeys hitems hswap hsize hcount hfree
  */
 #define hkeys(h) cf_hashtable_keys(h)
 
@@ -248,7 +295,7 @@
  *         // ...
  *     }
  * @remarks  This macro doesn't do much as `h` is already a valid pointer to the items.
- * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hhas hdel hclear hkeys hitems hswap hsize hcount hfree
+ * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hget_many hset_many hhas hdel hclear hkeys hitems hswap hsize hcount hfree
  */
 #define hitems(h) cf_hashtable_items(h)
 
@@ -270,7 +317,7 @@
  *         }
  *     }
  * @remarks  Use this for e.g. implementing a priority queue on top of the hash table.
- * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hhas hdel hclear hkeys hitems hswap hsize hcount hfree hsort hssort hsisort
+ * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hget_many hset_many hhas hdel hclear hkeys hitems hswap hsize hcount hfree hsort hssort hsisort
  */
 #define hswap(h, index_a, index_b) cf_hashtable_swap(h, index_a, index_b)
 
@@ -316,7 +363,7 @@
  * @brief    The number of {key, item} pairs in the table.
  * @param    h        The hashtable. Can be `NULL`. Needs to be a pointer to the type of items in the table.
  * @remarks  `h` can be `NULL`.
- * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hhas hdel hclear hkeys hitems hswap hsize hcount hfree
+ * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hget_many hset_many hhas hdel hclear hkeys hitems hswap hsize hcount hfree
  */
 #define hsize(h) cf_hashtable_size(h)
 
@@ -326,7 +373,7 @@
  * @brief    The number of {key, item} pairs in the table.
  * @param    h        The hashtable. Can be `NULL`. Needs to be a pointer to the type of items in the table.
  * @remarks  `h` can be `NULL`.
- * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hhas hdel hclear hkeys hitems hswap hsize hcount hfree
+ * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hget_many hset_many hhas hdel hclear hkeys hitems hswap hsize hcount hfree
  */
 #define hcount(h) cf_hashtable_count(h)
 
@@ -336,7 +383,7 @@
  * @brief    Frees up all resources used and sets `h` to `NULL`.
  * @param    h        The hashtable. Can be `NULL`. Needs to be a pointer to the type of items in the table.
  * @remarks  `h` can be `NULL`.
- * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hhas hdel hclear hkeys hitems hswap hsize hcount hfree
+ * @related  htbl hset hadd hget hfind hget_ptr hfind_ptr hget_many hset_many hhas hdel hclear hkeys hitems hswap hsize hcount hfree
  */
 #define hfree(h) cf_hashtable_free(h)
 
@@ -350,6 +397,8 @@
 #define cf_hashtable_find(h, k) cf_hashtable_get(h, k)
 #define cf_hashtable_get_ptr(h, k) (cf_hashtable_find_impl(CF_HHDR(h), (uint64_t)k), CF_HHDR(h)->return_index < 0 ? NULL : (h) + CF_HHDR(h)->return_index)
 #define cf_hashtable_find_ptr(h, k) cf_hashtable_get_ptr(h, k)
+#define cf_hashtable_get_many(h, keys, count, out) ((h) ? cf_hashtable_get_many_impl(CF_HHDR(h), keys, count, out) : (void)CF_MEMSET(out, 0, sizeof(*(h)) * (count)))
+#define cf_hashtable_set_many(h, keys, items, count) ((h) ? (h) : (*(void**)&(h) = cf_hashtable_make_impl(sizeof(uint64_t), sizeof(*(h)), (count) > 0 ? (count) : 1)), CF_HCANARY(h), *(void**)&(h) = cf_hashtable_set_many_impl(CF_HHDR(h), keys, items, count))
 #define cf_hashtable_has(h, k) ((h) ? cf_hashtable_has_impl(CF_HHDR(h), (uint64_t)k) : false)
 #define cf_hashtable_del(h, k) ((h) ? cf_hashtable_remove_impl(CF_HHDR(h), (uint64_t)k) : (void)0)
 #define cf_hashtable_clear(h) ((h) ? CF_HCANARY(h), cf_hashtable_clear_impl(CF_HHDR(h)) : (void)0)
@@ -369,6 +418,7 @@
 #define CF_HHDR(h) (((CF_Hhdr*)(h - 1) - 1)) // Converts pointer from the user-array to table header.
 #define CF_HCOOKIE 0xE6F7E359 // Magic number used for sanity/type checks.
 #define CF_HCANARY(h) (h ? CF_ASSERT(CF_HHDR(h)->cookie == CF_HCOOKIE) : (void)0) // Sanity/type check.
+#define CF_HBATCH_SIZE 16 // Keys hashed and prefetched at a time by the batched operations.
 
 #ifdef __cplusplus
 extern "C" {
@@ -396,6 +446,11 @@ typedef struct CF_Hhdr
 	void* items_data;
 	void* temp_key;
 	void* temp_item;
+	// Only used by the Swiss-table backend, see CF_FRAMEWORK_SWISS_HASHTABLE in CMakeLists.txt.
+	uint8_t* ctrl;
+	int* slot_items;
+	int growth_left;
+	uint64_t seed;
 	uint32_t cookie;
 } CF_Hhdr;
 
@@ -409,6 +464,9 @@ CF_API void CF_CALL cf_hashtable_remove_impl2(CF_Hhdr* table, const void* key);
 CF_API bool CF_CALL cf_hashtable_has_impl(CF_Hhdr* table, uint64_t key);
 CF_API int CF_CALL cf_hashtable_find_impl(const CF_Hhdr* table, uint64_t key);
 CF_API int CF_CALL cf_hashtable_find_impl2(const CF_Hhdr* table, const void* key);
+CF_API void CF_CALL cf_hashtable_find_many_impl(const CF_Hhdr* table, const void* keys, int count, int* out_indices);
+CF_API void CF_CALL cf_hashtable_get_many_impl(const CF_Hhdr* table, const uint64_t* keys, int count, void* out_items);
+CF_API void* CF_CALL cf_hashtable_set_many_impl(CF_Hhdr* table, const uint64_t* keys, const void* items, int count);
 CF_API int CF_CALL cf_hashtable_count_impl(const CF_Hhdr* table);
 CF_API void* CF_CALL cf_hashtable_items_impl(const CF_Hhdr* table);
 CF_API void* CF_CALL cf_hashtable_keys_impl(const CF_Hhdr* table);
@@ -452,6 +510,11 @@ struct Map
 	const T* try_find(const K& key) const { return try_get(key); }
 	bool has(const K& key) const { return try_get(key) ? true : false; }
 
+	// Looks up `count` keys at once, writing a pointer to each item (or NULL if missing) into `out`.
+	// Faster than a loop of `try_get` for large batches, as the lookups are prefetched ahead of time.
+	void find_batch(const K* keys, int count, T** out);
+	void find_batch(const K* keys, int count, const T** out) const;
+
 	T* insert(const K& key);
 	T* insert(const K& key, const T& val);
 	T* insert(const K& key, T&& val);
@@ -569,6 +632,27 @@ const T* Map<K, T>::try_get(const K& key) const
 	else return NULL;
 }
 
+template <typename K, typename T>
+void Map<K, T>::find_batch(const K* keys, int count, T** out)
+{
+	find_batch(keys, count, (const T**)out);
+}
+
+template <typename K, typename T>
+void Map<K, T>::find_batch(const K* keys, int count, const T** out) const
+{
+	int indices[CF_HBATCH_SIZE];
+	for (int base = 0; base < count; base += CF_HBATCH_SIZE) {
+		int n = count - base < CF_HBATCH_SIZE ? count - base : CF_HBATCH_SIZE;
+		if (m_table) {
+			cf_hashtable_find_many_impl(m_table, keys + base, n, indices);
+		}
+		for (int i = 0; i < n; ++i) {
+			out[base + i] = m_table && indices[i] >= 0 ? items() + indices[i] : NULL;
+		}
+	}
+}
+
 template <typename K, typename T>
 T* Map<K, T>::insert(const K& key)
 {
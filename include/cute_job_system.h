@@ -0,0 +1,279 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#ifndef CF_JOB_SYSTEM_H
+#define CF_JOB_SYSTEM_H
+
+#include "cute_defines.h"
+#include "cute_multithreading.h"
+
+//--------------------------------------------------------------------------------------------------
+// C API
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @struct   CF_JobSystem
+ * @category multithreading
+ * @brief    An opaque pool of worker threads which run jobs, balancing work between themselves by stealing.
+ * @remarks  Each worker keeps its own queue of jobs. Jobs started from a worker (or from the thread that made the job system) go
+ *           straight into that thread's queue without taking any locks, and idle workers steal jobs from the back of busy workers'
+ *           queues. Jobs may start other jobs, and wait on them, making it easy to split work up recursively. Unlike `CF_Threadpool`
+ *           there's no need to kick the system, as jobs start running as soon as they're ready.
+ * @related  CF_JobSystem CF_Job cf_make_job_system cf_make_fiber_job_system cf_destroy_job_system cf_job_run cf_job_run_after cf_job_wait
+ */
+typedef struct CF_JobSystem CF_JobSystem;
+// @end
+
+/**
+ * @struct   CF_Job
+ * @category multithreading
+ * @brief    A handle to a job started by `cf_job_run` or `cf_job_run_after`.
+ * @remarks  Handles stay valid after the job finishes, and simply report the job as done. A zero-initialized handle also counts as
+ *           a job that's already done.
+ * @related  CF_JobSystem CF_Job cf_job_run cf_job_run_after cf_job_is_done cf_job_wait
+ */
+typedef struct CF_Job { uint64_t id; } CF_Job;
+// @end
+
+/**
+ * @function CF_JobFn
+ * @category multithreading
+ * @brief    A function pointer for a job in a `CF_JobSystem`.
+ * @param    udata      Can be `NULL`. This comes from `cf_job_run` or `cf_job_run_after`.
+ * @remarks  Jobs may start more jobs, and may wait on them with `cf_job_wait`.
+ * @related  CF_JobFn cf_job_run cf_job_run_after
+ */
+typedef void (CF_CALL CF_JobFn)(void* udata);
+
+/**
+ * @function cf_make_job_system
+ * @category multithreading
+ * @brief    Returns a new job system.
+ * @param    thread_count  The number of worker threads to spawn. Pass zero or less to use one less than the number of cores, leaving
+ *                         a core for the calling thread.
+ * @param    max_jobs      The most jobs that can be waiting or running at once. Pass zero for a default of 4096.
+ * @remarks  All memory is allocated up front, so starting jobs never allocates. If `max_jobs` jobs are already in flight when
+ *           another is started, the starting thread runs other jobs until a slot frees up. The thread calling this function gets its
+ *           own queue as well, just like the workers, so starting jobs from it doesn't need any locks. Free the system with
+ *           `cf_destroy_job_system` when done.
+ * @related  CF_JobSystem cf_make_job_system cf_destroy_job_system cf_job_run cf_job_run_after cf_job_wait
+ */
+CF_API CF_JobSystem* CF_CALL cf_make_job_system(int thread_count, int max_jobs);
+
+/**
+ * @function cf_make_fiber_job_system
+ * @category multithreading
+ * @brief    Returns a new job system where jobs run on pooled fibers, letting them suspend while they wait.
+ * @param    thread_count      The number of worker threads to spawn. Pass zero or less to use one less than the number of cores.
+ * @param    max_jobs          The most jobs that can be waiting or running at once. Pass zero for a default of 4096.
+ * @param    fiber_count       The number of fibers to make up front. Pass zero for a default of 32 per worker thread.
+ * @param    fiber_stack_size  The size of each fiber's stack in bytes. Pass zero for a default of 64 KB.
+ * @remarks  Works just like `cf_make_job_system`, except worker threads run each job on a fiber, a small stack of its own taken from
+ *           a pool. When a job calls `cf_job_wait`, `cf_job_wait_counter` or `cf_job_yield` its fiber is suspended, and the worker goes
+ *           off to run other jobs. Later, once whatever it was waiting on is done, the worker picks the fiber back up right where it
+ *           left off. This makes it practical to write long jobs, such as loading an asset and then processing it, as plain sequential
+ *           code, without ever tying up a core while waiting. A suspended fiber always resumes on the same worker it started on.
+ *           
+ *           If every fiber is in use, jobs run directly on the worker's own stack, and waits within them run other jobs in the
+ *           meantime, just like `cf_make_job_system`. Jobs run by the thread that made the system never use fibers, as they could only
+ *           ever be resumed while that thread is calling into the job system.
+ * @related  CF_JobSystem cf_make_job_system cf_make_fiber_job_system cf_job_wait cf_job_wait_counter cf_job_yield
+ */
+CF_API CF_JobSystem* CF_CALL cf_make_fiber_job_system(int thread_count, int max_jobs, int fiber_count, int fiber_stack_size);
+
+/**
+ * @function cf_destroy_job_system
+ * @category multithreading
+ * @brief    Stops all worker threads and frees a job system.
+ * @param    system     The job system.
+ * @remarks  Every job must have finished first. Wait on them with `cf_job_wait`. May be called from any thread except the
+ *           system's own workers.
+ * @related  CF_JobSystem cf_make_job_system cf_destroy_job_system
+ */
+CF_API void CF_CALL cf_destroy_job_system(CF_JobSystem* system);
+
+/**
+ * @function cf_job_system_thread_count
+ * @category multithreading
+ * @brief    Returns the number of worker threads in a job system.
+ * @param    system     The job system.
+ * @related  CF_JobSystem cf_make_job_system cf_job_system_thread_count
+ */
+CF_API int CF_CALL cf_job_system_thread_count(const CF_JobSystem* system);
+
+/**
+ * @function cf_job_run
+ * @category multithreading
+ * @brief    Starts a job.
+ * @param    system     The job system.
+ * @param    fn         The function to run.
+ * @param    udata      Can be `NULL`. Handed to `fn` when it runs.
+ * @return   Returns a handle to wait on with `cf_job_wait`, or to pass as a dependency to `cf_job_run_after`.
+ * @remarks  May be called from any thread, including from within other jobs.
+ * @related  CF_JobSystem CF_Job CF_JobFn cf_job_run cf_job_run_after cf_job_is_done cf_job_wait
+ */
+CF_API CF_Job CF_CALL cf_job_run(CF_JobSystem* system, CF_JobFn* fn, void* udata);
+
+/**
+ * @function cf_job_run_after
+ * @category multithreading
+ * @brief    Starts a job once all of its dependencies have finished.
+ * @param    system            The job system.
+ * @param    fn                Can be `NULL`. The function to run. A job without a function is handy to wait on a group of jobs at once.
+ * @param    udata             Can be `NULL`. Handed to `fn` when it runs.
+ * @param    dependencies      The jobs which must finish first. Any which are already done are skipped.
+ * @param    dependency_count  The number of jobs in `dependencies`.
+ * @return   Returns a handle to wait on with `cf_job_wait`, or to pass as a dependency to other jobs.
+ * @remarks  The job never occupies a worker while it waits for its dependencies. Instead the last dependency to finish queues it up.
+ * @example > Run a job after three others, then wait for it.
+ *     CF_Job loads[3];
+ *     for (int i = 0; i < 3; ++i) loads[i] = cf_job_run(jobs, load_chunk, chunks + i);
+ *     CF_Job merge = cf_job_run_after(jobs, merge_chunks, chunks, loads, 3);
+ *     cf_job_wait(jobs, merge);
+ * @related  CF_JobSystem CF_Job CF_JobFn cf_job_run cf_job_run_after cf_job_is_done cf_job_wait
+ */
+CF_API CF_Job CF_CALL cf_job_run_after(CF_JobSystem* system, CF_JobFn* fn, void* udata, const CF_Job* dependencies, int dependency_count);
+
+/**
+ * @function cf_job_is_done
+ * @category multithreading
+ * @brief    Returns true once a job has finished running.
+ * @param    system     The job system.
+ * @param    job        The job.
+ * @related  CF_JobSystem CF_Job cf_job_run cf_job_is_done cf_job_wait
+ */
+CF_API bool CF_CALL cf_job_is_done(const CF_JobSystem* system, CF_Job job);
+
+/**
+ * @function cf_job_wait
+ * @category multithreading
+ * @brief    Waits for a job to finish.
+ * @param    system     The job system.
+ * @param    job        The job.
+ * @remarks  Rather than going to sleep, the calling thread runs other queued jobs while it waits. This makes it safe to wait from
+ *           within a job, as the worker keeps doing useful work, such as running the very jobs being waited on. Within a job running
+ *           on a fiber (see `cf_make_fiber_job_system`) the fiber is suspended instead, freeing up its worker entirely.
+ * @related  CF_JobSystem CF_Job cf_job_run cf_job_is_done cf_job_wait cf_job_wait_counter
+ */
+CF_API void CF_CALL cf_job_wait(CF_JobSystem* system, CF_Job job);
+
+/**
+ * @function cf_job_wait_counter
+ * @category multithreading
+ * @brief    Waits for an atomic counter to drop to `value` or below.
+ * @param    system     The job system.
+ * @param    counter    The counter, typically decremented as pieces of work complete, such as file reads finishing on another thread.
+ * @param    value      The value to wait for.
+ * @remarks  Waits the same way as `cf_job_wait`. Handy for waiting on work that happens outside of the job system.
+ * @example > Waiting on reads from an I/O thread within a fiber job.
+ *     CF_AtomicInt reads_left = cf_atomic_zero();
+ *     cf_atomic_set(&reads_left, 2);
+ *     queue_read(io, "a.png", &reads_left); // Decrements `reads_left` when done.
+ *     queue_read(io, "b.png", &reads_left);
+ *     cf_job_wait_counter(jobs, &reads_left, 0);
+ * @related  CF_JobSystem cf_make_fiber_job_system cf_job_wait cf_job_wait_counter cf_job_yield
+ */
+CF_API void CF_CALL cf_job_wait_counter(CF_JobSystem* system, CF_AtomicInt* counter, int value);
+
+/**
+ * @function cf_job_yield
+ * @category multithreading
+ * @brief    Lets other work run for a moment.
+ * @param    system     The job system.
+ * @remarks  Within a job running on a fiber (see `cf_make_fiber_job_system`) the fiber is suspended, and resumed once its worker has
+ *           had a chance to run something else. Otherwise runs one other queued job, if there is one. Useful for polling on something
+ *           without holding up a worker.
+ * @related  CF_JobSystem cf_make_fiber_job_system cf_job_wait cf_job_wait_counter cf_job_yield
+ */
+CF_API void CF_CALL cf_job_yield(CF_JobSystem* system);
+
+/**
+ * @function CF_ParallelForFn
+ * @category multithreading
+ * @brief    A function pointer for the body of a `cf_parallel_for` loop.
+ * @param    begin      The first index of this chunk.
+ * @param    end        One past the last index of this chunk.
+ * @param    udata      Can be `NULL`. This comes from `cf_parallel_for`.
+ * @remarks  Called once per chunk rather than once per index, so the loop over `[begin, end)` stays tight.
+ * @related  CF_ParallelForFn cf_parallel_for
+ */
+typedef void (CF_CALL CF_ParallelForFn)(int begin, int end, void* udata);
+
+/**
+ * @function cf_parallel_for
+ * @category multithreading
+ * @brief    Runs `fn` over the indices `[0, count)` split into chunks spread across a job system, returning once all are done.
+ * @param    system     Can be `NULL`. The job system to run on. If `NULL` the whole range runs on the calling thread.
+ * @param    count      The number of indices.
+ * @param    min_batch  The fewest indices to ever hand out as a single chunk. Raise this when each index is cheap to process.
+ * @param    fn         The loop body, called once per chunk.
+ * @param    udata      Can be `NULL`. Handed to `fn`.
+ * @remarks  The range is split in half recursively. One half is handed off as a job, while the current thread carries on splitting
+ *           the other half, until chunks are small enough to run. Only a few chunks per thread are made up front. Whenever a chunk gets
+ *           stolen by another thread it's split further, so the work balances itself out even when some indices take far longer than
+ *           others. The calling thread runs chunks too, and nothing is allocated. May be called from within a job.
+ * @example > Scaling a large array of positions.
+ *     void scale(int begin, int end, void* udata)
+ *     {
+ *         CF_V2* positions = (CF_V2*)udata;
+ *         for (int i = begin; i < end; ++i) positions[i] = cf_mul_v2_f(positions[i], 2.0f);
+ *     }
+ *
+ *     cf_parallel_for(jobs, count, 256, scale, positions);
+ * @related  CF_JobSystem CF_ParallelForFn cf_parallel_for
+ */
+CF_API void CF_CALL cf_parallel_for(CF_JobSystem* system, int count, int min_batch, CF_ParallelForFn* fn, void* udata);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+//--------------------------------------------------------------------------------------------------
+// C++ API
+
+#ifdef CF_CPP
+
+namespace Cute
+{
+
+using JobSystem = CF_JobSystem;
+using Job = CF_Job;
+
+CF_INLINE JobSystem* make_job_system(int thread_count = 0, int max_jobs = 0) { return cf_make_job_system(thread_count, max_jobs); }
+CF_INLINE JobSystem* make_fiber_job_system(int thread_count = 0, int max_jobs = 0, int fiber_count = 0, int fiber_stack_size = 0) { return cf_make_fiber_job_system(thread_count, max_jobs, fiber_count, fiber_stack_size); }
+CF_INLINE void destroy_job_system(JobSystem* system) { cf_destroy_job_system(system); }
+CF_INLINE int job_system_thread_count(const JobSystem* system) { return cf_job_system_thread_count(system); }
+CF_INLINE Job job_run(JobSystem* system, CF_JobFn* fn, void* udata) { return cf_job_run(system, fn, udata); }
+CF_INLINE Job job_run_after(JobSystem* system, CF_JobFn* fn, void* udata, const Job* dependencies, int dependency_count) { return cf_job_run_after(system, fn, udata, dependencies, dependency_count); }
+CF_INLINE bool job_is_done(const JobSystem* system, Job job) { return cf_job_is_done(system, job); }
+CF_INLINE void job_wait(JobSystem* system, Job job) { cf_job_wait(system, job); }
+CF_INLINE void job_wait_counter(JobSystem* system, CF_AtomicInt* counter, int value) { cf_job_wait_counter(system, counter, value); }
+CF_INLINE void job_yield(JobSystem* system) { cf_job_yield(system); }
+CF_INLINE void parallel_for(JobSystem* system, int count, int min_batch, CF_ParallelForFn* fn, void* udata) { cf_parallel_for(system, count, min_batch, fn, udata); }
+
+/**
+ * Runs `fn(i)` for every index in `[0, count)`, spread across a job system. See `cf_parallel_for`.
+ *
+ *     parallel_for(jobs, count, 256, [&](int i) { positions[i] *= 2.0f; });
+ */
+template <typename F>
+CF_INLINE void parallel_for(JobSystem* system, int count, int min_batch, const F& fn)
+{
+	cf_parallel_for(system, count, min_batch, [](int begin, int end, void* udata) {
+		const F& fn = *(const F*)udata;
+		for (int i = begin; i < end; ++i) fn(i);
+	}, (void*)&fn);
+}
+
+}
+
+#endif // CF_CPP
+
+#endif // CF_JOB_SYSTEM_H
@@ -0,0 +1,351 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#ifndef CF_PATHFINDING_H
+#define CF_PATHFINDING_H
+
+#include "cute_defines.h"
+#include "cute_multithreading.h"
+
+//--------------------------------------------------------------------------------------------------
+// C API
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @struct   CF_PathGrid
+ * @category pathfinding
+ * @brief    An opaque 2D grid of cells, each either open or blocked, used for finding paths.
+ * @remarks  Cells are addressed by integer (x, y) coordinates, from (0, 0) to (w - 1, h - 1). Paths may move between any of the 8
+ *           neighboring cells, but never cut the corner of a blocked cell when moving diagonally. Moving straight costs 1 and moving
+ *           diagonally costs sqrt(2).
+ * @related  CF_PathGrid cf_make_path_grid cf_destroy_path_grid cf_path_grid_set_blocked cf_path_grid_is_blocked cf_path_find
+ */
+typedef struct CF_PathGrid CF_PathGrid;
+// @end
+
+/**
+ * @struct   CF_PathContext
+ * @category pathfinding
+ * @brief    An opaque bundle of scratch memory for running path searches on a `CF_PathGrid`.
+ * @remarks  Scratch memory is allocated the first time each kind of search runs and then reused, so later searches don't allocate.
+ *           `cf_path_find` needs a node for every cell of the grid, while `cf_path_find_hierarchical` only needs room for one cluster
+ *           plus the graph of entrances. A context may only be used by one thread at a time, so make one per thread and reuse them
+ *           for every search.
+ * @related  CF_PathContext cf_make_path_context cf_destroy_path_context cf_path_find cf_path_find_batch
+ */
+typedef struct CF_PathContext CF_PathContext;
+// @end
+
+/**
+ * @struct   CF_PathHierarchy
+ * @category pathfinding
+ * @brief    An opaque cache of a `CF_PathGrid` split into clusters, for finding paths across large grids quickly.
+ * @remarks  The grid is split into square clusters. Cells where two neighboring clusters can be crossed between are recorded as
+ *           entrances, and the lengths of the paths between every pair of entrances within the same cluster are precomputed. Searches
+ *           then run over this much smaller graph of entrances, and only the clusters along the way are searched cell by cell.
+ *           Paths are not guaranteed to be the shortest possible, but are typically within a few percent.
+ * @related  CF_PathHierarchy cf_make_path_hierarchy cf_destroy_path_hierarchy cf_path_hierarchy_update cf_path_find_hierarchical
+ */
+typedef struct CF_PathHierarchy CF_PathHierarchy;
+// @end
+
+/**
+ * @struct   CF_PathPoint
+ * @category pathfinding
+ * @brief    A cell coordinate along a path.
+ * @related  CF_PathPoint CF_PathRequest cf_path_find
+ */
+typedef struct CF_PathPoint
+{
+	/* @member The x coordinate of the cell. */
+	int x;
+
+	/* @member The y coordinate of the cell. */
+	int y;
+} CF_PathPoint;
+// @end
+
+/**
+ * @struct   CF_PathRequest
+ * @category pathfinding
+ * @brief    Describes a single path search, and receives its results.
+ * @remarks  Fill out the start, goal, and `path` buffer, then pass the request to `cf_path_find`, `cf_path_find_hierarchical`, or
+ *           one of the batch versions. The path is recorded as a list of corners, from `start` to `goal` inclusive. Between two
+ *           consecutive points the path travels in a straight line, either horizontally, vertically, or diagonally.
+ * @related  CF_PathPoint CF_PathRequest cf_path_find cf_path_find_batch
+ */
+typedef struct CF_PathRequest
+{
+	/* @member The cell to search from. */
+	CF_PathPoint start;
+
+	/* @member The cell to search for. */
+	CF_PathPoint goal;
+
+	/* @member Can be `NULL`. Buffer to write the corners of the path into. */
+	CF_PathPoint* path;
+
+	/* @member The number of points `path` can hold. If the path has more corners than this, only the first `path_capacity` are written. */
+	int path_capacity;
+
+	/* @member Set true to skip Jump Point Search and run a plain A* search instead. Only useful for comparisons and debugging, as JPS finds paths of the same length far faster. */
+	bool astar_only;
+
+	/* @member Written with whether or not a path was found. */
+	bool found;
+
+	/* @member Written with the number of corners along the path, which may be larger than `path_capacity`. */
+	int path_count;
+
+	/* @member Written with the total length of the path. */
+	float cost;
+
+	/* @member Written with the number of nodes the search expanded, counting cells and, for hierarchical searches, entrances. Handy for profiling, or picking a cluster size. */
+	int expanded_count;
+} CF_PathRequest;
+// @end
+
+/**
+ * @function cf_make_path_grid
+ * @category pathfinding
+ * @brief    Returns a new grid with every cell open.
+ * @param    w            The number of cells along x.
+ * @param    h            The number of cells along y.
+ * @remarks  Free it with `cf_destroy_path_grid` when done.
+ * @related  CF_PathGrid cf_make_path_grid cf_destroy_path_grid cf_path_grid_set_blocked cf_path_grid_is_blocked
+ */
+CF_API CF_PathGrid* CF_CALL cf_make_path_grid(int w, int h);
+
+/**
+ * @function cf_destroy_path_grid
+ * @category pathfinding
+ * @brief    Frees a grid created by `cf_make_path_grid`.
+ * @param    grid         The grid.
+ * @remarks  Any `CF_PathContext` or `CF_PathHierarchy` made for this grid must be destroyed first.
+ * @related  CF_PathGrid cf_make_path_grid cf_destroy_path_grid
+ */
+CF_API void CF_CALL cf_destroy_path_grid(CF_PathGrid* grid);
+
+/**
+ * @function cf_path_grid_width
+ * @category pathfinding
+ * @brief    Returns the number of cells along x.
+ * @param    grid         The grid.
+ * @related  CF_PathGrid cf_path_grid_width cf_path_grid_height
+ */
+CF_API int CF_CALL cf_path_grid_width(const CF_PathGrid* grid);
+
+/**
+ * @function cf_path_grid_height
+ * @category pathfinding
+ * @brief    Returns the number of cells along y.
+ * @param    grid         The grid.
+ * @related  CF_PathGrid cf_path_grid_width cf_path_grid_height
+ */
+CF_API int CF_CALL cf_path_grid_height(const CF_PathGrid* grid);
+
+/**
+ * @function cf_path_grid_set_blocked
+ * @category pathfinding
+ * @brief    Marks a cell as blocked or open.
+ * @param    grid         The grid.
+ * @param    x            The x coordinate of the cell.
+ * @param    y            The y coordinate of the cell.
+ * @param    blocked      True to block the cell, false to open it.
+ * @remarks  The grid must not be modified while searches are running on it. If the grid has a `CF_PathHierarchy` only the clusters
+ *           touching this cell are marked as needing a rebuild, see `cf_path_hierarchy_update`.
+ * @related  CF_PathGrid cf_path_grid_set_blocked cf_path_grid_is_blocked cf_path_hierarchy_update
+ */
+CF_API void CF_CALL cf_path_grid_set_blocked(CF_PathGrid* grid, int x, int y, bool blocked);
+
+/**
+ * @function cf_path_grid_is_blocked
+ * @category pathfinding
+ * @brief    Returns true if a cell is blocked.
+ * @param    grid         The grid.
+ * @param    x            The x coordinate of the cell.
+ * @param    y            The y coordinate of the cell.
+ * @remarks  Cells outside of the grid count as blocked.
+ * @related  CF_PathGrid cf_path_grid_set_blocked cf_path_grid_is_blocked
+ */
+CF_API bool CF_CALL cf_path_grid_is_blocked(const CF_PathGrid* grid, int x, int y);
+
+/**
+ * @function cf_make_path_context
+ * @category pathfinding
+ * @brief    Returns a new context for running searches on `grid`.
+ * @param    grid         The grid to search.
+ * @remarks  This is cheap, memory for searches is allocated the first time it's needed, see `CF_PathContext`. Use one context per
+ *           thread. Free it with `cf_destroy_path_context` when done.
+ * @related  CF_PathContext cf_make_path_context cf_destroy_path_context cf_path_find cf_path_find_batch
+ */
+CF_API CF_PathContext* CF_CALL cf_make_path_context(const CF_PathGrid* grid);
+
+/**
+ * @function cf_destroy_path_context
+ * @category pathfinding
+ * @brief    Frees a context created by `cf_make_path_context`.
+ * @param    ctx          The context.
+ * @related  CF_PathContext cf_make_path_context cf_destroy_path_context
+ */
+CF_API void CF_CALL cf_destroy_path_context(CF_PathContext* ctx);
+
+/**
+ * @function cf_path_find
+ * @category pathfinding
+ * @brief    Finds the shortest path between two cells.
+ * @param    ctx          The context to search with.
+ * @param    request      The start and goal cells, and where to record the path. See `CF_PathRequest`.
+ * @return   Returns true if a path was found, the same as `request->found`.
+ * @example > Finding a path around a wall.
+ *     CF_PathGrid* grid = cf_make_path_grid(64, 64);
+ *     for (int y = 0; y < 60; ++y) cf_path_grid_set_blocked(grid, 32, y, true);
+ *     CF_PathContext* ctx = cf_make_path_context(grid);
+ *     CF_PathPoint points[64];
+ *     CF_PathRequest request = { };
+ *     request.start = { 2, 2 };
+ *     request.goal = { 60, 2 };
+ *     request.path = points;
+ *     request.path_capacity = 64;
+ *     if (cf_path_find(ctx, &request)) {
+ *         for (int i = 0; i < request.path_count; ++i) {
+ *             printf("(%d, %d)\n", points[i].x, points[i].y);
+ *         }
+ *     }
+ *     cf_destroy_path_context(ctx);
+ *     cf_destroy_path_grid(grid);
+ * @remarks  Uses A* with Jump Point Search, which skips over the long runs of open cells that plain A* would add to its open list
+ *           one by one. Fails if either the start or goal is blocked or outside the grid.
+ * @related  CF_PathRequest CF_PathContext cf_path_find cf_path_find_batch
+ */
+CF_API bool CF_CALL cf_path_find(CF_PathContext* ctx, CF_PathRequest* request);
+
+/**
+ * @function cf_path_find_batch
+ * @category pathfinding
+ * @brief    Solves many path requests at once, spread across a threadpool.
+ * @param    contexts       An array of contexts, one for each thread that will run searches.
+ * @param    context_count  The number of contexts in `contexts`.
+ * @param    pool           Can be `NULL`. The threadpool to run searches on. If `NULL` all searches run on this thread.
+ * @param    requests       The requests to solve.
+ * @param    request_count  The number of requests.
+ * @remarks  Pass one more context than the number of threads in `pool`, since the calling thread also runs searches while waiting.
+ *           Threads grab requests one at a time until all are solved, so a few long searches don't hold up the rest. Returns once
+ *           every request has been solved.
+ * @related  CF_PathRequest CF_PathContext cf_path_find cf_path_find_batch
+ */
+CF_API void CF_CALL cf_path_find_batch(CF_PathContext** contexts, int context_count, CF_Threadpool* pool, CF_PathRequest* requests, int request_count);
+
+/**
+ * @function cf_make_path_hierarchy
+ * @category pathfinding
+ * @brief    Returns a new hierarchy for finding paths across `grid` with `cf_path_find_hierarchical`.
+ * @param    grid          The grid. Only one hierarchy can be made per grid.
+ * @param    cluster_size  The width and height of each cluster in cells, such as 16 or 32. Larger clusters mean fewer entrances to
+ *                         search over, but more work to refine each part of a path, and to rebuild a cluster after an edit.
+ * @remarks  The entire hierarchy is built here. Afterwards the grid can still be edited with `cf_path_grid_set_blocked`, which
+ *           records which clusters have changed, and `cf_path_hierarchy_update` rebuilds only those. Free it with
+ *           `cf_destroy_path_hierarchy` when done.
+ * @related  CF_PathHierarchy cf_make_path_hierarchy cf_destroy_path_hierarchy cf_path_hierarchy_update cf_path_find_hierarchical
+ */
+CF_API CF_PathHierarchy* CF_CALL cf_make_path_hierarchy(CF_PathGrid* grid, int cluster_size);
+
+/**
+ * @function cf_destroy_path_hierarchy
+ * @category pathfinding
+ * @brief    Frees a hierarchy created by `cf_make_path_hierarchy`.
+ * @param    hierarchy     The hierarchy.
+ * @related  CF_PathHierarchy cf_make_path_hierarchy cf_destroy_path_hierarchy
+ */
+CF_API void CF_CALL cf_destroy_path_hierarchy(CF_PathHierarchy* hierarchy);
+
+/**
+ * @function cf_path_hierarchy_update
+ * @category pathfinding
+ * @brief    Rebuilds any clusters whose cells have changed since the last update.
+ * @param    hierarchy     The hierarchy.
+ * @return   Returns the number of clusters rebuilt.
+ * @remarks  Call this after editing the grid, and before running any more searches with `cf_path_find_hierarchical`. Editing a cell
+ *           inside a cluster only rebuilds that cluster, while editing a cell along a cluster's edge also rebuilds the neighbor across
+ *           that edge, as the entrances between them may have changed.
+ * @related  CF_PathHierarchy cf_make_path_hierarchy cf_path_hierarchy_update cf_path_grid_set_blocked
+ */
+CF_API int CF_CALL cf_path_hierarchy_update(CF_PathHierarchy* hierarchy);
+
+/**
+ * @function cf_path_find_hierarchical
+ * @category pathfinding
+ * @brief    Finds a path between two cells using a `CF_PathHierarchy`.
+ * @param    ctx           The context to search with, made for the same grid as `hierarchy`.
+ * @param    hierarchy     The hierarchy.
+ * @param    request       The start and goal cells, and where to record the path. See `CF_PathRequest`.
+ * @return   Returns true if a path was found, the same as `request->found`.
+ * @remarks  Much faster than `cf_path_find` for long paths across large grids, at the cost of paths that may be slightly longer than
+ *           the shortest possible. A path is found whenever one exists. `astar_only` is ignored. Scratch memory in the context grows
+ *           to fit one cluster and the hierarchy's entrances the first time it's searched, never the whole grid. Any number of threads may search the same hierarchy at once,
+ *           each with their own context, so long as the grid isn't edited or updated at the same time.
+ * @related  CF_PathHierarchy CF_PathRequest cf_path_find cf_path_find_hierarchical cf_path_find_hierarchical_batch
+ */
+CF_API bool CF_CALL cf_path_find_hierarchical(CF_PathContext* ctx, const CF_PathHierarchy* hierarchy, CF_PathRequest* request);
+
+/**
+ * @function cf_path_find_hierarchical_batch
+ * @category pathfinding
+ * @brief    Solves many path requests at once with `cf_path_find_hierarchical`, spread across a threadpool.
+ * @param    contexts       An array of contexts, one for each thread that will run searches.
+ * @param    context_count  The number of contexts in `contexts`.
+ * @param    pool           Can be `NULL`. The threadpool to run searches on. If `NULL` all searches run on this thread.
+ * @param    hierarchy      The hierarchy.
+ * @param    requests       The requests to solve.
+ * @param    request_count  The number of requests.
+ * @remarks  Works just like `cf_path_find_batch`.
+ * @related  CF_PathHierarchy CF_PathRequest cf_path_find_batch cf_path_find_hierarchical cf_path_find_hierarchical_batch
+ */
+CF_API void CF_CALL cf_path_find_hierarchical_batch(CF_PathContext** contexts, int context_count, CF_Threadpool* pool, const CF_PathHierarchy* hierarchy, CF_PathRequest* requests, int request_count);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+//--------------------------------------------------------------------------------------------------
+// C++ API
+
+#ifdef CF_CPP
+
+namespace Cute
+{
+
+using PathGrid = CF_PathGrid;
+using PathContext = CF_PathContext;
+using PathPoint = CF_PathPoint;
+using PathRequest = CF_PathRequest;
+using PathHierarchy = CF_PathHierarchy;
+
+CF_INLINE PathGrid* make_path_grid(int w, int h) { return cf_make_path_grid(w, h); }
+CF_INLINE void destroy_path_grid(PathGrid* grid) { cf_destroy_path_grid(grid); }
+CF_INLINE int path_grid_width(const PathGrid* grid) { return cf_path_grid_width(grid); }
+CF_INLINE int path_grid_height(const PathGrid* grid) { return cf_path_grid_height(grid); }
+CF_INLINE void path_grid_set_blocked(PathGrid* grid, int x, int y, bool blocked) { cf_path_grid_set_blocked(grid, x, y, blocked); }
+CF_INLINE bool path_grid_is_blocked(const PathGrid* grid, int x, int y) { return cf_path_grid_is_blocked(grid, x, y); }
+CF_INLINE PathContext* make_path_context(const PathGrid* grid) { return cf_make_path_context(grid); }
+CF_INLINE void destroy_path_context(PathContext* ctx) { cf_destroy_path_context(ctx); }
+CF_INLINE bool path_find(PathContext* ctx, PathRequest* request) { return cf_path_find(ctx, request); }
+CF_INLINE void path_find_batch(PathContext** contexts, int context_count, CF_Threadpool* pool, PathRequest* requests, int request_count) { cf_path_find_batch(contexts, context_count, pool, requests, request_count); }
+CF_INLINE PathHierarchy* make_path_hierarchy(PathGrid* grid, int cluster_size) { return cf_make_path_hierarchy(grid, cluster_size); }
+CF_INLINE void destroy_path_hierarchy(PathHierarchy* hierarchy) { cf_destroy_path_hierarchy(hierarchy); }
+CF_INLINE int path_hierarchy_update(PathHierarchy* hierarchy) { return cf_path_hierarchy_update(hierarchy); }
+CF_INLINE bool path_find_hierarchical(PathContext* ctx, const PathHierarchy* hierarchy, PathRequest* request) { return cf_path_find_hierarchical(ctx, hierarchy, request); }
+CF_INLINE void path_find_hierarchical_batch(PathContext** contexts, int context_count, CF_Threadpool* pool, const PathHierarchy* hierarchy, PathRequest* requests, int request_count) { cf_path_find_hierarchical_batch(contexts, context_count, pool, hierarchy, requests, request_count); }
+
+}
+
+#endif // CF_CPP
+
+#endif // CF_PATHFINDING_H
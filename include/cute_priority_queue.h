@@ -55,7 +55,7 @@ void PriorityQueue<T>::push_min(const T& val, float cost)
 	m_costs.add(cost);
 
 	int i = m_values.count();
-	while (i > 1 && predicate_min(i - 1, i / 2 - 1) > 0) {
+	while (i > 1 && predicate_min(i - 1, i / 2 - 1) < 0) {
 		swap(i - 1, i / 2 - 1);
 		i /= 2;
 	}
@@ -77,10 +77,10 @@ bool PriorityQueue<T>::pop_min(T* val, float* cost)
 	while (u != v) {
 		u = v;
 		if (2 * u + 1 <= count) {
-			if (predicate_min(u - 1, 2 * u - 1) <= 0) v = 2 * u;
-			if (predicate_min(v - 1, 2 * u + 1 - 1) <= 0) v = 2 * u + 1;
+			if (predicate_min(2 * u - 1, u - 1) < 0) v = 2 * u;
+			if (predicate_min(2 * u + 1 - 1, v - 1) < 0) v = 2 * u + 1;
 		} else if (2 * u <= count) {
-			if (predicate_min(u - 1, 2 * u - 1) <= 0) v = 2 * u;
+			if (predicate_min(2 * u - 1, u - 1) < 0) v = 2 * u;
 		}
 
 		if (u != v) {
@@ -98,7 +98,7 @@ void PriorityQueue<T>::push_max(const T& val, float cost)
 	m_costs.add(cost);
 
 	int i = m_values.count();
-	while (i > 1 && predicate_max(i - 1, i / 2 - 1) > 0) {
+	while (i > 1 && predicate_max(i - 1, i / 2 - 1) < 0) {
 		swap(i - 1, i / 2 - 1);
 		i /= 2;
 	}
@@ -120,10 +120,10 @@ bool PriorityQueue<T>::pop_max(T* val, float* cost)
 	while (u != v) {
 		u = v;
 		if (2 * u + 1 <= count) {
-			if (predicate_max(u - 1, 2 * u - 1) <= 0) v = 2 * u;
-			if (predicate_max(v - 1, 2 * u + 1 - 1) <= 0) v = 2 * u + 1;
+			if (predicate_max(2 * u - 1, u - 1) < 0) v = 2 * u;
+			if (predicate_max(2 * u + 1 - 1, v - 1) < 0) v = 2 * u + 1;
 		} else if (2 * u <= count) {
-			if (predicate_max(u - 1, 2 * u - 1) <= 0) v = 2 * u;
+			if (predicate_max(2 * u - 1, u - 1) < 0) v = 2 * u;
 		}
 
 		if (u != v) {
@@ -181,6 +181,245 @@ void PriorityQueue<T>::swap(int iA, int iB)
 	m_costs[iB] = fval;
 }
 
+/**
+ * A min-heap where each pushed item is given a handle, which can later be used to lower its cost (`decrease_key`), change its
+ * cost in either direction (`update`), or remove it from the middle of the queue. All of these are O(log n).
+ *
+ * This is the queue you want for A*, Dijkstra, or scheduling timed events that may be cancelled or rescheduled. It's a 4-ary
+ * heap, which is shallower than a binary heap and keeps each node's children next to each other in memory. Costs and values
+ * are stored together, so sifting items up and down touches one array instead of two.
+ *
+ * Handles are small integers and are recycled once their item is popped or removed. For a max-heap negate the costs.
+ */
+template <typename T>
+struct IndexedPriorityQueue
+{
+	int push(const T& value, float cost);
+	bool pop(T* value = NULL, float* cost = NULL, int* handle = NULL);
+	bool peek(T* value = NULL, float* cost = NULL, int* handle = NULL) const;
+
+	void decrease_key(int handle, float cost);
+	void update(int handle, float cost);
+	bool remove(int handle, T* value = NULL);
+
+	bool contains(int handle) const;
+	float cost(int handle) const;
+	T& value(int handle);
+	const T& value(int handle) const;
+
+	void reserve(int capacity);
+	int count() const;
+	bool empty() const;
+	void clear();
+
+private:
+	struct Node
+	{
+		float cost;
+		int handle;
+		T value;
+	};
+
+	Array<Node> m_heap;
+	Array<int> m_positions; // Heap index for each handle, or -1 if the handle is free.
+	Array<int> m_free_handles;
+
+	void sift_up(int i);
+	void sift_down(int i);
+	void place(int i, const Node& node);
+	void remove_at(int i);
+};
+
+// -------------------------------------------------------------------------------------------------
+
+#define CF_HEAP_ARITY 4
+
+template <typename T>
+int IndexedPriorityQueue<T>::push(const T& value, float cost)
+{
+	int handle;
+	if (m_free_handles.count()) {
+		handle = m_free_handles.pop();
+	} else {
+		handle = m_positions.count();
+		m_positions.add(-1);
+	}
+	m_heap.add({ cost, handle, value });
+	m_positions[handle] = m_heap.count() - 1;
+	sift_up(m_heap.count() - 1);
+	return handle;
+}
+
+template <typename T>
+bool IndexedPriorityQueue<T>::pop(T* value, float* cost, int* handle)
+{
+	if (!m_heap.count()) return false;
+	const Node& top = m_heap[0];
+	if (value) *value = top.value;
+	if (cost) *cost = top.cost;
+	if (handle) *handle = top.handle;
+	remove_at(0);
+	return true;
+}
+
+template <typename T>
+bool IndexedPriorityQueue<T>::peek(T* value, float* cost, int* handle) const
+{
+	if (!m_heap.count()) return false;
+	const Node& top = m_heap[0];
+	if (value) *value = top.value;
+	if (cost) *cost = top.cost;
+	if (handle) *handle = top.handle;
+	return true;
+}
+
+template <typename T>
+void IndexedPriorityQueue<T>::decrease_key(int handle, float cost)
+{
+	CF_ASSERT(contains(handle));
+	int i = m_positions[handle];
+	CF_ASSERT(cost <= m_heap[i].cost);
+	m_heap[i].cost = cost;
+	sift_up(i);
+}
+
+template <typename T>
+void IndexedPriorityQueue<T>::update(int handle, float cost)
+{
+	CF_ASSERT(contains(handle));
+	int i = m_positions[handle];
+	float old_cost = m_heap[i].cost;
+	m_heap[i].cost = cost;
+	if (cost < old_cost) sift_up(i);
+	else sift_down(i);
+}
+
+template <typename T>
+bool IndexedPriorityQueue<T>::remove(int handle, T* value)
+{
+	if (!contains(handle)) return false;
+	int i = m_positions[handle];
+	if (value) *value = m_heap[i].value;
+	remove_at(i);
+	return true;
+}
+
+template <typename T>
+bool IndexedPriorityQueue<T>::contains(int handle) const
+{
+	return handle >= 0 && handle < m_positions.count() && m_positions[handle] >= 0;
+}
+
+template <typename T>
+float IndexedPriorityQueue<T>::cost(int handle) const
+{
+	CF_ASSERT(contains(handle));
+	return m_heap[m_positions[handle]].cost;
+}
+
+template <typename T>
+T& IndexedPriorityQueue<T>::value(int handle)
+{
+	CF_ASSERT(contains(handle));
+	return m_heap[m_positions[handle]].value;
+}
+
+template <typename T>
+const T& IndexedPriorityQueue<T>::value(int handle) const
+{
+	CF_ASSERT(contains(handle));
+	return m_heap[m_positions[handle]].value;
+}
+
+template <typename T>
+void IndexedPriorityQueue<T>::reserve(int capacity)
+{
+	m_heap.ensure_capacity(capacity);
+	m_positions.ensure_capacity(capacity);
+	m_free_handles.ensure_capacity(capacity);
+}
+
+template <typename T>
+int IndexedPriorityQueue<T>::count() const
+{
+	return m_heap.count();
+}
+
+template <typename T>
+bool IndexedPriorityQueue<T>::empty() const
+{
+	return m_heap.count() == 0;
+}
+
+template <typename T>
+void IndexedPriorityQueue<T>::clear()
+{
+	m_heap.clear();
+	m_positions.clear();
+	m_free_handles.clear();
+}
+
+template <typename T>
+void IndexedPriorityQueue<T>::place(int i, const Node& node)
+{
+	m_heap[i] = node;
+	m_positions[node.handle] = i;
+}
+
+template <typename T>
+void IndexedPriorityQueue<T>::sift_up(int i)
+{
+	// Shift parents down into the hole instead of swapping, then drop the node in once at the end.
+	Node node = m_heap[i];
+	while (i > 0) {
+		int parent = (i - 1) / CF_HEAP_ARITY;
+		if (!(node.cost < m_heap[parent].cost)) break;
+		place(i, m_heap[parent]);
+		i = parent;
+	}
+	place(i, node);
+}
+
+template <typename T>
+void IndexedPriorityQueue<T>::sift_down(int i)
+{
+	Node node = m_heap[i];
+	int count = m_heap.count();
+	while (true) {
+		int first = i * CF_HEAP_ARITY + 1;
+		if (first >= count) break;
+		int last = first + CF_HEAP_ARITY < count ? first + CF_HEAP_ARITY : count;
+		int best = first;
+		for (int child = first + 1; child < last; ++child) {
+			if (m_heap[child].cost < m_heap[best].cost) best = child;
+		}
+		if (!(m_heap[best].cost < node.cost)) break;
+		place(i, m_heap[best]);
+		i = best;
+	}
+	place(i, node);
+}
+
+template <typename T>
+void IndexedPriorityQueue<T>::remove_at(int i)
+{
+	int handle = m_heap[i].handle;
+	m_positions[handle] = -1;
+	m_free_handles.add(handle);
+	int last = m_heap.count() - 1;
+	if (i != last) {
+		float removed_cost = m_heap[i].cost;
+		place(i, m_heap[last]);
+		m_heap.pop();
+		if (m_heap[i].cost < removed_cost) sift_up(i);
+		else sift_down(i);
+	} else {
+		m_heap.pop();
+	}
+}
+
+#undef CF_HEAP_ARITY
+
 }
 
 #endif // CF_CPP
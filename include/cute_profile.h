@@ -0,0 +1,155 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#ifndef CF_PROFILE_H
+#define CF_PROFILE_H
+
+#include "cute_defines.h"
+#include "cute_result.h"
+
+//--------------------------------------------------------------------------------------------------
+// C API
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @function CF_PROFILE_BEGIN
+ * @category profile
+ * @brief    Marks the start of a named region of code.
+ * @param    name       The name of the region. Must be a string literal, or otherwise live until the trace is saved, as only the pointer
+ *                      is recorded.
+ * @remarks  Must be paired with `CF_PROFILE_END` on the same thread. Regions may be nested. Expands to nothing unless `CF_PROFILING` is
+ *           defined, which the CMake option `CF_FRAMEWORK_PROFILING` does for CF and everything linking to it. With it off, every marker
+ *           within CF and your own code is compiled away entirely.
+ * @related  CF_PROFILE_BEGIN CF_PROFILE_END CF_PROFILE_SCOPE cf_profile_begin cf_profile_save_trace
+ */
+#ifdef CF_PROFILING
+#	define CF_PROFILE_BEGIN(name) cf_profile_begin(name)
+#else
+#	define CF_PROFILE_BEGIN(name)
+#endif
+
+/**
+ * @function CF_PROFILE_END
+ * @category profile
+ * @brief    Marks the end of the region most recently started with `CF_PROFILE_BEGIN` on this thread.
+ * @remarks  Expands to nothing unless `CF_PROFILING` is defined.
+ * @related  CF_PROFILE_BEGIN CF_PROFILE_END CF_PROFILE_SCOPE cf_profile_end
+ */
+#ifdef CF_PROFILING
+#	define CF_PROFILE_END() cf_profile_end()
+#else
+#	define CF_PROFILE_END()
+#endif
+
+/**
+ * @function cf_profile_begin
+ * @category profile
+ * @brief    Records the start of a named region of code on the calling thread.
+ * @param    name       The name of the region. Must be a string literal, or otherwise live until the trace is saved, as only the pointer
+ *                      is recorded.
+ * @remarks  Prefer `CF_PROFILE_BEGIN` or `CF_PROFILE_SCOPE`, which compile away when profiling is turned off. Each thread records into
+ *           its own ring buffer, so this never takes a lock and costs about as much as reading the clock. Once a thread's buffer is full
+ *           the oldest events are overwritten, so the trace always holds the most recent few seconds of activity.
+ * @related  cf_profile_begin cf_profile_end cf_profile_save_trace
+ */
+CF_API void CF_CALL cf_profile_begin(const char* name);
+
+/**
+ * @function cf_profile_end
+ * @category profile
+ * @brief    Records the end of the region most recently started on the calling thread.
+ * @related  cf_profile_begin cf_profile_end cf_profile_save_trace
+ */
+CF_API void CF_CALL cf_profile_end();
+
+/**
+ * @function cf_profile_clear
+ * @category profile
+ * @brief    Discards everything recorded so far, on all threads.
+ * @remarks  Handy to capture just a specific stretch of time, such as clearing right before a slow frame and saving right after.
+ * @related  cf_profile_begin cf_profile_end cf_profile_clear cf_profile_trace cf_profile_save_trace
+ */
+CF_API void CF_CALL cf_profile_clear();
+
+/**
+ * @function cf_profile_trace
+ * @category profile
+ * @brief    Returns everything recorded so far in the Chrome trace event JSON format.
+ * @return   Returns a dynamic string, free it with `sfree` when done.
+ * @remarks  Other threads may keep recording while this runs. Any of their events overwritten while the trace is being made are left
+ *           out. See `cf_profile_save_trace`.
+ * @related  cf_profile_clear cf_profile_trace cf_profile_save_trace
+ */
+CF_API char* CF_CALL cf_profile_trace();
+
+/**
+ * @function cf_profile_save_trace
+ * @category profile
+ * @brief    Saves everything recorded so far to a file in the Chrome trace event JSON format.
+ * @param    virtual_path  A path to the file in CF's virtual file system, see `cf_fs_set_write_directory`.
+ * @remarks  Open the file in [Perfetto](https://ui.perfetto.dev) or `chrome://tracing` to see a timeline of every recorded region, per
+ *           thread.
+ * @related  cf_profile_begin cf_profile_end cf_profile_clear cf_profile_trace cf_profile_save_trace
+ */
+CF_API CF_Result CF_CALL cf_profile_save_trace(const char* virtual_path);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+//--------------------------------------------------------------------------------------------------
+// C++ API
+
+#ifdef CF_CPP
+
+namespace Cute
+{
+
+// Records a profile region lasting until the end of the current scope, see `CF_PROFILE_SCOPE`.
+struct ProfileScope
+{
+	ProfileScope(const char* name) { cf_profile_begin(name); }
+	~ProfileScope() { cf_profile_end(); }
+};
+
+CF_INLINE void profile_begin(const char* name) { cf_profile_begin(name); }
+CF_INLINE void profile_end() { cf_profile_end(); }
+CF_INLINE void profile_clear() { cf_profile_clear(); }
+CF_INLINE char* profile_trace() { return cf_profile_trace(); }
+CF_INLINE CF_Result profile_save_trace(const char* virtual_path) { return cf_profile_save_trace(virtual_path); }
+
+}
+
+#define CF_PROFILE_TOKEN_PASTE_HELPER(X, Y) X ## Y
+#define CF_PROFILE_TOKEN_PASTE(X, Y) CF_PROFILE_TOKEN_PASTE_HELPER(X, Y)
+
+/**
+ * @function CF_PROFILE_SCOPE
+ * @category profile
+ * @brief    Records a named region from here until the end of the current scope.
+ * @param    name       The name of the region. Must be a string literal, or otherwise live until the trace is saved.
+ * @example > Profiling a function.
+ *     void update_enemies()
+ *     {
+ *         CF_PROFILE_SCOPE("update_enemies");
+ *         ...
+ *     }
+ * @remarks  C++ only, in C use `CF_PROFILE_BEGIN` and `CF_PROFILE_END`. Expands to nothing unless `CF_PROFILING` is defined.
+ * @related  CF_PROFILE_BEGIN CF_PROFILE_END CF_PROFILE_SCOPE
+ */
+#ifdef CF_PROFILING
+#	define CF_PROFILE_SCOPE(name) Cute::ProfileScope CF_PROFILE_TOKEN_PASTE(cf_profile_scope_, __LINE__)(name)
+#else
+#	define CF_PROFILE_SCOPE(name)
+#endif
+
+#endif // CF_CPP
+
+#endif // CF_PROFILE_H
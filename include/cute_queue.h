@@ -0,0 +1,210 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#ifndef CF_QUEUE_H
+#define CF_QUEUE_H
+
+#include "cute_defines.h"
+
+//--------------------------------------------------------------------------------------------------
+// C API
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @struct   CF_SPSCQueue
+ * @category multithreading
+ * @brief    An opaque fixed-size lock-free queue for passing items from exactly one producer thread to exactly one consumer thread.
+ * @remarks  Items are plain old data of a fixed size, copied in and out of the queue by value. The queue is a ring buffer with a read
+ *           index owned by the consumer and a write index owned by the producer, each on its own cache line, so the two threads never
+ *           take a lock and rarely even touch the same memory. Only one thread may push and only one thread may pop, for many threads
+ *           on either side use `CF_MPMCQueue` instead.
+ * @related  CF_SPSCQueue cf_make_spsc_queue cf_destroy_spsc_queue cf_spsc_queue_push cf_spsc_queue_pop CF_MPMCQueue
+ */
+typedef struct CF_SPSCQueue CF_SPSCQueue;
+// @end
+
+/**
+ * @struct   CF_MPMCQueue
+ * @category multithreading
+ * @brief    An opaque fixed-size lock-free queue which any number of threads can push to and pop from at once.
+ * @remarks  Items are plain old data of a fixed size, copied in and out of the queue by value. Each slot in the ring buffer carries a
+ *           sequence number telling whether it's ready to be written or read, so threads only ever contend on a single compare and swap
+ *           of the write or read index (a design by Dmitry Vyukov). Items pushed by any one thread are popped in the same order they
+ *           were pushed. When only one thread pushes and one thread pops, `CF_SPSCQueue` is faster.
+ * @related  CF_MPMCQueue cf_make_mpmc_queue cf_destroy_mpmc_queue cf_mpmc_queue_push cf_mpmc_queue_pop CF_SPSCQueue
+ */
+typedef struct CF_MPMCQueue CF_MPMCQueue;
+// @end
+
+/**
+ * @function cf_make_spsc_queue
+ * @category multithreading
+ * @brief    Returns a new single-producer single-consumer queue.
+ * @param    item_size    The size of each item in bytes.
+ * @param    capacity     The most items the queue can hold at once, rounded up to a power of two.
+ * @remarks  All memory is allocated up front, pushing and popping never allocate. Free it with `cf_destroy_spsc_queue`.
+ * @related  CF_SPSCQueue cf_make_spsc_queue cf_destroy_spsc_queue
+ */
+CF_API CF_SPSCQueue* CF_CALL cf_make_spsc_queue(int item_size, int capacity);
+
+/**
+ * @function cf_destroy_spsc_queue
+ * @category multithreading
+ * @brief    Frees a queue created by `cf_make_spsc_queue`.
+ * @param    queue        The queue. Passing `NULL` does nothing.
+ * @remarks  No other threads may be using the queue.
+ * @related  CF_SPSCQueue cf_make_spsc_queue cf_destroy_spsc_queue
+ */
+CF_API void CF_CALL cf_destroy_spsc_queue(CF_SPSCQueue* queue);
+
+/**
+ * @function cf_spsc_queue_push
+ * @category multithreading
+ * @brief    Copies an item onto the back of the queue.
+ * @param    queue        The queue.
+ * @param    item         Pointer to the item to copy in.
+ * @return   Returns false if the queue is full, in which case nothing is pushed.
+ * @remarks  Must only be called from the producer thread.
+ * @related  CF_SPSCQueue cf_spsc_queue_push cf_spsc_queue_pop cf_spsc_queue_count
+ */
+CF_API bool CF_CALL cf_spsc_queue_push(CF_SPSCQueue* queue, const void* item);
+
+/**
+ * @function cf_spsc_queue_pop
+ * @category multithreading
+ * @brief    Copies the item at the front of the queue out and removes it.
+ * @param    queue        The queue.
+ * @param    item         Where to copy the item to.
+ * @return   Returns false if the queue is empty, in which case `item` is left untouched.
+ * @remarks  Must only be called from the consumer thread.
+ * @related  CF_SPSCQueue cf_spsc_queue_push cf_spsc_queue_pop cf_spsc_queue_count
+ */
+CF_API bool CF_CALL cf_spsc_queue_pop(CF_SPSCQueue* queue, void* item);
+
+/**
+ * @function cf_spsc_queue_count
+ * @category multithreading
+ * @brief    Returns the number of items in the queue.
+ * @param    queue        The queue.
+ * @remarks  With other threads pushing or popping at the same time, this is only a snapshot which may already be out of date.
+ * @related  CF_SPSCQueue cf_spsc_queue_push cf_spsc_queue_pop cf_spsc_queue_count
+ */
+CF_API int CF_CALL cf_spsc_queue_count(const CF_SPSCQueue* queue);
+
+/**
+ * @function cf_make_mpmc_queue
+ * @category multithreading
+ * @brief    Returns a new multi-producer multi-consumer queue.
+ * @param    item_size    The size of each item in bytes.
+ * @param    capacity     The most items the queue can hold at once, rounded up to a power of two.
+ * @remarks  All memory is allocated up front, pushing and popping never allocate. Free it with `cf_destroy_mpmc_queue`.
+ * @related  CF_MPMCQueue cf_make_mpmc_queue cf_destroy_mpmc_queue
+ */
+CF_API CF_MPMCQueue* CF_CALL cf_make_mpmc_queue(int item_size, int capacity);
+
+/**
+ * @function cf_destroy_mpmc_queue
+ * @category multithreading
+ * @brief    Frees a queue created by `cf_make_mpmc_queue`.
+ * @param    queue        The queue. Passing `NULL` does nothing.
+ * @remarks  No other threads may be using the queue.
+ * @related  CF_MPMCQueue cf_make_mpmc_queue cf_destroy_mpmc_queue
+ */
+CF_API void CF_CALL cf_destroy_mpmc_queue(CF_MPMCQueue* queue);
+
+/**
+ * @function cf_mpmc_queue_push
+ * @category multithreading
+ * @brief    Copies an item onto the back of the queue.
+ * @param    queue        The queue.
+ * @param    item         Pointer to the item to copy in.
+ * @return   Returns false if the queue is full, in which case nothing is pushed.
+ * @remarks  Safe to call from any thread.
+ * @related  CF_MPMCQueue cf_mpmc_queue_push cf_mpmc_queue_pop cf_mpmc_queue_count
+ */
+CF_API bool CF_CALL cf_mpmc_queue_push(CF_MPMCQueue* queue, const void* item);
+
+/**
+ * @function cf_mpmc_queue_pop
+ * @category multithreading
+ * @brief    Copies the item at the front of the queue out and removes it.
+ * @param    queue        The queue.
+ * @param    item         Where to copy the item to.
+ * @return   Returns false if the queue is empty, in which case `item` is left untouched.
+ * @remarks  Safe to call from any thread.
+ * @related  CF_MPMCQueue cf_mpmc_queue_push cf_mpmc_queue_pop cf_mpmc_queue_count
+ */
+CF_API bool CF_CALL cf_mpmc_queue_pop(CF_MPMCQueue* queue, void* item);
+
+/**
+ * @function cf_mpmc_queue_count
+ * @category multithreading
+ * @brief    Returns the number of items in the queue.
+ * @param    queue        The queue.
+ * @remarks  With other threads pushing or popping at the same time, this is only a snapshot which may already be out of date.
+ * @related  CF_MPMCQueue cf_mpmc_queue_push cf_mpmc_queue_pop cf_mpmc_queue_count
+ */
+CF_API int CF_CALL cf_mpmc_queue_count(const CF_MPMCQueue* queue);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+//--------------------------------------------------------------------------------------------------
+// C++ API
+
+#ifdef CF_CPP
+
+namespace Cute
+{
+
+// A lock-free queue from one producer thread to one consumer thread, see `CF_SPSCQueue`.
+// Items are copied in and out by value, and must be plain old data.
+template <typename T>
+struct SPSCQueue
+{
+	SPSCQueue(int capacity) { m_queue = cf_make_spsc_queue(sizeof(T), capacity); }
+	SPSCQueue(const SPSCQueue<T>& other) = delete;
+	~SPSCQueue() { cf_destroy_spsc_queue(m_queue); }
+
+	bool push(const T& item) { return cf_spsc_queue_push(m_queue, &item); }
+	bool pop(T* out) { return cf_spsc_queue_pop(m_queue, out); }
+	int count() const { return cf_spsc_queue_count(m_queue); }
+
+	SPSCQueue<T>& operator=(const SPSCQueue<T>& rhs) = delete;
+
+private:
+	CF_SPSCQueue* m_queue;
+};
+
+// A lock-free queue any number of threads can push to and pop from, see `CF_MPMCQueue`.
+// Items are copied in and out by value, and must be plain old data.
+template <typename T>
+struct MPMCQueue
+{
+	MPMCQueue(int capacity) { m_queue = cf_make_mpmc_queue(sizeof(T), capacity); }
+	MPMCQueue(const MPMCQueue<T>& other) = delete;
+	~MPMCQueue() { cf_destroy_mpmc_queue(m_queue); }
+
+	bool push(const T& item) { return cf_mpmc_queue_push(m_queue, &item); }
+	bool pop(T* out) { return cf_mpmc_queue_pop(m_queue, out); }
+	int count() const { return cf_mpmc_queue_count(m_queue); }
+
+	MPMCQueue<T>& operator=(const MPMCQueue<T>& rhs) = delete;
+
+private:
+	CF_MPMCQueue* m_queue;
+};
+
+}
+
+#endif // CF_CPP
+
+#endif // CF_QUEUE_H
@@ -14,6 +14,7 @@
 #include "cute_hashtable.h"
 #include "cute_array.h"
 #include "cute_math.h"
+#include "cute_result.h"
 
 #include <inttypes.h>
 #include <stdarg.h>
@@ -734,11 +735,39 @@ extern "C" {
  *     }
  * @remarks  You can use this function in a loop to decode one codepoint at a time, where each codepoint
  *           represents a single UTF8 character. If the decoded codepoint is invalid then the "replacement character"
- *           0xFFFD will be recorded instead.
- * @related  sappend_UTF8 cf_decode_UTF8 cf_decode_UTF16
+ *           0xFFFD will be recorded instead. To decode long strings use `cf_decode_UTF8_bulk` instead.
+ * @related  sappend_UTF8 cf_decode_UTF8 cf_decode_UTF8_bulk cf_decode_UTF16
  */
 CF_API const char* CF_CALL cf_decode_UTF8(const char* s, int* codepoint);
 
+/**
+ * @function cf_decode_UTF8_bulk
+ * @category string
+ * @brief    Decodes a run of UTF8 text into an array of UTF32 codepoints.
+ * @param    s            The string.
+ * @param    byte_count   The number of bytes of `s` to decode, or -1 to decode up to the nul-terminator.
+ * @param    codepoints   Array to write the decoded codepoints into.
+ * @param    capacity     The maximum number of codepoints to write into `codepoints`.
+ * @param    count        Written with the number of codepoints decoded.
+ * @return   Returns a pointer just past the last decoded byte. If this isn't `s + byte_count` then `codepoints`
+ *           ran out of space, and you may call this function again to continue decoding from here.
+ * @example > Decoding a UTF8 string in chunks.
+ *     int cps[256];
+ *     int count;
+ *     const char* tmp = my_string;
+ *     const char* end = my_string + CF_STRLEN(my_string);
+ *     while (tmp < end) {
+ *         tmp = cf_decode_UTF8_bulk(tmp, (int)(end - tmp), cps, 256, &count);
+ *         DoSomethingWithCodepoints(cps, count);
+ *     }
+ * @remarks  This produces the same codepoints as calling `cf_decode_UTF8` in a loop, including 0xFFFD for invalid
+ *           characters, but is much faster for long strings. Runs of ASCII characters are converted 16 bytes at a time
+ *           with SIMD instructions where available. Unlike `cf_decode_UTF8` this function never reads past the end of
+ *           the given bytes, even if the text ends part way through a character.
+ * @related  cf_decode_UTF8 cf_decode_UTF8_bulk cf_decode_UTF16
+ */
+CF_API const char* CF_CALL cf_decode_UTF8_bulk(const char* s, int byte_count, int* codepoints, int capacity, int* count);
+
 /**
  * @function cf_decode_UTF16
  * @category string
@@ -778,6 +807,180 @@ CF_API const char* CF_CALL cf_decode_UTF8(const char* s, int* codepoint);
  */
 CF_API const uint16_t* CF_CALL cf_decode_UTF16(const uint16_t* s, int* codepoint);
 
+//--------------------------------------------------------------------------------------------------
+// Frame-scoped formatting.
+
+/**
+ * @function cf_frame_sfmt
+ * @category string
+ * @brief    Printf's into a temporary string that lives until the end of the current frame.
+ * @param    fmt          The format string.
+ * @param    ...          The format arguments.
+ * @return   Returns a nul-terminated string allocated with `cf_frame_alloc`.
+ * @example > Formatting some text to draw this frame, without any free.
+ *     cf_draw_text(cf_frame_sfmt("Score: %d", score), cf_v2(0, 0), -1);
+ * @remarks  The returned string is a plain C-string, *not* a dynamic string -- do not pass it to `sfree` or any of the
+ *           other `s*` functions that may grow the string. It is recycled along with the rest of the frame memory, see
+ *           `cf_frame_reset`.
+ * @related  cf_frame_sfmt cf_frame_alloc sfmt
+ */
+CF_API char* CF_CALL cf_frame_sfmt(const char* fmt, ...);
+
+//--------------------------------------------------------------------------------------------------
+// String builder.
+
+typedef struct CF_File CF_File;
+
+/**
+ * @struct   CF_StringBuilder
+ * @category string
+ * @brief    An opaque string builder for efficiently assembling large amounts of text.
+ * @remarks  Text is appended into a chain of fixed-size chunks, so appending never reallocates or copies what was written before,
+ *           unlike growing a single dynamic string with `sappend` or `sfmt_append`. When done, the text can be written straight out
+ *           to a file with `cf_string_builder_write`, or flattened into one contiguous string with `cf_string_builder_c_str`.
+ *           Chunks are kept around after `cf_string_builder_clear` to be reused, which makes a builder ideal for text rebuilt every frame.
+ * @related  CF_StringBuilder cf_make_string_builder cf_destroy_string_builder cf_string_builder_append cf_string_builder_fmt cf_string_builder_c_str
+ */
+typedef struct CF_StringBuilder CF_StringBuilder;
+// @end
+
+/**
+ * @function cf_make_string_builder
+ * @category string
+ * @brief    Returns a new string builder.
+ * @param    chunk_size   The size of each chunk of text in bytes. Pass zero for a sensible default.
+ * @remarks  Free it with `cf_destroy_string_builder` when done.
+ * @related  CF_StringBuilder cf_make_string_builder cf_destroy_string_builder
+ */
+CF_API CF_StringBuilder* CF_CALL cf_make_string_builder(int chunk_size);
+
+/**
+ * @function cf_destroy_string_builder
+ * @category string
+ * @brief    Frees a string builder made by `cf_make_string_builder`.
+ * @param    sb           The string builder.
+ * @remarks  Any pointers returned by `cf_string_builder_c_str` are invalidated.
+ * @related  CF_StringBuilder cf_make_string_builder cf_destroy_string_builder
+ */
+CF_API void CF_CALL cf_destroy_string_builder(CF_StringBuilder* sb);
+
+/**
+ * @function cf_string_builder_append
+ * @category string
+ * @brief    Appends a string onto the end of the builder.
+ * @param    sb           The string builder.
+ * @param    s            The string to append. Can be `NULL`.
+ * @related  CF_StringBuilder cf_string_builder_append cf_string_builder_append_range cf_string_builder_push cf_string_builder_fmt
+ */
+CF_API void CF_CALL cf_string_builder_append(CF_StringBuilder* sb, const char* s);
+
+/**
+ * @function cf_string_builder_append_range
+ * @category string
+ * @brief    Appends the range of characters `[start, end)` onto the end of the builder.
+ * @param    sb           The string builder.
+ * @param    start        The first character to append.
+ * @param    end          One past the last character to append.
+ * @related  CF_StringBuilder cf_string_builder_append cf_string_builder_append_range cf_string_builder_push cf_string_builder_fmt
+ */
+CF_API void CF_CALL cf_string_builder_append_range(CF_StringBuilder* sb, const char* start, const char* end);
+
+/**
+ * @function cf_string_builder_push
+ * @category string
+ * @brief    Appends a single character onto the end of the builder.
+ * @param    sb           The string builder.
+ * @param    ch           The character.
+ * @related  CF_StringBuilder cf_string_builder_append cf_string_builder_append_range cf_string_builder_push cf_string_builder_fmt
+ */
+CF_API void CF_CALL cf_string_builder_push(CF_StringBuilder* sb, char ch);
+
+/**
+ * @function cf_string_builder_fmt
+ * @category string
+ * @brief    Printf's onto the end of the builder.
+ * @param    sb           The string builder.
+ * @param    fmt          The format string.
+ * @param    ...          The format arguments.
+ * @remarks  Formats directly into the current chunk whenever the result fits.
+ * @related  CF_StringBuilder cf_string_builder_append cf_string_builder_fmt cf_string_builder_vfmt
+ */
+CF_API void CF_CALL cf_string_builder_fmt(CF_StringBuilder* sb, const char* fmt, ...);
+
+/**
+ * @function cf_string_builder_vfmt
+ * @category string
+ * @brief    Printf's onto the end of the builder, with a `va_list` of arguments.
+ * @param    sb           The string builder.
+ * @param    fmt          The format string.
+ * @param    args         The format arguments.
+ * @related  CF_StringBuilder cf_string_builder_append cf_string_builder_fmt cf_string_builder_vfmt
+ */
+CF_API void CF_CALL cf_string_builder_vfmt(CF_StringBuilder* sb, const char* fmt, va_list args);
+
+/**
+ * @function cf_string_builder_join
+ * @category string
+ * @brief    Moves all of the text in `src` onto the end of `sb`, without copying any of it.
+ * @param    sb           The string builder to append onto.
+ * @param    src          The string builder to take the text from. It's left empty afterwards.
+ * @remarks  The chunks of `src` are spliced onto the end of `sb`, which is useful to assemble text built separately, such as on other threads.
+ *           Both builders must have been made with the same chunk size.
+ * @related  CF_StringBuilder cf_string_builder_append cf_string_builder_join cf_string_builder_c_str
+ */
+CF_API void CF_CALL cf_string_builder_join(CF_StringBuilder* sb, CF_StringBuilder* src);
+
+/**
+ * @function cf_string_builder_len
+ * @category string
+ * @brief    Returns the number of characters in the builder, not counting a nul-terminator.
+ * @param    sb           The string builder.
+ * @related  CF_StringBuilder cf_string_builder_len cf_string_builder_clear
+ */
+CF_API int CF_CALL cf_string_builder_len(const CF_StringBuilder* sb);
+
+/**
+ * @function cf_string_builder_clear
+ * @category string
+ * @brief    Empties the builder, keeping its chunks around for reuse.
+ * @param    sb           The string builder.
+ * @related  CF_StringBuilder cf_string_builder_len cf_string_builder_clear
+ */
+CF_API void CF_CALL cf_string_builder_clear(CF_StringBuilder* sb);
+
+/**
+ * @function cf_string_builder_c_str
+ * @category string
+ * @brief    Returns all of the builder's text as a single nul-terminated string.
+ * @param    sb           The string builder.
+ * @remarks  If all the text fits within one chunk it's returned in-place without any copying. Otherwise the chunks are flattened into one
+ *           allocation. The string is owned by the builder, and is valid until the builder is next modified or destroyed. To get a copy
+ *           as a dynamic string use `cf_string_builder_to_string`.
+ * @related  CF_StringBuilder cf_string_builder_c_str cf_string_builder_to_string cf_string_builder_write
+ */
+CF_API const char* CF_CALL cf_string_builder_c_str(CF_StringBuilder* sb);
+
+/**
+ * @function cf_string_builder_to_string
+ * @category string
+ * @brief    Returns a copy of the builder's text as a new dynamic string.
+ * @param    sb           The string builder.
+ * @remarks  Free the string with `sfree` when done.
+ * @related  CF_StringBuilder cf_string_builder_c_str cf_string_builder_to_string cf_string_builder_write
+ */
+CF_API char* CF_CALL cf_string_builder_to_string(const CF_StringBuilder* sb);
+
+/**
+ * @function cf_string_builder_write
+ * @category string
+ * @brief    Writes all of the builder's text to a file, one chunk at a time.
+ * @param    sb           The string builder.
+ * @param    file         A file opened with `cf_fs_open_file_for_write`.
+ * @remarks  No nul-terminator is written, and the text is never flattened into one contiguous string.
+ * @related  CF_StringBuilder cf_string_builder_c_str cf_string_builder_to_string cf_string_builder_write
+ */
+CF_API CF_Result CF_CALL cf_string_builder_write(const CF_StringBuilder* sb, CF_File* file);
+
 //--------------------------------------------------------------------------------------------------
 // String Intering C API (global string table).
 // ^      ^
@@ -796,6 +999,7 @@ CF_API const uint16_t* CF_CALL cf_decode_UTF16(const uint16_t* s, int* codepoint
  *           - You can simply compare pointers for equality, as opposed to comparing the string contents, as long as both strings came from this function.
  *           - You may optionally call `sinuke` to free all resources used by the global string table.
  *           - This function is very fast if the string was already stored previously.
+ *           - It's safe to call from many threads at once. Looking up previously stored strings never takes a lock.
  * @related  sintern sintern_range sivalid silen sinuke
  */
 #define sintern(s) cf_sintern(s)
@@ -844,7 +1048,7 @@ CF_API const uint16_t* CF_CALL cf_decode_UTF16(const uint16_t* s, int* codepoint
  * @function sinuke
  * @category string
  * @brief    Frees up all resources used by the global string table built by `sintern`.
- * @remarks  All strings previously returned by `sintern` are now invalid.
+ * @remarks  All strings previously returned by `sintern` are now invalid. No other threads may be calling `sintern` at the same time.
  * @related  sintern sintern_range sivalid silen sinuke
  */
 #define sinuke() cf_sinuke()
@@ -991,109 +1195,129 @@ CF_INLINE uint64_t constexpr fnv1a(const void* data, int size)
 
 /**
  * General purpose string class.
- * Each string is stored in its own buffer internally.
- * 8 byte stack size.
+ * Short strings (up to 22 characters) are stored inline without any allocation, longer strings spill over onto the heap.
+ * Either way `c_str()` is a valid dynamic string for the C API (`slen`, `sfind`, etc.).
+ * 64 byte stack size.
  */
+#define CF_STRING_INLINE_SIZE 23
+
+// Wraps a call into the C API which may reallocate the string, moving from the inline buffer to the heap as needed.
+#define CF_STRING_WRITE(...) do { char* str = s_write(); __VA_ARGS__; s_commit(str); } while (0)
+
 struct String
 {
 	CF_INLINE String() { }
-	CF_INLINE String(const char* s) { sset(m_str, s); }
-	CF_INLINE String(const char* start, const char* end) { int length = (int)(end - start); sfit(m_str, length); CF_STRNCPY(m_str, start, length); CF_AHDR(m_str)->size = length + 1; }
-	CF_INLINE String(const String& s) { sset(m_str, s); }
-	CF_INLINE String(String&& s) {  m_str = s.m_str; s.m_str = NULL; }
-	CF_INLINE String(int i) { sint(m_str, i); }
-	CF_INLINE String(uint32_t i) { suint(m_str, i); }
-	CF_INLINE String(int64_t uint) { sint(m_str, uint); }
-	CF_INLINE String(uint64_t uint) { suint(m_str, uint); }
-	CF_INLINE String(float f) { sfloat(m_str, f); }
-	CF_INLINE String(double f) { sfloat(m_str, f); }
-	CF_INLINE String(bool b) { sbool(m_str, b); }
-	CF_INLINE ~String() { sfree(m_str); m_str = NULL; }
+	CF_INLINE String(const char* s) { CF_STRING_WRITE(sset(str, s)); }
+	CF_INLINE String(const char* start, const char* end) { int length = (int)(end - start); CF_STRING_WRITE(sfit(str, length + 1); CF_STRNCPY(str, start, length); CF_AHDR(str)->size = length + 1; str[length] = 0); }
+	CF_INLINE String(const String& s) { CF_STRING_WRITE(sset(str, s.s_ptr())); }
+	CF_INLINE String(String&& s) { s_move(s); }
+	CF_INLINE String(int i) { CF_STRING_WRITE(sint(str, i)); }
+	CF_INLINE String(uint32_t i) { CF_STRING_WRITE(suint(str, i)); }
+	CF_INLINE String(int64_t uint) { CF_STRING_WRITE(sint(str, uint)); }
+	CF_INLINE String(uint64_t uint) { CF_STRING_WRITE(suint(str, uint)); }
+	CF_INLINE String(float f) { CF_STRING_WRITE(sfloat(str, f)); }
+	CF_INLINE String(double f) { CF_STRING_WRITE(sfloat(str, f)); }
+	CF_INLINE String(bool b) { CF_STRING_WRITE(sbool(str, b)); }
+	CF_INLINE ~String() { sfree(m_str); m_str = NULL; m_inline = false; }
 
 	CF_INLINE static String steal_from(char* cute_c_api_string) { CF_ACANARY(cute_c_api_string); String r; r.m_str = cute_c_api_string; return r; }
-	CF_INLINE char* steal() { char* result = m_str; m_str = NULL; return result; }
-	CF_INLINE static String from_hex(uint64_t uint) { String r; shex(r.m_str, uint); return r; }
-
-	CF_INLINE int to_int() const { return stoint(m_str); }
-	CF_INLINE uint64_t to_uint() const { return stouint(m_str); }
-	CF_INLINE float to_float() const { return stofloat(m_str); }
-	CF_INLINE double to_double() const { return stodouble(m_str); }
-	CF_INLINE uint64_t to_hex() const { return stohex(m_str); }
-	CF_INLINE bool to_bool() const { return stobool(m_str); }
-
-	CF_INLINE const char* c_str() const { return m_str; }
-	CF_INLINE char* c_str() { return m_str; }
-	CF_INLINE const char* begin() const { return m_str; }
-	CF_INLINE char* begin() { return m_str; }
-	CF_INLINE const char* end() const { return m_str + scount(m_str); }
-	CF_INLINE char* end() { return m_str + scount(m_str); }
-	CF_INLINE char last() const { return slast(m_str); }
-	CF_INLINE char first() const { return sfirst(m_str); }
-	CF_INLINE operator const char*() const { return m_str; }
-	CF_INLINE operator char*() const { return m_str; }
-
-	CF_INLINE char& operator[](int index) { s_chki(index); return m_str[index]; }
-	CF_INLINE const char& operator[](int index) const { s_chki(index); return m_str[index]; }
-
-	CF_INLINE int len() const { return slen(m_str); }
-	CF_INLINE int capacity() const { return scap(m_str); }
-	CF_INLINE int size() const { return scount(m_str); }
-	CF_INLINE int count() const { return scount(m_str); }
-	CF_INLINE void ensure_capacity(int capacity) { sfit(m_str, capacity); }
-	CF_INLINE void fit(int capacity) { sfit(m_str, capacity); }
-	CF_INLINE void set_len(int len) { sfit(m_str, len + 1); cf_array_len(m_str) = len + 1; m_str[len] = 0; }
-	CF_INLINE bool empty() const { return sempty(m_str); }
-
-	CF_INLINE String& add(char ch) { spush(m_str, ch); return *this; }
-	CF_INLINE String& append(const char* s) { sappend(m_str, s); return *this; }
-	CF_INLINE String& append(const char* start, const char* end) { sappend_range(m_str, start, end); return *this; }
-	CF_INLINE String& append(int codepoint) { sappend_UTF8(m_str, codepoint); return *this; }
-	static CF_INLINE String fmt(const char* fmt, ...) { String result; va_list args; va_start(args, fmt); svfmt(result.m_str, fmt, args); va_end(args); return result; }
-	CF_INLINE String& fmt_append(const char* fmt, ...) { va_list args; va_start(args, fmt); svfmt_append(m_str, fmt, args); va_end(args); return *this; }
-	CF_INLINE String& trim() { strim(m_str); return *this; }
-	CF_INLINE String& ltrim() { sltrim(m_str); return *this; }
-	CF_INLINE String& rtrim() { srtrim(m_str); return *this; }
-	CF_INLINE String& lpad(char pad, int count) { slpad(m_str, pad, count); return *this; }
-	CF_INLINE String& rpad(char pad, int count) { srpad(m_str, pad, count); return *this; }
-	CF_INLINE String& dedup(char ch) { sdedup(m_str, ch); return *this; }
-	CF_INLINE String& set(const char* s) { sset(m_str, s); return *this; }
-	CF_INLINE String& operator=(const char* s) { sset(m_str, s); return *this; }
-	CF_INLINE String& operator=(const String& s) { sset(m_str, s); return *this; }
-	CF_INLINE String& operator=(String&& s) { m_str = s.m_str; s.m_str = NULL; return *this; }
-	CF_INLINE Array<String> split(char split_c) { Array<String> r; char** s = ssplit(m_str, split_c); for (int i=0;i<alen(s);++i) r.add(cf_move(steal_from(s[i]))); afree(s); return r; }
+	CF_INLINE char* steal() { char* result = m_inline ? sdup(s_ptr()) : m_str; m_str = NULL; m_inline = false; return result; }
+	CF_INLINE static String from_hex(uint64_t uint) { String r; char* str = r.s_write(); shex(str, uint); r.s_commit(str); return r; }
+
+	CF_INLINE int to_int() const { return stoint(s_ptr()); }
+	CF_INLINE uint64_t to_uint() const { return stouint(s_ptr()); }
+	CF_INLINE float to_float() const { return stofloat(s_ptr()); }
+	CF_INLINE double to_double() const { return stodouble(s_ptr()); }
+	CF_INLINE uint64_t to_hex() const { return stohex(s_ptr()); }
+	CF_INLINE bool to_bool() const { return stobool(s_ptr()); }
+
+	CF_INLINE const char* c_str() const { return s_ptr(); }
+	CF_INLINE char* c_str() { return s_ptr(); }
+	CF_INLINE const char* begin() const { return s_ptr(); }
+	CF_INLINE char* begin() { return s_ptr(); }
+	CF_INLINE const char* end() const { return s_ptr() + scount(s_ptr()); }
+	CF_INLINE char* end() { return s_ptr() + scount(s_ptr()); }
+	CF_INLINE char last() const { return slast(s_ptr()); }
+	CF_INLINE char first() const { return sfirst(s_ptr()); }
+	CF_INLINE operator const char*() const { return s_ptr(); }
+	CF_INLINE operator char*() const { return s_ptr(); }
+
+	CF_INLINE char& operator[](int index) { s_chki(index); return s_ptr()[index]; }
+	CF_INLINE const char& operator[](int index) const { s_chki(index); return s_ptr()[index]; }
+
+	CF_INLINE int len() const { return slen(s_ptr()); }
+	CF_INLINE int capacity() const { return scap(s_ptr()); }
+	CF_INLINE int size() const { return scount(s_ptr()); }
+	CF_INLINE int count() const { return scount(s_ptr()); }
+	CF_INLINE void ensure_capacity(int capacity) { CF_STRING_WRITE(sfit(str, capacity)); }
+	CF_INLINE void fit(int capacity) { CF_STRING_WRITE(sfit(str, capacity)); }
+	CF_INLINE void set_len(int len) { CF_STRING_WRITE(sfit(str, len + 1); cf_array_len(str) = len + 1; str[len] = 0); }
+	CF_INLINE bool empty() const { return sempty(s_ptr()); }
+	CF_INLINE bool is_inline() const { return m_inline; }
+
+	CF_INLINE String& add(char ch) { CF_STRING_WRITE(spush(str, ch)); return *this; }
+	CF_INLINE String& append(const char* s) { CF_STRING_WRITE(sappend(str, s)); return *this; }
+	CF_INLINE String& append(const char* start, const char* end) { CF_STRING_WRITE(sappend_range(str, start, end)); return *this; }
+	CF_INLINE String& append(int codepoint) { CF_STRING_WRITE(sappend_UTF8(str, codepoint)); return *this; }
+	static CF_INLINE String fmt(const char* fmt, ...) { String result; va_list args; va_start(args, fmt); char* str = result.s_write(); svfmt(str, fmt, args); result.s_commit(str); va_end(args); return result; }
+	CF_INLINE String& fmt_append(const char* fmt, ...) { va_list args; va_start(args, fmt); CF_STRING_WRITE(svfmt_append(str, fmt, args)); va_end(args); return *this; }
+	CF_INLINE String& trim() { CF_STRING_WRITE(strim(str)); return *this; }
+	CF_INLINE String& ltrim() { CF_STRING_WRITE(sltrim(str)); return *this; }
+	CF_INLINE String& rtrim() { CF_STRING_WRITE(srtrim(str)); return *this; }
+	CF_INLINE String& lpad(char pad, int count) { CF_STRING_WRITE(slpad(str, pad, count)); return *this; }
+	CF_INLINE String& rpad(char pad, int count) { CF_STRING_WRITE(srpad(str, pad, count)); return *this; }
+	CF_INLINE String& dedup(char ch) { CF_STRING_WRITE(sdedup(str, ch)); return *this; }
+	CF_INLINE String& set(const char* s) { CF_STRING_WRITE(sset(str, s)); return *this; }
+	CF_INLINE String& operator=(const char* s) { CF_STRING_WRITE(sset(str, s)); return *this; }
+	CF_INLINE String& operator=(const String& s) { if (this != &s) CF_STRING_WRITE(sset(str, s.s_ptr())); return *this; }
+	CF_INLINE String& operator=(String&& s) { if (this != &s) { sfree(m_str); s_move(s); } return *this; }
+	CF_INLINE Array<String> split(char split_c) { Array<String> r; char** s = ssplit(s_ptr(), split_c); for (int i=0;i<alen(s);++i) r.add(cf_move(steal_from(s[i]))); afree(s); return r; }
 	static CF_INLINE Array<String> split(const char* split_me, char split_c) { Array<String> r; char** s = ssplit(split_me, split_c); for (int i=0;i<alen(s);++i) r.add(cf_move(steal_from(s[i]))); afree(s); return r; }
-	CF_INLINE char pop() { char result = slast(m_str); spop(m_str); return result; }
-	CF_INLINE char pop(int n) { char result = slast(m_str); spopn(m_str, n); return result; }
-	CF_INLINE char popn(int n) { char result = slast(m_str); spopn(m_str, n); return result; }
-	CF_INLINE int first_index_of(char ch) const { return sfirst_index_of(m_str, ch); }
-	CF_INLINE int last_index_of(char ch) const { return slast_index_of(m_str, ch); }
-	CF_INLINE int first_index_of(char ch, int offset) const { return sfirst_index_of(m_str + offset, ch); }
-	CF_INLINE int last_index_of(char ch, int offset) const { return slast_index_of(m_str + offset, ch); }
-	CF_INLINE int find(const char* find_me) const { const char* ptr = sfind(m_str, find_me); return (int)(ptr ? ptr - m_str : -1); }
-	CF_INLINE String& replace(const char* replace_me, const char* with_me) { sreplace(m_str, replace_me, with_me); return *this; }
-	CF_INLINE String& erase(int index, int count) { serase(m_str, index, count); return *this; }
-	CF_INLINE String dup() const { return steal_from(sdup(m_str)); }
-	CF_INLINE void clear() { sclear(m_str); }
+	CF_INLINE char pop() { char result = slast(s_ptr()); CF_STRING_WRITE(spop(str)); return result; }
+	CF_INLINE char pop(int n) { char result = slast(s_ptr()); CF_STRING_WRITE(spopn(str, n)); return result; }
+	CF_INLINE char popn(int n) { char result = slast(s_ptr()); CF_STRING_WRITE(spopn(str, n)); return result; }
+	CF_INLINE int first_index_of(char ch) const { return sfirst_index_of(s_ptr(), ch); }
+	CF_INLINE int last_index_of(char ch) const { return slast_index_of(s_ptr(), ch); }
+	CF_INLINE int first_index_of(char ch, int offset) const { return sfirst_index_of(s_ptr() + offset, ch); }
+	CF_INLINE int last_index_of(char ch, int offset) const { return slast_index_of(s_ptr() + offset, ch); }
+	CF_INLINE int find(const char* find_me) const { const char* ptr = sfind(s_ptr(), find_me); return (int)(ptr ? ptr - s_ptr() : -1); }
+	CF_INLINE String& replace(const char* replace_me, const char* with_me) { CF_STRING_WRITE(sreplace(str, replace_me, with_me)); return *this; }
+	CF_INLINE String& erase(int index, int count) { CF_STRING_WRITE(serase(str, index, count)); return *this; }
+	CF_INLINE String dup() const { return String(*this); }
+	CF_INLINE void clear() { if (s_ptr()) CF_STRING_WRITE(sclear(str)); }
 	
-	CF_INLINE bool starts_with(const char* s) const { return sprefix(m_str, s); }
-	CF_INLINE bool begins_with(const char* s) const { return sprefix(m_str, s); }
-	CF_INLINE bool ends_with(const char* s) const { return ssuffix(m_str, s); }
-	CF_INLINE bool prefix(const char* s) const { return sprefix(m_str, s); }
-	CF_INLINE bool suffix(const char* s) const { return ssuffix(m_str, s); }
-	CF_INLINE bool operator==(const char* s) { return !CF_STRCMP(m_str, s); }
-	CF_INLINE bool operator!=(const char* s) { return CF_STRCMP(m_str, s); }
-	CF_INLINE bool compare(const char* s, bool no_case = false) { return no_case ? sequ(m_str, s) : siequ(m_str, s); }
+	CF_INLINE bool starts_with(const char* s) const { return sprefix(s_ptr(), s); }
+	CF_INLINE bool begins_with(const char* s) const { return sprefix(s_ptr(), s); }
+	CF_INLINE bool ends_with(const char* s) const { return ssuffix(s_ptr(), s); }
+	CF_INLINE bool prefix(const char* s) const { return sprefix(s_ptr(), s); }
+	CF_INLINE bool suffix(const char* s) const { return ssuffix(s_ptr(), s); }
+	CF_INLINE bool operator==(const char* s) { return !CF_STRCMP(s_ptr(), s); }
+	CF_INLINE bool operator!=(const char* s) { return CF_STRCMP(s_ptr(), s); }
+	CF_INLINE bool compare(const char* s, bool no_case = false) { return no_case ? sequ(s_ptr(), s) : siequ(s_ptr(), s); }
 	CF_INLINE bool cmp(const char* s, bool no_case = false) { return compare(s, no_case); }
-	CF_INLINE bool contains(const char* contains_me) { return scontains(m_str, contains_me); }
-	CF_INLINE String& to_upper() { stoupper(m_str); return *this; }
-	CF_INLINE String& to_lower() { stolower(m_str); return *this; }
-	CF_INLINE uint64_t hash() const { return shash(m_str); }
+	CF_INLINE bool contains(const char* contains_me) { return scontains(s_ptr(), contains_me); }
+	CF_INLINE String& to_upper() { stoupper(s_ptr()); return *this; }
+	CF_INLINE String& to_lower() { stolower(s_ptr()); return *this; }
+	CF_INLINE uint64_t hash() const { return shash(s_ptr()); }
 
 private:
+	// Heap allocated dynamic string, or NULL while the string lives in `m_buffer` (or was never written to).
 	sdyna char* m_str = NULL;
-	CF_INLINE void s_chki(int i) const { CF_ASSERT(i >= 0 && i < scount(m_str)); }
+	// Holds a `CF_Ahdr` followed by the characters, setup with `astatic` so the C API can operate on it directly.
+	// Only pointers relative to `this` are kept, never pointers into `m_buffer` itself, so Strings may be memcpy'd
+	// around (for example as items within a `Map`).
+	alignas(CF_Ahdr) char m_buffer[sizeof(CF_Ahdr) + CF_STRING_INLINE_SIZE];
+	bool m_inline = false;
+
+	CF_INLINE char* s_ptr() const { return m_inline ? (char*)(m_buffer + sizeof(CF_Ahdr)) : m_str; }
+	CF_INLINE char* s_write() { if (!m_str && !m_inline) { char* str; astatic(str, m_buffer, sizeof(m_buffer)); apush(str, 0); m_inline = true; } return s_ptr(); }
+	CF_INLINE void s_commit(char* str) { if (!m_inline || str != s_ptr()) { m_inline = false; m_str = str; } }
+	CF_INLINE void s_move(String& s) { m_str = s.m_str; m_inline = s.m_inline; if (m_inline) { CF_MEMCPY(m_buffer, s.m_buffer, sizeof(CF_Ahdr) + scount(s.s_ptr())); CF_AHDR(s_ptr())->data = s_ptr(); } s.m_str = NULL; s.m_inline = false; }
+	CF_INLINE void s_chki(int i) const { CF_ASSERT(i >= 0 && i < scount(s_ptr())); }
 };
 
+#undef CF_STRING_WRITE
+
 CF_INLINE char* operator+(const String& a, int i) { return (char*)a.c_str() + i; }
 CF_INLINE String operator+(const String& a, const String& b) { String result = a; result.append(b); return result; }
 CF_INLINE String to_string(const char* s) { return String(s); }
@@ -1103,6 +1327,37 @@ CF_INLINE String to_string(float f) { return String(f); }
 CF_INLINE String to_string(double f) { return String(f); }
 CF_INLINE String to_string(bool b) { return String(b); }
 
+// Assembles large amounts of text in chunks, without ever reallocating, see `CF_StringBuilder`.
+struct StringBuilder
+{
+	CF_INLINE StringBuilder(int chunk_size = 0) { m_sb = cf_make_string_builder(chunk_size); }
+	CF_INLINE StringBuilder(StringBuilder&& other) { m_sb = other.m_sb; other.m_sb = NULL; }
+	CF_INLINE StringBuilder(const StringBuilder& other) = delete;
+	CF_INLINE ~StringBuilder() { cf_destroy_string_builder(m_sb); }
+
+	CF_INLINE StringBuilder& add(char ch) { cf_string_builder_push(m_sb, ch); return *this; }
+	CF_INLINE StringBuilder& append(const char* s) { cf_string_builder_append(m_sb, s); return *this; }
+	CF_INLINE StringBuilder& append(const char* start, const char* end) { cf_string_builder_append_range(m_sb, start, end); return *this; }
+	CF_INLINE StringBuilder& fmt(const char* fmt, ...) { va_list args; va_start(args, fmt); cf_string_builder_vfmt(m_sb, fmt, args); va_end(args); return *this; }
+	CF_INLINE StringBuilder& join(StringBuilder& src) { cf_string_builder_join(m_sb, src.m_sb); return *this; }
+	CF_INLINE StringBuilder& operator+=(const char* s) { return append(s); }
+	CF_INLINE StringBuilder& operator+=(char ch) { return add(ch); }
+
+	CF_INLINE int len() const { return cf_string_builder_len(m_sb); }
+	CF_INLINE int size() const { return len(); }
+	CF_INLINE bool empty() const { return len() == 0; }
+	CF_INLINE void clear() { cf_string_builder_clear(m_sb); }
+	CF_INLINE const char* c_str() { return cf_string_builder_c_str(m_sb); }
+	CF_INLINE String to_string() const { return String::steal_from(cf_string_builder_to_string(m_sb)); }
+	CF_INLINE CF_Result write(CF_File* file) const { return cf_string_builder_write(m_sb, file); }
+
+	CF_INLINE StringBuilder& operator=(StringBuilder&& other) { cf_destroy_string_builder(m_sb); m_sb = other.m_sb; other.m_sb = NULL; return *this; }
+	CF_INLINE StringBuilder& operator=(const StringBuilder& other) = delete;
+
+private:
+	CF_StringBuilder* m_sb;
+};
+
 /**
  * UTF8 decoder. Load it up with a string and read `.codepoint`. Call `next` to fetch the
  * next codepoint.
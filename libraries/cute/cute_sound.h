@@ -448,6 +448,14 @@ void cs_set_global_user_allocator_context(void* user_allocator_context);
 	#define CUTE_SOUND_FREE(mem, ctx) free(mem)
 #endif
 
+#ifndef CUTE_SOUND_PROFILE_BEGIN
+#	define CUTE_SOUND_PROFILE_BEGIN(name)
+#endif
+
+#ifndef CUTE_SOUND_PROFILE_END
+#	define CUTE_SOUND_PROFILE_END()
+#endif
+
 #ifndef CUTE_SOUND_MEMCPY
 #	include <string.h>
 #	define CUTE_SOUND_MEMCPY memcpy
@@ -2232,6 +2240,7 @@ void cs_mix()
 	int samples_needed;
 	int write_offset = 0;
 
+	CUTE_SOUND_PROFILE_BEGIN("cs_mix");
 	cs_lock();
 
 #if CUTE_SOUND_PLATFORM == CUTE_SOUND_WINDOWS
@@ -2559,6 +2568,7 @@ void cs_mix()
 
 	unlock:
 	cs_unlock();
+	CUTE_SOUND_PROFILE_END();
 }
 
 void cs_spawn_mix_thread()
@@ -11,13 +11,44 @@
 #	include <crtdbg.h>
 #endif
 #include <stdlib.h>
+#include <stdio.h>
+#include <atomic>
+
+#if defined(_WIN32)
+#	ifndef WIN32_LEAN_AND_MEAN
+#		define WIN32_LEAN_AND_MEAN
+#	endif
+#	ifndef NOMINMAX
+#		define NOMINMAX
+#	endif
+#	include <windows.h>
+#elif !defined(__EMSCRIPTEN__)
+#	include <sys/mman.h>
+#	include <unistd.h>
+#endif
 
 #include <cute_alloc.h>
 #include <cute_c_runtime.h>
 #include <cute_array.h>
+#include <cute_multithreading.h>
 
 #include <internal/cute_alloc_internal.h>
 
+// Tiny lock for short critical sections inside of allocators, where a full mutex would be overkill.
+struct CF_SpinLock
+{
+	std::atomic<int> locked;
+
+	CF_INLINE void lock()
+	{
+		while (locked.exchange(1, std::memory_order_acquire)) {
+			while (locked.load(std::memory_order_relaxed)) { }
+		}
+	}
+
+	CF_INLINE void unlock() { locked.store(0, std::memory_order_release); }
+};
+
 void* s_default_alloc(size_t size, void* udata)
 {
 	CF_UNUSED(udata);
@@ -52,6 +83,30 @@ CF_Allocator s_default_allocator = {
 
 CF_GLOBAL CF_Allocator s_allocator = s_default_allocator;
 
+// Every allocator ever registered with `cf_allocator_override_tag`. Entries are never removed, so the header of an
+// allocation can record which one made it, and `cf_free` still finds it after the tag is overridden again or restored.
+// Index 0 stands for `s_allocator`.
+#define CF_TAG_ALLOCATOR_MAX 64
+CF_GLOBAL CF_Allocator s_tag_allocators[CF_TAG_ALLOCATOR_MAX];
+CF_GLOBAL int s_tag_allocator_count = 1;
+
+// Index into `s_tag_allocators` each tag currently routes to, 0 for tags without an override.
+CF_GLOBAL int s_tag_allocator_index[CF_MEMORY_TAG_COUNT];
+
+// Allocations carry a small header recording their tag, so `cf_free` can find the allocator that made them.
+// Without memory tracking the header is only needed once a per-tag allocator is registered. Pointers without
+// a header can't be free'd once headers are turned on, so headers may only be turned on before the first
+// allocation is made.
+#ifdef CF_MEMORY_TRACKING
+#	define CF_USE_MEMORY_HEADERS true
+#	define CF_NOTE_HEADERLESS_ALLOCATION() do { } while (0)
+#else
+CF_GLOBAL bool s_use_memory_headers;
+CF_GLOBAL std::atomic<bool> s_made_headerless_allocation;
+#	define CF_USE_MEMORY_HEADERS s_use_memory_headers
+#	define CF_NOTE_HEADERLESS_ALLOCATION() do { if (!s_made_headerless_allocation.load(std::memory_order_relaxed)) s_made_headerless_allocation.store(true, std::memory_order_relaxed); } while (0)
+#endif
+
 void cf_allocator_override(CF_Allocator allocator)
 {
 	s_allocator = allocator;
@@ -62,24 +117,528 @@ void cf_allocator_restore_default()
 	s_allocator = s_default_allocator;
 }
 
+void cf_allocator_override_tag(CF_MemoryTag tag, CF_Allocator allocator)
+{
+	CF_ASSERT(tag >= 0 && tag < CF_MEMORY_TAG_COUNT);
+	CF_ASSERT(allocator.alloc_fn && allocator.free_fn && allocator.calloc_fn && allocator.realloc_fn);
+#ifndef CF_MEMORY_TRACKING
+	if (!s_use_memory_headers) {
+		// Too late to turn on headers, `cf_free` would misread every pointer handed out so far.
+		bool made_allocation = s_made_headerless_allocation.load(std::memory_order_relaxed);
+		CF_ASSERT(!made_allocation && "cf_allocator_override_tag must be called before the first allocation.");
+		if (made_allocation) return;
+		s_use_memory_headers = true;
+	}
+#endif
+	int index = 1;
+	while (index < s_tag_allocator_count && CF_MEMCMP(s_tag_allocators + index, &allocator, sizeof(CF_Allocator))) ++index;
+	if (index == s_tag_allocator_count) {
+		CF_ASSERT(s_tag_allocator_count < CF_TAG_ALLOCATOR_MAX && "Too many distinct allocators given to cf_allocator_override_tag.");
+		if (s_tag_allocator_count == CF_TAG_ALLOCATOR_MAX) return;
+		s_tag_allocators[s_tag_allocator_count++] = allocator;
+	}
+	s_tag_allocator_index[tag] = index;
+}
+
+void cf_allocator_restore_default_tag(CF_MemoryTag tag)
+{
+	CF_ASSERT(tag >= 0 && tag < CF_MEMORY_TAG_COUNT);
+	s_tag_allocator_index[tag] = 0;
+}
+
+static CF_INLINE const CF_Allocator* s_allocator_at(int index)
+{
+	return index ? s_tag_allocators + index : &s_allocator;
+}
+
+static CF_INLINE void* s_alloc(const CF_Allocator* a, size_t size)
+{
+	return a->alloc_fn ? a->alloc_fn(size, a->udata) : s_default_alloc(size, NULL);
+}
+
+static CF_INLINE void s_free(const CF_Allocator* a, void* ptr)
+{
+	a->free_fn ? a->free_fn(ptr, a->udata) : s_default_free(ptr, NULL);
+}
+
+static CF_INLINE void* s_calloc(const CF_Allocator* a, size_t size, size_t count)
+{
+	return a->calloc_fn ? a->calloc_fn(size, count, a->udata) : s_default_calloc(size, count, NULL);
+}
+
+static CF_INLINE void* s_realloc(const CF_Allocator* a, void* ptr, size_t size)
+{
+	return a->realloc_fn ? a->realloc_fn(ptr, size, a->udata) : s_default_realloc(ptr, size, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Memory tags.
+// Each thread has a small stack of tags, and allocations are attributed to (and routed by) the top.
+
+#define CF_MEMORY_TAG_STACK_MAX 32
+
+static thread_local int s_memory_tag_stack[CF_MEMORY_TAG_STACK_MAX];
+static thread_local int s_memory_tag_depth;
+
+void cf_memory_push_tag(CF_MemoryTag tag)
+{
+	CF_ASSERT(s_memory_tag_depth < CF_MEMORY_TAG_STACK_MAX);
+	CF_ASSERT(tag >= 0 && tag < CF_MEMORY_TAG_COUNT);
+	s_memory_tag_stack[s_memory_tag_depth++] = tag;
+}
+
+void cf_memory_pop_tag()
+{
+	CF_ASSERT(s_memory_tag_depth > 0);
+	--s_memory_tag_depth;
+}
+
+static CF_INLINE CF_MemoryTag s_current_memory_tag()
+{
+	return s_memory_tag_depth ? (CF_MemoryTag)s_memory_tag_stack[s_memory_tag_depth - 1] : CF_MEMORY_TAG_GENERAL;
+}
+
+bool cf_memory_tracking_enabled()
+{
+#ifdef CF_MEMORY_TRACKING
+	return true;
+#else
+	return false;
+#endif
+}
+
+// Sits in front of every allocation when headers are in use, 16 bytes to preserve malloc's alignment guarantee.
+struct CF_MemoryHeader
+{
+	int32_t tag;
+	int32_t allocator; // Index into `s_tag_allocators`.
+	int64_t size;
+};
+
+#ifdef CF_MEMORY_TRACKING
+
+// Per-tag counters are updated with relaxed atomics, and each tag lives on its own cache line to avoid
+// false sharing between threads allocating for different subsystems.
+struct alignas(64) CF_MemoryCounters
+{
+	std::atomic<int64_t> live_bytes;
+	std::atomic<int64_t> live_allocations;
+	std::atomic<int64_t> peak_bytes;
+	std::atomic<int64_t> total_allocations;
+};
+
+CF_GLOBAL CF_MemoryCounters s_memory_counters[CF_MEMORY_TAG_COUNT];
+
+static CF_INLINE void s_track(int64_t tag, int64_t bytes, int64_t allocations)
+{
+	CF_MemoryCounters* counters = s_memory_counters + tag;
+	int64_t live = counters->live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+	if (allocations) {
+		counters->live_allocations.fetch_add(allocations, std::memory_order_relaxed);
+		if (allocations > 0) counters->total_allocations.fetch_add(allocations, std::memory_order_relaxed);
+	}
+	int64_t peak = counters->peak_bytes.load(std::memory_order_relaxed);
+	while (live > peak && !counters->peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) { }
+}
+
+CF_MemoryStats cf_memory_stats(CF_MemoryTag tag)
+{
+	CF_ASSERT(tag >= 0 && tag < CF_MEMORY_TAG_COUNT);
+	CF_MemoryCounters* counters = s_memory_counters + tag;
+	CF_MemoryStats stats;
+	stats.live_bytes = counters->live_bytes.load(std::memory_order_relaxed);
+	stats.live_allocations = counters->live_allocations.load(std::memory_order_relaxed);
+	stats.peak_bytes = counters->peak_bytes.load(std::memory_order_relaxed);
+	stats.total_allocations = counters->total_allocations.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void cf_memory_reset_peak(CF_MemoryTag tag)
+{
+	CF_ASSERT(tag >= 0 && tag < CF_MEMORY_TAG_COUNT);
+	CF_MemoryCounters* counters = s_memory_counters + tag;
+	counters->peak_bytes.store(counters->live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+int cf_memory_dump_leaks()
+{
+	int64_t leaks = 0;
+	for (int i = 0; i < CF_MEMORY_TAG_COUNT; ++i) {
+		CF_MemoryStats stats = cf_memory_stats((CF_MemoryTag)i);
+		if (!stats.live_allocations) continue;
+		fprintf(stderr, "Memory leak: %s has %lld live allocation(s) totaling %lld bytes (peak %lld bytes).\n", cf_memory_tag_to_string((CF_MemoryTag)i), (long long)stats.live_allocations, (long long)stats.live_bytes, (long long)stats.peak_bytes);
+		leaks += stats.live_allocations;
+	}
+	return (int)leaks;
+}
+
+#else // CF_MEMORY_TRACKING
+
+static CF_INLINE void s_track(int64_t tag, int64_t bytes, int64_t allocations)
+{
+	CF_UNUSED(tag);
+	CF_UNUSED(bytes);
+	CF_UNUSED(allocations);
+}
+
+CF_MemoryStats cf_memory_stats(CF_MemoryTag tag)
+{
+	CF_UNUSED(tag);
+	CF_MemoryStats stats;
+	CF_MEMSET(&stats, 0, sizeof(stats));
+	return stats;
+}
+
+void cf_memory_reset_peak(CF_MemoryTag tag)
+{
+	CF_UNUSED(tag);
+}
+
+int cf_memory_dump_leaks()
+{
+	return 0;
+}
+
+#endif // CF_MEMORY_TRACKING
+
+static CF_INLINE void* s_header_to_user(CF_MemoryHeader* header, CF_MemoryTag tag, int allocator, size_t size)
+{
+	header->tag = tag;
+	header->allocator = allocator;
+	header->size = (int64_t)size;
+	return header + 1;
+}
+
+void* cf_alloc_tagged(size_t size, CF_MemoryTag tag)
+{
+	if (!CF_USE_MEMORY_HEADERS) {
+		CF_NOTE_HEADERLESS_ALLOCATION();
+		return s_alloc(&s_allocator, size);
+	}
+	int allocator = s_tag_allocator_index[tag];
+	CF_MemoryHeader* header = (CF_MemoryHeader*)s_alloc(s_allocator_at(allocator), size + sizeof(CF_MemoryHeader));
+	if (!header) return NULL;
+	s_track(tag, (int64_t)size, 1);
+	return s_header_to_user(header, tag, allocator, size);
+}
+
+void* cf_calloc_tagged(size_t size, size_t count, CF_MemoryTag tag)
+{
+	if (!CF_USE_MEMORY_HEADERS) {
+		CF_NOTE_HEADERLESS_ALLOCATION();
+		return s_calloc(&s_allocator, size, count);
+	}
+	if (count && size > (SIZE_MAX - sizeof(CF_MemoryHeader)) / count) return NULL;
+	size_t bytes = size * count;
+	int allocator = s_tag_allocator_index[tag];
+	CF_MemoryHeader* header = (CF_MemoryHeader*)s_calloc(s_allocator_at(allocator), bytes + sizeof(CF_MemoryHeader), 1);
+	if (!header) return NULL;
+	s_track(tag, (int64_t)bytes, 1);
+	return s_header_to_user(header, tag, allocator, bytes);
+}
+
+void* cf_realloc_tagged(void* ptr, size_t size, CF_MemoryTag tag)
+{
+	if (!CF_USE_MEMORY_HEADERS) {
+		CF_NOTE_HEADERLESS_ALLOCATION();
+		return s_realloc(&s_allocator, ptr, size);
+	}
+	if (!ptr) return cf_alloc_tagged(size, tag);
+	CF_MemoryHeader* header = (CF_MemoryHeader*)ptr - 1;
+	// Reallocations stay with whichever tag (and allocator) made the original allocation.
+	CF_MemoryTag original_tag = (CF_MemoryTag)header->tag;
+	int allocator = header->allocator;
+	int64_t original_size = header->size;
+	header = (CF_MemoryHeader*)s_realloc(s_allocator_at(allocator), header, size + sizeof(CF_MemoryHeader));
+	if (!header) return NULL;
+	s_track(original_tag, (int64_t)size - original_size, 0);
+	return s_header_to_user(header, original_tag, allocator, size);
+}
+
 void* cf_alloc(size_t size)
 {
-	return s_allocator.alloc_fn ? s_allocator.alloc_fn(size, NULL) : s_default_alloc(size, NULL);
+	return cf_alloc_tagged(size, s_current_memory_tag());
 }
 
 void cf_free(void* ptr)
 {
-	s_allocator.free_fn ? s_allocator.free_fn(ptr, NULL) : s_default_free(ptr, NULL);
+	if (!CF_USE_MEMORY_HEADERS) {
+		s_free(&s_allocator, ptr);
+		return;
+	}
+	if (!ptr) return;
+	CF_MemoryHeader* header = (CF_MemoryHeader*)ptr - 1;
+	s_track(header->tag, -header->size, -1);
+	s_free(s_allocator_at(header->allocator), header);
 }
 
 void* cf_calloc(size_t size, size_t count)
 {
-	return s_allocator.calloc_fn ? s_allocator.calloc_fn(size, count, NULL) : s_default_calloc(size, count, NULL);
+	return cf_calloc_tagged(size, count, s_current_memory_tag());
 }
 
 void* cf_realloc(void* ptr, size_t size)
 {
-	return s_allocator.realloc_fn ? s_allocator.realloc_fn(ptr, size, NULL) : s_default_realloc(ptr, size, NULL);
+	return cf_realloc_tagged(ptr, size, s_current_memory_tag());
+}
+
+//--------------------------------------------------------------------------------------------------
+// Small-object allocator.
+// Segregated size classes, with a per-thread cache of free blocks in front of a central free list.
+
+#define CF_SMALL_CLASS_COUNT 12
+#define CF_SMALL_MAX_SIZE 1024
+#define CF_SMALL_CHUNK_SIZE (64 * CF_KB)
+#define CF_SMALL_LARGE_CLASS -1
+
+static constexpr int s_small_class_sizes[CF_SMALL_CLASS_COUNT] = { 16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024 };
+
+// Maps (size + 15) / 16 to a size class, so picking a class is a single lookup.
+struct CF_SmallClassTable
+{
+	uint8_t index[CF_SMALL_MAX_SIZE / 16 + 1];
+
+	constexpr CF_SmallClassTable() : index()
+	{
+		int c = 0;
+		for (int i = 0; i <= CF_SMALL_MAX_SIZE / 16; ++i) {
+			while (s_small_class_sizes[c] < i * 16) ++c;
+			index[i] = (uint8_t)c;
+		}
+	}
+};
+
+static constexpr CF_SmallClassTable s_small_classes;
+
+// Sits in front of every allocation, 16 bytes to preserve malloc's alignment guarantee.
+// Free blocks reuse the header as their free list link.
+struct CF_SmallHeader
+{
+	int size_class;
+	int pad;
+	size_t size;
+};
+
+struct CF_SmallCentral
+{
+	CF_SpinLock lock;
+	void* free_list;
+	int count;
+};
+
+// Trivially constructible/destructible, so it's safe to touch from other thread-exit destructors (such as
+// the frame allocator's) even after `CF_SmallCacheFlusher` has returned all blocks to the central lists.
+struct CF_SmallCache
+{
+	void* lists[CF_SMALL_CLASS_COUNT];
+	int counts[CF_SMALL_CLASS_COUNT];
+	bool flushed;
+};
+
+CF_GLOBAL CF_SmallCentral s_small_central[CF_SMALL_CLASS_COUNT];
+static thread_local CF_SmallCache s_small_cache;
+
+static CF_INLINE int s_small_stride(int c)
+{
+	return s_small_class_sizes[c] + (int)sizeof(CF_SmallHeader);
+}
+
+static CF_INLINE int s_small_batch(int c)
+{
+	// Move roughly 4kb worth of blocks at a time between a thread cache and the central list.
+	int batch = 4 * CF_KB / s_small_stride(c);
+	return batch < 4 ? 4 : batch;
+}
+
+static CF_INLINE void s_small_lock(CF_SmallCentral* central)
+{
+	central->lock.lock();
+}
+
+static CF_INLINE void s_small_unlock(CF_SmallCentral* central)
+{
+	central->lock.unlock();
+}
+
+// Returns up to `count` blocks from the front of a thread's list back to the central list.
+static void s_small_release(CF_SmallCache* cache, int c, int count)
+{
+	void* first = cache->lists[c];
+	if (!first) return;
+	void* last = first;
+	int n = 1;
+	while (n < count && *(void**)last) {
+		last = *(void**)last;
+		++n;
+	}
+	cache->lists[c] = *(void**)last;
+	cache->counts[c] -= n;
+
+	CF_SmallCentral* central = s_small_central + c;
+	s_small_lock(central);
+	*(void**)last = central->free_list;
+	central->free_list = first;
+	central->count += n;
+	s_small_unlock(central);
+}
+
+static void s_small_flush(CF_SmallCache* cache)
+{
+	for (int c = 0; c < CF_SMALL_CLASS_COUNT; ++c) {
+		s_small_release(cache, c, cache->counts[c]);
+	}
+	cache->flushed = true;
+}
+
+struct CF_SmallCacheFlusher
+{
+	~CF_SmallCacheFlusher() { s_small_flush(&s_small_cache); }
+};
+
+static thread_local CF_SmallCacheFlusher s_small_flusher;
+
+static void s_small_refill(CF_SmallCache* cache, int c)
+{
+	// Make sure this thread's cache gets flushed when the thread exits.
+	(void)&s_small_flusher;
+
+	// After the thread-exit flush only take single blocks, since nothing will flush the cache again.
+	int batch = cache->flushed ? 1 : s_small_batch(c);
+	CF_SmallCentral* central = s_small_central + c;
+	s_small_lock(central);
+	if (central->free_list) {
+		void* first = central->free_list;
+		void* last = first;
+		int n = 1;
+		while (n < batch && *(void**)last) {
+			last = *(void**)last;
+			++n;
+		}
+		central->free_list = *(void**)last;
+		central->count -= n;
+		*(void**)last = cache->lists[c];
+		cache->lists[c] = first;
+		cache->counts[c] += n;
+	} else {
+		// Central list is empty, carve a fresh chunk into blocks. Everything beyond one batch goes
+		// to the central list for other threads to pick up.
+		int stride = s_small_stride(c);
+		int n = CF_SMALL_CHUNK_SIZE / stride;
+		char* chunk = (char*)malloc(CF_SMALL_CHUNK_SIZE);
+		if (chunk) {
+			int take = n < batch ? n : batch;
+			for (int i = 0; i < n; ++i) {
+				void* block = chunk + stride * i;
+				if (i < take) {
+					*(void**)block = cache->lists[c];
+					cache->lists[c] = block;
+				} else {
+					*(void**)block = central->free_list;
+					central->free_list = block;
+				}
+			}
+			cache->counts[c] += take;
+			central->count += n - take;
+		}
+	}
+	s_small_unlock(central);
+}
+
+static void* s_small_alloc(size_t size, void* udata)
+{
+	CF_UNUSED(udata);
+	CF_SmallHeader* hdr;
+	if (size > CF_SMALL_MAX_SIZE) {
+		if (size > SIZE_MAX - sizeof(CF_SmallHeader)) return NULL;
+		hdr = (CF_SmallHeader*)malloc(sizeof(CF_SmallHeader) + size);
+		if (!hdr) return NULL;
+		hdr->size_class = CF_SMALL_LARGE_CLASS;
+	} else {
+		int c = s_small_classes.index[(size + 15) >> 4];
+		CF_SmallCache* cache = &s_small_cache;
+		if (!cache->lists[c]) {
+			s_small_refill(cache, c);
+			if (!cache->lists[c]) return NULL;
+		}
+		hdr = (CF_SmallHeader*)cache->lists[c];
+		cache->lists[c] = *(void**)hdr;
+		cache->counts[c]--;
+		hdr->size_class = c;
+	}
+	hdr->size = size;
+	return hdr + 1;
+}
+
+static void s_small_free(void* ptr, void* udata)
+{
+	CF_UNUSED(udata);
+	if (!ptr) return;
+	CF_SmallHeader* hdr = (CF_SmallHeader*)ptr - 1;
+	int c = hdr->size_class;
+	if (c == CF_SMALL_LARGE_CLASS) {
+		free(hdr);
+		return;
+	}
+	CF_ASSERT(c >= 0 && c < CF_SMALL_CLASS_COUNT);
+	CF_SmallCache* cache = &s_small_cache;
+	*(void**)hdr = cache->lists[c];
+	cache->lists[c] = hdr;
+	cache->counts[c]++;
+	int batch = s_small_batch(c);
+	if (cache->flushed) {
+		s_small_release(cache, c, cache->counts[c]);
+	} else if (cache->counts[c] > batch * 2) {
+		s_small_release(cache, c, batch);
+	}
+}
+
+static void* s_small_calloc(size_t size, size_t count, void* udata)
+{
+	if (count && size > SIZE_MAX / count) return NULL;
+	size_t bytes = size * count;
+	void* ptr = s_small_alloc(bytes, udata);
+	if (ptr) CF_MEMSET(ptr, 0, bytes);
+	return ptr;
+}
+
+static void* s_small_realloc(void* ptr, size_t size, void* udata)
+{
+	if (!ptr) return s_small_alloc(size, udata);
+	if (!size) {
+		s_small_free(ptr, udata);
+		return NULL;
+	}
+	CF_SmallHeader* hdr = (CF_SmallHeader*)ptr - 1;
+	if (hdr->size_class == CF_SMALL_LARGE_CLASS) {
+		if (size > CF_SMALL_MAX_SIZE) {
+			if (size > SIZE_MAX - sizeof(CF_SmallHeader)) return NULL;
+			hdr = (CF_SmallHeader*)realloc(hdr, sizeof(CF_SmallHeader) + size);
+			if (!hdr) return NULL;
+			hdr->size = size;
+			return hdr + 1;
+		}
+	} else if (size <= (size_t)s_small_class_sizes[hdr->size_class]) {
+		// Still fits within the same block.
+		hdr->size = size;
+		return ptr;
+	}
+	void* new_ptr = s_small_alloc(size, udata);
+	if (!new_ptr) return NULL;
+	CF_MEMCPY(new_ptr, ptr, hdr->size < size ? hdr->size : size);
+	s_small_free(ptr, udata);
+	return new_ptr;
+}
+
+CF_Allocator cf_small_allocator()
+{
+	CF_Allocator allocator = {
+		NULL,
+		s_small_alloc,
+		s_small_free,
+		s_small_calloc,
+		s_small_realloc
+	};
+	return allocator;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -172,6 +731,30 @@ void cf_arena_reset(CF_Arena* arena)
 	}
 }
 
+CF_ArenaMarker cf_arena_save(const CF_Arena* arena)
+{
+	CF_ArenaMarker marker;
+	marker.ptr = arena->ptr;
+	marker.block_index = arena->block_index;
+	return marker;
+}
+
+void cf_arena_restore(CF_Arena* arena, CF_ArenaMarker marker)
+{
+	CF_ASSERT(marker.block_index <= arena->block_index);
+	CF_ASSERT(marker.block_index < arena->block_index || marker.ptr <= arena->ptr);
+	arena->ptr = marker.ptr;
+	arena->block_index = marker.block_index;
+	if (marker.block_index > 0) {
+		// Blocks past the marker stay in `blocks` and are picked back up by `cf_arena_alloc`.
+		char* block = arena->blocks[marker.block_index - 1];
+		CF_ASSERT(marker.ptr >= block && marker.ptr <= block + arena->block_size);
+		arena->end = block + arena->block_size;
+	} else {
+		arena->end = NULL;
+	}
+}
+
 void cf_destroy_arena(CF_Arena* arena)
 {
 	if (arena->blocks) {
@@ -187,6 +770,161 @@ void cf_destroy_arena(CF_Arena* arena)
 }
 
 //--------------------------------------------------------------------------------------------------
+// Virtual memory arena.
+
+// Commit at least this much at a time, to keep calls into the OS off the hot path.
+#define CF_VIRTUAL_ARENA_COMMIT_SIZE (64 * CF_KB)
+
+static size_t s_page_size()
+{
+	static size_t page_size;
+	if (!page_size) {
+#if defined(CF_WINDOWS)
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		page_size = (size_t)info.dwPageSize;
+#elif defined(CF_EMSCRIPTEN)
+		page_size = 64 * CF_KB;
+#else
+		page_size = (size_t)sysconf(_SC_PAGESIZE);
+#endif
+	}
+	return page_size;
+}
+
+static CF_INLINE size_t s_round_to_pages(size_t size)
+{
+	size_t page_size = s_page_size();
+	return (size + page_size - 1) & ~(page_size - 1);
+}
+
+static void* s_vm_reserve(size_t size)
+{
+#if defined(CF_WINDOWS)
+	return VirtualAlloc(NULL, size, MEM_RESERVE, PAGE_NOACCESS);
+#elif defined(CF_EMSCRIPTEN)
+	return malloc(size);
+#else
+	void* p = mmap(NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	return p == MAP_FAILED ? NULL : p;
+#endif
+}
+
+static bool s_vm_commit(void* p, size_t size)
+{
+#if defined(CF_WINDOWS)
+	return VirtualAlloc(p, size, MEM_COMMIT, PAGE_READWRITE) != NULL;
+#elif defined(CF_EMSCRIPTEN)
+	CF_UNUSED(p);
+	CF_UNUSED(size);
+	return true;
+#else
+	return mprotect(p, size, PROT_READ | PROT_WRITE) == 0;
+#endif
+}
+
+static void s_vm_decommit(void* p, size_t size)
+{
+#if defined(CF_WINDOWS)
+	VirtualFree(p, size, MEM_DECOMMIT);
+#elif defined(CF_EMSCRIPTEN)
+	CF_UNUSED(p);
+	CF_UNUSED(size);
+#else
+	// Hand the physical pages back to the OS, then make the range inaccessible again.
+	madvise(p, size, MADV_DONTNEED);
+	mprotect(p, size, PROT_NONE);
+#endif
+}
+
+static void s_vm_release(void* p, size_t size)
+{
+#if defined(CF_WINDOWS)
+	CF_UNUSED(size);
+	VirtualFree(p, 0, MEM_RELEASE);
+#elif defined(CF_EMSCRIPTEN)
+	CF_UNUSED(size);
+	free(p);
+#else
+	munmap(p, size);
+#endif
+}
+
+CF_VirtualArena cf_make_virtual_arena(int alignment, size_t reserve_size, size_t retain_size)
+{
+	CF_ASSERT(alignment > 0 && alignment <= 256 && !(alignment & (alignment - 1)));
+	CF_VirtualArena arena;
+	CF_MEMSET(&arena, 0, sizeof(arena));
+	arena.alignment = alignment;
+	arena.retain_size = s_round_to_pages(retain_size);
+	reserve_size = s_round_to_pages(reserve_size);
+	arena.base = (char*)s_vm_reserve(reserve_size);
+	if (!arena.base) return arena;
+	arena.ptr = arena.base;
+	arena.commit_end = arena.base;
+	arena.reserve_end = arena.base + reserve_size;
+#ifdef CF_EMSCRIPTEN
+	arena.commit_end = arena.reserve_end;
+#endif
+	return arena;
+}
+
+void* cf_virtual_arena_alloc(CF_VirtualArena* arena, size_t size)
+{
+	char* result = (char*)CF_ALIGN_FORWARD_PTR(arena->ptr, arena->alignment);
+	if (size > (size_t)(arena->reserve_end - result)) {
+		CF_ASSERT(!"Virtual arena reservation exhausted.");
+		return NULL;
+	}
+	char* end = result + size;
+	if (end > arena->commit_end) {
+		size_t commit_size = s_round_to_pages((size_t)(end - arena->commit_end));
+		if (commit_size < CF_VIRTUAL_ARENA_COMMIT_SIZE) commit_size = CF_VIRTUAL_ARENA_COMMIT_SIZE;
+		size_t available = (size_t)(arena->reserve_end - arena->commit_end);
+		if (commit_size > available) commit_size = available;
+		if (!s_vm_commit(arena->commit_end, commit_size)) return NULL;
+		arena->commit_end += commit_size;
+	}
+	arena->ptr = end;
+	return result;
+}
+
+void cf_virtual_arena_reset(CF_VirtualArena* arena)
+{
+	arena->ptr = arena->base;
+#ifndef CF_EMSCRIPTEN
+	char* keep = arena->base + arena->retain_size;
+	if (arena->commit_end > keep) {
+		s_vm_decommit(keep, (size_t)(arena->commit_end - keep));
+		arena->commit_end = keep;
+	}
+#endif
+}
+
+void cf_destroy_virtual_arena(CF_VirtualArena* arena)
+{
+	if (arena->base) {
+		s_vm_release(arena->base, (size_t)(arena->reserve_end - arena->base));
+	}
+	CF_MEMSET(arena, 0, sizeof(*arena));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Thread-safe pool of fixed-size elements.
+//
+// Free elements are moved around in magazines, small fixed-capacity arrays of element pointers. Each
+// thread gets a slot in the pool holding two magazines (Bonwick-style "loaded" and "previous"), so
+// nearly all allocs and frees only touch memory no other thread is using. Once both magazines are
+// exhausted (or full) a whole magazine is traded with the depot, a pair of lock-free stacks of full
+// and empty magazines. Only growing the pool and trimming it take a lock.
+//
+// Magazines are referred to by 32-bit index rather than pointer, which leaves room in a 64-bit word
+// for an ABA counter on the depot stacks.
+
+#define CF_POOL_MAGAZINE_CAPACITY 32
+#define CF_POOL_SLOT_COUNT 32
+#define CF_POOL_MAGAZINE_CHUNK_SIZE 256
 
 struct CF_MemoryBlock
 {
@@ -194,43 +932,200 @@ struct CF_MemoryBlock
 	CF_MemoryBlock* next;
 };
 
+struct CF_PoolMagazine
+{
+	std::atomic<uint32_t> next; // Index + 1 of the next magazine on a depot stack, zero for none.
+	int count;
+	void* elements[CF_POOL_MAGAZINE_CAPACITY];
+};
+
+// A Treiber stack of magazines. The low 32 bits of `head` are the index + 1 of the top magazine, and
+// the high 32 bits are bumped on every push and pop to defeat ABA.
+struct CF_PoolStack
+{
+	alignas(64) std::atomic<uint64_t> head;
+};
+
+// Pointers to each chunk of `CF_POOL_MAGAZINE_CHUNK_SIZE` magazines, grown on demand. Growing copies
+// into a bigger table, but the old table is kept on the `retired` list until the pool is destroyed,
+// since lock-free readers may still be looking at it. Chunks themselves never move.
+struct CF_PoolMagazineTable
+{
+	CF_PoolMagazineTable* retired;
+	uint32_t capacity;
+	CF_PoolMagazine* chunks[1];
+};
+
+struct alignas(64) CF_PoolSlot
+{
+	CF_SpinLock lock;
+	uint32_t loaded;   // Index + 1, zero until the slot is first used.
+	uint32_t previous; // Index + 1, zero until the slot is first used.
+};
+
 struct CF_MemoryPool
 {
+	CF_PoolSlot slots[CF_POOL_SLOT_COUNT];
+	CF_PoolStack full;  // Magazines with at least one element.
+	CF_PoolStack empty; // Magazines with no elements.
+
+	// Everything below is guarded by `grow_lock`, except `magazine_table` which is read without
+	// the lock once published.
+	alignas(64) CF_SpinLock grow_lock;
 	int element_size;
 	size_t block_size;
 	int alignment;
-	void* free_list;
 	CF_MemoryBlock* blocks;
+	int block_count;
 	int element_count_per_block;
+	uint32_t magazine_count;
+	std::atomic<CF_PoolMagazineTable*> magazine_table;
 };
 
+CF_GLOBAL CF_AtomicInt s_pool_thread_counter;
+static thread_local int s_pool_thread_slot = -1;
+
+static CF_INLINE int s_pool_slot_index()
+{
+	if (s_pool_thread_slot < 0) {
+		s_pool_thread_slot = cf_atomic_add(&s_pool_thread_counter, 1) % CF_POOL_SLOT_COUNT;
+	}
+	return s_pool_thread_slot;
+}
+
+static CF_INLINE CF_PoolMagazine* s_pool_magazine(CF_MemoryPool* pool, uint32_t index)
+{
+	CF_ASSERT(index);
+	index -= 1;
+	CF_PoolMagazineTable* table = pool->magazine_table.load(std::memory_order_acquire);
+	return table->chunks[index / CF_POOL_MAGAZINE_CHUNK_SIZE] + index % CF_POOL_MAGAZINE_CHUNK_SIZE;
+}
+
+static void s_pool_push(CF_MemoryPool* pool, CF_PoolStack* stack, uint32_t index)
+{
+	CF_PoolMagazine* magazine = s_pool_magazine(pool, index);
+	uint64_t head = stack->head.load(std::memory_order_relaxed);
+	uint64_t next;
+	do {
+		magazine->next.store((uint32_t)head, std::memory_order_relaxed);
+		next = ((head >> 32) + 1) << 32 | index;
+	} while (!stack->head.compare_exchange_weak(head, next, std::memory_order_release, std::memory_order_relaxed));
+}
+
+static uint32_t s_pool_pop(CF_MemoryPool* pool, CF_PoolStack* stack)
+{
+	uint64_t head = stack->head.load(std::memory_order_acquire);
+	uint64_t next;
+	do {
+		uint32_t index = (uint32_t)head;
+		if (!index) return 0;
+		// Magazines are never free'd while the pool is alive, so reading `next` is safe even if another
+		// thread pops this magazine first -- the tag in the high bits makes our CAS fail in that case.
+		uint32_t after = s_pool_magazine(pool, index)->next.load(std::memory_order_relaxed);
+		next = ((head >> 32) + 1) << 32 | after;
+	} while (!stack->head.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire));
+	return (uint32_t)head;
+}
+
+// Must be called with `grow_lock` held.
+static uint32_t s_pool_new_magazine_locked(CF_MemoryPool* pool)
+{
+	uint32_t index = pool->magazine_count;
+	CF_ASSERT(index < UINT32_MAX);
+	uint32_t chunk = index / CF_POOL_MAGAZINE_CHUNK_SIZE;
+	if (index % CF_POOL_MAGAZINE_CHUNK_SIZE == 0) {
+		CF_PoolMagazine* magazines = (CF_PoolMagazine*)cf_alloc(sizeof(CF_PoolMagazine) * CF_POOL_MAGAZINE_CHUNK_SIZE);
+		for (int i = 0; i < CF_POOL_MAGAZINE_CHUNK_SIZE; ++i) {
+			CF_PLACEMENT_NEW(&magazines[i].next) std::atomic<uint32_t>(0);
+			magazines[i].count = 0;
+		}
+
+		// Only the lock holder writes the table, so a relaxed load is enough here.
+		CF_PoolMagazineTable* table = pool->magazine_table.load(std::memory_order_relaxed);
+		if (!table || chunk == table->capacity) {
+			uint32_t capacity = table ? table->capacity * 2 : 4;
+			CF_PoolMagazineTable* bigger = (CF_PoolMagazineTable*)cf_alloc(sizeof(CF_PoolMagazineTable) + sizeof(CF_PoolMagazine*) * (capacity - 1));
+			bigger->retired = table;
+			bigger->capacity = capacity;
+			if (table) CF_MEMCPY(bigger->chunks, table->chunks, sizeof(CF_PoolMagazine*) * table->capacity);
+			table = bigger;
+		}
+		table->chunks[chunk] = magazines;
+
+		// Publish before the new magazine's index escapes to any other thread.
+		pool->magazine_table.store(table, std::memory_order_release);
+	}
+	pool->magazine_count++;
+	return index + 1;
+}
+
+static uint32_t s_pool_get_empty_magazine(CF_MemoryPool* pool)
+{
+	uint32_t index = s_pool_pop(pool, &pool->empty);
+	if (index) return index;
+	pool->grow_lock.lock();
+	index = s_pool_new_magazine_locked(pool);
+	pool->grow_lock.unlock();
+	return index;
+}
+
+// Allocates a new block, carves it into full magazines, and returns one of them. The rest are pushed
+// onto the depot for other threads.
+static uint32_t s_pool_grow(CF_MemoryPool* pool)
+{
+	pool->grow_lock.lock();
+
+	// Another thread may have grown the pool while we waited on the lock.
+	uint32_t result = s_pool_pop(pool, &pool->full);
+	if (result) {
+		pool->grow_lock.unlock();
+		return result;
+	}
+
+	CF_MemoryBlock* block = (CF_MemoryBlock*)cf_alloc(sizeof(CF_MemoryBlock));
+	block->memory = (uint8_t*)cf_aligned_alloc(pool->block_size, pool->alignment);
+	block->next = pool->blocks;
+	pool->blocks = block;
+	pool->block_count++;
+
+	int i = 0;
+	while (i < pool->element_count_per_block) {
+		uint32_t index = s_pool_pop(pool, &pool->empty);
+		if (!index) index = s_pool_new_magazine_locked(pool);
+		CF_PoolMagazine* magazine = s_pool_magazine(pool, index);
+		magazine->count = 0;
+		while (magazine->count < CF_POOL_MAGAZINE_CAPACITY && i < pool->element_count_per_block) {
+			magazine->elements[magazine->count++] = block->memory + (size_t)pool->element_size * i++;
+		}
+		if (!result) result = index;
+		else s_pool_push(pool, &pool->full, index);
+	}
+
+	pool->grow_lock.unlock();
+	return result;
+}
+
+static CF_INLINE void s_pool_slot_init(CF_MemoryPool* pool, CF_PoolSlot* slot)
+{
+	if (!slot->loaded) {
+		slot->loaded = s_pool_get_empty_magazine(pool);
+		slot->previous = s_pool_get_empty_magazine(pool);
+	}
+}
+
 CF_MemoryPool* cf_make_memory_pool(int element_size, int element_count, int alignment)
 {
-	element_size = element_size > sizeof(void*) ? element_size : sizeof(void*);
+	element_size = (size_t)element_size > sizeof(void*) ? element_size : (int)sizeof(void*);
 	element_size = CF_ALIGN_FORWARD(element_size, alignment);
 	size_t block_size = element_size * element_count;
 
-	CF_MemoryPool* pool = (CF_MemoryPool*)cf_aligned_alloc(sizeof(CF_MemoryPool), alignment);
+	CF_MemoryPool* pool = (CF_MemoryPool*)cf_aligned_alloc(sizeof(CF_MemoryPool), 64);
+	CF_PLACEMENT_NEW(pool) CF_MemoryPool();
 	pool->element_size = element_size;
 	pool->block_size = block_size;
 	pool->alignment = alignment;
-	pool->free_list = NULL;
 	pool->element_count_per_block = element_count;
 
-	// Allocate the first block and initialize the free list.
-	CF_MemoryBlock* block = (CF_MemoryBlock*)cf_aligned_alloc(sizeof(CF_MemoryBlock), alignment);
-	block->memory = (uint8_t*)cf_aligned_alloc(block_size, alignment);
-	block->next = NULL;
-	pool->blocks = block;
-	pool->free_list = block->memory;
-	for (int i = 0; i < element_count - 1; ++i) {
-		void** element = (void**)(block->memory + element_size * i);
-		void* next = (void*)(block->memory + element_size * (i + 1));
-		*element = next;
-	}
-	void** last_element = (void**)(block->memory + element_size * (element_count - 1));
-	*last_element = NULL;
-
 	return pool;
 }
 
@@ -240,40 +1135,267 @@ void cf_destroy_memory_pool(CF_MemoryPool* pool)
 	while (block) {
 		CF_MemoryBlock* next = block->next;
 		cf_aligned_free(block->memory);
-		cf_aligned_free(block);
+		cf_free(block);
 		block = next;
 	}
+	CF_PoolMagazineTable* table = pool->magazine_table.load(std::memory_order_relaxed);
+	uint32_t chunk_count = (pool->magazine_count + CF_POOL_MAGAZINE_CHUNK_SIZE - 1) / CF_POOL_MAGAZINE_CHUNK_SIZE;
+	for (uint32_t i = 0; i < chunk_count; ++i) {
+		cf_free(table->chunks[i]);
+	}
+	while (table) {
+		CF_PoolMagazineTable* retired = table->retired;
+		cf_free(table);
+		table = retired;
+	}
 	cf_aligned_free(pool);
 }
 
 void* cf_memory_pool_alloc(CF_MemoryPool* pool)
 {
-	// Try to allocate from the free list first.
-	if (pool->free_list) {
-		void* mem = pool->free_list;
-		pool->free_list = *(void**)pool->free_list;
-		return mem;
-	}
+	CF_PoolSlot* slot = pool->slots + s_pool_slot_index();
+	slot->lock.lock();
+	s_pool_slot_init(pool, slot);
 
-	// If no free elements, allocate a new block and initialize its free list.
-	CF_MemoryBlock* new_block = (CF_MemoryBlock*)cf_aligned_alloc(sizeof(CF_MemoryBlock), pool->alignment);
-	new_block->memory = (uint8_t*)cf_aligned_alloc(pool->block_size, pool->alignment);
-	new_block->next = pool->blocks;
-	pool->blocks = new_block;
-	pool->free_list = new_block->memory;
-	for (int i = 0; i < pool->element_count_per_block - 1; ++i) {
-		void** element = (void**)(new_block->memory + pool->element_size * i);
-		void* next = (void*)(new_block->memory + pool->element_size * (i + 1));
-		*element = next;
+	CF_PoolMagazine* loaded = s_pool_magazine(pool, slot->loaded);
+	if (!loaded->count) {
+		if (s_pool_magazine(pool, slot->previous)->count) {
+			// Swap in the previous magazine, it still has elements.
+			uint32_t t = slot->loaded;
+			slot->loaded = slot->previous;
+			slot->previous = t;
+		} else {
+			// Both magazines are empty, trade one in for a full magazine from the depot.
+			s_pool_push(pool, &pool->empty, slot->previous);
+			slot->previous = slot->loaded;
+			uint32_t full = s_pool_pop(pool, &pool->full);
+			slot->loaded = full ? full : s_pool_grow(pool);
+		}
+		loaded = s_pool_magazine(pool, slot->loaded);
 	}
-	void** last_element = (void**)(new_block->memory + pool->element_size * (pool->element_count_per_block - 1));
-	*last_element = NULL;
 
-	return cf_memory_pool_alloc(pool);
+	void* element = loaded->elements[--loaded->count];
+	slot->lock.unlock();
+	return element;
 }
 
 void cf_memory_pool_free(CF_MemoryPool* pool, void* element)
 {
-	*(void**)element = pool->free_list;
-	pool->free_list = element;
-}
\ No newline at end of file
+	CF_PoolSlot* slot = pool->slots + s_pool_slot_index();
+	slot->lock.lock();
+	s_pool_slot_init(pool, slot);
+
+	CF_PoolMagazine* loaded = s_pool_magazine(pool, slot->loaded);
+	if (loaded->count == CF_POOL_MAGAZINE_CAPACITY) {
+		if (s_pool_magazine(pool, slot->previous)->count < CF_POOL_MAGAZINE_CAPACITY) {
+			uint32_t t = slot->loaded;
+			slot->loaded = slot->previous;
+			slot->previous = t;
+		} else {
+			// Both magazines are full, hand one to the depot and continue with an empty one.
+			s_pool_push(pool, &pool->full, slot->previous);
+			slot->previous = slot->loaded;
+			slot->loaded = s_pool_get_empty_magazine(pool);
+		}
+		loaded = s_pool_magazine(pool, slot->loaded);
+	}
+
+	loaded->elements[loaded->count++] = element;
+	slot->lock.unlock();
+}
+
+static int s_pool_block_compare(const void* a, const void* b)
+{
+	uintptr_t pa = (uintptr_t)(*(CF_MemoryBlock**)a)->memory;
+	uintptr_t pb = (uintptr_t)(*(CF_MemoryBlock**)b)->memory;
+	return pa < pb ? -1 : (pa > pb ? 1 : 0);
+}
+
+int cf_memory_pool_trim(CF_MemoryPool* pool)
+{
+	// Return every slot's magazines to the depot, so their elements can be counted.
+	for (int i = 0; i < CF_POOL_SLOT_COUNT; ++i) {
+		CF_PoolSlot* slot = pool->slots + i;
+		slot->lock.lock();
+		uint32_t magazines[2] = { slot->loaded, slot->previous };
+		for (int j = 0; j < 2; ++j) {
+			if (!magazines[j]) continue;
+			s_pool_push(pool, s_pool_magazine(pool, magazines[j])->count ? &pool->full : &pool->empty, magazines[j]);
+		}
+		slot->loaded = slot->previous = 0;
+		slot->lock.unlock();
+	}
+
+	pool->grow_lock.lock();
+	if (!pool->block_count) {
+		pool->grow_lock.unlock();
+		return 0;
+	}
+
+	// Take all free elements out of the depot. Elements other threads grab in the meantime simply
+	// count as in-use, so their blocks are kept.
+	dyna uint32_t* drained = NULL;
+	dyna void** elements = NULL;
+	uint32_t index;
+	while ((index = s_pool_pop(pool, &pool->full))) {
+		CF_PoolMagazine* magazine = s_pool_magazine(pool, index);
+		for (int i = 0; i < magazine->count; ++i) apush(elements, magazine->elements[i]);
+		magazine->count = 0;
+		apush(drained, index);
+	}
+
+	// Count free elements per block.
+	CF_MemoryBlock** blocks = (CF_MemoryBlock**)cf_alloc(sizeof(CF_MemoryBlock*) * pool->block_count);
+	int* free_counts = (int*)cf_calloc(sizeof(int), pool->block_count);
+	int block_count = 0;
+	for (CF_MemoryBlock* block = pool->blocks; block; block = block->next) {
+		blocks[block_count++] = block;
+	}
+	qsort(blocks, block_count, sizeof(CF_MemoryBlock*), s_pool_block_compare);
+	dyna int* element_blocks = NULL;
+	afit(element_blocks, asize(elements));
+	for (int i = 0; i < asize(elements); ++i) {
+		uint8_t* p = (uint8_t*)elements[i];
+		int lo = 0, hi = block_count - 1;
+		while (lo < hi) {
+			int mid = (lo + hi + 1) / 2;
+			if (blocks[mid]->memory <= p) lo = mid;
+			else hi = mid - 1;
+		}
+		CF_ASSERT(p >= blocks[lo]->memory && p < blocks[lo]->memory + pool->block_size);
+		free_counts[lo]++;
+		apush(element_blocks, lo);
+	}
+
+	// Release fully free blocks, and unlink them from the pool.
+	int released = 0;
+	for (int i = 0; i < block_count; ++i) {
+		if (free_counts[i] != pool->element_count_per_block) continue;
+		CF_MemoryBlock** link = &pool->blocks;
+		while (*link != blocks[i]) link = &(*link)->next;
+		*link = blocks[i]->next;
+		cf_aligned_free(blocks[i]->memory);
+		cf_free(blocks[i]);
+		pool->block_count--;
+		released++;
+	}
+
+	// Put the surviving elements back into magazines.
+	int m = 0;
+	CF_PoolMagazine* magazine = NULL;
+	for (int i = 0; i < asize(elements); ++i) {
+		if (free_counts[element_blocks[i]] == pool->element_count_per_block) continue;
+		if (!magazine || magazine->count == CF_POOL_MAGAZINE_CAPACITY) {
+			if (magazine) s_pool_push(pool, &pool->full, drained[m++]);
+			magazine = s_pool_magazine(pool, drained[m]);
+		}
+		magazine->elements[magazine->count++] = elements[i];
+	}
+	if (magazine) s_pool_push(pool, &pool->full, drained[m++]);
+	for (; m < asize(drained); ++m) {
+		s_pool_push(pool, &pool->empty, drained[m]);
+	}
+
+	afree(element_blocks);
+	cf_free(free_counts);
+	cf_free(blocks);
+	afree(elements);
+	afree(drained);
+	pool->grow_lock.unlock();
+
+	return released;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+#define CF_FRAME_ALIGNMENT 16
+#define CF_FRAME_BLOCK_SIZE CF_MB
+
+// Frame memory handed out since one reset. Allocations too large for a single arena block are tracked
+// separately and released whenever the buffer is recycled.
+struct CF_FrameBuffer
+{
+	CF_Arena arena = cf_make_arena(CF_FRAME_ALIGNMENT, CF_FRAME_BLOCK_SIZE);
+	dyna void** large_allocs = NULL;
+
+	void recycle()
+	{
+		for (int i = 0; i < asize(large_allocs); ++i) {
+			cf_aligned_free(large_allocs[i]);
+		}
+		aclear(large_allocs);
+		cf_arena_reset(&arena);
+	}
+
+	void release()
+	{
+		recycle();
+		cf_destroy_arena(&arena);
+		afree(large_allocs);
+		arena = cf_make_arena(CF_FRAME_ALIGNMENT, CF_FRAME_BLOCK_SIZE);
+	}
+};
+
+// One of these lives on each thread that calls `cf_frame_alloc`. The two buffers alternate on each reset,
+// so memory from the previous frame stays valid for one more frame. That way a worker still using its
+// frame memory when the main thread calls `cf_frame_reset`, or results handed over from the last frame,
+// don't get overwritten out from under it.
+struct CF_FrameAllocator
+{
+	int generation = 0;
+	int current = 0;
+	CF_FrameBuffer buffers[2];
+
+	~CF_FrameAllocator()
+	{
+		release();
+	}
+
+	void release()
+	{
+		buffers[0].release();
+		buffers[1].release();
+	}
+
+	void advance(int new_generation)
+	{
+		// Recycle the buffer from two resets ago, keeping the previous one alive. If more than one reset
+		// happened since this thread last allocated, the previous buffer is stale as well.
+		current = !current;
+		buffers[current].recycle();
+		if (new_generation - generation != 1) buffers[!current].recycle();
+		generation = new_generation;
+	}
+};
+
+CF_GLOBAL CF_AtomicInt s_frame_generation;
+static thread_local CF_FrameAllocator s_frame;
+
+void* cf_frame_alloc(size_t size)
+{
+	// Lazily advance this thread's buffers if a reset happened since our last allocation.
+	CF_FrameAllocator* frame = &s_frame;
+	int generation = cf_atomic_get(&s_frame_generation);
+	if (frame->generation != generation) {
+		frame->advance(generation);
+	}
+
+	CF_FrameBuffer* buffer = frame->buffers + frame->current;
+	if (size >= CF_FRAME_BLOCK_SIZE) {
+		void* ptr = cf_aligned_alloc(size, CF_FRAME_ALIGNMENT);
+		apush(buffer->large_allocs, ptr);
+		return ptr;
+	}
+
+	return cf_arena_alloc(&buffer->arena, (int)size);
+}
+
+void cf_frame_reset()
+{
+	cf_atomic_add(&s_frame_generation, 1);
+}
+
+void cf_frame_release()
+{
+	s_frame.release();
+}
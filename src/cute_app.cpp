@@ -13,6 +13,7 @@
 #include <cute_c_runtime.h>
 #include <cute_draw.h>
 #include <cute_time.h>
+#include <cute_profile.h>
 
 #include <internal/cute_alloc_internal.h>
 #include <internal/cute_app_internal.h>
@@ -408,6 +409,9 @@ void cf_destroy_app()
 	app->~CF_App();
 	CF_FREE(app);
 	cf_fs_destroy();
+	cf_frame_release();
+	sinuke();
+	cf_memory_dump_leaks();
 }
 
 bool cf_app_is_running()
@@ -444,6 +448,11 @@ static void s_on_update(void* udata)
 
 void cf_app_update(CF_OnUpdateFn* on_update)
 {
+	CF_PROFILE_SCOPE("cf_app_update");
+
+	// Recycle all scratch memory handed out by `cf_frame_alloc` last frame.
+	cf_frame_reset();
+
 	if (app->gfx_enabled) {
 		// Deal with DPI scaling.
 		int pw = 0, ph = 0;
@@ -482,6 +491,8 @@ static void s_imgui_present(SDL_GPUTexture* swapchain_texture)
 
 int cf_app_draw_onto_screen(bool clear)
 {
+	CF_PROFILE_SCOPE("cf_app_draw_onto_screen");
+
 	if (app->sync_window) {
 		app->sync_window = false;
 		SDL_SyncWindow(app->window);
@@ -506,7 +517,9 @@ int cf_app_draw_onto_screen(bool clear)
 	// All references to backend texture id's are now invalid (fetch_image or cf_texture_handle).
 	if (!draw->delay_defrag) {
 		spritebatch_tick(&draw->sb);
+		CF_PROFILE_BEGIN("spritebatch_defrag");
 		spritebatch_defrag(&draw->sb);
+		CF_PROFILE_END();
 	}
 
 	// Render any remaining geometry in the draw API.
@@ -555,7 +568,9 @@ int cf_app_draw_onto_screen(bool clear)
 	// to have the perf-hit and delay until next frame.
 	if (draw->delay_defrag) {
 		spritebatch_tick(&draw->sb);
+		CF_PROFILE_BEGIN("spritebatch_defrag");
 		spritebatch_defrag(&draw->sb);
+		CF_PROFILE_END();
 		draw->delay_defrag = false;
 	}
 
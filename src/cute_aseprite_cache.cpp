@@ -13,6 +13,8 @@
 #include <internal/cute_alloc_internal.h>
 #include <internal/cute_app_internal.h>
 
+#define CUTE_ASEPRITE_ALLOC(size, ctx) cf_alloc_tagged(size, CF_MEMORY_TAG_ASEPRITE_CACHE)
+#define CUTE_ASEPRITE_FREE(mem, ctx) cf_free(mem)
 #define CUTE_ASEPRITE_IMPLEMENTATION
 #include <cute/cute_aseprite.h>
 
@@ -50,6 +52,7 @@ void cf_aseprite_cache_get_pixels(uint64_t image_id, void* buffer, int bytes_to_
 
 void cf_make_aseprite_cache()
 {
+	CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_ASEPRITE_CACHE);
 	cache = CF_NEW(CF_AsepriteCache);
 }
 
@@ -101,6 +104,7 @@ static void s_sprite(CF_AsepriteCacheEntry entry, CF_Sprite* sprite)
 
 static CF_Result s_aseprite_cache_load_from_memory(const char* unique_name, const void* data, int sz, CF_Sprite* sprite_out)
 {
+	CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_ASEPRITE_CACHE);
 	ase_t* ase = cute_aseprite_load_from_memory(data, (int)sz, NULL);
 	if (!ase) return cf_result_error("Unable to open ase file at `aseprite_path`.");
 
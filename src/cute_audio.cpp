@@ -8,6 +8,7 @@
 #include <cute_audio.h>
 #include <cute_file_system.h>
 #include <cute_alloc.h>
+#include <cute_profile.h>
 
 #include <internal/cute_alloc_internal.h>
 #include <internal/cute_app_internal.h>
@@ -21,9 +22,13 @@
 #	endif // CUTE_SOUND_SCALAR_MODE
 #endif // CF_EMSCRIPTEN
 
+#define CUTE_SOUND_ALLOC(size, ctx) cf_alloc_tagged(size, CF_MEMORY_TAG_AUDIO)
+#define CUTE_SOUND_FREE(mem, ctx) cf_free(mem)
 #define CUTE_SOUND_IMPLEMENTATION
 #define CUTE_SOUND_FORCE_SDL
 #define CUTE_SOUND_ASSERT CF_ASSERT
+#define CUTE_SOUND_PROFILE_BEGIN(name) CF_PROFILE_BEGIN(name)
+#define CUTE_SOUND_PROFILE_END() CF_PROFILE_END()
 #include <cute/cute_sound.h>
 
 CF_Audio cf_audio_load_ogg(const char* path)
@@ -305,5 +310,20 @@ int cf_audio_channel_count(CF_Audio audio)
 	return src->channel_count;
 }
 
+// cute_sound frees the samples decoded by stb_vorbis with CUTE_SOUND_FREE, so stb_vorbis must allocate through
+// CF as well. Pull in the system headers stb_vorbis wants first, so only its own calls get redirected.
+#include <stdlib.h>
+#if !(defined(__APPLE__) || defined(MACOSX) || defined(macintosh) || defined(Macintosh))
+#	include <malloc.h>
+#	if defined(__linux__) || defined(__linux) || defined(__EMSCRIPTEN__)
+#		include <alloca.h>
+#	endif
+#endif
+#define malloc(size) cf_alloc_tagged(size, CF_MEMORY_TAG_AUDIO)
+#define realloc(ptr, size) cf_realloc_tagged(ptr, size, CF_MEMORY_TAG_AUDIO)
+#define free(ptr) cf_free(ptr)
 #undef STB_VORBIS_HEADER_ONLY
 #include <stb/stb_vorbis.c>
+#undef malloc
+#undef realloc
+#undef free
@@ -0,0 +1,155 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include <cute_concurrent_map.h>
+#include <cute_hashtable.h>
+#include <cute_multithreading.h>
+#include <cute_c_runtime.h>
+#include <cute_alloc.h>
+
+#include <internal/cute_alloc_internal.h>
+
+#define CF_CONCURRENT_MAP_DEFAULT_SHARDS_PER_CORE 4
+#define CF_CONCURRENT_MAP_CACHELINE 64
+
+// Each shard sits on its own cache line(s), so threads hammering different shards don't false-share lock state.
+struct CF_MapShard
+{
+	CF_ReadWriteLock lock;
+	CF_Hhdr* table;
+	char padding[CF_CONCURRENT_MAP_CACHELINE - (sizeof(CF_ReadWriteLock) + sizeof(CF_Hhdr*)) % CF_CONCURRENT_MAP_CACHELINE];
+};
+
+struct CF_ConcurrentMap
+{
+	CF_MapShard* shards;
+	int shard_count;
+	int shard_shift;
+	int item_size;
+};
+
+static CF_INLINE CF_Hhdr* s_header(void* items, int item_size)
+{
+	return (CF_Hhdr*)((uint8_t*)items - item_size) - 1;
+}
+
+static CF_INLINE CF_MapShard* s_shard(CF_ConcurrentMap* map, uint64_t key)
+{
+	// Pick the shard from the high bits of a mixed key, the low bits are left for the shard's own hashtable.
+	uint64_t h = key * 0x9E3779B97F4A7C15ULL;
+	return map->shards + (map->shard_shift < 64 ? (int)(h >> map->shard_shift) : 0);
+}
+
+static CF_INLINE int s_find(const CF_Hhdr* table, uint64_t key)
+{
+	// Use the batched lookup, as unlike `cf_hashtable_find_impl2` it doesn't write to the table.
+	int index;
+	cf_hashtable_find_many_impl(table, &key, 1, &index);
+	return index;
+}
+
+static CF_INLINE void* s_item(CF_Hhdr* table, int index)
+{
+	return (uint8_t*)cf_hashtable_items_impl(table) + index * table->item_size;
+}
+
+CF_ConcurrentMap* cf_make_concurrent_map(int item_size, int shard_count)
+{
+	CF_ASSERT(item_size > 0);
+	if (shard_count <= 0) shard_count = cf_core_count() * CF_CONCURRENT_MAP_DEFAULT_SHARDS_PER_CORE;
+	int bits = 0;
+	while ((1 << bits) < shard_count) ++bits;
+	shard_count = 1 << bits;
+
+	CF_ConcurrentMap* map = (CF_ConcurrentMap*)CF_ALLOC(sizeof(CF_ConcurrentMap));
+	map->shards = (CF_MapShard*)cf_aligned_alloc(sizeof(CF_MapShard) * shard_count, CF_CONCURRENT_MAP_CACHELINE);
+	map->shard_count = shard_count;
+	map->shard_shift = 64 - bits;
+	map->item_size = item_size;
+	for (int i = 0; i < shard_count; ++i) {
+		map->shards[i].lock = cf_make_rw_lock();
+		map->shards[i].table = s_header(cf_hashtable_make_impl(sizeof(uint64_t), item_size, 32), item_size);
+	}
+	return map;
+}
+
+void cf_destroy_concurrent_map(CF_ConcurrentMap* map)
+{
+	if (!map) return;
+	for (int i = 0; i < map->shard_count; ++i) {
+		cf_destroy_rw_lock(&map->shards[i].lock);
+		cf_hashtable_free_impl(map->shards[i].table);
+	}
+	cf_aligned_free(map->shards);
+	CF_FREE(map);
+}
+
+void cf_concurrent_map_set(CF_ConcurrentMap* map, uint64_t key, const void* item)
+{
+	CF_MapShard* shard = s_shard(map, key);
+	cf_write_lock(&shard->lock);
+	shard->table = s_header(cf_hashtable_insert_impl2(shard->table, &key, item), map->item_size);
+	cf_write_unlock(&shard->lock);
+}
+
+bool cf_concurrent_map_add(CF_ConcurrentMap* map, uint64_t key, void* item)
+{
+	CF_MapShard* shard = s_shard(map, key);
+	cf_write_lock(&shard->lock);
+	int index = s_find(shard->table, key);
+	if (index >= 0) {
+		CF_MEMCPY(item, s_item(shard->table, index), map->item_size);
+	} else {
+		shard->table = s_header(cf_hashtable_insert_impl2(shard->table, &key, item), map->item_size);
+	}
+	cf_write_unlock(&shard->lock);
+	return index < 0;
+}
+
+bool cf_concurrent_map_get(CF_ConcurrentMap* map, uint64_t key, void* out_item)
+{
+	CF_MapShard* shard = s_shard(map, key);
+	cf_read_lock(&shard->lock);
+	int index = s_find(shard->table, key);
+	if (index >= 0 && out_item) {
+		CF_MEMCPY(out_item, s_item(shard->table, index), map->item_size);
+	}
+	cf_read_unlock(&shard->lock);
+	return index >= 0;
+}
+
+bool cf_concurrent_map_remove(CF_ConcurrentMap* map, uint64_t key)
+{
+	CF_MapShard* shard = s_shard(map, key);
+	cf_write_lock(&shard->lock);
+	bool found = s_find(shard->table, key) >= 0;
+	if (found) cf_hashtable_remove_impl2(shard->table, &key);
+	cf_write_unlock(&shard->lock);
+	return found;
+}
+
+int cf_concurrent_map_count(CF_ConcurrentMap* map)
+{
+	int count = 0;
+	for (int i = 0; i < map->shard_count; ++i) {
+		CF_MapShard* shard = map->shards + i;
+		cf_read_lock(&shard->lock);
+		count += cf_hashtable_count_impl(shard->table);
+		cf_read_unlock(&shard->lock);
+	}
+	return count;
+}
+
+void cf_concurrent_map_clear(CF_ConcurrentMap* map)
+{
+	for (int i = 0; i < map->shard_count; ++i) {
+		CF_MapShard* shard = map->shards + i;
+		cf_write_lock(&shard->lock);
+		cf_hashtable_clear_impl(shard->table);
+		cf_write_unlock(&shard->lock);
+	}
+}
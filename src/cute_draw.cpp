@@ -12,6 +12,7 @@
 #include <cute_defer.h>
 #include <cute_routine.h>
 #include <cute_rnd.h>
+#include <cute_profile.h>
 
 #include <internal/cute_alloc_internal.h>
 #include <internal/cute_app_internal.h>
@@ -23,6 +24,8 @@
 struct CF_Draw* draw;
 
 //#define SPRITEBATCH_LOG printf
+#define SPRITEBATCH_MALLOC(size, ctx) cf_alloc_tagged(size, CF_MEMORY_TAG_DRAW)
+#define SPRITEBATCH_FREE(ptr, ctx) cf_free(ptr)
 #define SPRITEBATCH_IMPLEMENTATION
 #include <cute/cute_spritebatch.h>
 
@@ -121,6 +124,8 @@ static CF_INLINE float s_intersect(float a, float b, float u0, float u1, float p
 
 static void s_draw_report(spritebatch_sprite_t* sprites, int count, int texture_w, int texture_h, void* udata)
 {
+	CF_PROFILE_SCOPE("s_draw_report");
+	CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_DRAW);
 	CF_UNUSED(udata);
 	int vert_count = 0;
 	draw->verts.ensure_count(count * 6);
@@ -432,6 +437,7 @@ void CF_Draw::set_aaf()
 
 void cf_make_draw()
 {
+	CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_DRAW);
 	draw = CF_NEW(CF_Draw);
 	draw->projection = ortho_2d(0, 0, (float)app->w, (float)app->h);
 	draw->reset_cam();
@@ -1286,6 +1292,7 @@ void cf_draw_arrow(CF_V2 a, CF_V2 b, float thickness, float arrow_width)
 
 CF_Result cf_make_font_from_memory(void* data, int size, const char* font_name)
 {
+	CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_DRAW);
 	font_name = sintern(font_name);
 	CF_Font* font = (CF_Font*)CF_NEW(CF_Font);
 	font->file_data = (uint8_t*)data;
@@ -1671,24 +1678,23 @@ static bool s_is_space(int cp)
 	}
 }
 
-static const char* s_find_end_of_line(CF_Font* font, const char* text, float wrap_width)
+// Returns the index of the codepoint the current line ends on, searching forward from `index`.
+static int s_find_end_of_line(CF_Font* font, const int* codepoints, int count, int index, float wrap_width)
 {
 	float font_size = draw->font_sizes.last();
 	int blur = draw->blurs.last();
 	float x = 0;
-	const char* start_of_word = 0;
+	int start_of_word = -1;
 	float word_w = 0;
-	int cp;
 
-	while (*text) {
-		const char* text_prev = text;
-		text = cf_decode_UTF8(text, &cp);
+	while (index < count) {
+		int cp = codepoints[index++];
 		CF_Glyph* glyph = cf_font_get_glyph(font, cp, font_size, blur);
 
 		if (cp == '\n') {
 			x = 0;
 			word_w = 0;
-			start_of_word = 0;
+			start_of_word = -1;
 			continue;
 		} else if (cp == '\r') {
 			continue;
@@ -1696,10 +1702,10 @@ static const char* s_find_end_of_line(CF_Font* font, const char* text, float wra
 			if (s_is_space(cp)) {
 				x += word_w + glyph->xadvance;
 				word_w = 0;
-				start_of_word = 0;
+				start_of_word = -1;
 			} else {
-				if (!start_of_word) {
-					start_of_word = text_prev;
+				if (start_of_word < 0) {
+					start_of_word = index - 1;
 				}
 				if (x + word_w + glyph->xadvance < wrap_width) {
 					word_w += glyph->xadvance;
@@ -1709,14 +1715,14 @@ static const char* s_find_end_of_line(CF_Font* font, const char* text, float wra
 						return start_of_word;
 					} else {
 						// Word itself does not fit on one line, so just cut it here.
-						return text;
+						return index;
 					}
 				}
 			}
 		}
 	}
 
-	return text + 1;
+	return count + 1;
 }
 
 struct CF_CodeParseState
@@ -2038,6 +2044,20 @@ static v2 s_draw_text(const char* text, CF_V2 position, int text_length, bool re
 		text = effect_state->sanitized.c_str();
 	}
 
+	// Decode the whole string up front, the layout below then walks codepoints by index. Short strings are
+	// decoded onto the stack, longer ones into frame memory. Text effects and markup callbacks may draw text
+	// themselves, so no shared scratch.
+	int codepoints_on_stack[256];
+	int* codepoints = codepoints_on_stack;
+	int codepoint_count = 0;
+	int byte_count = text ? (int)CF_STRLEN(text) : 0;
+	if (byte_count > (int)CF_ARRAY_SIZE(codepoints_on_stack)) {
+		codepoints = (int*)cf_frame_alloc(sizeof(int) * byte_count);
+	}
+	if (text) {
+		cf_decode_UTF8_bulk(text, byte_count, codepoints, byte_count, &codepoint_count);
+	}
+
 	// Gather up all state required for rendering.
 	float font_size = draw->font_sizes.last();
 	int blur = draw->blurs.last();
@@ -2046,7 +2066,7 @@ static v2 s_draw_text(const char* text, CF_V2 position, int text_length, bool re
 	float line_height = font->line_height * scale;
 	int cp_prev = 0;
 	int cp = 0;
-	const char* end_of_line = NULL;
+	int end_of_line = -1;
 	float h = (font->ascent + font->descent) * scale;
 	float w = font->width * scale;
 
@@ -2112,7 +2132,7 @@ static v2 s_draw_text(const char* text, CF_V2 position, int text_length, bool re
 
 	// Used by the line-wrapping algorithm to skip characters.
 	auto skip_to_next = [&]() {
-		text = cf_decode_UTF8(text, &cp);
+		cp = codepoints[index];
 		effect_cleanup();
 		++index;
 	};
@@ -2157,11 +2177,11 @@ static v2 s_draw_text(const char* text, CF_V2 position, int text_length, bool re
 	}
 
 	// Render the string glyph-by-glyph.
-	while (text_length-- && *text) {
+	while (text_length-- && index < codepoint_count && codepoints[index]) {
 		cp_prev = cp;
-		const char* prev_text = text;
+		int prev_index = index;
 		if ((render || markups) && do_effects) effect_spawn();
-		text = cf_decode_UTF8(text, &cp);
+		cp = codepoints[index];
 		++index;
 		CF_DEFER(effect_cleanup());
 
@@ -2171,18 +2191,18 @@ static v2 s_draw_text(const char* text, CF_V2 position, int text_length, bool re
 		}
 
 		// Word wrapping logic.
-		if (!end_of_line) {
-			end_of_line = s_find_end_of_line(font, prev_text, wrap_w);
+		if (end_of_line < 0) {
+			end_of_line = s_find_end_of_line(font, codepoints, codepoint_count, prev_index, wrap_w);
 		}
 
-		int finished_rendering_line = !(text < end_of_line);
+		int finished_rendering_line = !(index < end_of_line);
 		if (finished_rendering_line) {
-			end_of_line = NULL;
+			end_of_line = -1;
 			apply_newline();
 
 			// Skip whitespace at the beginning of new lines.
 			while (cp) {
-				cp = *text;
+				cp = index < codepoint_count ? codepoints[index] : 0;
 				if (cp == '\n') {
 					apply_newline();
 					skip_to_next();
@@ -2302,6 +2322,7 @@ static v2 s_draw_text(const char* text, CF_V2 position, int text_length, bool re
 
 void cf_draw_text(const char* text, CF_V2 position, int text_length)
 {
+	CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_DRAW);
 	s_draw_text(text, position, text_length);
 }
 
@@ -2820,14 +2841,20 @@ static void s_process_command(CF_Canvas canvas, CF_Command* cmd, CF_Command* nex
 		// the atlas compiler.
 		draw->need_flush = false;
 		if (!draw->delay_defrag) {
+			CF_PROFILE_BEGIN("spritebatch_defrag");
 			spritebatch_defrag(&draw->sb);
+			CF_PROFILE_END();
 		}
+		CF_PROFILE_BEGIN("spritebatch_flush");
 		spritebatch_flush(&draw->sb);
+		CF_PROFILE_END();
 	}
 }
 
 void cf_render_layers_to(CF_Canvas canvas, int layer_lo, int layer_hi, bool clear)
 {
+	CF_PROFILE_SCOPE("cf_render_layers_to");
+	CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_DRAW);
 	// We will render to this canvas.
 	cf_apply_canvas(canvas, clear);
 
@@ -2857,9 +2884,13 @@ void cf_render_layers_to(CF_Canvas canvas, int layer_lo, int layer_hi, bool clea
 	if (draw->need_flush) {
 		draw->need_flush = false;
 		if (!draw->delay_defrag) {
+			CF_PROFILE_BEGIN("spritebatch_defrag");
 			spritebatch_defrag(&draw->sb);
+			CF_PROFILE_END();
 		}
+		CF_PROFILE_BEGIN("spritebatch_flush");
 		spritebatch_flush(&draw->sb);
+		CF_PROFILE_END();
 	}
 	draw->has_drawn_something = false;
 	cf_arena_reset(&draw->uniform_arena);
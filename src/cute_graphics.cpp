@@ -9,6 +9,7 @@
 #include <cute_c_runtime.h>
 #include <cute_graphics.h>
 #include <cute_file_system.h>
+#include <cute_profile.h>
 
 #include <internal/cute_alloc_internal.h>
 #include <internal/cute_app_internal.h>
@@ -228,6 +229,7 @@ static SDL_GPUTextureLocation SDL_GPUTextureLocationDefaults(CF_TextureInternal*
 
 void cf_texture_update(CF_Texture texture_handle, void* data, int size)
 {
+	CF_PROFILE_SCOPE("cf_texture_update");
 	CF_TextureInternal* tex = (CF_TextureInternal*)texture_handle.id;
 
 	// Copy bytes over to the driver.
@@ -261,6 +263,7 @@ void cf_texture_update(CF_Texture texture_handle, void* data, int size)
 
 void cf_texture_update_mip(CF_Texture texture_handle, void* data, int size, int mip_level)
 {
+	CF_PROFILE_SCOPE("cf_texture_update_mip");
 	CF_TextureInternal* tex = (CF_TextureInternal*)texture_handle.id;
 
 	// Create a temporary transfer buffer if needed.
@@ -1379,6 +1382,7 @@ static SDL_GPUGraphicsPipeline* s_build_pipeline(CF_ShaderInternal* shader, CF_R
 
 void cf_apply_shader(CF_Shader shader_handle, CF_Material material_handle)
 {
+	CF_PROFILE_SCOPE("cf_apply_shader");
 	CF_ASSERT(s_canvas);
 	CF_ASSERT(s_canvas->mesh);
 	CF_MeshInternal* mesh = s_canvas->mesh;
@@ -0,0 +1,160 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include <cute_handle_table.h>
+#include <cute_c_runtime.h>
+#include <cute_alloc.h>
+
+#include <internal/cute_alloc_internal.h>
+
+// Handles are laid out as { generation : 16, slot : 32 } with the generation in the upper bits. Generations
+// start at one and skip zero when wrapping, so a valid handle is never `CF_INVALID_HANDLE`.
+#define CF_HANDLE_SLOT(handle) ((uint32_t)((handle) & 0xFFFFFFFFULL))
+#define CF_HANDLE_GENERATION(handle) ((uint16_t)((handle) >> 32))
+#define CF_HANDLE_MAKE(slot, generation) (((uint64_t)(generation) << 32) | (uint64_t)(slot))
+
+#define CF_HANDLE_ALIVE_BIT 0x8000
+#define CF_HANDLE_FREE_LIST_END UINT32_MAX
+
+struct CF_HandleEntry
+{
+	// The user's index for live entries, or the next free slot for free entries.
+	uint32_t index;
+	uint16_t generation;
+	uint16_t type_and_alive;
+};
+
+struct CF_HandleTable
+{
+	CF_HandleEntry* entries;
+	uint32_t capacity;
+	// Free slots form a FIFO queue, so recently free'd slots (and their generations) are reused last.
+	uint32_t free_head;
+	uint32_t free_tail;
+};
+
+static void s_push_free_range(CF_HandleTable* table, uint32_t first, uint32_t end)
+{
+	if (first == end) return;
+	for (uint32_t i = first; i < end - 1; ++i) {
+		table->entries[i].index = i + 1;
+	}
+	table->entries[end - 1].index = CF_HANDLE_FREE_LIST_END;
+	if (table->free_head == CF_HANDLE_FREE_LIST_END) {
+		table->free_head = first;
+	} else {
+		table->entries[table->free_tail].index = first;
+	}
+	table->free_tail = end - 1;
+}
+
+static void s_grow(CF_HandleTable* table, uint32_t capacity)
+{
+	CF_ASSERT(capacity > table->capacity);
+	table->entries = (CF_HandleEntry*)CF_REALLOC(table->entries, sizeof(CF_HandleEntry) * capacity);
+	for (uint32_t i = table->capacity; i < capacity; ++i) {
+		table->entries[i].generation = 1;
+		table->entries[i].type_and_alive = 0;
+	}
+	uint32_t old_capacity = table->capacity;
+	table->capacity = capacity;
+	s_push_free_range(table, old_capacity, capacity);
+}
+
+static CF_INLINE const CF_HandleEntry* s_entry(const CF_HandleTable* table, CF_Handle handle)
+{
+	uint32_t slot = CF_HANDLE_SLOT(handle);
+	if (slot >= table->capacity) return NULL;
+	const CF_HandleEntry* entry = table->entries + slot;
+	if (entry->generation != CF_HANDLE_GENERATION(handle) || !(entry->type_and_alive & CF_HANDLE_ALIVE_BIT)) return NULL;
+	return entry;
+}
+
+CF_HandleTable* cf_make_handle_allocator(int initial_capacity)
+{
+	CF_HandleTable* table = (CF_HandleTable*)CF_ALLOC(sizeof(CF_HandleTable));
+	table->entries = NULL;
+	table->capacity = 0;
+	table->free_head = CF_HANDLE_FREE_LIST_END;
+	table->free_tail = CF_HANDLE_FREE_LIST_END;
+	s_grow(table, initial_capacity > 0 ? (uint32_t)initial_capacity : 1);
+	return table;
+}
+
+void cf_destroy_handle_allocator(CF_HandleTable* table)
+{
+	if (!table) return;
+	CF_FREE(table->entries);
+	CF_FREE(table);
+}
+
+CF_Handle cf_handle_allocator_alloc(CF_HandleTable* table, uint32_t index, uint16_t type)
+{
+	CF_ASSERT(!(type & CF_HANDLE_ALIVE_BIT));
+	if (table->free_head == CF_HANDLE_FREE_LIST_END) {
+		CF_ASSERT(table->capacity < UINT32_MAX / 2);
+		s_grow(table, table->capacity * 2);
+	}
+	uint32_t slot = table->free_head;
+	CF_HandleEntry* entry = table->entries + slot;
+	table->free_head = entry->index;
+	if (table->free_head == CF_HANDLE_FREE_LIST_END) table->free_tail = CF_HANDLE_FREE_LIST_END;
+	entry->index = index;
+	entry->type_and_alive = type | CF_HANDLE_ALIVE_BIT;
+	return CF_HANDLE_MAKE(slot, entry->generation);
+}
+
+uint32_t cf_handle_allocator_get_index(const CF_HandleTable* table, CF_Handle handle)
+{
+	const CF_HandleEntry* entry = s_entry(table, handle);
+	CF_ASSERT(entry);
+	return entry->index;
+}
+
+uint16_t cf_handle_allocator_get_type(const CF_HandleTable* table, CF_Handle handle)
+{
+	const CF_HandleEntry* entry = s_entry(table, handle);
+	CF_ASSERT(entry);
+	return entry->type_and_alive & ~CF_HANDLE_ALIVE_BIT;
+}
+
+bool cf_handle_allocator_is_handle_valid(const CF_HandleTable* table, CF_Handle handle)
+{
+	return s_entry(table, handle) != NULL;
+}
+
+void cf_handle_allocator_update_index(CF_HandleTable* table, CF_Handle handle, uint32_t index)
+{
+	CF_HandleEntry* entry = (CF_HandleEntry*)s_entry(table, handle);
+	CF_ASSERT(entry);
+	entry->index = index;
+}
+
+void cf_handle_allocator_free(CF_HandleTable* table, CF_Handle handle)
+{
+	CF_HandleEntry* entry = (CF_HandleEntry*)s_entry(table, handle);
+	CF_ASSERT(entry);
+	if (!entry) return;
+	entry->type_and_alive = 0;
+	if (++entry->generation == 0) entry->generation = 1;
+	uint32_t slot = CF_HANDLE_SLOT(handle);
+	s_push_free_range(table, slot, slot + 1);
+}
+
+void cf_handle_allocator_clear(CF_HandleTable* table)
+{
+	for (uint32_t i = 0; i < table->capacity; ++i) {
+		CF_HandleEntry* entry = table->entries + i;
+		if (entry->type_and_alive & CF_HANDLE_ALIVE_BIT) {
+			entry->type_and_alive = 0;
+			if (++entry->generation == 0) entry->generation = 1;
+		}
+	}
+	table->free_head = CF_HANDLE_FREE_LIST_END;
+	table->free_tail = CF_HANDLE_FREE_LIST_END;
+	s_push_free_range(table, 0, table->capacity);
+}
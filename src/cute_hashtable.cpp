@@ -18,6 +18,400 @@ using namespace Cute;
 // Original implementation by Mattias Gustavsson
 // https://github.com/mattiasgustavsson/libs/blob/main/hashtable.h
 
+static CF_INLINE void* s_get_item(const CF_Hhdr* table, int index)
+{
+	uint8_t* items = (uint8_t*)table->items_data;
+	return items + index * table->item_size;
+}
+
+static CF_INLINE void* s_get_key(const CF_Hhdr* table, int index)
+{
+	uint8_t* keys = (uint8_t*)table->items_key;
+	return keys + index * table->key_size;
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+#	define CF_HPREFETCH(p) __builtin_prefetch(p)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#	include <xmmintrin.h>
+#	define CF_HPREFETCH(p) _mm_prefetch((const char*)(p), _MM_HINT_T0)
+#else
+#	define CF_HPREFETCH(p) ((void)(p))
+#endif
+
+static CF_INLINE int s_keys_equal(const CF_Hhdr* table, const void* a, const void* b)
+{
+	return !CF_MEMCMP(a, b, table->key_size);
+}
+
+#ifdef CF_SWISS_HASHTABLE
+
+// Swiss-table style open addressing.
+// Slots are grouped into runs of 16, each with one control byte per slot. A control byte is either empty, deleted,
+// or holds the low 7 bits of the key's hash. Lookups compare all 16 control bytes of a group at once with SSE2/NEON,
+// and only compare keys for matching bytes. The capacity is a power of two so probing needs no divides. Each table
+// gets its own hash seed, which takes the place of prime table sizes for resisting hash-flooding.
+
+#ifdef _MSC_VER
+#	include <intrin.h>
+#endif
+
+#define CF_HGROUP_SIZE 16
+#define CF_HCTRL_EMPTY ((uint8_t)0x80)
+#define CF_HCTRL_DELETED ((uint8_t)0xFE)
+
+#if !defined(CF_HASHTABLE_SCALAR_MODE) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#	include <arm_neon.h>
+
+// NEON has no movemask, so matches are narrowed down to one bit per nibble instead of one bit per byte.
+#	define CF_HGROUP_SHIFT 2
+typedef uint64_t CF_Hmask;
+
+static CF_INLINE CF_Hmask s_group_mask(uint8x16_t matches)
+{
+	uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+	return nibbles & 0x8888888888888888ULL;
+}
+
+static CF_INLINE CF_Hmask s_group_match(const uint8_t* ctrl, uint8_t h2)
+{
+	return s_group_mask(vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(h2)));
+}
+
+static CF_INLINE CF_Hmask s_group_match_empty(const uint8_t* ctrl)
+{
+	return s_group_mask(vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(CF_HCTRL_EMPTY)));
+}
+
+static CF_INLINE CF_Hmask s_group_match_empty_or_deleted(const uint8_t* ctrl)
+{
+	return s_group_mask(vcltq_s8(vreinterpretq_s8_u8(vld1q_u8(ctrl)), vdupq_n_s8(0)));
+}
+
+#elif !defined(CF_HASHTABLE_SCALAR_MODE) && (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#	include <emmintrin.h>
+
+#	define CF_HGROUP_SHIFT 0
+typedef uint32_t CF_Hmask;
+
+static CF_INLINE CF_Hmask s_group_match(const uint8_t* ctrl, uint8_t h2)
+{
+	__m128i group = _mm_loadu_si128((const __m128i*)ctrl);
+	return (CF_Hmask)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)h2)));
+}
+
+static CF_INLINE CF_Hmask s_group_match_empty(const uint8_t* ctrl)
+{
+	return s_group_match(ctrl, CF_HCTRL_EMPTY);
+}
+
+static CF_INLINE CF_Hmask s_group_match_empty_or_deleted(const uint8_t* ctrl)
+{
+	// Both empty and deleted have their high bit set, full slots never do.
+	return (CF_Hmask)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)ctrl));
+}
+
+#else
+
+#	define CF_HGROUP_SHIFT 0
+typedef uint32_t CF_Hmask;
+
+static CF_INLINE CF_Hmask s_group_match(const uint8_t* ctrl, uint8_t h2)
+{
+	CF_Hmask mask = 0;
+	for (int i = 0; i < CF_HGROUP_SIZE; ++i) {
+		if (ctrl[i] == h2) mask |= 1u << i;
+	}
+	return mask;
+}
+
+static CF_INLINE CF_Hmask s_group_match_empty(const uint8_t* ctrl)
+{
+	return s_group_match(ctrl, CF_HCTRL_EMPTY);
+}
+
+static CF_INLINE CF_Hmask s_group_match_empty_or_deleted(const uint8_t* ctrl)
+{
+	CF_Hmask mask = 0;
+	for (int i = 0; i < CF_HGROUP_SIZE; ++i) {
+		if (ctrl[i] & 0x80) mask |= 1u << i;
+	}
+	return mask;
+}
+
+#endif
+
+static CF_INLINE int s_mask_first(CF_Hmask mask)
+{
+#if defined(_MSC_VER) && CF_HGROUP_SHIFT
+	unsigned long index;
+	_BitScanForward64(&index, mask);
+	return (int)index >> CF_HGROUP_SHIFT;
+#elif defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return (int)index;
+#else
+	return __builtin_ctzll((uint64_t)mask) >> CF_HGROUP_SHIFT;
+#endif
+}
+
+static CF_INLINE uint64_t s_fmix(uint64_t h)
+{
+	h ^= h >> 33;
+	h *= 0xFF51AFD7ED558CCDULL;
+	h ^= h >> 33;
+	h *= 0xC4CEB9FE1A85EC53ULL;
+	h ^= h >> 33;
+	return h;
+}
+
+static CF_INLINE uint64_t s_hash(const CF_Hhdr* table, const void* key)
+{
+	const uint8_t* bytes = (const uint8_t*)key;
+	int size = table->key_size;
+	uint64_t h = table->seed;
+	while (size >= 8) {
+		uint64_t v;
+		CF_MEMCPY(&v, bytes, 8);
+		h = s_fmix(h ^ v) + 0x9E3779B97F4A7C15ULL;
+		bytes += 8;
+		size -= 8;
+	}
+	if (size) {
+		uint64_t v = 0;
+		CF_MEMCPY(&v, bytes, size);
+		h = s_fmix(h ^ v) + 0x9E3779B97F4A7C15ULL;
+	}
+	return s_fmix(h ^ (uint64_t)table->key_size);
+}
+
+static uint64_t s_make_seed(const CF_Hhdr* table)
+{
+	// Addresses are randomized per-process (ASLR), and the counter separates tables made on the same thread.
+	static thread_local uint64_t s_seed_counter;
+	s_seed_counter += 0x9E3779B97F4A7C15ULL;
+	return s_fmix(s_seed_counter ^ (uint64_t)(uintptr_t)&s_seed_counter) ^ s_fmix((uint64_t)(uintptr_t)table);
+}
+
+static CF_INLINE uint8_t s_h2(uint64_t hash)
+{
+	return (uint8_t)(hash & 0x7F);
+}
+
+static CF_INLINE int s_max_load(int capacity)
+{
+	return capacity - capacity / 8;
+}
+
+static CF_INLINE int s_slot_item(const CF_Hhdr* table, int slot)
+{
+	return table->slot_items[slot];
+}
+
+static CF_INLINE void s_set_slot_item(CF_Hhdr* table, int slot, int item_index)
+{
+	table->slot_items[slot] = item_index;
+}
+
+static CF_INLINE void s_prefetch_slot(const CF_Hhdr* table, uint64_t hash)
+{
+	int group = (int)(hash >> 7) & (table->slot_capacity - 1) & ~(CF_HGROUP_SIZE - 1);
+	CF_HPREFETCH(table->ctrl + group);
+	CF_HPREFETCH(table->slot_items + group);
+}
+
+// Groups are probed in triangular order, which visits every group exactly once when the group count is a power of two.
+static int s_find_slot(const CF_Hhdr* table, uint64_t hash, const void* key)
+{
+	int mask = table->slot_capacity - 1;
+	int group = (int)(hash >> 7) & mask & ~(CF_HGROUP_SIZE - 1);
+	uint8_t h2 = s_h2(hash);
+	for (int step = CF_HGROUP_SIZE; ; step += CF_HGROUP_SIZE) {
+		const uint8_t* ctrl = table->ctrl + group;
+		CF_Hmask matches = s_group_match(ctrl, h2);
+		while (matches) {
+			int slot = group + s_mask_first(matches);
+			if (s_keys_equal(table, s_get_key(table, table->slot_items[slot]), key)) {
+				return slot;
+			}
+			matches &= matches - 1;
+		}
+		if (s_group_match_empty(ctrl)) return -1;
+		group = (group + step) & mask;
+	}
+}
+
+static int s_find_free_slot(const CF_Hhdr* table, uint64_t hash)
+{
+	int mask = table->slot_capacity - 1;
+	int group = (int)(hash >> 7) & mask & ~(CF_HGROUP_SIZE - 1);
+	for (int step = CF_HGROUP_SIZE; ; step += CF_HGROUP_SIZE) {
+		CF_Hmask free_slots = s_group_match_empty_or_deleted(table->ctrl + group);
+		if (free_slots) return group + s_mask_first(free_slots);
+		group = (group + step) & mask;
+	}
+}
+
+static void s_rehash(CF_Hhdr* table, int capacity)
+{
+	CF_FREE(table->ctrl);
+	CF_FREE(table->slot_items);
+	table->slot_capacity = capacity;
+	table->ctrl = (uint8_t*)CF_ALLOC(capacity);
+	table->slot_items = (int*)CF_ALLOC(capacity * sizeof(int));
+	CF_MEMSET(table->ctrl, CF_HCTRL_EMPTY, capacity);
+	for (int i = 0; i < table->count; ++i) {
+		uint64_t hash = s_hash(table, s_get_key(table, i));
+		int slot = s_find_free_slot(table, hash);
+		table->ctrl[slot] = s_h2(hash);
+		table->slot_items[slot] = i;
+		table->items_slot_index[i] = slot;
+	}
+	table->growth_left = s_max_load(capacity) - table->count;
+}
+
+void* cf_hashtable_make_impl(int key_size, int item_size, int capacity)
+{
+	CF_ASSERT(capacity);
+
+	CF_Hhdr* table = (CF_Hhdr*)CF_CALLOC(sizeof(CF_Hhdr) + (capacity + 1) * item_size);
+	table->cookie = CF_HCOOKIE;
+	table->key_size = key_size;
+	table->item_size = item_size;
+
+	// Space is made for a zero'd out "hidden item" to represent failed lookups.
+	// This is critical to support return-by-value polymorphism in the C macro API for `hget` and `hfind`.
+	// We also "pass" in values to `hadd` through this space.
+	table->hidden_item = (void*)((uintptr_t)(table + 1));
+	table->items_data = (void*)((uintptr_t)(table + 1) + item_size);
+	table->item_capacity = capacity;
+	table->items_key = CF_ALLOC(capacity * key_size);
+	table->items_slot_index = (int*)CF_ALLOC(capacity * sizeof(*table->items_slot_index));
+	table->temp_key = CF_ALLOC(key_size);
+	table->temp_item = CF_ALLOC(item_size);
+	table->seed = s_make_seed(table);
+
+	int slot_capacity = CF_HGROUP_SIZE;
+	while (s_max_load(slot_capacity) < capacity) slot_capacity *= 2;
+	s_rehash(table, slot_capacity);
+
+	return s_get_item(table, 0);
+}
+
+void cf_hashtable_free_impl(CF_Hhdr* table)
+{
+	if (!table) return;
+	CF_FREE(table->ctrl);
+	CF_FREE(table->slot_items);
+	CF_FREE(table->items_key);
+	CF_FREE(table->items_slot_index);
+	CF_FREE(table->temp_key);
+	CF_FREE(table->temp_item);
+	CF_FREE(table);
+}
+
+static CF_Hhdr* s_expand_items(CF_Hhdr* table)
+{
+	int capacity = table->item_capacity * 2;
+	table = (CF_Hhdr*)CF_REALLOC(table, sizeof(CF_Hhdr) + (capacity + 1) * table->item_size);
+	table->item_capacity = capacity;
+	table->hidden_item = (void*)((uintptr_t)(table + 1));
+	table->items_data = (void*)((uintptr_t)(table + 1) + table->item_size);
+	table->items_key = CF_REALLOC(table->items_key, capacity * table->key_size);
+	table->items_slot_index = (int*)CF_REALLOC(table->items_slot_index, capacity * sizeof(*table->items_slot_index));
+	return table;
+}
+
+static CF_Hhdr* s_insert(CF_Hhdr* table, uint64_t hash, const void* key, const void* item)
+{
+	int slot = s_find_slot(table, hash, key);
+	if (slot >= 0) {
+		int item_index = table->slot_items[slot];
+		void* item_dst = s_get_item(table, item_index);
+		if (item) {
+			CF_MEMCPY(item_dst, item, table->item_size);
+		} else {
+			CF_MEMSET(item_dst, 0, table->item_size);
+		}
+		table->return_index = item_index;
+		return table;
+	}
+
+	if (table->growth_left == 0) {
+		// Mostly tombstones means a same-sized rehash is enough to clean them up.
+		int capacity = table->slot_capacity;
+		if (table->count >= s_max_load(capacity) / 2) capacity *= 2;
+		s_rehash(table, capacity);
+	}
+
+	if (table->count >= table->item_capacity) {
+		bool hidden = item == table->hidden_item;
+		table = s_expand_items(table);
+
+		// Update the "hidden item" pointer, as it was invalidated by the item array expansion
+		// since the hidden item is at index -1.
+		if (hidden) item = table->hidden_item;
+	}
+
+	slot = s_find_free_slot(table, hash);
+	if (table->ctrl[slot] == CF_HCTRL_EMPTY) --table->growth_left;
+	table->ctrl[slot] = s_h2(hash);
+	table->slot_items[slot] = table->count;
+
+	void* item_dst = s_get_item(table, table->count);
+	void* key_dst = s_get_key(table, table->count);
+	if (item) {
+		CF_MEMCPY(item_dst, item, table->item_size);
+	} else {
+		CF_MEMSET(item_dst, 0, table->item_size);
+	}
+	CF_MEMCPY(key_dst, key, table->key_size);
+	table->items_slot_index[table->count] = slot;
+	table->return_index = table->count++;
+
+	return table;
+}
+
+void cf_hashtable_remove_impl2(CF_Hhdr* table, const void* key)
+{
+	int slot = s_find_slot(table, s_hash(table, key), key);
+	CF_ASSERT(slot >= 0);
+
+	// A slot can only go back to empty if its group already has an empty slot. Otherwise a probe for some other
+	// key may have continued on past this group, and would now stop here too early.
+	int group = slot & ~(CF_HGROUP_SIZE - 1);
+	if (s_group_match_empty(table->ctrl + group)) {
+		table->ctrl[slot] = CF_HCTRL_EMPTY;
+		++table->growth_left;
+	} else {
+		table->ctrl[slot] = CF_HCTRL_DELETED;
+	}
+
+	int index = table->slot_items[slot];
+	int last_index = table->count - 1;
+	if (index != last_index) {
+		void* dst_key = s_get_key(table, index);
+		void* src_key = s_get_key(table, last_index);
+		CF_MEMCPY(dst_key, src_key, (size_t)table->key_size);
+		void* dst_item = s_get_item(table, index);
+		void* src_item = s_get_item(table, last_index);
+		CF_MEMCPY(dst_item, src_item, (size_t)table->item_size);
+		table->items_slot_index[index] = table->items_slot_index[last_index];
+		table->slot_items[table->items_slot_index[last_index]] = index;
+	}
+	--table->count;
+}
+
+void cf_hashtable_clear_impl(CF_Hhdr* table)
+{
+	table->count = 0;
+	CF_MEMSET(table->ctrl, CF_HCTRL_EMPTY, table->slot_capacity);
+	table->growth_left = s_max_load(table->slot_capacity);
+}
+
+#else // CF_SWISS_HASHTABLE
+
 // Prime table sizes are used to help security of the table at the expense of the % operator,
 // as opposed to the speed << operator, for lookups.
 // By using prime table sizes we ensure all bits of each hash are utilized. This helps mitigate
@@ -35,18 +429,6 @@ static CF_INLINE int s_next_prime(int a)
 	return s_primes[i];
 }
 
-static CF_INLINE void* s_get_item(const CF_Hhdr* table, int index)
-{
-	uint8_t* items = (uint8_t*)table->items_data;
-	return items + index * table->item_size;
-}
-
-static CF_INLINE void* s_get_key(const CF_Hhdr* table, int index)
-{
-	uint8_t* keys = (uint8_t*)table->items_key;
-	return keys + index * table->key_size;
-}
-
 void* cf_hashtable_make_impl(int key_size, int item_size, int capacity)
 {
 	CF_ASSERT(capacity);
@@ -86,9 +468,9 @@ void cf_hashtable_free_impl(CF_Hhdr* table)
 	CF_FREE(table);
 }
 
-static CF_INLINE int s_keys_equal(const CF_Hhdr* table, const void* a, const void* b)
+static CF_INLINE uint64_t s_hash(const CF_Hhdr* table, const void* key)
 {
-	return !CF_MEMCMP(a, b, table->key_size);
+	return (uint32_t)fnv1a(key, table->key_size);
 }
 
 static int s_find_slot(const CF_Hhdr *table, uint32_t hash, const void* key)
@@ -162,9 +544,8 @@ static CF_Hhdr* s_expand_items(CF_Hhdr* table)
 	return table;
 }
 
-void* cf_hashtable_insert_impl2(CF_Hhdr* table, const void* key, const void* item)
+static CF_Hhdr* s_insert(CF_Hhdr* table, uint32_t hash, const void* key, const void* item)
 {
-	uint32_t hash = (uint32_t)fnv1a(key, table->key_size);
 	int slot = s_find_slot(table, hash, key);
 	if (slot >= 0) {
 		int item_index = table->slots[slot].item_index;
@@ -174,7 +555,8 @@ void* cf_hashtable_insert_impl2(CF_Hhdr* table, const void* key, const void* ite
 		} else {
 			CF_MEMSET(item_dst, 0, table->item_size);
 		}
-		return s_get_item(table, 0);
+		table->return_index = item_index;
+		return table;
 	}
 
 	if (table->count >= (table->slot_capacity - table->slot_capacity / 3)) {
@@ -202,11 +584,12 @@ void* cf_hashtable_insert_impl2(CF_Hhdr* table, const void* key, const void* ite
 	}
 
 	if (table->count >= table->item_capacity) {
+		bool hidden = item == table->hidden_item;
 		table = s_expand_items(table);
 
 		// Update the "hidden item" pointer, as it was invalidated by the item array expansion
 		// since the hidden item is at index -1.
-		item = (void*)((uintptr_t)(table + 1));
+		if (hidden) item = table->hidden_item;
 	}
 
 	CF_ASSERT(table->count < table->item_capacity);
@@ -226,22 +609,12 @@ void* cf_hashtable_insert_impl2(CF_Hhdr* table, const void* key, const void* ite
 	table->items_slot_index[table->count] = slot;
 	table->return_index = table->count++;
 
-	return s_get_item(table, 0);
-}
-
-void* cf_hashtable_insert_impl3(CF_Hhdr* table, const void* key)
-{
-	return cf_hashtable_insert_impl2(table, key, table->hidden_item);
-}
-
-void* cf_hashtable_insert_impl(CF_Hhdr* table, uint64_t key)
-{
-	return cf_hashtable_insert_impl2(table, &key, table->hidden_item);
+	return table;
 }
 
 void cf_hashtable_remove_impl2(CF_Hhdr* table, const void* key)
 {
-	uint32_t hash = (uint32_t)fnv1a(key, table->key_size);
+	uint32_t hash = (uint32_t)s_hash(table, key);
 	int slot = s_find_slot(table, hash, key);
 	CF_ASSERT(slot >= 0);
 
@@ -264,9 +637,19 @@ void cf_hashtable_remove_impl2(CF_Hhdr* table, const void* key)
 	--table->count;
 }
 
-void cf_hashtable_remove_impl(CF_Hhdr* table, uint64_t key)
+static CF_INLINE int s_slot_item(const CF_Hhdr* table, int slot)
 {
-	cf_hashtable_remove_impl2(table, &key);
+	return table->slots[slot].item_index;
+}
+
+static CF_INLINE void s_set_slot_item(CF_Hhdr* table, int slot, int item_index)
+{
+	table->slots[slot].item_index = item_index;
+}
+
+static CF_INLINE void s_prefetch_slot(const CF_Hhdr* table, uint64_t hash)
+{
+	CF_HPREFETCH(table->slots + (uint32_t)hash % (uint32_t)table->slot_capacity);
 }
 
 void cf_hashtable_clear_impl(CF_Hhdr* table)
@@ -278,9 +661,18 @@ void cf_hashtable_clear_impl(CF_Hhdr* table)
 	}
 }
 
+
+#endif // CF_SWISS_HASHTABLE
+
+void* cf_hashtable_insert_impl2(CF_Hhdr* table, const void* key, const void* item)
+{
+	table = s_insert(table, s_hash(table, key), key, item);
+	return s_get_item(table, 0);
+}
+
 int cf_hashtable_find_impl2(const CF_Hhdr* table, const void* key)
 {
-	int slot = s_find_slot(table, (uint32_t)fnv1a(key, table->key_size), key);
+	int slot = s_find_slot(table, s_hash(table, key), key);
 	if (slot < 0) {
 		// We will be "returning" a zero'd out item through `hget` with this
 		// hidden item.
@@ -289,10 +681,82 @@ int cf_hashtable_find_impl2(const CF_Hhdr* table, const void* key)
 		((CF_Hhdr *)table)->return_index = -1;
 		return -1;
 	}
-	((CF_Hhdr*)table)->return_index = table->slots[slot].item_index;
+	((CF_Hhdr*)table)->return_index = s_slot_item(table, slot);
 	return table->return_index;
 }
 
+// Batched operations hash CF_HBATCH_SIZE keys and prefetch their slots up-front, so the cache misses for
+// independent keys overlap instead of being paid one after another.
+void cf_hashtable_find_many_impl(const CF_Hhdr* table, const void* keys, int count, int* out_indices)
+{
+	uint64_t hashes[CF_HBATCH_SIZE];
+	const uint8_t* key_bytes = (const uint8_t*)keys;
+	for (int base = 0; base < count; base += CF_HBATCH_SIZE) {
+		int n = count - base < CF_HBATCH_SIZE ? count - base : CF_HBATCH_SIZE;
+		for (int i = 0; i < n; ++i) {
+			hashes[i] = s_hash(table, key_bytes + (base + i) * table->key_size);
+			s_prefetch_slot(table, hashes[i]);
+		}
+		for (int i = 0; i < n; ++i) {
+			int slot = s_find_slot(table, hashes[i], key_bytes + (base + i) * table->key_size);
+			out_indices[base + i] = slot < 0 ? -1 : s_slot_item(table, slot);
+		}
+	}
+}
+
+void cf_hashtable_get_many_impl(const CF_Hhdr* table, const uint64_t* keys, int count, void* out_items)
+{
+	CF_ASSERT(table->key_size == sizeof(uint64_t));
+	int indices[CF_HBATCH_SIZE];
+	uint8_t* out = (uint8_t*)out_items;
+	for (int base = 0; base < count; base += CF_HBATCH_SIZE) {
+		int n = count - base < CF_HBATCH_SIZE ? count - base : CF_HBATCH_SIZE;
+		cf_hashtable_find_many_impl(table, keys + base, n, indices);
+		for (int i = 0; i < n; ++i) {
+			void* dst = out + (base + i) * table->item_size;
+			if (indices[i] < 0) {
+				CF_MEMSET(dst, 0, table->item_size);
+			} else {
+				CF_MEMCPY(dst, s_get_item(table, indices[i]), table->item_size);
+			}
+		}
+	}
+}
+
+void* cf_hashtable_set_many_impl(CF_Hhdr* table, const uint64_t* keys, const void* items, int count)
+{
+	CF_ASSERT(table->key_size == sizeof(uint64_t));
+	uint64_t hashes[CF_HBATCH_SIZE];
+	const uint8_t* src = (const uint8_t*)items;
+	for (int base = 0; base < count; base += CF_HBATCH_SIZE) {
+		int n = count - base < CF_HBATCH_SIZE ? count - base : CF_HBATCH_SIZE;
+		for (int i = 0; i < n; ++i) {
+			hashes[i] = s_hash(table, keys + base + i);
+			s_prefetch_slot(table, hashes[i]);
+		}
+		for (int i = 0; i < n; ++i) {
+			// Hashes stay valid across any growth, since a table's hash function never changes.
+			table = s_insert(table, hashes[i], keys + base + i, src + (base + i) * table->item_size);
+		}
+	}
+	return s_get_item(table, 0);
+}
+
+void* cf_hashtable_insert_impl3(CF_Hhdr* table, const void* key)
+{
+	return cf_hashtable_insert_impl2(table, key, table->hidden_item);
+}
+
+void* cf_hashtable_insert_impl(CF_Hhdr* table, uint64_t key)
+{
+	return cf_hashtable_insert_impl2(table, &key, table->hidden_item);
+}
+
+void cf_hashtable_remove_impl(CF_Hhdr* table, uint64_t key)
+{
+	cf_hashtable_remove_impl2(table, &key);
+}
+
 int cf_hashtable_find_impl(const CF_Hhdr* table, uint64_t key)
 {
 	return cf_hashtable_find_impl2(table, &key);
@@ -340,8 +804,8 @@ void cf_hashtable_swap_impl(CF_Hhdr* table, int index_a, int index_b)
 	CF_MEMCPY(item_a, item_b, table->item_size);
 	CF_MEMCPY(item_b, table->temp_item, table->item_size);
 
-	table->slots[slot_a].item_index = index_b;
-	table->slots[slot_b].item_index = index_a;
+	s_set_slot_item(table, slot_a, index_b);
+	s_set_slot_item(table, slot_b, index_a);
 }
 
 static void s_sort(CF_Hhdr* table, int offset, int count)
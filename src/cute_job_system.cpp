@@ -0,0 +1,801 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include <cute_job_system.h>
+#include <cute_multithreading.h>
+#include <cute_c_runtime.h>
+#include <cute_alloc.h>
+#include <cute_array.h>
+#include <cute_math.h>
+
+#include <internal/cute_alloc_internal.h>
+
+#include <edubart/minicoro.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace Cute;
+
+#define CF_JOB_CACHELINE 64
+#define CF_JOB_DEFAULT_MAX_JOBS 4096
+#define CF_JOB_DEFAULT_FIBERS_PER_THREAD 32
+#define CF_JOB_DEFAULT_FIBER_STACK_SIZE (64 * 1024)
+// Each thread keeps a few free job slots to itself, so starting and finishing jobs rarely touches the shared free list.
+#define CF_JOB_FREE_CACHE_SIZE 64
+// How many times an idle worker looks for work before going to sleep.
+#define CF_JOB_SPIN_COUNT 64
+
+// Low 32 bits of a job's state, the high 32 bits hold the job's generation.
+#define CF_JOB_NO_DEPENDENTS 0xFFFFFFFFu
+#define CF_JOB_FINISHED      0xFFFFFFFEu
+
+struct alignas(CF_JOB_CACHELINE) CF_JobSlot
+{
+	CF_JobFn* fn;
+	void* udata;
+	// Dependencies yet to finish, plus one held by whoever is starting the job. Queued once this hits zero.
+	std::atomic<int> pending;
+	// Generation in the high bits, and in the low bits the head of the list of jobs waiting on this one, `CF_JOB_NO_DEPENDENTS`, or
+	// `CF_JOB_FINISHED`. Handles with a stale generation are finished, so nothing needs to be cleared when a slot is reused.
+	std::atomic<uint64_t> state;
+	std::atomic<int> next_free;
+};
+
+// Links a job into the list of jobs waiting on one of its dependencies.
+struct CF_JobEdge
+{
+	int job;
+	int next;
+	std::atomic<int> next_free;
+};
+
+// Chase-Lev work stealing deque of job indices. The owning thread pushes and pops at the bottom, any other thread may steal from
+// the top. It's sized to hold every job slot, so it can never fill up.
+struct CF_JobDeque
+{
+	alignas(CF_JOB_CACHELINE) std::atomic<int64_t> top;
+	alignas(CF_JOB_CACHELINE) std::atomic<int64_t> bottom;
+	std::atomic<int>* buffer;
+	int64_t mask;
+};
+
+#define CF_JOB_FIBER_RUNNING      0
+#define CF_JOB_FIBER_FINISHED     1
+#define CF_JOB_FIBER_YIELD        2
+#define CF_JOB_FIBER_WAIT_JOB     3
+#define CF_JOB_FIBER_WAIT_COUNTER 4
+
+// A pooled coroutine stack for jobs to run on, so they can be suspended mid-way while their worker moves on to other jobs.
+struct CF_JobFiber
+{
+	mco_coro* mco;
+	CF_JobSystem* system;
+	int job;
+	int state;
+	CF_Job wait_job;
+	CF_AtomicInt* counter;
+	int value;
+	std::atomic<int> next_free;
+};
+
+struct alignas(CF_JOB_CACHELINE) CF_JobWorker
+{
+	CF_JobSystem* system;
+	int index;
+	CF_Thread* thread;
+	CF_JobDeque deque;
+	uint32_t rnd;
+	int free_count;
+	int free_cache[CF_JOB_FREE_CACHE_SIZE];
+
+	// The fiber currently running on this worker, if any.
+	CF_JobFiber* fiber;
+	// Fibers which started on this worker and are suspended waiting on something. A fiber always resumes on the same worker it
+	// started on, as compilers are free to cache the addresses of thread local variables across a suspension.
+	Array<CF_JobFiber*> suspended;
+	bool fibers_first;
+};
+
+// Lock-free stack of free indices. The high 32 bits count every change, so a stale head can never be swapped in (ABA).
+struct CF_JobFreeList
+{
+	alignas(CF_JOB_CACHELINE) std::atomic<uint64_t> head;
+};
+
+struct CF_JobSystem
+{
+	int thread_count;
+	int max_jobs;
+	int free_cache_size;
+	CF_JobSlot* slots;
+	CF_JobEdge* edges;
+	int edge_count;
+	CF_JobFreeList free_slots;
+	CF_JobFreeList free_edges;
+
+	// Only used when made by `cf_make_fiber_job_system`.
+	CF_JobFiber* fibers;
+	int fiber_count;
+	CF_JobFreeList free_fibers;
+
+	// Worker 0 belongs to the thread which made the system, the rest each run on their own thread.
+	CF_JobWorker* workers;
+	int worker_count;
+	CF_ThreadId owner;
+
+	// Jobs started from threads without a deque of their own.
+	CF_Mutex injected_lock;
+	Array<int> injected;
+	std::atomic<int> injected_count;
+
+	alignas(CF_JOB_CACHELINE) std::atomic<bool> running;
+	std::atomic<int> sleeping;
+	CF_Mutex sleep_lock;
+	CF_ConditionVariable sleep_cv;
+};
+
+// Only set on worker threads, which are always joined before their system is destroyed, so this never dangles.
+// The thread which made a system is matched by id instead, as it may outlive the system or destroy it from elsewhere.
+static thread_local CF_JobWorker* s_worker;
+
+static CF_INLINE CF_JobWorker* s_current_worker(const CF_JobSystem* system)
+{
+	if (s_worker && s_worker->system == system) return s_worker;
+	return system->owner == cf_thread_id() ? system->workers : NULL;
+}
+
+static CF_INLINE uint64_t s_pack(uint32_t hi, uint32_t lo) { return ((uint64_t)hi << 32) | lo; }
+static CF_INLINE uint32_t s_hi(uint64_t v) { return (uint32_t)(v >> 32); }
+static CF_INLINE uint32_t s_lo(uint64_t v) { return (uint32_t)v; }
+
+//--------------------------------------------------------------------------------------------------
+// Free lists.
+
+template <typename T>
+static int s_free_list_pop(CF_JobFreeList* list, T* items)
+{
+	uint64_t head = list->head.load(std::memory_order_acquire);
+	while (true) {
+		uint32_t index = s_lo(head);
+		if (!index) return -1;
+		int next = items[index - 1].next_free.load(std::memory_order_relaxed);
+		if (list->head.compare_exchange_weak(head, s_pack(s_hi(head) + 1, (uint32_t)(next + 1)), std::memory_order_acquire, std::memory_order_acquire)) {
+			return (int)index - 1;
+		}
+	}
+}
+
+template <typename T>
+static void s_free_list_push(CF_JobFreeList* list, T* items, int index)
+{
+	uint64_t head = list->head.load(std::memory_order_relaxed);
+	while (true) {
+		items[index].next_free.store((int)s_lo(head) - 1, std::memory_order_relaxed);
+		if (list->head.compare_exchange_weak(head, s_pack(s_hi(head) + 1, (uint32_t)(index + 1)), std::memory_order_release, std::memory_order_relaxed)) {
+			return;
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+// Work stealing deque.
+
+static void s_deque_push(CF_JobDeque* deque, int job)
+{
+	int64_t b = deque->bottom.load(std::memory_order_relaxed);
+	deque->buffer[b & deque->mask].store(job, std::memory_order_relaxed);
+	deque->bottom.store(b + 1, std::memory_order_release);
+}
+
+static int s_deque_pop(CF_JobDeque* deque)
+{
+	int64_t b = deque->bottom.load(std::memory_order_relaxed) - 1;
+	deque->bottom.store(b, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t t = deque->top.load(std::memory_order_relaxed);
+	if (t > b) {
+		deque->bottom.store(b + 1, std::memory_order_relaxed);
+		return -1;
+	}
+	int job = deque->buffer[b & deque->mask].load(std::memory_order_relaxed);
+	if (t == b) {
+		// Last job, race any thieves for it.
+		if (!deque->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) job = -1;
+		deque->bottom.store(b + 1, std::memory_order_relaxed);
+	}
+	return job;
+}
+
+static int s_deque_steal(CF_JobDeque* deque)
+{
+	int64_t t = deque->top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t b = deque->bottom.load(std::memory_order_acquire);
+	if (t >= b) return -1;
+	int job = deque->buffer[t & deque->mask].load(std::memory_order_relaxed);
+	if (!deque->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return -1;
+	return job;
+}
+
+static CF_INLINE bool s_deque_empty(const CF_JobDeque* deque)
+{
+	return deque->top.load(std::memory_order_relaxed) >= deque->bottom.load(std::memory_order_relaxed);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Scheduling.
+
+static void s_wake(CF_JobSystem* system)
+{
+	// Pairs with the fence in `s_sleep`, either the sleeper sees the new job or this sees the sleeper.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (system->sleeping.load(std::memory_order_relaxed)) {
+		cf_mutex_lock(&system->sleep_lock);
+		cf_cv_wake_one(&system->sleep_cv);
+		cf_mutex_unlock(&system->sleep_lock);
+	}
+}
+
+static void s_queue(CF_JobSystem* system, int job)
+{
+	CF_JobWorker* worker = s_current_worker(system);
+	if (worker) {
+		s_deque_push(&worker->deque, job);
+	} else {
+		cf_mutex_lock(&system->injected_lock);
+		system->injected.add(job);
+		system->injected_count.store(system->injected.count(), std::memory_order_release);
+		cf_mutex_unlock(&system->injected_lock);
+	}
+	s_wake(system);
+}
+
+static int s_find_job(CF_JobSystem* system, CF_JobWorker* worker)
+{
+	int job;
+	if (worker && (job = s_deque_pop(&worker->deque)) >= 0) return job;
+
+	if (system->injected_count.load(std::memory_order_acquire)) {
+		job = -1;
+		cf_mutex_lock(&system->injected_lock);
+		if (system->injected.count()) {
+			job = system->injected.pop();
+			system->injected_count.store(system->injected.count(), std::memory_order_release);
+		}
+		cf_mutex_unlock(&system->injected_lock);
+		if (job >= 0) return job;
+	}
+
+	// Steal from the other workers, starting from a random one so thieves spread out.
+	uint32_t start = 0;
+	if (worker) {
+		worker->rnd ^= worker->rnd << 13;
+		worker->rnd ^= worker->rnd >> 17;
+		worker->rnd ^= worker->rnd << 5;
+		start = worker->rnd;
+	}
+	for (int i = 0; i < system->worker_count; ++i) {
+		CF_JobWorker* victim = system->workers + (start + i) % system->worker_count;
+		if (victim == worker) continue;
+		if ((job = s_deque_steal(&victim->deque)) >= 0) return job;
+	}
+	return -1;
+}
+
+static bool s_has_work(CF_JobSystem* system)
+{
+	if (system->injected_count.load(std::memory_order_relaxed)) return true;
+	for (int i = 0; i < system->worker_count; ++i) {
+		if (!s_deque_empty(&system->workers[i].deque)) return true;
+	}
+	return false;
+}
+
+static void s_sleep(CF_JobSystem* system)
+{
+	cf_mutex_lock(&system->sleep_lock);
+	system->sleeping.fetch_add(1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (system->running.load(std::memory_order_relaxed) && !s_has_work(system)) {
+		cf_cv_wait(&system->sleep_cv, &system->sleep_lock);
+	}
+	system->sleeping.fetch_sub(1, std::memory_order_relaxed);
+	cf_mutex_unlock(&system->sleep_lock);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Jobs.
+
+static void s_free_slot(CF_JobSystem* system, int index)
+{
+	CF_JobWorker* worker = s_current_worker(system);
+	if (!worker || !system->free_cache_size) {
+		s_free_list_push(&system->free_slots, system->slots, index);
+		return;
+	}
+	if (worker->free_count == system->free_cache_size) {
+		// Hand half back, so slots freed on one thread and used on another keep moving.
+		for (int i = 0; i < (system->free_cache_size + 1) / 2; ++i) {
+			s_free_list_push(&system->free_slots, system->slots, worker->free_cache[--worker->free_count]);
+		}
+	}
+	worker->free_cache[worker->free_count++] = index;
+}
+
+static CF_INLINE void s_release(CF_JobSystem* system, int index)
+{
+	if (system->slots[index].pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		s_queue(system, index);
+	}
+}
+
+static void s_execute(CF_JobSystem* system, int index)
+{
+	CF_JobSlot* slot = system->slots + index;
+	if (slot->fn) slot->fn(slot->udata);
+
+	// Mark the job finished, closing its list of dependents, then queue up any dependents this was the last dependency of.
+	uint64_t state = slot->state.load(std::memory_order_relaxed);
+	state = slot->state.exchange(s_pack(s_hi(state), CF_JOB_FINISHED), std::memory_order_acq_rel);
+	uint32_t edge = s_lo(state);
+	while (edge != CF_JOB_NO_DEPENDENTS) {
+		CF_JobEdge* e = system->edges + edge;
+		uint32_t next = (uint32_t)e->next;
+		s_release(system, e->job);
+		s_free_list_push(&system->free_edges, system->edges, (int)edge);
+		edge = next;
+	}
+	s_free_slot(system, index);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Fibers.
+
+static void s_fiber_fn(mco_coro* mco)
+{
+	CF_JobFiber* fiber = (CF_JobFiber*)mco_get_user_data(mco);
+	// Fibers are reused over and over, so this never returns. Each pass runs one job then hands control back to the worker.
+	while (true) {
+		s_execute(fiber->system, fiber->job);
+		fiber->state = CF_JOB_FIBER_FINISHED;
+		mco_yield(mco);
+	}
+}
+
+static bool s_fiber_ready(const CF_JobSystem* system, CF_JobFiber* fiber)
+{
+	switch (fiber->state) {
+	case CF_JOB_FIBER_WAIT_JOB: return cf_job_is_done(system, fiber->wait_job);
+	case CF_JOB_FIBER_WAIT_COUNTER: return cf_atomic_get(fiber->counter) <= fiber->value;
+	default: return true;
+	}
+}
+
+static void s_resume(CF_JobSystem* system, CF_JobWorker* worker, CF_JobFiber* fiber)
+{
+	CF_ASSERT(!worker->fiber);
+	worker->fiber = fiber;
+	fiber->state = CF_JOB_FIBER_RUNNING;
+	mco_result res = mco_resume(fiber->mco);
+	CF_ASSERT(res == MCO_SUCCESS);
+	CF_UNUSED(res);
+	worker->fiber = NULL;
+	if (fiber->state == CF_JOB_FIBER_FINISHED) {
+		s_free_list_push(&system->free_fibers, system->fibers, (int)(fiber - system->fibers));
+	} else {
+		worker->suspended.add(fiber);
+	}
+}
+
+static bool s_resume_ready_fiber(CF_JobSystem* system, CF_JobWorker* worker)
+{
+	for (int i = 0; i < worker->suspended.count(); ++i) {
+		CF_JobFiber* fiber = worker->suspended[i];
+		if (s_fiber_ready(system, fiber)) {
+			worker->suspended.unordered_remove(i);
+			s_resume(system, worker, fiber);
+			return true;
+		}
+	}
+	return false;
+}
+
+static void s_run(CF_JobSystem* system, CF_JobWorker* worker, int job)
+{
+	// Only worker threads own fibers. If the thread which made the system suspended fibers of its own, they would be stuck whenever it
+	// stopped calling into the job system.
+	if (system->fiber_count && worker && worker->index) {
+		int index = s_free_list_pop(&system->free_fibers, system->fibers);
+		if (index >= 0) {
+			system->fibers[index].job = job;
+			s_resume(system, worker, system->fibers + index);
+			return;
+		}
+	}
+	// Out of fibers, so just run it on this thread's own stack.
+	s_execute(system, job);
+}
+
+// Does one piece of work, either continuing a suspended fiber that's ready or running a queued job. Alternates which comes
+// first, so fibers that merely yielded can't starve out new jobs, and vice versa.
+static bool s_work_once(CF_JobSystem* system, CF_JobWorker* worker)
+{
+	bool fibers_first = false;
+	if (worker && worker->suspended.count()) {
+		fibers_first = worker->fibers_first = !worker->fibers_first;
+		if (fibers_first && s_resume_ready_fiber(system, worker)) return true;
+	}
+	int job = s_find_job(system, worker);
+	if (job >= 0) {
+		s_run(system, worker, job);
+		return true;
+	}
+	return worker && !fibers_first && worker->suspended.count() && s_resume_ready_fiber(system, worker);
+}
+
+// Suspends the running fiber until it's ready again, handing its worker back to other work in the meantime.
+static void s_suspend(CF_JobWorker* worker, int state)
+{
+	CF_JobFiber* fiber = worker->fiber;
+	fiber->state = state;
+	mco_result res = mco_yield(fiber->mco);
+	CF_ASSERT(res == MCO_SUCCESS);
+	CF_UNUSED(res);
+}
+
+// Makes a little progress on other work while waiting for something.
+static void s_help(CF_JobSystem* system, CF_JobWorker* worker)
+{
+	if (worker && worker->fiber) {
+		s_suspend(worker, CF_JOB_FIBER_YIELD);
+	} else if (!s_work_once(system, worker)) {
+		std::this_thread::yield();
+	}
+}
+
+static int s_alloc_slot(CF_JobSystem* system)
+{
+	CF_JobWorker* worker = s_current_worker(system);
+	if (worker && worker->free_count) return worker->free_cache[--worker->free_count];
+	while (true) {
+		int index = s_free_list_pop(&system->free_slots, system->slots);
+		if (index >= 0) return index;
+		// Every slot is in use, so help finish some jobs off.
+		s_help(system, worker);
+		if (worker && worker->free_count) return worker->free_cache[--worker->free_count];
+	}
+}
+
+static int s_alloc_edge(CF_JobSystem* system)
+{
+	while (true) {
+		int index = s_free_list_pop(&system->free_edges, system->edges);
+		if (index >= 0) return index;
+		s_help(system, s_current_worker(system));
+	}
+}
+
+static int s_worker_thread(void* udata)
+{
+	CF_JobWorker* worker = (CF_JobWorker*)udata;
+	CF_JobSystem* system = worker->system;
+	s_worker = worker;
+	int idle = 0;
+	while (system->running.load(std::memory_order_acquire)) {
+		if (s_work_once(system, worker)) {
+			idle = 0;
+		} else if (++idle < CF_JOB_SPIN_COUNT || worker->suspended.count()) {
+			// Nothing wakes a sleeping worker when one of its suspended fibers becomes ready, so never sleep while holding any.
+			std::this_thread::yield();
+		} else {
+			s_sleep(system);
+			idle = 0;
+		}
+	}
+	s_worker = NULL;
+	return 0;
+}
+
+static CF_JobSystem* s_make_job_system(int thread_count, int max_jobs, int fiber_count, int fiber_stack_size)
+{
+	int capacity = 1;
+	while (capacity < max_jobs) capacity *= 2;
+
+	CF_JobSystem* system = (CF_JobSystem*)cf_aligned_alloc(sizeof(CF_JobSystem), CF_JOB_CACHELINE);
+	CF_PLACEMENT_NEW(system) CF_JobSystem();
+	system->thread_count = thread_count;
+	system->max_jobs = max_jobs;
+	system->slots = (CF_JobSlot*)cf_aligned_alloc(sizeof(CF_JobSlot) * max_jobs, CF_JOB_CACHELINE);
+	system->edge_count = max_jobs * 4;
+	system->edges = (CF_JobEdge*)CF_ALLOC(sizeof(CF_JobEdge) * system->edge_count);
+	system->free_slots.head = 0;
+	system->free_edges.head = 0;
+	for (int i = max_jobs - 1; i >= 0; --i) {
+		CF_PLACEMENT_NEW(system->slots + i) CF_JobSlot();
+		system->slots[i].state = s_pack(0, CF_JOB_FINISHED);
+		s_free_list_push(&system->free_slots, system->slots, i);
+	}
+	for (int i = system->edge_count - 1; i >= 0; --i) {
+		CF_PLACEMENT_NEW(system->edges + i) CF_JobEdge();
+		s_free_list_push(&system->free_edges, system->edges, i);
+	}
+
+	system->injected_lock = cf_make_mutex();
+	system->injected.ensure_capacity(max_jobs);
+	system->injected_count = 0;
+	system->running = true;
+	system->sleeping = 0;
+	system->sleep_lock = cf_make_mutex();
+	system->sleep_cv = cf_make_cv();
+
+	system->worker_count = thread_count + 1;
+	// Caches are kept small enough that most slots always stay up for grabs by any thread.
+	system->free_cache_size = cf_min(max_jobs / (system->worker_count * 4), CF_JOB_FREE_CACHE_SIZE);
+	system->workers = (CF_JobWorker*)cf_aligned_alloc(sizeof(CF_JobWorker) * system->worker_count, CF_JOB_CACHELINE);
+	for (int i = 0; i < system->worker_count; ++i) {
+		CF_JobWorker* worker = system->workers + i;
+		CF_PLACEMENT_NEW(worker) CF_JobWorker();
+		worker->system = system;
+		worker->index = i;
+		worker->thread = NULL;
+		worker->deque.top = 0;
+		worker->deque.bottom = 0;
+		worker->deque.buffer = (std::atomic<int>*)CF_ALLOC(sizeof(std::atomic<int>) * capacity);
+		for (int j = 0; j < capacity; ++j) CF_PLACEMENT_NEW(worker->deque.buffer + j) std::atomic<int>(-1);
+		worker->deque.mask = capacity - 1;
+		worker->rnd = 0x9E3779B9u * (uint32_t)(i + 1);
+		worker->free_count = 0;
+		worker->fiber = NULL;
+		worker->suspended.ensure_capacity(fiber_count);
+		worker->fibers_first = false;
+	}
+
+	system->fiber_count = fiber_count;
+	system->fibers = NULL;
+	system->free_fibers.head = 0;
+	if (fiber_count) {
+		system->fibers = (CF_JobFiber*)CF_ALLOC(sizeof(CF_JobFiber) * fiber_count);
+		for (int i = fiber_count - 1; i >= 0; --i) {
+			CF_JobFiber* fiber = system->fibers + i;
+			CF_PLACEMENT_NEW(fiber) CF_JobFiber();
+			mco_desc desc = mco_desc_init(s_fiber_fn, (size_t)fiber_stack_size);
+			desc.user_data = (void*)fiber;
+			mco_result res = mco_create(&fiber->mco, &desc);
+			CF_ASSERT(res == MCO_SUCCESS);
+			CF_UNUSED(res);
+			fiber->system = system;
+			fiber->state = CF_JOB_FIBER_FINISHED;
+			s_free_list_push(&system->free_fibers, system->fibers, i);
+		}
+	}
+
+	system->owner = cf_thread_id();
+	for (int i = 1; i < system->worker_count; ++i) {
+		system->workers[i].thread = cf_thread_create(s_worker_thread, "CF Job Worker", system->workers + i);
+	}
+	return system;
+}
+
+CF_JobSystem* cf_make_job_system(int thread_count, int max_jobs)
+{
+	if (thread_count <= 0) thread_count = cf_max(cf_core_count() - 1, 1);
+	if (max_jobs <= 0) max_jobs = CF_JOB_DEFAULT_MAX_JOBS;
+	return s_make_job_system(thread_count, max_jobs, 0, 0);
+}
+
+CF_JobSystem* cf_make_fiber_job_system(int thread_count, int max_jobs, int fiber_count, int fiber_stack_size)
+{
+	if (thread_count <= 0) thread_count = cf_max(cf_core_count() - 1, 1);
+	if (max_jobs <= 0) max_jobs = CF_JOB_DEFAULT_MAX_JOBS;
+	if (fiber_count <= 0) fiber_count = thread_count * CF_JOB_DEFAULT_FIBERS_PER_THREAD;
+	if (fiber_stack_size <= 0) fiber_stack_size = CF_JOB_DEFAULT_FIBER_STACK_SIZE;
+	return s_make_job_system(thread_count, max_jobs, fiber_count, fiber_stack_size);
+}
+
+void cf_destroy_job_system(CF_JobSystem* system)
+{
+	if (!system) return;
+	cf_mutex_lock(&system->sleep_lock);
+	system->running.store(false, std::memory_order_release);
+	cf_cv_wake_all(&system->sleep_cv);
+	cf_mutex_unlock(&system->sleep_lock);
+	for (int i = 1; i < system->worker_count; ++i) {
+		cf_thread_wait(system->workers[i].thread);
+	}
+
+	for (int i = 0; i < system->worker_count; ++i) {
+		CF_FREE(system->workers[i].deque.buffer);
+		system->workers[i].~CF_JobWorker();
+	}
+	for (int i = 0; i < system->fiber_count; ++i) {
+		mco_destroy(system->fibers[i].mco);
+	}
+	CF_FREE(system->fibers);
+	cf_aligned_free(system->workers);
+	cf_destroy_mutex(&system->injected_lock);
+	cf_destroy_mutex(&system->sleep_lock);
+	cf_destroy_cv(&system->sleep_cv);
+	cf_aligned_free(system->slots);
+	CF_FREE(system->edges);
+	system->~CF_JobSystem();
+	cf_aligned_free(system);
+}
+
+int cf_job_system_thread_count(const CF_JobSystem* system)
+{
+	return system->thread_count;
+}
+
+CF_Job cf_job_run(CF_JobSystem* system, CF_JobFn* fn, void* udata)
+{
+	return cf_job_run_after(system, fn, udata, NULL, 0);
+}
+
+CF_Job cf_job_run_after(CF_JobSystem* system, CF_JobFn* fn, void* udata, const CF_Job* dependencies, int dependency_count)
+{
+	int index = s_alloc_slot(system);
+	CF_JobSlot* slot = system->slots + index;
+	slot->fn = fn;
+	slot->udata = udata;
+	slot->pending.store(dependency_count + 1, std::memory_order_relaxed);
+	uint32_t generation = s_hi(slot->state.load(std::memory_order_relaxed)) + 1;
+	if (!generation) generation = 1;
+	slot->state.store(s_pack(generation, CF_JOB_NO_DEPENDENTS), std::memory_order_release);
+	CF_Job job = { s_pack(generation, (uint32_t)index) };
+
+	for (int i = 0; i < dependency_count; ++i) {
+		// Link this job into the dependency's list of dependents, unless it has already finished.
+		uint32_t dependency_generation = s_hi(dependencies[i].id);
+		CF_JobSlot* dependency = system->slots + s_lo(dependencies[i].id);
+		int edge = -1;
+		uint64_t state = dependency_generation ? dependency->state.load(std::memory_order_acquire) : 0;
+		while (dependency_generation && s_hi(state) == dependency_generation && s_lo(state) != CF_JOB_FINISHED) {
+			if (edge < 0) {
+				edge = s_alloc_edge(system);
+				system->edges[edge].job = index;
+				// Allocating may have run jobs, including this dependency.
+				state = dependency->state.load(std::memory_order_acquire);
+				continue;
+			}
+			system->edges[edge].next = (int)s_lo(state);
+			if (dependency->state.compare_exchange_weak(state, s_pack(dependency_generation, (uint32_t)edge), std::memory_order_acq_rel, std::memory_order_acquire)) {
+				edge = -2;
+				break;
+			}
+		}
+		if (edge == -2) continue;
+		if (edge >= 0) s_free_list_push(&system->free_edges, system->edges, edge);
+		slot->pending.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	s_release(system, index);
+	return job;
+}
+
+bool cf_job_is_done(const CF_JobSystem* system, CF_Job job)
+{
+	if (!job.id) return true;
+	uint64_t state = system->slots[s_lo(job.id)].state.load(std::memory_order_acquire);
+	return s_hi(state) != s_hi(job.id) || s_lo(state) == CF_JOB_FINISHED;
+}
+
+void cf_job_wait(CF_JobSystem* system, CF_Job job)
+{
+	CF_JobWorker* worker = s_current_worker(system);
+	if (cf_job_is_done(system, job)) return;
+	if (worker && worker->fiber) {
+		worker->fiber->wait_job = job;
+		s_suspend(worker, CF_JOB_FIBER_WAIT_JOB);
+		return;
+	}
+	while (!cf_job_is_done(system, job)) {
+		if (!s_work_once(system, worker)) std::this_thread::yield();
+	}
+}
+
+void cf_job_wait_counter(CF_JobSystem* system, CF_AtomicInt* counter, int value)
+{
+	CF_JobWorker* worker = s_current_worker(system);
+	if (cf_atomic_get(counter) <= value) return;
+	if (worker && worker->fiber) {
+		worker->fiber->counter = counter;
+		worker->fiber->value = value;
+		s_suspend(worker, CF_JOB_FIBER_WAIT_COUNTER);
+		return;
+	}
+	while (cf_atomic_get(counter) > value) {
+		if (!s_work_once(system, worker)) std::this_thread::yield();
+	}
+}
+
+void cf_job_yield(CF_JobSystem* system)
+{
+	s_help(system, s_current_worker(system));
+}
+
+//--------------------------------------------------------------------------------------------------
+// Parallel for.
+
+struct CF_ParallelForRange
+{
+	CF_JobSystem* system;
+	CF_ParallelForFn* fn;
+	void* udata;
+	int begin;
+	int end;
+	int min_batch;
+	// How many more times this range may be split in half.
+	int splits;
+	// The worker which handed this range off, to tell when it's been stolen.
+	CF_JobWorker* owner;
+};
+
+static int s_split_levels(const CF_JobSystem* system)
+{
+	int levels = 0;
+	while ((1 << levels) < system->worker_count) ++levels;
+	return levels;
+}
+
+static void s_parallel_for_range(void* udata)
+{
+	CF_ParallelForRange* range = (CF_ParallelForRange*)udata;
+	CF_JobSystem* system = range->system;
+	CF_JobWorker* worker = s_current_worker(system);
+	int splits = range->splits;
+	if (worker != range->owner) {
+		// Another thread ran out of work and stole this range, so make sure there's enough left to go around again.
+		splits = cf_max(splits, s_split_levels(system) + 1);
+	}
+
+	// Hand off the upper half over and over, keeping the lower half. Each half lives on this stack frame, which waits on them below,
+	// so nothing is allocated. The range at least halves every time, so 32 levels is plenty for any int.
+	CF_ParallelForRange halves[32];
+	CF_Job jobs[32];
+	int count = 0;
+	int begin = range->begin;
+	int end = range->end;
+	while (splits > 0 && end - begin >= range->min_batch * 2) {
+		int mid = begin + (end - begin) / 2;
+		CF_ParallelForRange* half = halves + count;
+		*half = *range;
+		half->begin = mid;
+		half->end = end;
+		half->splits = --splits;
+		half->owner = worker;
+		jobs[count++] = cf_job_run(system, s_parallel_for_range, half);
+		end = mid;
+	}
+	range->fn(begin, end, range->udata);
+
+	// Newest halves are the smallest and the most likely to still be sitting in this thread's queue.
+	while (count) {
+		cf_job_wait(system, jobs[--count]);
+	}
+}
+
+void cf_parallel_for(CF_JobSystem* system, int count, int min_batch, CF_ParallelForFn* fn, void* udata)
+{
+	if (count <= 0) return;
+	if (min_batch < 1) min_batch = 1;
+	if (!system || count < min_batch * 2) {
+		fn(0, count, udata);
+		return;
+	}
+	CF_ParallelForRange range;
+	range.system = system;
+	range.fn = fn;
+	range.udata = udata;
+	range.begin = 0;
+	range.end = count;
+	range.min_batch = min_batch;
+	// Start with a few chunks per thread, later steals split things up further as needed.
+	range.splits = s_split_levels(system) + 2;
+	range.owner = s_current_worker(system);
+	s_parallel_for_range(&range);
+}
@@ -9,18 +9,41 @@
 #include "cute_file_system.h"
 #include "internal/yyjson.h"
 
+#include <internal/cute_alloc_internal.h>
+
 #include <stddef.h>
 
+static void* s_json_alloc(void* ctx, size_t size)
+{
+	CF_UNUSED(ctx);
+	return cf_alloc_tagged(size, CF_MEMORY_TAG_JSON);
+}
+
+static void* s_json_realloc(void* ctx, void* ptr, size_t old_size, size_t size)
+{
+	CF_UNUSED(ctx);
+	CF_UNUSED(old_size);
+	return cf_realloc_tagged(ptr, size, CF_MEMORY_TAG_JSON);
+}
+
+static void s_json_free(void* ctx, void* ptr)
+{
+	CF_UNUSED(ctx);
+	cf_free(ptr);
+}
+
+static const yyjson_alc s_json_allocator = { s_json_alloc, s_json_realloc, s_json_free, NULL };
+
 CF_JDoc cf_make_json(const void* data, size_t size)
 {
 	yyjson_mut_doc* doc = NULL;
 	if (data) {
 		yyjson_read_flag flags = YYJSON_READ_ALLOW_TRAILING_COMMAS | YYJSON_READ_ALLOW_COMMENTS | YYJSON_READ_ALLOW_INF_AND_NAN | YYJSON_READ_ALLOW_INVALID_UNICODE;
-		yyjson_doc* read_only_doc = yyjson_read((char*)data, size, flags);
-		doc = yyjson_doc_mut_copy(read_only_doc, NULL);
+		yyjson_doc* read_only_doc = yyjson_read_opts((char*)data, size, flags, &s_json_allocator, NULL);
+		doc = yyjson_doc_mut_copy(read_only_doc, &s_json_allocator);
 		yyjson_doc_free(read_only_doc);
 	} else {
-		doc = yyjson_mut_doc_new(NULL);
+		doc = yyjson_mut_doc_new(&s_json_allocator);
 	}
 	CF_JDoc result = { (uint64_t)doc };
 	return result;
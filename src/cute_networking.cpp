@@ -6,7 +6,12 @@
 */
 
 #include <cute_networking.h>
+#include <cute_profile.h>
 
+#include <internal/cute_alloc_internal.h>
+
+#define CN_ALLOC(size, ctx) cf_alloc_tagged(size, CF_MEMORY_TAG_NET)
+#define CN_FREE(mem, ctx) cf_free(mem)
 #define CUTE_NET_IMPLEMENTATION
 #include <cute/cute_net.h>
 
@@ -184,6 +189,7 @@ void cf_server_free_packet(CF_Server* server, int client_index, void* data)
 
 void cf_server_update(CF_Server* server, double dt, uint64_t current_time)
 {
+	CF_PROFILE_SCOPE("cf_server_update");
 	cn_server_update(server, dt, current_time);
 }
 
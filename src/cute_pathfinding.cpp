@@ -0,0 +1,1027 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include <cute_pathfinding.h>
+#include <cute_priority_queue.h>
+#include <cute_c_runtime.h>
+#include <cute_alloc.h>
+#include <cute_math.h>
+
+#include <internal/cute_alloc_internal.h>
+
+#include <atomic>
+
+using namespace Cute;
+
+#define CF_PATH_SQRT2 1.41421356f
+#define CF_PATH_CLOSED -1
+// Runs of open cells along a cluster's edge longer than this get an entrance at each end, instead of one in the middle.
+#define CF_PATH_ENTRANCE_SPLIT 5
+
+// Cells are stored with a one cell border of blocked cells all the way around, so neighbor lookups never need
+// bounds checks. Cells are addressed by their index into this padded array.
+struct CF_PathGrid
+{
+	int w;
+	int h;
+	int stride;
+	uint8_t* blocked;
+	CF_PathHierarchy* hierarchy;
+};
+
+struct CF_PathNode
+{
+	float g;
+	int parent;
+	// Nodes are only valid if their generation matches the context's, so nothing is cleared between searches.
+	uint32_t generation;
+	// Handle into the open list, or `CF_PATH_CLOSED`.
+	int handle;
+};
+
+struct CF_PathEdge
+{
+	int to;
+	float cost;
+};
+
+struct CF_PathContext
+{
+	const CF_PathGrid* grid;
+	IndexedPriorityQueue<int> open;
+	// Nodes popped off the open list since the last request started, see `CF_PathRequest::expanded_count`.
+	int expanded;
+
+	// One node per cell of the whole grid for `cf_path_find`. Only allocated on the first call, as contexts used just for
+	// hierarchical searches never need it.
+	uint32_t generation;
+	CF_PathNode* nodes;
+
+	// Nodes for searches confined to a single cluster, addressed by position within the cluster rather than by cell, so this
+	// only ever grows as big as one cluster. Parents are stored as cells.
+	uint32_t window_generation;
+	Array<CF_PathNode> window;
+	// Parallel to `window`, holding the generation of the search a cell is a target of, so flood searches check for targets in O(1).
+	Array<uint32_t> window_targets;
+	int window_x0, window_y0;
+	int window_w, window_h;
+
+	// Scratch for hierarchical searches, grown to fit the hierarchy the first time it's searched.
+	uint32_t abstract_generation;
+	Array<CF_PathNode> abstract;
+	Array<CF_PathEdge> start_edges;
+	Array<CF_PathEdge> goal_edges;
+	Array<int> gathered;
+	Array<int> targets;
+	Array<int> route;
+	Array<int> cells;
+};
+
+// An entrance cell on one side of a cluster's edge. The first edge always leads to its partner across the edge, and the rest lead
+// to the other entrances within the same cluster.
+struct CF_PathEntrance
+{
+	int cell;
+	int x, y;
+	int cluster;
+	Array<CF_PathEdge> edges;
+};
+
+struct CF_PathCluster
+{
+	int x0, y0;
+	int x1, y1;
+	// Pairs of entrances along the edge shared with the cluster to the right (east) and above (north). Even elements sit in this
+	// cluster, and odd elements are their partners in the neighbor.
+	Array<int> east;
+	Array<int> north;
+	bool dirty;
+	bool east_dirty;
+	bool north_dirty;
+};
+
+struct CF_PathHierarchy
+{
+	CF_PathGrid* grid;
+	int cluster_size;
+	int cluster_w;
+	int cluster_h;
+	Array<CF_PathCluster> clusters;
+	Array<CF_PathEntrance> entrances;
+	Array<int> free_entrances;
+	Array<int> dirty;
+	Array<int> gathered;
+	Array<int> targets;
+	CF_PathContext* ctx;
+};
+
+static void s_cell_changed(CF_PathHierarchy* hierarchy, int x, int y);
+
+static CF_INLINE int s_index(const CF_PathGrid* grid, int x, int y)
+{
+	return (y + 1) * grid->stride + (x + 1);
+}
+
+static CF_INLINE int s_x(const CF_PathGrid* grid, int index) { return index % grid->stride - 1; }
+static CF_INLINE int s_y(const CF_PathGrid* grid, int index) { return index / grid->stride - 1; }
+
+static CF_INLINE int s_sign(int v) { return (v > 0) - (v < 0); }
+
+static CF_INLINE float s_octile(int dx, int dy)
+{
+	dx = dx < 0 ? -dx : dx;
+	dy = dy < 0 ? -dy : dy;
+	int lo = dx < dy ? dx : dy;
+	int hi = dx < dy ? dy : dx;
+	return (float)(hi - lo) + (float)lo * CF_PATH_SQRT2;
+}
+
+CF_PathGrid* cf_make_path_grid(int w, int h)
+{
+	CF_ASSERT(w > 0 && h > 0);
+	CF_PathGrid* grid = (CF_PathGrid*)CF_ALLOC(sizeof(CF_PathGrid));
+	grid->w = w;
+	grid->h = h;
+	grid->stride = w + 2;
+	int count = (w + 2) * (h + 2);
+	grid->blocked = (uint8_t*)CF_ALLOC(count);
+	grid->hierarchy = NULL;
+	CF_MEMSET(grid->blocked, 1, count);
+	for (int y = 0; y < h; ++y) {
+		CF_MEMSET(grid->blocked + s_index(grid, 0, y), 0, w);
+	}
+	return grid;
+}
+
+void cf_destroy_path_grid(CF_PathGrid* grid)
+{
+	if (!grid) return;
+	CF_ASSERT(!grid->hierarchy);
+	CF_FREE(grid->blocked);
+	CF_FREE(grid);
+}
+
+int cf_path_grid_width(const CF_PathGrid* grid)
+{
+	return grid->w;
+}
+
+int cf_path_grid_height(const CF_PathGrid* grid)
+{
+	return grid->h;
+}
+
+void cf_path_grid_set_blocked(CF_PathGrid* grid, int x, int y, bool blocked)
+{
+	CF_ASSERT(x >= 0 && x < grid->w && y >= 0 && y < grid->h);
+	uint8_t* cell = grid->blocked + s_index(grid, x, y);
+	if (*cell == (blocked ? 1 : 0)) return;
+	*cell = blocked ? 1 : 0;
+	if (grid->hierarchy) s_cell_changed(grid->hierarchy, x, y);
+}
+
+bool cf_path_grid_is_blocked(const CF_PathGrid* grid, int x, int y)
+{
+	if (x < 0 || x >= grid->w || y < 0 || y >= grid->h) return true;
+	return grid->blocked[s_index(grid, x, y)];
+}
+
+CF_PathContext* cf_make_path_context(const CF_PathGrid* grid)
+{
+	CF_PathContext* ctx = (CF_PathContext*)CF_ALLOC(sizeof(CF_PathContext));
+	CF_PLACEMENT_NEW(ctx) CF_PathContext();
+	ctx->grid = grid;
+	ctx->generation = 0;
+	ctx->nodes = NULL;
+	ctx->window_generation = 0;
+	ctx->window_x0 = ctx->window_y0 = 0;
+	ctx->window_w = ctx->window_h = 0;
+	ctx->abstract_generation = 0;
+	ctx->expanded = 0;
+	ctx->open.reserve(1024);
+	return ctx;
+}
+
+void cf_destroy_path_context(CF_PathContext* ctx)
+{
+	if (!ctx) return;
+	CF_FREE(ctx->nodes);
+	ctx->~CF_PathContext();
+	CF_FREE(ctx);
+}
+
+// Steps from `from` in the direction `d` until a jump point is found, returning it along with the number of steps taken.
+// `perp` is the offset perpendicular to `d`, used to look for forced neighbors on either side.
+static int s_jump_straight(const CF_PathGrid* grid, int from, int d, int perp, int goal, int* steps)
+{
+	const uint8_t* blocked = grid->blocked;
+	int c = from;
+	int n = 1;
+	while (!blocked[c]) {
+		if (c == goal) { *steps = n; return c; }
+		// A neighbor to the side which can't be reached diagonally from the previous cell (corner cutting isn't allowed)
+		// is forced, so this cell must be expanded.
+		if ((!blocked[c + perp] && blocked[c - d + perp]) || (!blocked[c - perp] && blocked[c - d - perp])) {
+			*steps = n;
+			return c;
+		}
+		c += d;
+		++n;
+	}
+	return -1;
+}
+
+static int s_jump_diagonal(const CF_PathGrid* grid, int from, int dx, int dy, int goal, int* steps)
+{
+	const uint8_t* blocked = grid->blocked;
+	int stride = grid->stride;
+	int dv = dy * stride;
+	int c = from;
+	int n = 1;
+	int unused;
+	while (!blocked[c]) {
+		if (c == goal) { *steps = n; return c; }
+		// Any jump point found by scanning straight out from here makes this cell a jump point.
+		if (s_jump_straight(grid, c + dx, dx, stride, goal, &unused) >= 0 || s_jump_straight(grid, c + dv, dv, 1, goal, &unused) >= 0) {
+			*steps = n;
+			return c;
+		}
+		if (blocked[c + dx] || blocked[c + dv]) break;
+		c += dx + dv;
+		++n;
+	}
+	return -1;
+}
+
+// Estimated distance left to the goal. Searches without a goal flood outwards, like Dijkstra's algorithm.
+static CF_INLINE float s_heuristic(const CF_PathGrid* grid, int from, int goal)
+{
+	if (goal < 0) return 0;
+	return s_octile(s_x(grid, from) - s_x(grid, goal), s_y(grid, from) - s_y(grid, goal));
+}
+
+static void s_begin_search(CF_PathContext* ctx, int start, int goal)
+{
+	if (!ctx->nodes) {
+		ctx->nodes = (CF_PathNode*)CF_CALLOC(sizeof(CF_PathNode) * ctx->grid->stride * (ctx->grid->h + 2));
+		ctx->generation = 0;
+	}
+	if (++ctx->generation == 0) {
+		// Wrapped around, so old generations could look valid again.
+		CF_MEMSET(ctx->nodes, 0, sizeof(CF_PathNode) * ctx->grid->stride * (ctx->grid->h + 2));
+		ctx->generation = 1;
+	}
+	ctx->open.clear();
+	CF_PathNode* node = ctx->nodes + start;
+	node->generation = ctx->generation;
+	node->g = 0;
+	node->parent = -1;
+	node->handle = ctx->open.push(start, s_heuristic(ctx->grid, start, goal));
+}
+
+static void s_relax(CF_PathContext* ctx, int from, int to, float g, int goal)
+{
+	CF_PathNode* node = ctx->nodes + to;
+	if (node->generation != ctx->generation) {
+		node->generation = ctx->generation;
+		node->g = g;
+		node->parent = from;
+		node->handle = ctx->open.push(to, g + s_heuristic(ctx->grid, to, goal));
+	} else if (node->handle != CF_PATH_CLOSED && g < node->g) {
+		node->g = g;
+		node->parent = from;
+		ctx->open.decrease_key(node->handle, g + s_heuristic(ctx->grid, to, goal));
+	}
+}
+
+static void s_expand_jps(CF_PathContext* ctx, int c, int goal)
+{
+	const CF_PathGrid* grid = ctx->grid;
+	const uint8_t* blocked = grid->blocked;
+	int stride = grid->stride;
+	CF_PathNode* node = ctx->nodes + c;
+
+	// Pick which directions to scan, pruning away any neighbor reachable at least as cheaply without going through `c`.
+	int dirs[8][2];
+	int dir_count = 0;
+	auto add = [&](int dx, int dy) { dirs[dir_count][0] = dx; dirs[dir_count][1] = dy; ++dir_count; };
+	if (node->parent < 0) {
+		for (int dy = -1; dy <= 1; ++dy) {
+			for (int dx = -1; dx <= 1; ++dx) {
+				if (!dx && !dy) continue;
+				if (dx && dy && (blocked[c + dx] || blocked[c + dy * stride])) continue;
+				add(dx, dy);
+			}
+		}
+	} else {
+		int dx = s_sign(s_x(grid, c) - s_x(grid, node->parent));
+		int dy = s_sign(s_y(grid, c) - s_y(grid, node->parent));
+		if (dx && dy) {
+			bool h = !blocked[c + dx];
+			bool v = !blocked[c + dy * stride];
+			if (v) add(0, dy);
+			if (h) add(dx, 0);
+			if (h && v) add(dx, dy);
+		} else {
+			// Moving straight, only the cell ahead is a natural neighbor. A cell to the side is forced when the cell behind it is
+			// blocked, as then it can't be reached diagonally from the parent without cutting a corner.
+			int d = dx + dy * stride;
+			int perp = dx ? stride : 1;
+			bool next = !blocked[c + d];
+			if (next) add(dx, dy);
+			for (int side = -1; side <= 1; side += 2) {
+				if (blocked[c + side * perp] || !blocked[c - d + side * perp]) continue;
+				int sx = dx ? 0 : side;
+				int sy = dx ? side : 0;
+				add(sx, sy);
+				if (next) add(dx + sx, dy + sy);
+			}
+		}
+	}
+
+	for (int i = 0; i < dir_count; ++i) {
+		int dx = dirs[i][0];
+		int dy = dirs[i][1];
+		int steps;
+		int jump;
+		if (dx && dy) {
+			jump = s_jump_diagonal(grid, c + dx + dy * stride, dx, dy, goal, &steps);
+		} else if (dx) {
+			jump = s_jump_straight(grid, c + dx, dx, stride, goal, &steps);
+		} else {
+			jump = s_jump_straight(grid, c + dy * stride, dy * stride, 1, goal, &steps);
+		}
+		if (jump < 0) continue;
+		s_relax(ctx, c, jump, node->g + (float)steps * (dx && dy ? CF_PATH_SQRT2 : 1.0f), goal);
+	}
+}
+
+static void s_expand_astar(CF_PathContext* ctx, int c, int goal)
+{
+	const uint8_t* blocked = ctx->grid->blocked;
+	int stride = ctx->grid->stride;
+	float g = ctx->nodes[c].g;
+	for (int dy = -1; dy <= 1; ++dy) {
+		for (int dx = -1; dx <= 1; ++dx) {
+			if (!dx && !dy) continue;
+			int n = c + dx + dy * stride;
+			if (blocked[n]) continue;
+			if (dx && dy && (blocked[c + dx] || blocked[c + dy * stride])) continue;
+			s_relax(ctx, c, n, g + (dx && dy ? CF_PATH_SQRT2 : 1.0f), goal);
+		}
+	}
+}
+
+// Walks the parent links back from the goal, writing out only the cells where the path changes direction.
+static void s_write_path(CF_PathContext* ctx, int start, int goal, CF_PathRequest* request)
+{
+	const CF_PathGrid* grid = ctx->grid;
+	int count = 0;
+	for (int pass = 0; pass < 2; ++pass) {
+		int written = 0;
+		int c = goal;
+		int dx = 0, dy = 0;
+		while (true) {
+			int parent = c == start ? -1 : ctx->nodes[c].parent;
+			int ndx = parent < 0 ? 0 : s_sign(s_x(grid, c) - s_x(grid, parent));
+			int ndy = parent < 0 ? 0 : s_sign(s_y(grid, c) - s_y(grid, parent));
+			if (c == goal || parent < 0 || ndx != dx || ndy != dy) {
+				if (pass == 1) {
+					int i = count - 1 - written;
+					if (i < request->path_capacity) {
+						request->path[i].x = s_x(grid, c);
+						request->path[i].y = s_y(grid, c);
+					}
+				}
+				++written;
+			}
+			if (parent < 0) break;
+			dx = ndx;
+			dy = ndy;
+			c = parent;
+		}
+		count = written;
+		if (!request->path) break;
+	}
+	request->path_count = count;
+}
+
+bool cf_path_find(CF_PathContext* ctx, CF_PathRequest* request)
+{
+	const CF_PathGrid* grid = ctx->grid;
+	request->found = false;
+	request->path_count = 0;
+	request->cost = 0;
+	request->expanded_count = 0;
+	if (cf_path_grid_is_blocked(grid, request->start.x, request->start.y) || cf_path_grid_is_blocked(grid, request->goal.x, request->goal.y)) {
+		return false;
+	}
+
+	int start = s_index(grid, request->start.x, request->start.y);
+	int goal = s_index(grid, request->goal.x, request->goal.y);
+	s_begin_search(ctx, start, goal);
+	ctx->expanded = 0;
+
+	int c;
+	while (ctx->open.pop(&c)) {
+		ctx->nodes[c].handle = CF_PATH_CLOSED;
+		++ctx->expanded;
+		if (c == goal) {
+			request->found = true;
+			request->cost = ctx->nodes[c].g;
+			request->expanded_count = ctx->expanded;
+			s_write_path(ctx, start, goal, request);
+			return true;
+		}
+		if (request->astar_only) {
+			s_expand_astar(ctx, c, goal);
+		} else {
+			s_expand_jps(ctx, c, goal);
+		}
+	}
+
+	request->expanded_count = ctx->expanded;
+	return false;
+}
+
+// Plain A* which only visits cells inside of a cluster. With a negative `goal` this floods outwards instead, until every cell in
+// `targets` has been reached or the whole cluster has been visited. Results are read back with `s_cluster_reached`.
+static bool s_search_cluster(CF_PathContext* ctx, const CF_PathCluster* cluster, int start, int goal, const int* targets = NULL, int target_count = 0)
+{
+	const CF_PathGrid* grid = ctx->grid;
+	const uint8_t* blocked = grid->blocked;
+	int stride = grid->stride;
+	int x0 = cluster->x0, y0 = cluster->y0;
+	int x1 = cluster->x1, y1 = cluster->y1;
+	int w = x1 - x0;
+	int gx = goal < 0 ? 0 : s_x(grid, goal);
+	int gy = goal < 0 ? 0 : s_y(grid, goal);
+	auto heuristic = [&](int x, int y) { return goal < 0 ? 0.0f : s_octile(x - gx, y - gy); };
+
+	ctx->window_x0 = x0;
+	ctx->window_y0 = y0;
+	ctx->window_w = w;
+	ctx->window_h = y1 - y0;
+	if (ctx->window.count() < w * ctx->window_h) {
+		ctx->window.ensure_count(w * ctx->window_h);
+		ctx->window_targets.ensure_count(w * ctx->window_h);
+	}
+	if (++ctx->window_generation == 0) {
+		// Wrapped around, so old generations could look valid again.
+		CF_MEMSET(ctx->window.data(), 0, sizeof(CF_PathNode) * ctx->window.count());
+		CF_MEMSET(ctx->window_targets.data(), 0, sizeof(uint32_t) * ctx->window_targets.count());
+		ctx->window_generation = 1;
+	}
+	CF_PathNode* nodes = ctx->window.data();
+	uint32_t generation = ctx->window_generation;
+
+	ctx->open.clear();
+	int sx = s_x(grid, start), sy = s_y(grid, start);
+	CF_PathNode* node = nodes + (sx - x0) + (sy - y0) * w;
+	node->generation = generation;
+	node->g = 0;
+	node->parent = -1;
+	node->handle = ctx->open.push(start, heuristic(sx, sy));
+
+	// Mark each target, counting duplicates once. They're crossed off by clearing the mark as they're reached.
+	uint32_t* target_marks = ctx->window_targets.data();
+	int remaining = 0;
+	for (int i = 0; i < target_count; ++i) {
+		int tx = s_x(grid, targets[i]), ty = s_y(grid, targets[i]);
+		CF_ASSERT(tx >= x0 && tx < x1 && ty >= y0 && ty < y1);
+		int local = (tx - x0) + (ty - y0) * w;
+		if (target_marks[local] != generation) {
+			target_marks[local] = generation;
+			++remaining;
+		}
+	}
+
+	int c;
+	while (ctx->open.pop(&c)) {
+		int cx = s_x(grid, c);
+		int cy = s_y(grid, c);
+		int local = (cx - x0) + (cy - y0) * w;
+		nodes[local].handle = CF_PATH_CLOSED;
+		++ctx->expanded;
+		if (c == goal) return true;
+		if (target_marks[local] == generation) {
+			target_marks[local] = 0;
+			if (!--remaining) return true;
+		}
+		float g = nodes[local].g;
+		for (int dy = -1; dy <= 1; ++dy) {
+			if (cy + dy < y0 || cy + dy >= y1) continue;
+			for (int dx = -1; dx <= 1; ++dx) {
+				if (!dx && !dy) continue;
+				if (cx + dx < x0 || cx + dx >= x1) continue;
+				int n = c + dx + dy * stride;
+				if (blocked[n]) continue;
+				if (dx && dy && (blocked[c + dx] || blocked[c + dy * stride])) continue;
+				float ng = g + (dx && dy ? CF_PATH_SQRT2 : 1.0f);
+				CF_PathNode* neighbor = nodes + local + dx + dy * w;
+				if (neighbor->generation != generation) {
+					neighbor->generation = generation;
+					neighbor->g = ng;
+					neighbor->parent = c;
+					neighbor->handle = ctx->open.push(n, ng + heuristic(cx + dx, cy + dy));
+				} else if (neighbor->handle != CF_PATH_CLOSED && ng < neighbor->g) {
+					neighbor->g = ng;
+					neighbor->parent = c;
+					ctx->open.decrease_key(neighbor->handle, ng + heuristic(cx + dx, cy + dy));
+				}
+			}
+		}
+	}
+	return false;
+}
+
+// Returns the node for `cell` if the last `s_search_cluster` finished with it closed, meaning its shortest distance is known.
+static CF_INLINE const CF_PathNode* s_cluster_reached(const CF_PathContext* ctx, int cell)
+{
+	int x = s_x(ctx->grid, cell) - ctx->window_x0;
+	int y = s_y(ctx->grid, cell) - ctx->window_y0;
+	CF_ASSERT(x >= 0 && x < ctx->window_w && y >= 0 && y < ctx->window_h);
+	const CF_PathNode* node = ctx->window.data() + x + y * ctx->window_w;
+	return node->generation == ctx->window_generation && node->handle == CF_PATH_CLOSED ? node : NULL;
+}
+
+static CF_INLINE int s_cluster_of(const CF_PathHierarchy* hierarchy, int x, int y)
+{
+	return (y / hierarchy->cluster_size) * hierarchy->cluster_w + x / hierarchy->cluster_size;
+}
+
+static void s_mark_dirty(CF_PathHierarchy* hierarchy, int cluster)
+{
+	if (hierarchy->clusters[cluster].dirty) return;
+	hierarchy->clusters[cluster].dirty = true;
+	hierarchy->dirty.add(cluster);
+}
+
+static void s_cell_changed(CF_PathHierarchy* hierarchy, int x, int y)
+{
+	int index = s_cluster_of(hierarchy, x, y);
+	CF_PathCluster* cluster = &hierarchy->clusters[index];
+	s_mark_dirty(hierarchy, index);
+
+	// Cells along an edge can open or close entrances into the neighbor.
+	if (x == cluster->x1 - 1 && x + 1 < hierarchy->grid->w) cluster->east_dirty = true;
+	if (y == cluster->y1 - 1 && y + 1 < hierarchy->grid->h) cluster->north_dirty = true;
+	if (x == cluster->x0 && x > 0) {
+		hierarchy->clusters[index - 1].east_dirty = true;
+		s_mark_dirty(hierarchy, index - 1);
+	}
+	if (y == cluster->y0 && y > 0) {
+		hierarchy->clusters[index - hierarchy->cluster_w].north_dirty = true;
+		s_mark_dirty(hierarchy, index - hierarchy->cluster_w);
+	}
+}
+
+static int s_add_entrance(CF_PathHierarchy* hierarchy, int cell, int cluster)
+{
+	int index;
+	if (hierarchy->free_entrances.count()) {
+		index = hierarchy->free_entrances.pop();
+	} else {
+		index = hierarchy->entrances.count();
+		hierarchy->entrances.add();
+	}
+	CF_PathEntrance* entrance = &hierarchy->entrances[index];
+	entrance->cell = cell;
+	entrance->x = s_x(hierarchy->grid, cell);
+	entrance->y = s_y(hierarchy->grid, cell);
+	entrance->cluster = cluster;
+	entrance->edges.clear();
+	return index;
+}
+
+static void s_remove_entrance(CF_PathHierarchy* hierarchy, int index)
+{
+	hierarchy->entrances[index].cell = -1;
+	hierarchy->entrances[index].edges.clear();
+	hierarchy->free_entrances.add(index);
+}
+
+// Replaces all entrances along the east or north edge of a cluster. Each run of cells open on both sides of the edge gets one pair
+// of entrances in its middle, or one pair at each end if it's long.
+static void s_build_entrances(CF_PathHierarchy* hierarchy, int index, bool east)
+{
+	const CF_PathGrid* grid = hierarchy->grid;
+	CF_PathCluster* cluster = &hierarchy->clusters[index];
+	int neighbor = east ? index + 1 : index + hierarchy->cluster_w;
+	Array<int>& pairs = east ? cluster->east : cluster->north;
+	for (int i = 0; i < pairs.count(); ++i) {
+		s_remove_entrance(hierarchy, pairs[i]);
+	}
+	pairs.clear();
+
+	int x = east ? cluster->x1 - 1 : cluster->x0;
+	int y = east ? cluster->y0 : cluster->y1 - 1;
+	int step = east ? grid->stride : 1;
+	int across = east ? 1 : grid->stride;
+	int first = s_index(grid, x, y);
+	int length = east ? cluster->y1 - cluster->y0 : cluster->x1 - cluster->x0;
+	auto add = [&](int i) {
+		int cell = first + i * step;
+		int a = s_add_entrance(hierarchy, cell, index);
+		int b = s_add_entrance(hierarchy, cell + across, neighbor);
+		hierarchy->entrances[a].edges.add({ b, 1.0f });
+		hierarchy->entrances[b].edges.add({ a, 1.0f });
+		pairs.add(a);
+		pairs.add(b);
+	};
+	int run = 0;
+	for (int i = 0; i <= length; ++i) {
+		int cell = first + i * step;
+		if (i < length && !grid->blocked[cell] && !grid->blocked[cell + across]) {
+			++run;
+			continue;
+		}
+		if (run > CF_PATH_ENTRANCE_SPLIT) {
+			add(i - run);
+			add(i - 1);
+		} else if (run) {
+			add(i - run + (run - 1) / 2);
+		}
+		run = 0;
+	}
+
+	if (east) cluster->east_dirty = false;
+	else cluster->north_dirty = false;
+	s_mark_dirty(hierarchy, neighbor);
+}
+
+// Collects every entrance sitting inside a cluster, from all four of its edges.
+static void s_gather_entrances(const CF_PathHierarchy* hierarchy, int index, Array<int>* out)
+{
+	out->clear();
+	const CF_PathCluster* cluster = &hierarchy->clusters[index];
+	for (int i = 0; i < cluster->east.count(); i += 2) out->add(cluster->east[i]);
+	for (int i = 0; i < cluster->north.count(); i += 2) out->add(cluster->north[i]);
+	if (cluster->x0 > 0) {
+		const Array<int>& pairs = hierarchy->clusters[index - 1].east;
+		for (int i = 1; i < pairs.count(); i += 2) out->add(pairs[i]);
+	}
+	if (cluster->y0 > 0) {
+		const Array<int>& pairs = hierarchy->clusters[index - hierarchy->cluster_w].north;
+		for (int i = 1; i < pairs.count(); i += 2) out->add(pairs[i]);
+	}
+}
+
+// Recomputes the paths between every pair of entrances within a cluster. Paths are symmetric, so each flood fills in the edges
+// in both directions to all later entrances.
+static void s_build_edges(CF_PathHierarchy* hierarchy, int index)
+{
+	CF_PathContext* ctx = hierarchy->ctx;
+	CF_PathCluster* cluster = &hierarchy->clusters[index];
+	Array<int>& gathered = hierarchy->gathered;
+	Array<int>& targets = hierarchy->targets;
+	s_gather_entrances(hierarchy, index, &gathered);
+	targets.clear();
+	for (int i = 0; i < gathered.count(); ++i) {
+		hierarchy->entrances[gathered[i]].edges.set_count(1);
+		targets.add(hierarchy->entrances[gathered[i]].cell);
+	}
+
+	// Any two cells of a cluster with nothing blocked are joined by a straight line and a diagonal, so no searching is needed.
+	bool open = true;
+	const CF_PathGrid* grid = hierarchy->grid;
+	for (int y = cluster->y0; open && y < cluster->y1; ++y) {
+		const uint8_t* row = grid->blocked + s_index(grid, cluster->x0, y);
+		for (int x = 0; x < cluster->x1 - cluster->x0; ++x) {
+			if (row[x]) {
+				open = false;
+				break;
+			}
+		}
+	}
+	if (open) {
+		for (int i = 0; i < gathered.count(); ++i) {
+			CF_PathEntrance* a = &hierarchy->entrances[gathered[i]];
+			for (int j = i + 1; j < gathered.count(); ++j) {
+				CF_PathEntrance* b = &hierarchy->entrances[gathered[j]];
+				float cost = s_octile(a->x - b->x, a->y - b->y);
+				a->edges.add({ gathered[j], cost });
+				b->edges.add({ gathered[i], cost });
+			}
+		}
+		cluster->dirty = false;
+		return;
+	}
+
+	for (int i = 0; i < gathered.count() - 1; ++i) {
+		CF_PathEntrance* a = &hierarchy->entrances[gathered[i]];
+		s_search_cluster(ctx, cluster, a->cell, -1, targets + (i + 1), targets.count() - (i + 1));
+		for (int j = i + 1; j < gathered.count(); ++j) {
+			CF_PathEntrance* b = &hierarchy->entrances[gathered[j]];
+			const CF_PathNode* node = s_cluster_reached(ctx, b->cell);
+			if (!node) continue;
+			float cost = node->g;
+			a->edges.add({ gathered[j], cost });
+			b->edges.add({ gathered[i], cost });
+		}
+	}
+	cluster->dirty = false;
+}
+
+CF_PathHierarchy* cf_make_path_hierarchy(CF_PathGrid* grid, int cluster_size)
+{
+	CF_ASSERT(cluster_size >= 2);
+	CF_ASSERT(!grid->hierarchy);
+	CF_PathHierarchy* hierarchy = (CF_PathHierarchy*)CF_ALLOC(sizeof(CF_PathHierarchy));
+	CF_PLACEMENT_NEW(hierarchy) CF_PathHierarchy();
+	hierarchy->grid = grid;
+	hierarchy->cluster_size = cluster_size;
+	hierarchy->cluster_w = (grid->w + cluster_size - 1) / cluster_size;
+	hierarchy->cluster_h = (grid->h + cluster_size - 1) / cluster_size;
+	hierarchy->clusters.set_count(hierarchy->cluster_w * hierarchy->cluster_h);
+	for (int y = 0; y < hierarchy->cluster_h; ++y) {
+		for (int x = 0; x < hierarchy->cluster_w; ++x) {
+			int index = y * hierarchy->cluster_w + x;
+			CF_PathCluster* cluster = &hierarchy->clusters[index];
+			cluster->x0 = x * cluster_size;
+			cluster->y0 = y * cluster_size;
+			cluster->x1 = cf_min(cluster->x0 + cluster_size, grid->w);
+			cluster->y1 = cf_min(cluster->y0 + cluster_size, grid->h);
+			cluster->dirty = false;
+			cluster->east_dirty = x + 1 < hierarchy->cluster_w;
+			cluster->north_dirty = y + 1 < hierarchy->cluster_h;
+			s_mark_dirty(hierarchy, index);
+		}
+	}
+	hierarchy->ctx = cf_make_path_context(grid);
+	grid->hierarchy = hierarchy;
+	cf_path_hierarchy_update(hierarchy);
+	return hierarchy;
+}
+
+void cf_destroy_path_hierarchy(CF_PathHierarchy* hierarchy)
+{
+	if (!hierarchy) return;
+	hierarchy->grid->hierarchy = NULL;
+	cf_destroy_path_context(hierarchy->ctx);
+	hierarchy->~CF_PathHierarchy();
+	CF_FREE(hierarchy);
+}
+
+int cf_path_hierarchy_update(CF_PathHierarchy* hierarchy)
+{
+	// Entrances go first, as they mark the clusters on both sides of the edge as needing their edges rebuilt.
+	for (int i = 0; i < hierarchy->dirty.count(); ++i) {
+		int index = hierarchy->dirty[i];
+		if (hierarchy->clusters[index].east_dirty) s_build_entrances(hierarchy, index, true);
+		if (hierarchy->clusters[index].north_dirty) s_build_entrances(hierarchy, index, false);
+	}
+	int count = hierarchy->dirty.count();
+	for (int i = 0; i < count; ++i) {
+		s_build_edges(hierarchy, hierarchy->dirty[i]);
+	}
+	hierarchy->dirty.clear();
+	return count;
+}
+
+// Writes out the corners of a path given as a list of cells, where consecutive cells lie along a straight or diagonal line.
+static void s_write_cells(const CF_PathGrid* grid, const int* cells, int count, CF_PathRequest* request)
+{
+	int written = 0;
+	for (int i = 0; i < count; ++i) {
+		if (i > 0 && i < count - 1) {
+			int a = cells[i - 1], b = cells[i], c = cells[i + 1];
+			int dx = s_sign(s_x(grid, b) - s_x(grid, a));
+			int dy = s_sign(s_y(grid, b) - s_y(grid, a));
+			if (dx == s_sign(s_x(grid, c) - s_x(grid, b)) && dy == s_sign(s_y(grid, c) - s_y(grid, b))) continue;
+		}
+		if (request->path && written < request->path_capacity) {
+			request->path[written].x = s_x(grid, cells[i]);
+			request->path[written].y = s_y(grid, cells[i]);
+		}
+		++written;
+	}
+	request->path_count = written;
+}
+
+bool cf_path_find_hierarchical(CF_PathContext* ctx, const CF_PathHierarchy* hierarchy, CF_PathRequest* request)
+{
+	const CF_PathGrid* grid = ctx->grid;
+	CF_ASSERT(grid == hierarchy->grid);
+	CF_ASSERT(!hierarchy->dirty.count()); // Call `cf_path_hierarchy_update` after editing the grid.
+	request->found = false;
+	request->path_count = 0;
+	request->cost = 0;
+	request->expanded_count = 0;
+	if (cf_path_grid_is_blocked(grid, request->start.x, request->start.y) || cf_path_grid_is_blocked(grid, request->goal.x, request->goal.y)) {
+		return false;
+	}
+
+	ctx->expanded = 0;
+
+	// The start and goal are temporarily added to the graph of entrances, just past the end of the real ones.
+	int start = s_index(grid, request->start.x, request->start.y);
+	int goal = s_index(grid, request->goal.x, request->goal.y);
+	int start_cluster = s_cluster_of(hierarchy, request->start.x, request->start.y);
+	int goal_cluster = s_cluster_of(hierarchy, request->goal.x, request->goal.y);
+	int start_id = hierarchy->entrances.count();
+	int goal_id = start_id + 1;
+	auto cell_of = [&](int id) { return id == start_id ? start : id == goal_id ? goal : hierarchy->entrances[id].cell; };
+	auto cluster_of = [&](int id) { return id == start_id ? start_cluster : id == goal_id ? goal_cluster : hierarchy->entrances[id].cluster; };
+
+	// Connect the start to every entrance of its cluster, and directly to the goal if it's in there too.
+	s_gather_entrances(hierarchy, start_cluster, &ctx->gathered);
+	ctx->targets.clear();
+	for (int i = 0; i < ctx->gathered.count(); ++i) {
+		ctx->targets.add(hierarchy->entrances[ctx->gathered[i]].cell);
+	}
+	if (start_cluster == goal_cluster) ctx->targets.add(goal);
+	const CF_PathCluster* cluster = &hierarchy->clusters[start_cluster];
+	s_search_cluster(ctx, cluster, start, -1, ctx->targets.data(), ctx->targets.count());
+	ctx->start_edges.clear();
+	for (int i = 0; i < ctx->gathered.count(); ++i) {
+		int cell = hierarchy->entrances[ctx->gathered[i]].cell;
+		const CF_PathNode* node = s_cluster_reached(ctx, cell);
+		if (node) ctx->start_edges.add({ ctx->gathered[i], node->g });
+	}
+	if (start_cluster == goal_cluster) {
+		const CF_PathNode* node = s_cluster_reached(ctx, goal);
+		if (node) ctx->start_edges.add({ goal_id, node->g });
+	}
+
+	// And connect every entrance of the goal's cluster to the goal.
+	s_gather_entrances(hierarchy, goal_cluster, &ctx->gathered);
+	ctx->targets.clear();
+	for (int i = 0; i < ctx->gathered.count(); ++i) {
+		ctx->targets.add(hierarchy->entrances[ctx->gathered[i]].cell);
+	}
+	cluster = &hierarchy->clusters[goal_cluster];
+	s_search_cluster(ctx, cluster, goal, -1, ctx->targets.data(), ctx->targets.count());
+	ctx->goal_edges.clear();
+	for (int i = 0; i < ctx->gathered.count(); ++i) {
+		int cell = hierarchy->entrances[ctx->gathered[i]].cell;
+		const CF_PathNode* node = s_cluster_reached(ctx, cell);
+		if (node) ctx->goal_edges.add({ ctx->gathered[i], node->g });
+	}
+
+	// A* across the graph of entrances.
+	if (ctx->abstract.count() < goal_id + 1) ctx->abstract.ensure_count(goal_id + 1);
+	if (++ctx->abstract_generation == 0) {
+		CF_MEMSET(ctx->abstract.data(), 0, sizeof(CF_PathNode) * ctx->abstract.count());
+		ctx->abstract_generation = 1;
+	}
+	CF_PathNode* nodes = ctx->abstract.data();
+	const CF_PathEntrance* entrances = hierarchy->entrances.data();
+	auto estimate = [&](int id) {
+		if (id == goal_id) return 0.0f;
+		CF_PathPoint p = id == start_id ? request->start : CF_PathPoint{ entrances[id].x, entrances[id].y };
+		return s_octile(p.x - request->goal.x, p.y - request->goal.y);
+	};
+	auto relax = [&](int from, int to, float g) {
+		CF_PathNode* node = nodes + to;
+		if (node->generation != ctx->abstract_generation) {
+			node->generation = ctx->abstract_generation;
+			node->g = g;
+			node->parent = from;
+			node->handle = ctx->open.push(to, g + estimate(to));
+		} else if (node->handle != CF_PATH_CLOSED && g < node->g) {
+			node->g = g;
+			node->parent = from;
+			ctx->open.decrease_key(node->handle, g + estimate(to));
+		}
+	};
+	ctx->open.clear();
+	nodes[start_id].generation = ctx->abstract_generation;
+	nodes[start_id].g = 0;
+	nodes[start_id].parent = -1;
+	nodes[start_id].handle = ctx->open.push(start_id, estimate(start_id));
+	bool found = false;
+	int c;
+	while (ctx->open.pop(&c)) {
+		nodes[c].handle = CF_PATH_CLOSED;
+		++ctx->expanded;
+		if (c == goal_id) {
+			found = true;
+			break;
+		}
+		float g = nodes[c].g;
+		const Array<CF_PathEdge>& edges = c == start_id ? ctx->start_edges : entrances[c].edges;
+		const CF_PathEdge* edge = edges.data();
+		for (int i = 0; i < edges.count(); ++i) {
+			relax(c, edge[i].to, g + edge[i].cost);
+		}
+		if (cluster_of(c) == goal_cluster) {
+			for (int i = 0; i < ctx->goal_edges.count(); ++i) {
+				if (ctx->goal_edges[i].to == c) relax(c, goal_id, g + ctx->goal_edges[i].cost);
+			}
+		}
+	}
+	if (!found) {
+		request->expanded_count = ctx->expanded;
+		return false;
+	}
+
+	// Refine each step of the route into cells, searching only within the cluster it crosses.
+	ctx->route.clear();
+	for (int id = goal_id; id >= 0; id = nodes[id].parent) {
+		ctx->route.add(id);
+	}
+	ctx->route.reverse();
+	ctx->cells.clear();
+	ctx->cells.add(start);
+	for (int i = 0; i < ctx->route.count() - 1; ++i) {
+		int a = ctx->route[i];
+		int b = ctx->route[i + 1];
+		int from = cell_of(a);
+		int to = cell_of(b);
+		if (from == to) continue;
+		if (cluster_of(a) != cluster_of(b)) {
+			ctx->cells.add(to);
+			continue;
+		}
+		cluster = &hierarchy->clusters[cluster_of(a)];
+		s_search_cluster(ctx, cluster, from, to);
+		// The parent links run backwards, so append the cells then flip them around in place.
+		int first = ctx->cells.count();
+		for (int cell = to; cell != from; cell = s_cluster_reached(ctx, cell)->parent) {
+			ctx->cells.add(cell);
+		}
+		for (int last = ctx->cells.count() - 1; first < last; ++first, --last) {
+			int t = ctx->cells[first];
+			ctx->cells[first] = ctx->cells[last];
+			ctx->cells[last] = t;
+		}
+	}
+
+	request->found = true;
+	request->cost = nodes[goal_id].g;
+	request->expanded_count = ctx->expanded;
+	s_write_cells(grid, ctx->cells.data(), ctx->cells.count(), request);
+	return true;
+}
+
+struct CF_PathBatch
+{
+	std::atomic<int> next;
+	const CF_PathHierarchy* hierarchy;
+	CF_PathRequest* requests;
+	int request_count;
+};
+
+struct CF_PathBatchTask
+{
+	CF_PathBatch* batch;
+	CF_PathContext* ctx;
+};
+
+static void s_path_batch_task(void* udata)
+{
+	CF_PathBatchTask* task = (CF_PathBatchTask*)udata;
+	CF_PathBatch* batch = task->batch;
+	while (true) {
+		int i = batch->next.fetch_add(1, std::memory_order_relaxed);
+		if (i >= batch->request_count) break;
+		if (batch->hierarchy) {
+			cf_path_find_hierarchical(task->ctx, batch->hierarchy, batch->requests + i);
+		} else {
+			cf_path_find(task->ctx, batch->requests + i);
+		}
+	}
+}
+
+static void s_path_find_batch(CF_PathContext** contexts, int context_count, CF_Threadpool* pool, const CF_PathHierarchy* hierarchy, CF_PathRequest* requests, int request_count)
+{
+	CF_ASSERT(context_count > 0);
+	CF_PathBatch batch;
+	batch.next = 0;
+	batch.hierarchy = hierarchy;
+	batch.requests = requests;
+	batch.request_count = request_count;
+	if (!pool || context_count == 1) {
+		CF_PathBatchTask task = { &batch, contexts[0] };
+		s_path_batch_task(&task);
+		return;
+	}
+
+	CF_PathBatchTask tasks_on_stack[64];
+	CF_PathBatchTask* tasks = tasks_on_stack;
+	if (context_count > (int)CF_ARRAY_SIZE(tasks_on_stack)) {
+		tasks = (CF_PathBatchTask*)CF_ALLOC(sizeof(CF_PathBatchTask) * context_count);
+	}
+	for (int i = 0; i < context_count; ++i) {
+		tasks[i].batch = &batch;
+		tasks[i].ctx = contexts[i];
+		cf_threadpool_add_task(pool, s_path_batch_task, tasks + i);
+	}
+	cf_threadpool_kick_and_wait(pool);
+	if (tasks != tasks_on_stack) CF_FREE(tasks);
+}
+
+void cf_path_find_batch(CF_PathContext** contexts, int context_count, CF_Threadpool* pool, CF_PathRequest* requests, int request_count)
+{
+	s_path_find_batch(contexts, context_count, pool, NULL, requests, request_count);
+}
+
+void cf_path_find_hierarchical_batch(CF_PathContext** contexts, int context_count, CF_Threadpool* pool, const CF_PathHierarchy* hierarchy, CF_PathRequest* requests, int request_count)
+{
+	s_path_find_batch(contexts, context_count, pool, hierarchy, requests, request_count);
+}
@@ -38,6 +38,7 @@ void cf_png_cache_get_pixels(uint64_t image_id, void* buffer, int bytes_to_fill)
 
 void cf_make_png_cache()
 {
+	CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_PNG_CACHE);
 	cache = CF_NEW(CF_PngCache);
 }
 
@@ -68,6 +69,7 @@ void cf_destroy_png_cache()
 
 CF_Result cf_png_cache_load(const char* png_path, CF_Png* png)
 {
+	CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_PNG_CACHE);
 	CF_Image img;
 	CF_Result err = cf_image_load_png(png_path, &img);
 	if (cf_is_error(err)) return err;
@@ -86,6 +88,7 @@ CF_Result cf_png_cache_load(const char* png_path, CF_Png* png)
 
 CF_Result cf_png_cache_load_from_memory(const char* png_path, const void* memory, size_t size, CF_Png* png)
 {
+	CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_PNG_CACHE);
 	CF_Image img;
 	CF_Result err = cf_image_load_png_from_memory(memory, (int)size, &img);
 	if (cf_is_error(err)) return err;
@@ -114,6 +117,7 @@ void cf_png_cache_unload(CF_Png png)
 
 const CF_Animation* cf_make_png_cache_animation(const char* name, const CF_Png* pngs, int pngs_count, const float* delays, int delays_count)
 {
+	CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_PNG_CACHE);
 	CF_ASSERT(pngs_count == delays_count);
 	name = sintern(name);
 
@@ -147,6 +151,7 @@ const CF_Animation* cf_png_cache_get_animation(const char* name)
 
 const CF_Animation** cf_make_png_cache_animation_table(const char* sprite_name, const CF_Animation* const* animations, int animations_count)
 {
+	CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_PNG_CACHE);
 	sprite_name = sintern(sprite_name);
 
 	// If already made, just return the old table.
@@ -0,0 +1,198 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include <cute_profile.h>
+#include <cute_alloc.h>
+#include <cute_array.h>
+#include <cute_string.h>
+#include <cute_time.h>
+#include <cute_file_system.h>
+#include <cute_multithreading.h>
+
+#include <internal/cute_alloc_internal.h>
+
+#include <atomic>
+#include <stdlib.h>
+
+using namespace Cute;
+
+// Must be a power of two. About a megabyte per thread, or a couple seconds of a busy frame loop.
+#define CF_PROFILE_EVENT_COUNT (1 << 16)
+#define CF_PROFILE_CACHELINE 64
+
+// A `NULL` name marks the end of a region. The fields are atomic only so a trace can be read while the owning thread keeps writing, on
+// common hardware they're plain loads and stores.
+struct CF_ProfileEvent
+{
+	std::atomic<const char*> name;
+	std::atomic<uint64_t> ticks;
+};
+
+// One per thread, written to only by its owning thread. Rings are never freed, when a thread exits its ring is handed to the next new
+// thread that starts profiling.
+struct CF_ProfileRing
+{
+	CF_ProfileRing* next;
+	std::atomic<uint64_t> thread_id;
+	std::atomic<uint32_t> begin;
+	std::atomic<bool> in_use;
+
+	alignas(CF_PROFILE_CACHELINE) std::atomic<uint32_t> write;
+	CF_ProfileEvent events[CF_PROFILE_EVENT_COUNT];
+};
+
+static std::atomic<CF_ProfileRing*> s_rings;
+static std::atomic<uint64_t> s_clear_ticks;
+static thread_local CF_ProfileRing* s_ring;
+
+// Hands the ring back when its thread exits. Kept apart from `s_ring` so the hot path doesn't pay for a thread_local destructor check.
+struct CF_ProfileThreadExit
+{
+	CF_ProfileRing* ring = NULL;
+	~CF_ProfileThreadExit() { if (ring) ring->in_use.store(false, std::memory_order_release); }
+};
+
+static thread_local CF_ProfileThreadExit s_thread_exit;
+
+static CF_ProfileRing* s_acquire_ring()
+{
+	CF_ProfileRing* ring = s_rings.load(std::memory_order_acquire);
+	while (ring) {
+		bool expected = false;
+		if (!ring->in_use.load(std::memory_order_relaxed) && ring->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+			// Hide events left over from the previous owner.
+			ring->begin.store(ring->write.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			break;
+		}
+		ring = ring->next;
+	}
+	if (!ring) {
+		// Rings live forever, so take them straight from malloc rather than the tracked heap, otherwise every ring
+		// would show up in `cf_memory_dump_leaks`.
+		void* memory = malloc(sizeof(CF_ProfileRing) + CF_PROFILE_CACHELINE);
+		CF_ASSERT(memory);
+		ring = (CF_ProfileRing*)CF_ALIGN_FORWARD_PTR(memory, CF_PROFILE_CACHELINE);
+		CF_PLACEMENT_NEW(ring) CF_ProfileRing();
+		ring->in_use = true;
+		ring->begin = 0;
+		ring->write = 0;
+		ring->next = s_rings.load(std::memory_order_relaxed);
+		while (!s_rings.compare_exchange_weak(ring->next, ring, std::memory_order_release, std::memory_order_relaxed)) {}
+	}
+	ring->thread_id.store((uint64_t)cf_thread_id(), std::memory_order_relaxed);
+	s_thread_exit.ring = ring;
+	s_ring = ring;
+	return ring;
+}
+
+static CF_INLINE void s_record(const char* name)
+{
+	CF_ProfileRing* ring = s_ring;
+	if (!ring) ring = s_acquire_ring();
+	uint32_t index = ring->write.load(std::memory_order_relaxed);
+	CF_ProfileEvent* event = ring->events + (index & (CF_PROFILE_EVENT_COUNT - 1));
+	event->name.store(name, std::memory_order_relaxed);
+	event->ticks.store(cf_get_ticks(), std::memory_order_relaxed);
+	ring->write.store(index + 1, std::memory_order_release);
+}
+
+void cf_profile_begin(const char* name)
+{
+	s_record(name);
+}
+
+void cf_profile_end()
+{
+	s_record(NULL);
+}
+
+void cf_profile_clear()
+{
+	s_clear_ticks.store(cf_get_ticks(), std::memory_order_relaxed);
+}
+
+struct CF_ProfileEventCopy
+{
+	const char* name;
+	uint64_t ticks;
+};
+
+// Copies out every event still in the ring, without stopping its thread from writing more. Returns the index of the first copy known
+// to be intact.
+static int s_copy_events(CF_ProfileRing* ring, Array<CF_ProfileEventCopy>* events)
+{
+	events->clear();
+	uint32_t end = ring->write.load(std::memory_order_acquire);
+	uint32_t count = end - ring->begin.load(std::memory_order_relaxed);
+	if (count > CF_PROFILE_EVENT_COUNT) count = CF_PROFILE_EVENT_COUNT;
+	for (uint32_t i = end - count; i != end; ++i) {
+		CF_ProfileEvent* event = ring->events + (i & (CF_PROFILE_EVENT_COUNT - 1));
+		events->add({ event->name.load(std::memory_order_relaxed), event->ticks.load(std::memory_order_relaxed) });
+	}
+
+	// Anything the owner wrote in the meantime overwrote the oldest events, and it may be part way through writing one more. Drop the
+	// copies which may have been torn.
+	std::atomic_thread_fence(std::memory_order_acquire);
+	uint32_t now = ring->write.load(std::memory_order_relaxed);
+	int64_t overwritten = (int64_t)(now - end) + 1 - (CF_PROFILE_EVENT_COUNT - count);
+	if (overwritten <= 0) return 0;
+	return (int)cf_min(overwritten, (int64_t)count);
+}
+
+static char* s_append_name(char* s, const char* name)
+{
+	for (const char* c = name; *c; ++c) {
+		switch (*c) {
+		case '"': sappend(s, "\\\""); break;
+		case '\\': sappend(s, "\\\\"); break;
+		default:
+			if ((unsigned char)*c < 0x20) sfmt_append(s, "\\u%04x", (int)*c);
+			else spush(s, *c);
+		}
+	}
+	return s;
+}
+
+char* cf_profile_trace()
+{
+	uint64_t clear_ticks = s_clear_ticks.load(std::memory_order_relaxed);
+	double us_per_tick = 1.0e6 / (double)cf_get_tick_frequency();
+	Array<CF_ProfileEventCopy> events;
+	char* s = NULL;
+	sappend(s, "{\"traceEvents\":[");
+	bool first = true;
+
+	for (CF_ProfileRing* ring = s_rings.load(std::memory_order_acquire); ring; ring = ring->next) {
+		int first_intact = s_copy_events(ring, &events);
+		unsigned long long tid = (unsigned long long)ring->thread_id.load(std::memory_order_relaxed);
+		InlineArray<const char*, 32> open;
+		for (int i = first_intact; i < events.count(); ++i) {
+			CF_ProfileEventCopy e = events[i];
+			if (e.ticks < clear_ticks) continue;
+			// The start of this region was cleared or overwritten.
+			if (!e.name && !open.count()) continue;
+			sappend(s, first ? "\n" : ",\n");
+			first = false;
+			sappend(s, "{\"name\":\"");
+			s = s_append_name(s, e.name ? e.name : open.last());
+			sfmt_append(s, "\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":1,\"tid\":%llu}", e.name ? "B" : "E", e.ticks * us_per_tick, tid);
+			if (e.name) open.add(e.name);
+			else open.pop();
+		}
+	}
+
+	sappend(s, "\n]}\n");
+	return s;
+}
+
+CF_Result cf_profile_save_trace(const char* virtual_path)
+{
+	char* trace = cf_profile_trace();
+	CF_Result result = cf_fs_write_string_to_file(virtual_path, trace);
+	sfree(trace);
+	return result;
+}
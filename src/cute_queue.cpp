@@ -0,0 +1,198 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include <cute_queue.h>
+#include <cute_c_runtime.h>
+#include <cute_alloc.h>
+
+#include <internal/cute_alloc_internal.h>
+
+#include <atomic>
+
+#define CF_QUEUE_CACHELINE 64
+
+static uint32_t s_pow2(int capacity)
+{
+	uint32_t n = 2;
+	while ((int)n < capacity) n *= 2;
+	return n;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Single-producer single-consumer.
+
+// The producer and consumer each get a cache line to themselves. They keep a copy of the other side's index, and only reload the real
+// one when their copy says the queue looks full (or empty), so most pushes and pops never read the other thread's cache line.
+struct CF_SPSCQueue
+{
+	uint8_t* items;
+	int item_size;
+	uint32_t mask;
+
+	alignas(CF_QUEUE_CACHELINE) std::atomic<uint32_t> head;
+	uint32_t cached_tail;
+
+	alignas(CF_QUEUE_CACHELINE) std::atomic<uint32_t> tail;
+	uint32_t cached_head;
+};
+
+CF_SPSCQueue* cf_make_spsc_queue(int item_size, int capacity)
+{
+	CF_SPSCQueue* queue = (CF_SPSCQueue*)cf_aligned_alloc(sizeof(CF_SPSCQueue), CF_QUEUE_CACHELINE);
+	CF_PLACEMENT_NEW(queue) CF_SPSCQueue();
+	uint32_t n = s_pow2(capacity);
+	queue->items = (uint8_t*)CF_ALLOC((size_t)item_size * n);
+	queue->item_size = item_size;
+	queue->mask = n - 1;
+	queue->head = 0;
+	queue->cached_tail = 0;
+	queue->tail = 0;
+	queue->cached_head = 0;
+	return queue;
+}
+
+void cf_destroy_spsc_queue(CF_SPSCQueue* queue)
+{
+	if (!queue) return;
+	CF_FREE(queue->items);
+	queue->~CF_SPSCQueue();
+	cf_aligned_free(queue);
+}
+
+bool cf_spsc_queue_push(CF_SPSCQueue* queue, const void* item)
+{
+	uint32_t tail = queue->tail.load(std::memory_order_relaxed);
+	if (tail - queue->cached_head > queue->mask) {
+		queue->cached_head = queue->head.load(std::memory_order_acquire);
+		if (tail - queue->cached_head > queue->mask) return false;
+	}
+	CF_MEMCPY(queue->items + (size_t)(tail & queue->mask) * queue->item_size, item, queue->item_size);
+	queue->tail.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+bool cf_spsc_queue_pop(CF_SPSCQueue* queue, void* item)
+{
+	uint32_t head = queue->head.load(std::memory_order_relaxed);
+	if (head == queue->cached_tail) {
+		queue->cached_tail = queue->tail.load(std::memory_order_acquire);
+		if (head == queue->cached_tail) return false;
+	}
+	CF_MEMCPY(item, queue->items + (size_t)(head & queue->mask) * queue->item_size, queue->item_size);
+	queue->head.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+int cf_spsc_queue_count(const CF_SPSCQueue* queue)
+{
+	uint32_t head = queue->head.load(std::memory_order_acquire);
+	uint32_t tail = queue->tail.load(std::memory_order_acquire);
+	return (int)(tail - head);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Multi-producer multi-consumer.
+
+// Each cell starts with a sequence number, followed by the item. A cell is free to write at position `pos` once its sequence equals
+// `pos`, and holds an item ready to read once its sequence equals `pos + 1`. Reading bumps the sequence a whole lap ahead, to
+// `pos + capacity`, freeing the cell for the next time around.
+struct CF_MPMCQueue
+{
+	uint8_t* cells;
+	int item_size;
+	int stride;
+	uint32_t mask;
+
+	alignas(CF_QUEUE_CACHELINE) std::atomic<uint32_t> enqueue_pos;
+	alignas(CF_QUEUE_CACHELINE) std::atomic<uint32_t> dequeue_pos;
+	char padding[CF_QUEUE_CACHELINE - sizeof(std::atomic<uint32_t>)];
+};
+
+#define CF_MPMC_ITEM_OFFSET 8
+
+static CF_INLINE std::atomic<uint32_t>* s_sequence(const CF_MPMCQueue* queue, uint32_t pos)
+{
+	return (std::atomic<uint32_t>*)(queue->cells + (size_t)(pos & queue->mask) * queue->stride);
+}
+
+CF_MPMCQueue* cf_make_mpmc_queue(int item_size, int capacity)
+{
+	CF_MPMCQueue* queue = (CF_MPMCQueue*)cf_aligned_alloc(sizeof(CF_MPMCQueue), CF_QUEUE_CACHELINE);
+	CF_PLACEMENT_NEW(queue) CF_MPMCQueue();
+	uint32_t n = s_pow2(capacity);
+	queue->item_size = item_size;
+	// Keep items 8 byte aligned.
+	queue->stride = (CF_MPMC_ITEM_OFFSET + item_size + 7) & ~7;
+	queue->mask = n - 1;
+	queue->cells = (uint8_t*)cf_aligned_alloc((size_t)queue->stride * n, CF_QUEUE_CACHELINE);
+	for (uint32_t i = 0; i < n; ++i) {
+		CF_PLACEMENT_NEW(s_sequence(queue, i)) std::atomic<uint32_t>(i);
+	}
+	queue->enqueue_pos = 0;
+	queue->dequeue_pos = 0;
+	return queue;
+}
+
+void cf_destroy_mpmc_queue(CF_MPMCQueue* queue)
+{
+	if (!queue) return;
+	cf_aligned_free(queue->cells);
+	queue->~CF_MPMCQueue();
+	cf_aligned_free(queue);
+}
+
+bool cf_mpmc_queue_push(CF_MPMCQueue* queue, const void* item)
+{
+	uint32_t pos = queue->enqueue_pos.load(std::memory_order_relaxed);
+	std::atomic<uint32_t>* sequence;
+	while (true) {
+		sequence = s_sequence(queue, pos);
+		int32_t diff = (int32_t)(sequence->load(std::memory_order_acquire) - pos);
+		if (diff == 0) {
+			// The cell is free, claim it.
+			if (queue->enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+		} else if (diff < 0) {
+			// The cell still holds an item from a lap ago, the queue is full.
+			return false;
+		} else {
+			// Another producer claimed this position first.
+			pos = queue->enqueue_pos.load(std::memory_order_relaxed);
+		}
+	}
+	CF_MEMCPY((uint8_t*)sequence + CF_MPMC_ITEM_OFFSET, item, queue->item_size);
+	sequence->store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+bool cf_mpmc_queue_pop(CF_MPMCQueue* queue, void* item)
+{
+	uint32_t pos = queue->dequeue_pos.load(std::memory_order_relaxed);
+	std::atomic<uint32_t>* sequence;
+	while (true) {
+		sequence = s_sequence(queue, pos);
+		int32_t diff = (int32_t)(sequence->load(std::memory_order_acquire) - (pos + 1));
+		if (diff == 0) {
+			if (queue->dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+		} else if (diff < 0) {
+			// Nothing has been written here yet, the queue is empty.
+			return false;
+		} else {
+			pos = queue->dequeue_pos.load(std::memory_order_relaxed);
+		}
+	}
+	CF_MEMCPY(item, (uint8_t*)sequence + CF_MPMC_ITEM_OFFSET, queue->item_size);
+	sequence->store(pos + queue->mask + 1, std::memory_order_release);
+	return true;
+}
+
+int cf_mpmc_queue_count(const CF_MPMCQueue* queue)
+{
+	uint32_t head = queue->dequeue_pos.load(std::memory_order_acquire);
+	uint32_t tail = queue->enqueue_pos.load(std::memory_order_acquire);
+	int32_t count = (int32_t)(tail - head);
+	return count < 0 ? 0 : count;
+}
@@ -9,16 +9,20 @@
 #include "cute_multithreading.h"
 #include "cute_array.h"
 #include "cute_math.h"
+#include "cute_file_system.h"
 
 #include <cute_string.h>
 
 #include <internal/cute_alloc_internal.h>
 #include <internal/cute_app_internal.h>
 
+#include <atomic>
+
 using namespace Cute;
 
 char* cf_sfit(char* a, int n)
 {
+	CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_STRING);
 	cf_array_fit(a, n + 1);
 	if (scount(a) == 0) apush(a, 0);
 	return a;
@@ -26,6 +30,7 @@ char* cf_sfit(char* a, int n)
 
 char* cf_sset(char* a, const char* b)
 {
+	CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_STRING);
 	CF_ACANARY(a);
 	if (!b) return NULL;
 	int bsize = (int)(b ? CF_STRLEN(b) : 0) + 1;
@@ -42,6 +47,7 @@ char* cf_sset(char* a, const char* b)
 
 char* cf_sfmt(char* s, const char* fmt, ...)
 {
+	CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_STRING);
 	CF_ACANARY(s);
 	va_list args;
 	va_start(args, fmt);
@@ -59,6 +65,7 @@ char* cf_sfmt(char* s, const char* fmt, ...)
 
 char* cf_sfmt_append(char* s, const char* fmt, ...)
 {
+	CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_STRING);
 	CF_ACANARY(s);
 	va_list args;
 	va_start(args, fmt);
@@ -80,6 +87,7 @@ char* cf_sfmt_append(char* s, const char* fmt, ...)
 
 char* cf_svfmt(char* s, const char* fmt, va_list args)
 {
+	CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_STRING);
 	CF_ACANARY(s);
 	va_list copy_args;
 	va_copy(copy_args, args);
@@ -95,6 +103,7 @@ char* cf_svfmt(char* s, const char* fmt, va_list args)
 
 char* cf_svfmt_append(char* s, const char* fmt, va_list args)
 {
+	CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_STRING);
 	CF_ACANARY(s);
 	va_list copy_args;
 	va_copy(copy_args, args);
@@ -112,6 +121,230 @@ char* cf_svfmt_append(char* s, const char* fmt, va_list args)
 	return s;
 }
 
+char* cf_frame_sfmt(const char* fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	char buffer[256];
+	int n = 1+vsnprintf(buffer, sizeof(buffer), fmt, args);
+	va_end(args);
+	char* s = (char*)cf_frame_alloc(n);
+	if (n <= (int)sizeof(buffer)) {
+		CF_MEMCPY(s, buffer, n);
+	} else {
+		va_start(args, fmt);
+		vsnprintf(s, n, fmt, args);
+		va_end(args);
+	}
+	return s;
+}
+
+// Chunks are bump-allocated buffers of text. Each is allocated with one extra byte past `cap`, so a nul-terminator
+// can always be written in-place.
+struct CF_StringChunk
+{
+	CF_StringChunk* next;
+	int len;
+	int cap;
+};
+
+struct CF_StringBuilder
+{
+	CF_StringChunk* head;
+	CF_StringChunk* tail;
+	CF_StringChunk* free_list; // Chunks kept around from `cf_string_builder_clear` or flattening, for reuse.
+	int chunk_size;
+	int len;
+};
+
+#define CF_STRING_BUILDER_DEFAULT_CHUNK_SIZE (16 * CF_KB)
+
+static CF_INLINE char* s_chunk_data(CF_StringChunk* chunk)
+{
+	return (char*)(chunk + 1);
+}
+
+static CF_StringChunk* s_push_chunk(CF_StringBuilder* sb, int min_cap)
+{
+	CF_StringChunk* chunk = sb->free_list;
+	if (chunk && chunk->cap >= min_cap) {
+		sb->free_list = chunk->next;
+	} else {
+		CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_STRING);
+		int cap = max(min_cap, sb->chunk_size);
+		chunk = (CF_StringChunk*)CF_ALLOC(sizeof(CF_StringChunk) + cap + 1);
+		chunk->cap = cap;
+	}
+	chunk->next = NULL;
+	chunk->len = 0;
+	if (sb->tail) {
+		sb->tail->next = chunk;
+	} else {
+		sb->head = chunk;
+	}
+	sb->tail = chunk;
+	return chunk;
+}
+
+static void s_free_chunks(CF_StringChunk* chunk)
+{
+	while (chunk) {
+		CF_StringChunk* next = chunk->next;
+		CF_FREE(chunk);
+		chunk = next;
+	}
+}
+
+CF_StringBuilder* cf_make_string_builder(int chunk_size)
+{
+	CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_STRING);
+	CF_StringBuilder* sb = (CF_StringBuilder*)CF_ALLOC(sizeof(CF_StringBuilder));
+	CF_MEMSET(sb, 0, sizeof(*sb));
+	sb->chunk_size = chunk_size > 0 ? chunk_size : CF_STRING_BUILDER_DEFAULT_CHUNK_SIZE;
+	return sb;
+}
+
+void cf_destroy_string_builder(CF_StringBuilder* sb)
+{
+	if (!sb) return;
+	s_free_chunks(sb->head);
+	s_free_chunks(sb->free_list);
+	CF_FREE(sb);
+}
+
+void cf_string_builder_append_range(CF_StringBuilder* sb, const char* start, const char* end)
+{
+	int n = (int)(end - start);
+	sb->len += n > 0 ? n : 0;
+	while (n > 0) {
+		CF_StringChunk* chunk = sb->tail;
+		if (!chunk || chunk->len == chunk->cap) chunk = s_push_chunk(sb, 0);
+		int count = min(n, chunk->cap - chunk->len);
+		CF_MEMCPY(s_chunk_data(chunk) + chunk->len, start, count);
+		chunk->len += count;
+		start += count;
+		n -= count;
+	}
+}
+
+void cf_string_builder_append(CF_StringBuilder* sb, const char* s)
+{
+	if (s) cf_string_builder_append_range(sb, s, s + CF_STRLEN(s));
+}
+
+void cf_string_builder_push(CF_StringBuilder* sb, char ch)
+{
+	CF_StringChunk* chunk = sb->tail;
+	if (!chunk || chunk->len == chunk->cap) chunk = s_push_chunk(sb, 0);
+	s_chunk_data(chunk)[chunk->len++] = ch;
+	sb->len++;
+}
+
+void cf_string_builder_vfmt(CF_StringBuilder* sb, const char* fmt, va_list args)
+{
+	CF_StringChunk* chunk = sb->tail;
+	if (!chunk) chunk = s_push_chunk(sb, 0);
+
+	// Try formatting straight into the current chunk. The spare byte past `cap` makes room for vsnprintf's nul-terminator.
+	va_list copy;
+	va_copy(copy, args);
+	int avail = chunk->cap - chunk->len;
+	int n = vsnprintf(s_chunk_data(chunk) + chunk->len, avail + 1, fmt, copy);
+	va_end(copy);
+	if (n < 0) return;
+	if (n <= avail) {
+		chunk->len += n;
+		sb->len += n;
+		return;
+	}
+
+	// Didn't fit, so the current chunk now holds a truncated result. Format again into a fresh chunk big enough for
+	// the whole thing, leaving the remainder of the current chunk unused.
+	chunk = s_push_chunk(sb, n);
+	vsnprintf(s_chunk_data(chunk), n + 1, fmt, args);
+	chunk->len = n;
+	sb->len += n;
+}
+
+void cf_string_builder_fmt(CF_StringBuilder* sb, const char* fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	cf_string_builder_vfmt(sb, fmt, args);
+	va_end(args);
+}
+
+void cf_string_builder_join(CF_StringBuilder* sb, CF_StringBuilder* src)
+{
+	if (!src->head) return;
+	if (sb->tail) {
+		sb->tail->next = src->head;
+	} else {
+		sb->head = src->head;
+	}
+	sb->tail = src->tail;
+	sb->len += src->len;
+	src->head = src->tail = NULL;
+	src->len = 0;
+}
+
+int cf_string_builder_len(const CF_StringBuilder* sb)
+{
+	return sb->len;
+}
+
+void cf_string_builder_clear(CF_StringBuilder* sb)
+{
+	if (sb->tail) {
+		sb->tail->next = sb->free_list;
+		sb->free_list = sb->head;
+	}
+	sb->head = sb->tail = NULL;
+	sb->len = 0;
+}
+
+const char* cf_string_builder_c_str(CF_StringBuilder* sb)
+{
+	if (!sb->head) return "";
+	if (sb->head != sb->tail) {
+		// Coalesce all chunks into a single one. Later appends keep going into its spare room, and calling this
+		// again without more chunks being added costs nothing.
+		CF_StringChunk* old = sb->head;
+		sb->head = sb->tail = NULL;
+		CF_StringChunk* flat = s_push_chunk(sb, sb->len);
+		for (CF_StringChunk* chunk = old; chunk; chunk = chunk->next) {
+			CF_MEMCPY(s_chunk_data(flat) + flat->len, s_chunk_data(chunk), chunk->len);
+			flat->len += chunk->len;
+		}
+		CF_StringChunk* last = old;
+		while (last->next) last = last->next;
+		last->next = sb->free_list;
+		sb->free_list = old;
+	}
+	s_chunk_data(sb->head)[sb->head->len] = 0;
+	return s_chunk_data(sb->head);
+}
+
+char* cf_string_builder_to_string(const CF_StringBuilder* sb)
+{
+	char* s = NULL;
+	sfit(s, sb->len);
+	for (CF_StringChunk* chunk = sb->head; chunk; chunk = chunk->next) {
+		sappend_range(s, s_chunk_data(chunk), s_chunk_data(chunk) + chunk->len);
+	}
+	return s;
+}
+
+CF_Result cf_string_builder_write(const CF_StringBuilder* sb, CF_File* file)
+{
+	for (CF_StringChunk* chunk = sb->head; chunk; chunk = chunk->next) {
+		if (cf_fs_write(file, s_chunk_data(chunk), (size_t)chunk->len) != (size_t)chunk->len) {
+			return cf_result_error("Failed to write string builder to file.");
+		}
+	}
+	return cf_result_success();
+}
+
 bool cf_sprefix(char* s, const char* prefix)
 {
 	CF_ACANARY(s);
@@ -152,6 +385,7 @@ void cf_stolower(char* s)
 
 char* cf_sappend(char* a, const char* b)
 {
+	CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_STRING);
 	CF_ACANARY(a);
 	int blen = (int)CF_STRLEN(b);
 	if (blen <= 0) return a;
@@ -164,6 +398,7 @@ char* cf_sappend(char* a, const char* b)
 
 char* cf_sappend_range(char* a, const char* b, const char* b_end)
 {
+	CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_STRING);
 	CF_ACANARY(a);
 	int blen = (int)(b_end - b);
 	if (blen <= 0) return a;
@@ -211,6 +446,7 @@ char* cf_srtrim(char* s)
 
 char* cf_slpad(char* s, char pad, int count)
 {
+	CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_STRING);
 	CF_ACANARY(s);
 	int cap = scap(s) - scount(s);
 	if (cap < count) {
@@ -224,6 +460,7 @@ char* cf_slpad(char* s, char pad, int count)
 
 char* cf_srpad(char* s, char pad, int count)
 {
+	CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_STRING);
 	CF_ACANARY(s);
 	int cap = scap(s) - scount(s);
 	if (cap < count) {
@@ -262,6 +499,7 @@ char* cf_ssplit_once(char* s, char split_c)
 
 char** cf_ssplit(const char* s, char split_c)
 {
+	CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_STRING);
 	char* copy = NULL;
 	char** result = NULL;
 	char* split = NULL;
@@ -339,6 +577,7 @@ uint64_t cf_stohex(const char* s)
 
 char* cf_sreplace(char* s, const char* replace_me, const char* with_me)
 {
+	CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_STRING);
 	CF_ACANARY(s);
 	if (!s) return NULL;
 	size_t replace_len = CF_STRLEN(replace_me);
@@ -433,46 +672,116 @@ char* cf_spopn(char* s, int n)
 
 using intern_t = cf_intern_t;
 
-struct intern_table_t
+// The intern table is split into shards by hash, each an open-addressed array of {hash, intern} slots. Lookups
+// never lock: slots are only ever filled in (never cleared or moved) while a shard's array is live, and growing a
+// shard publishes a whole new array, so readers see either the old or new array, both complete. Old arrays are
+// retired rather than free'd, since readers may still be probing them, and are cleaned up in `cf_sinuke_intern_table`.
+// Inserts take a per-shard mutex, so threads interning different strings rarely wait on each other.
+#define CF_INTERN_SHARD_BITS 4
+#define CF_INTERN_SHARD_COUNT (1 << CF_INTERN_SHARD_BITS)
+#define CF_INTERN_SHARD_BLOCK_SIZE (256 * CF_KB)
+#define CF_INTERN_CACHE_SIZE 256
+
+struct intern_slot_t
+{
+	std::atomic<uint64_t> hash;
+	std::atomic<intern_t*> intern;
+};
+
+struct intern_slots_t
+{
+	int capacity;
+	intern_slots_t* retired;
+	intern_slot_t slots[1];
+};
+
+struct alignas(64) intern_shard_t
 {
-	htbl intern_t** interns;
+	std::atomic<intern_slots_t*> slots;
+	int count;
+	CF_Mutex lock;
 	CF_Arena arena;
-	CF_ReadWriteLock lock;
+	dyna void** large; // Strings too big for an arena block.
+};
+
+struct intern_table_t
+{
+	intern_shard_t shards[CF_INTERN_SHARD_COUNT];
+};
 
-	CF_INLINE void read_lock() { cf_read_lock(&lock); }
-	CF_INLINE void read_unlock() { cf_read_unlock(&lock); }
-	CF_INLINE void write_lock() { cf_write_lock(&lock); }
-	CF_INLINE void write_unlock() { cf_write_unlock(&lock); }
+// Small direct-mapped cache of recently intern'd strings per thread, checked before touching the shared table.
+// Entries are tagged with the table generation, so `cf_sinuke_intern_table` invalidates every thread's cache at once.
+struct intern_cache_entry_t
+{
+	uint64_t hash;
+	uint64_t generation;
+	const char* string;
 };
 
-static intern_table_t* g_intern_table;
+static std::atomic<intern_table_t*> g_intern_table;
+static std::atomic<uint64_t> g_intern_generation{ 1 };
+static thread_local intern_cache_entry_t s_intern_cache[CF_INTERN_CACHE_SIZE];
+
+static intern_slots_t* s_make_intern_slots(int capacity)
+{
+	intern_slots_t* slots = (intern_slots_t*)CF_CALLOC(sizeof(intern_slots_t) + sizeof(intern_slot_t) * (capacity - 1));
+	slots->capacity = capacity;
+	return slots;
+}
 
 static intern_table_t* s_inst()
 {
 	// Locklessly get/instantiate a global instance.
-	intern_table_t* inst = (intern_table_t*)cf_atomic_ptr_get((void**)&g_intern_table);
+	intern_table_t* inst = g_intern_table.load(std::memory_order_acquire);
 	if (!inst) {
 		// Create a new instance of the table.
-		inst = (intern_table_t*)CF_ALLOC(sizeof(intern_table_t));
-		CF_MEMSET(inst, 0, sizeof(*inst));
-		inst->interns = NULL;
-		inst->arena.alignment = 8;
-		inst->arena.block_size = CF_MB;
-		inst->lock = cf_make_rw_lock();
+		CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_STRING);
+		inst = (intern_table_t*)cf_aligned_alloc(sizeof(intern_table_t), alignof(intern_table_t));
+		CF_MEMSET((void*)inst, 0, sizeof(*inst));
+		for (int i = 0; i < CF_INTERN_SHARD_COUNT; ++i) {
+			intern_shard_t* shard = inst->shards + i;
+			shard->slots.store(s_make_intern_slots(64), std::memory_order_relaxed);
+			shard->lock = cf_make_mutex();
+			shard->arena = cf_make_arena(8, CF_INTERN_SHARD_BLOCK_SIZE);
+		}
 
 		// Try and set the global pointer. If this fails it means another thread
 		// has raced us and completed first, so then just destroy ours and use theirs.
-		CF_Result result = cf_atomic_ptr_cas((void**)&g_intern_table, NULL, inst);
-		if (is_error(result)) {
-			cf_destroy_rw_lock(&inst->lock);
-			CF_FREE(inst);
-			inst = (intern_table_t*)cf_atomic_ptr_get((void**)&g_intern_table);
+		intern_table_t* expected = NULL;
+		if (!g_intern_table.compare_exchange_strong(expected, inst, std::memory_order_acq_rel)) {
+			for (int i = 0; i < CF_INTERN_SHARD_COUNT; ++i) {
+				CF_FREE(inst->shards[i].slots.load(std::memory_order_relaxed));
+				cf_destroy_mutex(&inst->shards[i].lock);
+			}
+			cf_aligned_free(inst);
+			inst = expected;
 			CF_ASSERT(inst);
 		}
 	}
 	return inst;
 }
 
+static intern_t* s_intern_find(const intern_slots_t* slots, uint64_t hash, const char* start, int len)
+{
+	int mask = slots->capacity - 1;
+	for (int i = (int)hash & mask;; i = (i + 1) & mask) {
+		intern_t* intern = slots->slots[i].intern.load(std::memory_order_acquire);
+		if (!intern) return NULL;
+		if (slots->slots[i].hash.load(std::memory_order_relaxed) == hash && intern->len == len && !CF_MEMCMP(intern->string, start, len)) {
+			return intern;
+		}
+	}
+}
+
+static void s_intern_insert(intern_slots_t* slots, uint64_t hash, intern_t* intern)
+{
+	int mask = slots->capacity - 1;
+	int i = (int)hash & mask;
+	while (slots->slots[i].intern.load(std::memory_order_relaxed)) i = (i + 1) & mask;
+	slots->slots[i].hash.store(hash, std::memory_order_relaxed);
+	slots->slots[i].intern.store(intern, std::memory_order_release);
+}
+
 const char* cf_sintern(const char* s)
 {
 	return s ? cf_sintern_range(s, s + CF_STRLEN(s)) : NULL;
@@ -480,44 +789,63 @@ const char* cf_sintern(const char* s)
 
 const char* cf_sintern_range(const char* start, const char* end)
 {
-	intern_table_t* table = s_inst();
-	intern_t* intern = NULL;
 	int len = (int)(end - start);
 	uint64_t hash = fnv1a(start, len);
 
-	// Fast-path, fetch already intern'd strings and return them as-is.
-	// Uses a mere read-lock, which is just a couple atomic read operations
-	// and supports *many* simultaneous lockless readers.
-	if (table->interns) {
-		table->read_lock();
-		intern = hget(table->interns, hash);
-		table->read_unlock();
-		if (intern) {
-			// This loop is highly unlikely to ever actually run more than one iteration.
-			intern_t* i = intern;
-			while (i) {
-				if (len == i->len && !CF_STRNCMP(i->string, start, len)) {
-					return i->string;
+	// Fastest path, this thread recently intern'd the same string.
+	uint64_t generation = g_intern_generation.load(std::memory_order_acquire);
+	intern_cache_entry_t* cached = s_intern_cache + ((hash ^ (hash >> 32)) & (CF_INTERN_CACHE_SIZE - 1));
+	if (cached->generation == generation && cached->hash == hash && silen(cached->string) == len && !CF_MEMCMP(cached->string, start, len)) {
+		return cached->string;
+	}
+
+	// Fast-path, fetch already intern'd strings from the shard without taking any locks.
+	intern_table_t* table = s_inst();
+	intern_shard_t* shard = table->shards + ((hash * 0x9E3779B97F4A7C15ULL) >> (64 - CF_INTERN_SHARD_BITS));
+	intern_t* intern = s_intern_find(shard->slots.load(std::memory_order_acquire), hash, start, len);
+
+	if (!intern) {
+		// String is likely not yet interned. Lock the shard and check again, in case another thread
+		// interned the same string in the meantime.
+		CF_MEMORY_TAG_SCOPE(CF_MEMORY_TAG_STRING);
+		cf_mutex_lock(&shard->lock);
+		intern_slots_t* slots = shard->slots.load(std::memory_order_relaxed);
+		intern = s_intern_find(slots, hash, start, len);
+		if (!intern) {
+			int size = (int)sizeof(intern_t) + len + 1;
+			if (size < CF_INTERN_SHARD_BLOCK_SIZE / 4) {
+				intern = (intern_t*)arena_alloc(&shard->arena, size);
+			} else {
+				intern = (intern_t*)CF_ALLOC(size);
+				apush(shard->large, (void*)intern);
+			}
+			intern->cookie = CF_INTERN_COOKIE;
+			intern->len = len;
+			intern->string = (char*)(intern + 1);
+			CF_MEMCPY((char*)intern->string, start, len);
+			((char*)intern->string)[len] = 0;
+			intern->next = NULL;
+
+			// Keep the load factor at or under one half, so probe sequences stay short.
+			if ((shard->count + 1) * 2 > slots->capacity) {
+				intern_slots_t* grown = s_make_intern_slots(slots->capacity * 2);
+				for (int i = 0; i < slots->capacity; ++i) {
+					intern_t* old = slots->slots[i].intern.load(std::memory_order_relaxed);
+					if (old) s_intern_insert(grown, slots->slots[i].hash.load(std::memory_order_relaxed), old);
 				}
-				i = i->next;
+				grown->retired = slots;
+				shard->slots.store(grown, std::memory_order_release);
+				slots = grown;
 			}
+			s_intern_insert(slots, hash, intern);
+			++shard->count;
 		}
+		cf_mutex_unlock(&shard->lock);
 	}
 
-	// String is not yet interned, create a new allocation for it.
-	// We write-lock the data structure, this will wait for all readers to flush.
-	CF_ASSERT(!intern || intern->cookie == CF_INTERN_COOKIE);
-	intern_t* list = intern;
-	table->write_lock();
-	intern = (intern_t*)arena_alloc(&table->arena, sizeof(intern_t) + len + 1);
-	hset(table->interns, hash, intern);
-	intern->cookie = CF_INTERN_COOKIE;
-	intern->len = len;
-	intern->string = (char*)(intern + 1);
-	CF_MEMCPY((char*)intern->string, start, len);
-	((char*)intern->string)[len] = 0;
-	intern->next = list;
-	table->write_unlock();
+	cached->hash = hash;
+	cached->generation = generation;
+	cached->string = intern->string;
 
 	// Return a copy of the string as a stable pointer.
 	return intern->string;
@@ -525,14 +853,25 @@ const char* cf_sintern_range(const char* start, const char* end)
 
 void cf_sinuke_intern_table()
 {
-	intern_table_t* table = s_inst();
-	table->write_lock();
-	cf_atomic_ptr_set((void**)&g_intern_table, NULL);
-	table->write_unlock();
-	arena_reset(&table->arena);
-	hfree(table->interns);
-	cf_destroy_rw_lock(&table->lock);
-	CF_FREE(table);
+	intern_table_t* table = g_intern_table.exchange(NULL, std::memory_order_acq_rel);
+	g_intern_generation.fetch_add(1, std::memory_order_acq_rel);
+	if (!table) return;
+	for (int i = 0; i < CF_INTERN_SHARD_COUNT; ++i) {
+		intern_shard_t* shard = table->shards + i;
+		intern_slots_t* slots = shard->slots.load(std::memory_order_relaxed);
+		while (slots) {
+			intern_slots_t* retired = slots->retired;
+			CF_FREE(slots);
+			slots = retired;
+		}
+		for (int j = 0; j < asize(shard->large); ++j) {
+			CF_FREE(shard->large[j]);
+		}
+		afree(shard->large);
+		cf_destroy_arena(&shard->arena);
+		cf_destroy_mutex(&shard->lock);
+	}
+	cf_aligned_free(table);
 }
 
 // All invalid characters are encoded as the "replacement character" 0xFFFD for both
@@ -570,6 +909,132 @@ const char* cf_decode_UTF8(const char* s, int* codepoint)
 	return s;
 }
 
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#	include <arm_neon.h>
+#	define CF_UTF8_NEON
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	include <emmintrin.h>
+#	define CF_UTF8_SSE2
+#	ifdef _MSC_VER
+#		include <intrin.h>
+#	endif
+#endif
+
+// Same as `cf_decode_UTF8`, but never reads at or past `end`. A sequence cut off by `end` decodes as 0xFFFD.
+static CF_INLINE const char* s_decode_UTF8_bounded(const char* s, const char* end, int* codepoint)
+{
+	unsigned char c = *s++;
+	int extra = 0;
+	int min = 0;
+	int cp;
+	     if (c >= 0xF0) { cp = c & 0x07; extra = 3; min = 0x10000; }
+	else if (c >= 0xE0) { cp = c & 0x0F; extra = 2; min = 0x800; }
+	else if (c >= 0xC0) { cp = c & 0x1F; extra = 1; min = 0x80; }
+	else if (c >= 0x80) { cp = 0xFFFD; }
+	else cp = c;
+	if (extra > (int)(end - s)) {
+		*codepoint = 0xFFFD;
+		return end;
+	}
+	while (extra--) {
+		c = *s++;
+		if ((c & 0xC0) != 0x80) { cp = 0xFFFD; }
+		if (cp != 0xFFFD) { cp = (cp << 6) | (c & 0x3F); }
+	}
+	if (cp < min) cp = 0xFFFD;
+	*codepoint = cp;
+	return s;
+}
+
+#ifdef CF_UTF8_SSE2
+static CF_INLINE int s_first_set_bit(int mask)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, (unsigned long)mask);
+	return (int)index;
+#else
+	return __builtin_ctz((unsigned)mask);
+#endif
+}
+#endif
+
+const char* cf_decode_UTF8_bulk(const char* s, int byte_count, int* codepoints, int capacity, int* count)
+{
+	if (byte_count < 0) byte_count = (int)CF_STRLEN(s);
+	const char* end = s + byte_count;
+	int n = 0;
+	while (s < end && n < capacity) {
+		// ASCII fast path, 16 bytes at a time. Each byte is zero-extended straight into a codepoint.
+#if defined(CF_UTF8_SSE2)
+		while (end - s >= 16 && capacity - n >= 16) {
+			__m128i bytes = _mm_loadu_si128((const __m128i*)s);
+			int mask = _mm_movemask_epi8(bytes);
+			if (mask) {
+				// Copy the ASCII bytes leading up to the first non-ASCII byte.
+				int ascii = s_first_set_bit(mask);
+				for (int i = 0; i < ascii; ++i) codepoints[n + i] = (unsigned char)s[i];
+				s += ascii;
+				n += ascii;
+				break;
+			}
+			__m128i zero = _mm_setzero_si128();
+			__m128i lo = _mm_unpacklo_epi8(bytes, zero);
+			__m128i hi = _mm_unpackhi_epi8(bytes, zero);
+			__m128i* out = (__m128i*)(codepoints + n);
+			_mm_storeu_si128(out + 0, _mm_unpacklo_epi16(lo, zero));
+			_mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo, zero));
+			_mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi, zero));
+			_mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi, zero));
+			s += 16;
+			n += 16;
+		}
+#elif defined(CF_UTF8_NEON)
+		while (end - s >= 16 && capacity - n >= 16) {
+			uint8x16_t bytes = vld1q_u8((const uint8_t*)s);
+			if (vmaxvq_u8(bytes) >= 0x80) break;
+			uint16x8_t lo = vmovl_u8(vget_low_u8(bytes));
+			uint16x8_t hi = vmovl_u8(vget_high_u8(bytes));
+			uint32_t* out = (uint32_t*)(codepoints + n);
+			vst1q_u32(out + 0, vmovl_u16(vget_low_u16(lo)));
+			vst1q_u32(out + 4, vmovl_u16(vget_high_u16(lo)));
+			vst1q_u32(out + 8, vmovl_u16(vget_low_u16(hi)));
+			vst1q_u32(out + 12, vmovl_u16(vget_high_u16(hi)));
+			s += 16;
+			n += 16;
+		}
+#endif
+		if (s >= end || n >= capacity) break;
+
+		// Decode one codepoint, then stay on the scalar path through any run of non-ASCII text (e.g. CJK), since
+		// the SIMD path would only bail out again immediately.
+		do {
+			const unsigned char* u = (const unsigned char*)s;
+			int left = (int)(end - s);
+			if (u[0] < 0x80) {
+				codepoints[n++] = u[0];
+				++s;
+				continue;
+			} else if (u[0] >= 0xE0 && u[0] < 0xF0 && left >= 3 && (u[1] & 0xC0) == 0x80 && (u[2] & 0xC0) == 0x80) {
+				// Well-formed 3 byte characters cover nearly all CJK text, skip the general decoder for them.
+				int cp = ((u[0] & 0x0F) << 12) | ((u[1] & 0x3F) << 6) | (u[2] & 0x3F);
+				if (cp >= 0x800) {
+					codepoints[n++] = cp;
+					s += 3;
+					continue;
+				}
+			} else if (u[0] >= 0xC2 && u[0] < 0xE0 && left >= 2 && (u[1] & 0xC0) == 0x80) {
+				codepoints[n++] = ((u[0] & 0x1F) << 6) | (u[1] & 0x3F);
+				s += 2;
+				continue;
+			}
+			s = s_decode_UTF8_bounded(s, end, codepoints + n++);
+		} while (s < end && n < capacity && (unsigned char)*s >= 0x80);
+	}
+	*count = n;
+	return s;
+}
+
 const uint16_t* cf_decode_UTF16(const uint16_t* s, int* codepoint)
 {
 	int W1 = *s++;
@@ -18,4 +18,24 @@
 #	define CF_REALLOC(ptr, size) cf_realloc(ptr, size)
 #endif
 
+// Allocations attributed to an explicit `CF_MemoryTag`, regardless of the calling thread's current tag.
+// Used to hook up third party libraries that take their own allocation macros. Memory from these functions
+// can be free'd with `cf_free`, and vice versa.
+void* cf_alloc_tagged(size_t size, CF_MemoryTag tag);
+void* cf_calloc_tagged(size_t size, size_t count, CF_MemoryTag tag);
+void* cf_realloc_tagged(void* ptr, size_t size, CF_MemoryTag tag);
+
+// Frees all frame memory owned by the calling thread. The frame arena starts over from scratch if used again.
+void cf_frame_release();
+
+// Pushes a memory tag for the rest of the enclosing scope, see `cf_memory_push_tag`.
+struct CF_MemoryTagScope
+{
+	CF_MemoryTagScope(CF_MemoryTag tag) { cf_memory_push_tag(tag); }
+	~CF_MemoryTagScope() { cf_memory_pop_tag(); }
+};
+#define CF_MEMORY_TAG_SCOPE_PASTE2(X, Y) X ## Y
+#define CF_MEMORY_TAG_SCOPE_PASTE(X, Y) CF_MEMORY_TAG_SCOPE_PASTE2(X, Y)
+#define CF_MEMORY_TAG_SCOPE(tag) CF_MemoryTagScope CF_MEMORY_TAG_SCOPE_PASTE(cf_memory_tag_scope_, __LINE__)(tag)
+
 #endif // CF_ALLOC_INTERNAL_H
@@ -126,6 +126,10 @@ struct CF_Command
 	draw->add_cmd(); \
 	draw->cmds.last().u = u
 
+// Draw state stacks rarely hold more than a few entries, so keep them inline within `CF_Draw`.
+template <typename T>
+using CF_DrawStack = Cute::InlineArray<T, 4>;
+
 struct CF_Draw
 {
 	CF_INLINE CF_Command& add_cmd() {
@@ -150,30 +154,30 @@ struct CF_Draw
 	CF_Mesh mesh;
 	CF_Material material;
 	CF_Arena uniform_arena;
-	Cute::Array<float> alpha_discards = { true };
-	Cute::Array<CF_Color> colors = { cf_color_white() };
-	Cute::Array<bool> antialias = { true };
-	Cute::Array<float> antialias_scale = { 1.5f };
-	Cute::Array<CF_RenderState> render_states;
-	Cute::Array<CF_Rect> scissors = { { 0, 0, -1, -1 } };
-	Cute::Array<CF_Rect> viewports = { { 0, 0, -1, -1 } };
-	Cute::Array<int> layers = { 0 };
-	Cute::Array<CF_M3x2> cam_stack = { cf_make_identity() };
+	CF_DrawStack<float> alpha_discards = { true };
+	CF_DrawStack<CF_Color> colors = { cf_color_white() };
+	CF_DrawStack<bool> antialias = { true };
+	CF_DrawStack<float> antialias_scale = { 1.5f };
+	CF_DrawStack<CF_RenderState> render_states;
+	CF_DrawStack<CF_Rect> scissors = { { 0, 0, -1, -1 } };
+	CF_DrawStack<CF_Rect> viewports = { { 0, 0, -1, -1 } };
+	CF_DrawStack<int> layers = { 0 };
+	CF_DrawStack<CF_M3x2> cam_stack = { cf_make_identity() };
 	float aaf = 0;
 	CF_M3x2 projection;
 	CF_M3x2 mvp;
 	void reset_cam();
 	void set_aaf();
-	Cute::Array<CF_Color> user_params = { cf_make_color_hex(0) };
-	Cute::Array<CF_Shader> shaders;
+	CF_DrawStack<CF_Color> user_params = { cf_make_color_hex(0) };
+	CF_DrawStack<CF_Shader> shaders;
 	Cute::Array<CF_V2> temp;
-	Cute::Array<float> font_sizes = { 18 };
-	Cute::Array<const char*> fonts = { sintern("Calibri") };
-	Cute::Array<int> blurs = { 0 };
-	Cute::Array<float> text_wrap_widths = { FLT_MAX };
-	Cute::Array<bool> vertical = { false };
+	CF_DrawStack<float> font_sizes = { 18 };
+	CF_DrawStack<const char*> fonts = { sintern("Calibri") };
+	CF_DrawStack<int> blurs = { 0 };
+	CF_DrawStack<float> text_wrap_widths = { FLT_MAX };
+	CF_DrawStack<bool> vertical = { false };
 	Cute::Array<CF_Strike> strikes;
-	Cute::Array<bool> text_effects = { true };
+	CF_DrawStack<bool> text_effects = { true };
 	Cute::Map<uint64_t, CF_AtlasSubImage> premade_sub_image_id_to_sub_image;
 	Cute::Map<uint64_t, uint64_t> draw_shd_to_blit_shd;
 	bool blit_init = false;
@@ -25,15 +25,24 @@
 
 #include <cute.h>
 
+TEST_SUITE(test_alloc_route_tag);
+TEST_SUITE(test_alloc);
 TEST_SUITE(test_array);
 TEST_SUITE(test_aseprite);
 TEST_SUITE(test_audio);
 TEST_SUITE(test_base64);
+TEST_SUITE(test_concurrent_map);
 TEST_SUITE(test_coroutine);
 TEST_SUITE(test_doubly_list);
+TEST_SUITE(test_handle);
 TEST_SUITE(test_hashtable);
+TEST_SUITE(test_job_system);
 TEST_SUITE(test_path);
+TEST_SUITE(test_pathfinding);
 TEST_SUITE(test_png_cache);
+TEST_SUITE(test_priority_queue);
+TEST_SUITE(test_profile);
+TEST_SUITE(test_queue);
 TEST_SUITE(test_sprite);
 TEST_SUITE(test_string);
 TEST_SUITE(test_json);
@@ -43,6 +52,11 @@ TEST_SUITE(test_markups);
 
 int main(int argc, char* argv[])
 {
+	pu_display_colors(true);
+
+	// Has to come before the first allocation, which cf_fs_init makes.
+	RUN_TEST_SUITE(test_alloc_route_tag);
+
 	cf_fs_init(argv[0]);
 	printf("Tests are running from \"%s\"\n\n", cf_fs_get_base_directory());
 	cf_fs_destroy();
@@ -59,17 +73,23 @@ int main(int argc, char* argv[])
 	#define RUN_TEST_SUITE(suite_fp) pu_run_suite(#suite_fp, suite_fp); sinuke(); SDL_Quit(); _CrtDumpMemoryLeaks();
 #endif
 
-	pu_display_colors(true);
-
+	RUN_TEST_SUITE(test_alloc);
 	RUN_TEST_SUITE(test_array);
 	RUN_TEST_SUITE(test_aseprite);
 	RUN_TEST_SUITE(test_audio);
 	RUN_TEST_SUITE(test_base64);
+	RUN_TEST_SUITE(test_concurrent_map);
 	RUN_TEST_SUITE(test_coroutine);
 	RUN_TEST_SUITE(test_doubly_list);
+	RUN_TEST_SUITE(test_handle);
 	RUN_TEST_SUITE(test_hashtable);
+	RUN_TEST_SUITE(test_job_system);
 	RUN_TEST_SUITE(test_path);
+	RUN_TEST_SUITE(test_pathfinding);
 	RUN_TEST_SUITE(test_png_cache);
+	RUN_TEST_SUITE(test_priority_queue);
+	RUN_TEST_SUITE(test_profile);
+	RUN_TEST_SUITE(test_queue);
 	RUN_TEST_SUITE(test_sprite);
 	RUN_TEST_SUITE(test_string);
 	RUN_TEST_SUITE(test_json);
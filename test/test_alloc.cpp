@@ -0,0 +1,656 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include "test_harness.h"
+
+#include <cute.h>
+
+using namespace Cute;
+
+/* Save and restore markers within a single arena block. */
+TEST_CASE(test_arena_save_restore)
+{
+	CF_Arena arena = cf_make_arena(8, 1024);
+
+	// Restoring a marker saved before any allocation rewinds to an empty arena.
+	CF_ArenaMarker empty = cf_arena_save(&arena);
+	char* a = (char*)cf_arena_alloc(&arena, 100);
+	cf_arena_restore(&arena, empty);
+	REQUIRE(cf_arena_alloc(&arena, 100) == a);
+
+	CF_ArenaMarker m0 = cf_arena_save(&arena);
+	char* b = (char*)cf_arena_alloc(&arena, 16);
+	CF_ArenaMarker m1 = cf_arena_save(&arena);
+	char* c = (char*)cf_arena_alloc(&arena, 16);
+	REQUIRE(c > b);
+
+	cf_arena_restore(&arena, m1);
+	REQUIRE(cf_arena_alloc(&arena, 16) == c);
+	cf_arena_restore(&arena, m0);
+	REQUIRE(cf_arena_alloc(&arena, 16) == b);
+
+	cf_destroy_arena(&arena);
+
+	return true;
+}
+
+/* Markers are restored correctly when allocations spill over into later blocks. */
+TEST_CASE(test_arena_save_restore_across_blocks)
+{
+	CF_Arena arena = cf_make_arena(16, 256);
+
+	char* first = (char*)cf_arena_alloc(&arena, 200);
+	CF_ArenaMarker m = cf_arena_save(&arena);
+	char* second = (char*)cf_arena_alloc(&arena, 32);
+	REQUIRE(second == first + 208);
+
+	// Spill over into three more blocks.
+	char* blocks[3];
+	for (int i = 0; i < 3; ++i) {
+		blocks[i] = (char*)cf_arena_alloc(&arena, 200);
+		CF_MEMSET(blocks[i], i, 200);
+	}
+	REQUIRE(arena.block_index == 4);
+
+	cf_arena_restore(&arena, m);
+	REQUIRE(arena.block_index == 1);
+
+	// The same memory is handed out again, and the old blocks are reused rather than reallocated.
+	REQUIRE(cf_arena_alloc(&arena, 32) == second);
+	for (int i = 0; i < 3; ++i) {
+		REQUIRE(cf_arena_alloc(&arena, 200) == blocks[i]);
+	}
+	REQUIRE(asize(arena.blocks) == 4);
+
+	cf_destroy_arena(&arena);
+
+	return true;
+}
+
+static int s_recurse(CF_Arena* arena, int depth)
+{
+	ArenaScope scope(arena);
+	int* values = (int*)scope.alloc(sizeof(int) * 16);
+	for (int i = 0; i < 16; ++i) values[i] = depth;
+	int sum = depth ? s_recurse(arena, depth - 1) : 0;
+	for (int i = 0; i < 16; ++i) {
+		if (values[i] != depth) return -1;
+	}
+	return sum + depth;
+}
+
+/* Nested ArenaScope's within a recursive function, spanning many blocks. */
+TEST_CASE(test_arena_scope)
+{
+	CF_Arena arena = cf_make_arena(8, 128);
+	CF_ArenaMarker start = cf_arena_save(&arena);
+
+	REQUIRE(s_recurse(&arena, 32) == 32 * 33 / 2);
+	REQUIRE(arena.ptr == start.ptr);
+	REQUIRE(arena.block_index == start.block_index);
+	int block_count = asize(arena.blocks);
+	REQUIRE(block_count > 1);
+
+	// Running again reuses the same blocks.
+	REQUIRE(s_recurse(&arena, 32) == 32 * 33 / 2);
+	REQUIRE(asize(arena.blocks) == block_count);
+
+	cf_destroy_arena(&arena);
+
+	return true;
+}
+
+/* Virtual arenas hand out large contiguous allocations, and decommit above the retention watermark on reset. */
+TEST_CASE(test_virtual_arena)
+{
+	CF_VirtualArena arena = cf_make_virtual_arena(16, 64 * CF_MB, 256 * CF_KB);
+	REQUIRE(arena.base);
+
+	char* a = (char*)cf_virtual_arena_alloc(&arena, 10);
+	char* b = (char*)cf_virtual_arena_alloc(&arena, 4 * CF_MB);
+	REQUIRE(a == arena.base);
+	REQUIRE(b == a + 16);
+	CF_MEMSET(b, 0xFF, 4 * CF_MB);
+
+	cf_virtual_arena_reset(&arena);
+	REQUIRE(arena.ptr == arena.base);
+#ifndef CF_EMSCRIPTEN
+	REQUIRE(arena.commit_end == arena.base + 256 * CF_KB);
+#endif
+	REQUIRE(cf_virtual_arena_alloc(&arena, 10) == a);
+
+	cf_destroy_virtual_arena(&arena);
+	REQUIRE(!arena.base);
+
+	return true;
+}
+
+struct PoolStress
+{
+	CF_MemoryPool* pool;
+	int id;
+	bool ok;
+};
+
+static int s_pool_stress(void* udata)
+{
+	PoolStress* stress = (PoolStress*)udata;
+	uint64_t* live[256];
+	int count = 0;
+	stress->ok = true;
+	for (int i = 0; i < 20000; ++i) {
+		if (count < 256 && (count == 0 || (i * 7 + stress->id) % 3)) {
+			uint64_t* p = (uint64_t*)cf_memory_pool_alloc(stress->pool);
+			p[0] = (uint64_t)stress->id;
+			p[1] = (uint64_t)(uintptr_t)p;
+			live[count++] = p;
+		} else {
+			uint64_t* p = live[--count];
+			if (p[0] != (uint64_t)stress->id || p[1] != (uint64_t)(uintptr_t)p) stress->ok = false;
+			cf_memory_pool_free(stress->pool, p);
+		}
+	}
+	while (count) cf_memory_pool_free(stress->pool, live[--count]);
+	return 0;
+}
+
+/* Many threads allocating and freeing from one pool, then trimming everything back. */
+TEST_CASE(test_memory_pool_threads)
+{
+	int thread_counts[] = { 1, 4, 16 };
+	for (int t = 0; t < 3; ++t) {
+		CF_MemoryPool* pool = cf_make_memory_pool(sizeof(uint64_t) * 2, 64, 8);
+		PoolStress stress[16];
+		CF_Thread* threads[16];
+		for (int i = 0; i < thread_counts[t]; ++i) {
+			stress[i] = { pool, i, false };
+			threads[i] = cf_thread_create(s_pool_stress, "pool stress", stress + i);
+		}
+		for (int i = 0; i < thread_counts[t]; ++i) {
+			cf_thread_wait(threads[i]);
+			REQUIRE(stress[i].ok);
+		}
+
+		// Every element is free, so every block can be released.
+		REQUIRE(cf_memory_pool_trim(pool) > 0);
+		REQUIRE(cf_memory_pool_trim(pool) == 0);
+
+		// The pool still works after trimming.
+		void* p = cf_memory_pool_alloc(pool);
+		REQUIRE(p);
+		cf_memory_pool_free(pool, p);
+		cf_destroy_memory_pool(pool);
+	}
+
+	return true;
+}
+
+/* Growing a pool well past its first few thousand magazines, then handing every element back out. */
+TEST_CASE(test_memory_pool_grow)
+{
+	const int count = 200000;
+	CF_MemoryPool* pool = cf_make_memory_pool(sizeof(int), 64, 4);
+	int** elements = (int**)cf_alloc(sizeof(int*) * count);
+	for (int i = 0; i < count; ++i) {
+		elements[i] = (int*)cf_memory_pool_alloc(pool);
+		*elements[i] = i;
+	}
+	for (int i = 0; i < count; ++i) {
+		REQUIRE(*elements[i] == i);
+		cf_memory_pool_free(pool, elements[i]);
+	}
+	for (int i = 0; i < count; ++i) elements[i] = (int*)cf_memory_pool_alloc(pool);
+	for (int i = 0; i < count; ++i) cf_memory_pool_free(pool, elements[i]);
+	REQUIRE(cf_memory_pool_trim(pool) > 0);
+	cf_free(elements);
+	cf_destroy_memory_pool(pool);
+
+	return true;
+}
+
+/* Trimming keeps blocks with live elements. */
+TEST_CASE(test_memory_pool_trim)
+{
+	CF_MemoryPool* pool = cf_make_memory_pool(16, 32, 16);
+	void* elements[128];
+	for (int i = 0; i < 128; ++i) elements[i] = cf_memory_pool_alloc(pool);
+
+	// Free all but one element, which pins exactly one of the four blocks.
+	for (int i = 1; i < 128; ++i) cf_memory_pool_free(pool, elements[i]);
+	REQUIRE(cf_memory_pool_trim(pool) == 3);
+
+	cf_memory_pool_free(pool, elements[0]);
+	REQUIRE(cf_memory_pool_trim(pool) == 1);
+	cf_destroy_memory_pool(pool);
+
+	return true;
+}
+
+struct CF_CountingAllocator
+{
+	int allocs;
+	int frees;
+	int reallocs;
+};
+
+static void* s_counting_alloc(size_t size, void* udata) { ((CF_CountingAllocator*)udata)->allocs++; return malloc(size); }
+static void s_counting_free(void* ptr, void* udata) { ((CF_CountingAllocator*)udata)->frees++; free(ptr); }
+static void* s_counting_calloc(size_t size, size_t count, void* udata) { ((CF_CountingAllocator*)udata)->allocs++; return calloc(size, count); }
+static void* s_counting_realloc(void* ptr, size_t size, void* udata) { ((CF_CountingAllocator*)udata)->reallocs++; return realloc(ptr, size); }
+
+static bool s_asserted;
+static void s_note_assert(bool expr, const char* message, const char* file, int line) { if (!expr) s_asserted = true; }
+
+// Set once `test_allocator_route_tag` has turned on memory headers.
+static bool s_tag_routing;
+
+/* A tag routed to its own allocator before anything else allocates, the way an app would near the top of main. */
+TEST_CASE(test_allocator_route_tag)
+{
+	CF_CountingAllocator counts = { 0 };
+	CF_Allocator counting = { &counts, s_counting_alloc, s_counting_free, s_counting_calloc, s_counting_realloc };
+	cf_assert_fn* assert_fn = g_assert_fn;
+	cf_set_assert_handler(s_note_assert);
+	s_asserted = false;
+	cf_allocator_override_tag(CF_MEMORY_TAG_AUDIO, counting);
+	cf_set_assert_handler(assert_fn);
+	REQUIRE(!s_asserted);
+	s_tag_routing = true;
+
+	// Only allocations made under the tag reach its allocator.
+	void* general = cf_alloc(32);
+	cf_memory_push_tag(CF_MEMORY_TAG_AUDIO);
+	void* a = cf_alloc(64);
+	void* b = cf_calloc(16, 4);
+	cf_memory_pop_tag();
+	REQUIRE(counts.allocs == 2);
+
+	// Reallocating under a different tag stays with the allocator that made the block.
+	a = cf_realloc(a, 4096);
+	REQUIRE(counts.reallocs == 1);
+
+	// After a restore new allocations go to the default allocator, while blocks already handed out still go
+	// back to the allocator that made them.
+	cf_allocator_restore_default_tag(CF_MEMORY_TAG_AUDIO);
+	cf_memory_push_tag(CF_MEMORY_TAG_AUDIO);
+	void* c = cf_alloc(64);
+	cf_memory_pop_tag();
+	REQUIRE(counts.allocs == 2);
+	cf_free(a);
+	cf_free(b);
+	REQUIRE(counts.frees == 2);
+	cf_free(c);
+	cf_free(general);
+	REQUIRE(counts.frees == 2);
+
+	return true;
+}
+
+/* Overriding a tag after allocations were made never changes how those allocations are free'd. */
+TEST_CASE(test_allocator_override_tag)
+{
+	void* before = cf_alloc(64);
+
+	CF_CountingAllocator counts = { 0 };
+	CF_Allocator counting = { &counts, s_counting_alloc, s_counting_free, s_counting_calloc, s_counting_realloc };
+	cf_assert_fn* assert_fn = g_assert_fn;
+	cf_set_assert_handler(s_note_assert);
+	s_asserted = false;
+	cf_allocator_override_tag(CF_MEMORY_TAG_JSON, counting);
+	cf_set_assert_handler(assert_fn);
+
+	cf_memory_push_tag(CF_MEMORY_TAG_JSON);
+	void* after = cf_alloc(64);
+	cf_memory_pop_tag();
+
+	if (cf_memory_tracking_enabled() || s_tag_routing) {
+		// Every allocation already carries a header, so the override takes effect right away.
+		REQUIRE(!s_asserted);
+		REQUIRE(counts.allocs == 1);
+	} else {
+		// Allocations were made without headers, so the override is refused.
+		REQUIRE(s_asserted);
+		REQUIRE(counts.allocs == 0);
+	}
+
+	// Neither of these may reach the wrong allocator.
+	cf_free(before);
+	cf_free(after);
+	REQUIRE(counts.frees == counts.allocs);
+	cf_allocator_restore_default_tag(CF_MEMORY_TAG_JSON);
+
+	return true;
+}
+
+/* Per-tag counters follow allocations made under a tag, and everything is zero when tracking is off. */
+TEST_CASE(test_memory_stats)
+{
+	if (!cf_memory_tracking_enabled()) {
+		CF_MemoryStats stats = cf_memory_stats(CF_MEMORY_TAG_NET);
+		REQUIRE(!stats.live_bytes && !stats.live_allocations && !stats.peak_bytes && !stats.total_allocations);
+		REQUIRE(cf_memory_dump_leaks() == 0);
+		return true;
+	}
+
+	CF_MemoryStats start = cf_memory_stats(CF_MEMORY_TAG_NET);
+	cf_memory_push_tag(CF_MEMORY_TAG_NET);
+	void* a = cf_alloc(100);
+	void* b = cf_calloc(50, 4);
+	cf_memory_pop_tag();
+
+	// Allocations stay with their tag even once it's no longer active.
+	CF_MemoryStats stats = cf_memory_stats(CF_MEMORY_TAG_NET);
+	REQUIRE(stats.live_bytes - start.live_bytes == 300);
+	REQUIRE(stats.live_allocations - start.live_allocations == 2);
+	REQUIRE(stats.total_allocations - start.total_allocations == 2);
+	REQUIRE(stats.peak_bytes >= stats.live_bytes);
+
+	a = cf_realloc(a, 150);
+	stats = cf_memory_stats(CF_MEMORY_TAG_NET);
+	REQUIRE(stats.live_bytes - start.live_bytes == 350);
+	REQUIRE(stats.live_allocations - start.live_allocations == 2);
+	REQUIRE(stats.total_allocations - start.total_allocations == 2);
+
+	int leaks = cf_memory_dump_leaks();
+	REQUIRE(leaks >= 2);
+	cf_free(b);
+	REQUIRE(cf_memory_dump_leaks() == leaks - 1);
+
+	// The peak remembers the high-water mark until reset.
+	stats = cf_memory_stats(CF_MEMORY_TAG_NET);
+	REQUIRE(stats.live_bytes - start.live_bytes == 150);
+	REQUIRE(stats.peak_bytes - start.live_bytes >= 350);
+	cf_memory_reset_peak(CF_MEMORY_TAG_NET);
+	REQUIRE(cf_memory_stats(CF_MEMORY_TAG_NET).peak_bytes == stats.live_bytes);
+
+	cf_free(a);
+	stats = cf_memory_stats(CF_MEMORY_TAG_NET);
+	REQUIRE(stats.live_bytes == start.live_bytes);
+	REQUIRE(stats.live_allocations == start.live_allocations);
+
+	return true;
+}
+
+static const int s_small_class_sizes[] = { 16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024 };
+
+static bool s_check_bytes(const void* p, size_t size, uint8_t value)
+{
+	for (size_t i = 0; i < size; ++i) {
+		if (((const uint8_t*)p)[i] != value) return false;
+	}
+	return true;
+}
+
+/* Small allocator picks the right size class on either side of every class boundary. */
+TEST_CASE(test_small_allocator_classes)
+{
+	CF_Allocator small = cf_small_allocator();
+	int prev = 0;
+	for (int i = 0; i < (int)CF_ARRAY_SIZE(s_small_class_sizes); ++i) {
+		int size = s_small_class_sizes[i];
+
+		// The smallest size in a class can grow to the largest without moving.
+		void* p = small.alloc_fn((size_t)prev + 1, small.udata);
+		REQUIRE(p);
+		REQUIRE(((size_t)p & 15) == 0);
+		CF_MEMSET(p, 0xAB, prev + 1);
+		REQUIRE(small.realloc_fn(p, size, small.udata) == p);
+		CF_MEMSET(p, 0xAB, size);
+
+		// One byte past the class moves to the next one, keeping the contents.
+		void* q = small.realloc_fn(p, (size_t)size + 1, small.udata);
+		REQUIRE(q);
+		REQUIRE(q != p);
+		REQUIRE(s_check_bytes(q, size, 0xAB));
+		small.free_fn(q, small.udata);
+		prev = size;
+	}
+
+	// Zero sized allocations still hand back a unique, freeable block.
+	void* a = small.alloc_fn(0, small.udata);
+	void* b = small.alloc_fn(0, small.udata);
+	REQUIRE(a && b && a != b);
+	small.free_fn(a, small.udata);
+	small.free_fn(b, small.udata);
+
+	return true;
+}
+
+/* Allocations above the largest class fall through to the large path, and reallocs move between the two. */
+TEST_CASE(test_small_allocator_large)
+{
+	CF_Allocator small = cf_small_allocator();
+
+	uint8_t* p = (uint8_t*)small.alloc_fn(1025, small.udata);
+	REQUIRE(p);
+	REQUIRE(((size_t)p & 15) == 0);
+	CF_MEMSET(p, 1, 1025);
+
+	// Large to large.
+	p = (uint8_t*)small.realloc_fn(p, 1 * CF_MB, small.udata);
+	REQUIRE(p);
+	REQUIRE(s_check_bytes(p, 1025, 1));
+	CF_MEMSET(p, 2, 1 * CF_MB);
+
+	// Large to small.
+	p = (uint8_t*)small.realloc_fn(p, 40, small.udata);
+	REQUIRE(p);
+	REQUIRE(s_check_bytes(p, 40, 2));
+
+	// Small to small across a couple classes, then small to large.
+	p = (uint8_t*)small.realloc_fn(p, 300, small.udata);
+	REQUIRE(s_check_bytes(p, 40, 2));
+	CF_MEMSET(p, 3, 300);
+	p = (uint8_t*)small.realloc_fn(p, 64 * CF_KB, small.udata);
+	REQUIRE(p);
+	REQUIRE(s_check_bytes(p, 300, 3));
+
+	// Realloc to zero frees.
+	REQUIRE(small.realloc_fn(p, 0, small.udata) == NULL);
+
+	// Calloc zeroes, and refuses sizes that overflow.
+	uint8_t* z = (uint8_t*)small.calloc_fn(24, 10, small.udata);
+	REQUIRE(z);
+	REQUIRE(s_check_bytes(z, 240, 0));
+	small.free_fn(z, small.udata);
+	REQUIRE(small.calloc_fn(SIZE_MAX / 2, 4, small.udata) == NULL);
+	REQUIRE(small.alloc_fn(SIZE_MAX - 4, small.udata) == NULL);
+
+	return true;
+}
+
+struct SmallHandoff
+{
+	void* blocks[4096];
+	int count;
+	bool ok;
+};
+
+static int s_small_alloc_blocks(void* udata)
+{
+	SmallHandoff* handoff = (SmallHandoff*)udata;
+	CF_Allocator small = cf_small_allocator();
+	for (int i = 0; i < (int)CF_ARRAY_SIZE(handoff->blocks); ++i) {
+		size_t size = (size_t)s_small_class_sizes[i % CF_ARRAY_SIZE(s_small_class_sizes)];
+		handoff->blocks[i] = small.alloc_fn(size, small.udata);
+		CF_MEMSET(handoff->blocks[i], (uint8_t)i, size);
+	}
+	handoff->count = (int)CF_ARRAY_SIZE(handoff->blocks);
+	return 0;
+}
+
+static int s_small_free_blocks(void* udata)
+{
+	SmallHandoff* handoff = (SmallHandoff*)udata;
+	CF_Allocator small = cf_small_allocator();
+	handoff->ok = true;
+	for (int i = 0; i < handoff->count; ++i) {
+		size_t size = (size_t)s_small_class_sizes[i % CF_ARRAY_SIZE(s_small_class_sizes)];
+		if (!s_check_bytes(handoff->blocks[i], size, (uint8_t)i)) handoff->ok = false;
+		small.free_fn(handoff->blocks[i], small.udata);
+	}
+	handoff->count = 0;
+	return 0;
+}
+
+/* Blocks allocated on one thread can be freed on another, in both directions. */
+TEST_CASE(test_small_allocator_cross_thread)
+{
+	SmallHandoff* handoff = (SmallHandoff*)cf_calloc(sizeof(SmallHandoff), 1);
+
+	// Allocate on a worker, free here.
+	cf_thread_wait(cf_thread_create(s_small_alloc_blocks, "small alloc", handoff));
+	s_small_free_blocks(handoff);
+	REQUIRE(handoff->ok);
+
+	// Allocate here, free on a worker.
+	s_small_alloc_blocks(handoff);
+	cf_thread_wait(cf_thread_create(s_small_free_blocks, "small free", handoff));
+	REQUIRE(handoff->ok);
+
+	// Blocks returned from other threads are handed out again intact.
+	cf_thread_wait(cf_thread_create(s_small_alloc_blocks, "small alloc", handoff));
+	s_small_free_blocks(handoff);
+	REQUIRE(handoff->ok);
+
+	cf_free(handoff);
+
+	return true;
+}
+
+/* Frame allocations are aligned, and grow past the first block and into the large path. */
+TEST_CASE(test_frame_alloc)
+{
+	cf_frame_reset();
+	cf_frame_reset();
+
+	for (int i = 0; i < 64; ++i) {
+		void* p = cf_frame_alloc((size_t)i * 3 + 1);
+		REQUIRE(((size_t)p & 15) == 0);
+	}
+
+	// Blocks are 1mb, so these spill over into a second block and keep their contents.
+	char* blocks[3];
+	for (int i = 0; i < 3; ++i) {
+		blocks[i] = (char*)cf_frame_alloc(600 * CF_KB);
+		REQUIRE(((size_t)blocks[i] & 15) == 0);
+		CF_MEMSET(blocks[i], i + 1, 600 * CF_KB);
+	}
+	for (int i = 0; i < 3; ++i) {
+		REQUIRE(s_check_bytes(blocks[i], 600 * CF_KB, (uint8_t)(i + 1)));
+	}
+
+	// Too big for a block entirely.
+	char* large = (char*)cf_frame_alloc(3 * CF_MB);
+	REQUIRE(((size_t)large & 15) == 0);
+	CF_MEMSET(large, 7, 3 * CF_MB);
+	REQUIRE(s_check_bytes(blocks[2], 600 * CF_KB, 3));
+
+	cf_frame_reset();
+	cf_frame_reset();
+
+	return true;
+}
+
+/* Frame memory survives one reset, and is reused after the second. */
+TEST_CASE(test_frame_reset)
+{
+	cf_frame_reset();
+	cf_frame_reset();
+
+	char* a = (char*)cf_frame_alloc(64);
+	CF_MEMSET(a, 1, 64);
+
+	// The previous frame's memory is still intact during the next frame.
+	cf_frame_reset();
+	char* b = (char*)cf_frame_alloc(64);
+	REQUIRE(b != a);
+	CF_MEMSET(b, 2, 64);
+	REQUIRE(s_check_bytes(a, 64, 1));
+
+	// One more reset and the first frame's memory is handed out again.
+	cf_frame_reset();
+	REQUIRE(cf_frame_alloc(64) == a);
+	REQUIRE(s_check_bytes(b, 64, 2));
+
+	// Skipping frames without allocating recycles both buffers at once.
+	cf_frame_reset();
+	cf_frame_reset();
+	cf_frame_reset();
+	char* c = (char*)cf_frame_alloc(64);
+	REQUIRE(c == a || c == b);
+
+	// Many frames of steady use don't grow memory, each frame reuses the same two addresses.
+	for (int i = 0; i < 100; ++i) {
+		cf_frame_reset();
+		char* p = (char*)cf_frame_alloc(64);
+		REQUIRE(p == a || p == b);
+	}
+
+	return true;
+}
+
+/* FrameArray grows within frame memory, and cf_frame_sfmt formats into it. */
+TEST_CASE(test_frame_array)
+{
+	cf_frame_reset();
+
+	FrameArray<int> a;
+	for (int i = 0; i < 10000; ++i) a.add(i);
+	REQUIRE(a.count() == 10000);
+	REQUIRE(((size_t)a.data() & 15) == 0);
+	for (int i = 0; i < 10000; ++i) REQUIRE(a[i] == i);
+	REQUIRE(a.pop() == 9999);
+
+	FrameArray<int> b = { 1, 2, 3 };
+	FrameArray<int> c = b;
+	c.add(4);
+	REQUIRE(b.count() == 3);
+	REQUIRE(c.count() == 4);
+	REQUIRE(c.last() == 4);
+
+	const char* s = cf_frame_sfmt("%d-%s", 42, "frame");
+	REQUIRE(!CF_STRCMP(s, "42-frame"));
+
+	// Longer than the internal stack buffer.
+	char long_str[600];
+	CF_MEMSET(long_str, 'x', sizeof(long_str) - 1);
+	long_str[sizeof(long_str) - 1] = 0;
+	const char* t = cf_frame_sfmt("<%s>", long_str);
+	REQUIRE(CF_STRLEN(t) == sizeof(long_str) + 1);
+	REQUIRE(t[0] == '<' && t[sizeof(long_str)] == '>');
+
+	cf_frame_reset();
+	cf_frame_reset();
+
+	return true;
+}
+
+// Run before anything else allocates, see `cf_allocator_override_tag`.
+TEST_SUITE(test_alloc_route_tag)
+{
+	RUN_TEST_CASE(test_allocator_route_tag);
+}
+
+TEST_SUITE(test_alloc)
+{
+	RUN_TEST_CASE(test_arena_save_restore);
+	RUN_TEST_CASE(test_arena_save_restore_across_blocks);
+	RUN_TEST_CASE(test_arena_scope);
+	RUN_TEST_CASE(test_virtual_arena);
+	RUN_TEST_CASE(test_memory_pool_threads);
+	RUN_TEST_CASE(test_memory_pool_grow);
+	RUN_TEST_CASE(test_memory_pool_trim);
+	RUN_TEST_CASE(test_allocator_override_tag);
+	RUN_TEST_CASE(test_memory_stats);
+	RUN_TEST_CASE(test_small_allocator_classes);
+	RUN_TEST_CASE(test_small_allocator_large);
+	RUN_TEST_CASE(test_small_allocator_cross_thread);
+	RUN_TEST_CASE(test_frame_alloc);
+	RUN_TEST_CASE(test_frame_reset);
+	RUN_TEST_CASE(test_frame_array);
+}
@@ -56,7 +56,84 @@ TEST_CASE(test_array_list_init)
 	return true;
 }
 
+/* InlineArray stays inline up to N elements, spills to the heap beyond, and copies/moves in either state. */
+TEST_CASE(test_inline_array)
+{
+	InlineArray<String, 2> a = { "a", "b" };
+	REQUIRE(a.is_inline());
+	REQUIRE(a.capacity() == 2);
+
+	a.add("c");
+	REQUIRE(!a.is_inline());
+	REQUIRE(a.count() == 3);
+	REQUIRE(!CF_STRCMP(a[0].c_str(), "a"));
+	REQUIRE(!CF_STRCMP(a.last().c_str(), "c"));
+
+	// Copy and move while spilled.
+	InlineArray<String, 2> b = a;
+	REQUIRE(b.count() == 3);
+	REQUIRE(!CF_STRCMP(b[2].c_str(), "c"));
+	InlineArray<String, 2> c = cf_move(a);
+	REQUIRE(a.count() == 0);
+	REQUIRE(a.is_inline());
+	REQUIRE(!CF_STRCMP(c[1].c_str(), "b"));
+
+	// Copy and move while inline.
+	InlineArray<String, 2> d = { "x" };
+	InlineArray<String, 2> e = cf_move(d);
+	REQUIRE(d.count() == 0);
+	REQUIRE(e.is_inline());
+	REQUIRE(!CF_STRCMP(e[0].c_str(), "x"));
+	c = e;
+	REQUIRE(c.count() == 1);
+	REQUIRE(!CF_STRCMP(c[0].c_str(), "x"));
+
+	REQUIRE(!CF_STRCMP(b.pop().c_str(), "c"));
+	b.unordered_remove(0);
+	REQUIRE(b.count() == 1);
+	REQUIRE(!CF_STRCMP(b[0].c_str(), "b"));
+
+	return true;
+}
+
+/* SoA keeps each column packed, and removes rows with swap-and-pop. */
+TEST_CASE(test_soa)
+{
+	SoA<v2, v2, String> bodies;
+	for (int i = 0; i < 100; ++i) {
+		REQUIRE(bodies.add(V2((float)i, 0), V2(1, 2), String(i)) == i);
+	}
+	REQUIRE(bodies.count() == 100);
+
+	Span<v2> p = bodies.column<0>();
+	Span<v2> v = bodies.column<1>();
+	REQUIRE(p.count() == 100);
+	for (int i = 0; i < p.count(); ++i) p[i] += v[i];
+	REQUIRE(bodies.get<0>(10).x == 11.0f);
+	REQUIRE(bodies.get<0>(10).y == 2.0f);
+
+	// The last row moves into the removed row's place.
+	bodies.remove(10);
+	REQUIRE(bodies.count() == 99);
+	REQUIRE(bodies.get<0>(10).x == 100.0f);
+	REQUIRE(!CF_STRCMP(bodies.get<2>(10).c_str(), "99"));
+
+	SoA<v2, v2, String> copy = bodies;
+	REQUIRE(copy.count() == 99);
+	REQUIRE(!CF_STRCMP(copy.get<2>(98).c_str(), "98"));
+	SoA<v2, v2, String> moved = cf_move(copy);
+	REQUIRE(copy.count() == 0);
+	REQUIRE(moved.get<0>(0).x == 1.0f);
+
+	bodies.clear();
+	REQUIRE(bodies.empty());
+
+	return true;
+}
+
 TEST_SUITE(test_array)
 {
 	RUN_TEST_CASE(test_array_list_init);
+	RUN_TEST_CASE(test_inline_array);
+	RUN_TEST_CASE(test_soa);
 }
\ No newline at end of file
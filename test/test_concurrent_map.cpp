@@ -0,0 +1,120 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include "test_harness.h"
+
+#include <cute.h>
+
+using namespace Cute;
+
+struct Entry
+{
+	uint64_t key;
+	int value;
+};
+
+/* Basic single-threaded set/add/get/remove. */
+TEST_CASE(test_concurrent_map_basic)
+{
+	ConcurrentMap<Entry> map(4);
+	for (uint64_t i = 0; i < 1000; ++i) {
+		map.set(i, { i, (int)i });
+	}
+	REQUIRE(map.count() == 1000);
+
+	Entry e;
+	REQUIRE(map.get(10, &e));
+	REQUIRE(e.key == 10 && e.value == 10);
+	REQUIRE(!map.get(5000, &e));
+
+	// Adding an existing key fails, and hands back the existing entry.
+	Entry other = { 7, -1 };
+	REQUIRE(!map.add(7, &other));
+	REQUIRE(other.value == 7);
+	other = { 5000, 5000 };
+	REQUIRE(map.add(5000, &other));
+	REQUIRE(map.has(5000));
+
+	REQUIRE(map.remove(5000));
+	REQUIRE(!map.remove(5000));
+	REQUIRE(!map.has(5000));
+	REQUIRE(map.count() == 1000);
+
+	map.clear();
+	REQUIRE(map.count() == 0);
+	REQUIRE(!map.has(10));
+
+	return true;
+}
+
+struct MapStress
+{
+	ConcurrentMap<Entry>* map;
+	int id;
+	bool ok;
+};
+
+static int s_map_stress(void* udata)
+{
+	MapStress* stress = (MapStress*)udata;
+	stress->ok = true;
+
+	// Every thread owns a range of keys it sets and removes, and reads from a shared range.
+	uint64_t base = (uint64_t)(stress->id + 1) << 32;
+	for (int i = 0; i < 512 * 40; ++i) {
+		uint64_t key = base + (uint64_t)(i % 512);
+		if ((i / 512) % 2 == 0) {
+			stress->map->set(key, { key, i });
+		} else {
+			Entry e;
+			if (!stress->map->get(key, &e) || e.key != key) stress->ok = false;
+			stress->map->remove(key);
+		}
+
+		Entry shared;
+		uint64_t shared_key = (uint64_t)(i % 100);
+		if (!stress->map->get(shared_key, &shared) || shared.key != shared_key) stress->ok = false;
+
+		// Threads race to add the same key, every one of them must agree on the winner.
+		Entry race = { 0x1000 + (uint64_t)(i % 64), stress->id };
+		stress->map->add(race.key, &race);
+		if (race.key != 0x1000 + (uint64_t)(i % 64)) stress->ok = false;
+	}
+	return 0;
+}
+
+/* Many threads setting, getting and removing at once. */
+TEST_CASE(test_concurrent_map_threads)
+{
+	int thread_counts[] = { 1, 4, 16 };
+	for (int t = 0; t < 3; ++t) {
+		ConcurrentMap<Entry> map;
+		for (uint64_t i = 0; i < 100; ++i) map.set(i, { i, 0 });
+
+		MapStress stress[16];
+		CF_Thread* threads[16];
+		for (int i = 0; i < thread_counts[t]; ++i) {
+			stress[i] = { &map, i, false };
+			threads[i] = cf_thread_create(s_map_stress, "map stress", stress + i);
+		}
+		for (int i = 0; i < thread_counts[t]; ++i) {
+			cf_thread_wait(threads[i]);
+			REQUIRE(stress[i].ok);
+		}
+
+		// Each thread ends having removed all of its own keys.
+		REQUIRE(map.count() == 100 + 64);
+	}
+
+	return true;
+}
+
+TEST_SUITE(test_concurrent_map)
+{
+	RUN_TEST_CASE(test_concurrent_map_basic);
+	RUN_TEST_CASE(test_concurrent_map_threads);
+}
@@ -115,10 +115,114 @@ TEST_CASE(test_handle_alloc_too_many)
 	return true;
 }
 
+/* Stale handles are rejected after their slot is recycled. */
+TEST_CASE(test_handle_generations)
+{
+	CF_HandleTable* table = cf_make_handle_allocator(1);
+	CHECK_POINTER(table);
+
+	REQUIRE(!cf_handle_allocator_is_handle_valid(table, CF_INVALID_HANDLE));
+	CF_Handle h0 = cf_handle_allocator_alloc(table, 3, 5);
+	REQUIRE(cf_handle_allocator_is_handle_valid(table, h0));
+	REQUIRE(cf_handle_allocator_get_type(table, h0) == 5);
+	cf_handle_allocator_free(table, h0);
+	REQUIRE(!cf_handle_allocator_is_handle_valid(table, h0));
+
+	// The only slot is recycled, with a new generation.
+	CF_Handle h1 = cf_handle_allocator_alloc(table, 4, 0);
+	REQUIRE(h1 != h0);
+	REQUIRE(!cf_handle_allocator_is_handle_valid(table, h0));
+	REQUIRE(cf_handle_allocator_is_handle_valid(table, h1));
+
+	cf_handle_allocator_clear(table);
+	REQUIRE(!cf_handle_allocator_is_handle_valid(table, h1));
+
+	cf_destroy_handle_allocator(table);
+
+	return true;
+}
+
+/* SlotMap keeps items packed densely while handles stay valid. */
+TEST_CASE(test_slot_map)
+{
+	SlotMap<int> map;
+	Handle handles[100];
+	for (int i = 0; i < 100; ++i) {
+		handles[i] = map.add(i);
+	}
+	REQUIRE(map.count() == 100);
+
+	// Remove every even item.
+	for (int i = 0; i < 100; i += 2) {
+		map.remove(handles[i]);
+	}
+	REQUIRE(map.count() == 50);
+
+	for (int i = 0; i < 100; ++i) {
+		if (i % 2) {
+			REQUIRE(map.has(handles[i]));
+			REQUIRE(*map.get(handles[i]) == i);
+		} else {
+			REQUIRE(!map.has(handles[i]));
+			REQUIRE(map.get(handles[i]) == NULL);
+		}
+	}
+
+	// Dense iteration only sees live items, and handles() lines up with items().
+	int sum = 0;
+	for (int item : map) sum += item;
+	REQUIRE(sum == 50 * 50);
+	for (int i = 0; i < map.count(); ++i) {
+		REQUIRE(*map.get(map.handles()[i]) == map[i]);
+	}
+
+	// Removing a stale handle does nothing.
+	map.remove(handles[0]);
+	REQUIRE(map.count() == 50);
+
+	map.clear();
+	REQUIRE(map.count() == 0);
+	REQUIRE(!map.has(handles[1]));
+
+	return true;
+}
+
+/* A moved-from SlotMap is empty, and can be used again. */
+TEST_CASE(test_slot_map_move)
+{
+	SlotMap<int> a;
+	Handle h = a.add(7);
+
+	SlotMap<int> b(cf_move(a));
+	REQUIRE(*b.get(h) == 7);
+	REQUIRE(a.count() == 0);
+	REQUIRE(!a.has(h));
+	REQUIRE(a.get(h) == NULL);
+	a.remove(h);
+	a.clear();
+
+	// Reusing the moved-from map.
+	Handle h2 = a.add(8);
+	REQUIRE(*a.get(h2) == 8);
+	REQUIRE(a.count() == 1);
+
+	SlotMap<int> c;
+	c = cf_move(b);
+	REQUIRE(*c.get(h) == 7);
+	REQUIRE(b.count() == 0);
+	REQUIRE(!b.has(h));
+	REQUIRE(b.get(h) == NULL);
+
+	return true;
+}
+
 TEST_SUITE(test_handle)
 {
 	RUN_TEST_CASE(test_handle_basic);
 	RUN_TEST_CASE(test_handle_large_loop);
 	RUN_TEST_CASE(test_handle_large_loop_and_free);
 	RUN_TEST_CASE(test_handle_alloc_too_many);
-}
\ No newline at end of file
+	RUN_TEST_CASE(test_handle_generations);
+	RUN_TEST_CASE(test_slot_map);
+	RUN_TEST_CASE(test_slot_map_move);
+}
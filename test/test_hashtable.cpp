@@ -205,7 +205,135 @@ TEST_CASE(test_hashtable_has)
     return true;
 }
 
+struct OddKey
+{
+	uint32_t a, b, c;
+};
+
+/* Lots of interleaved inserts and removes, checked against a plain array of expected values. */
+TEST_CASE(test_hashtable_churn)
+{
+	const int n = 4096;
+	int* expected = (int*)cf_alloc(sizeof(int) * n);
+	for (int i = 0; i < n; ++i) expected[i] = -1;
+
+	Map<uint64_t, int> m;
+	Map<OddKey, int> odd;
+	uint64_t rnd = 0x1234567;
+	for (int iter = 0; iter < 100000; ++iter) {
+		rnd = rnd * 6364136223846793005ULL + 1442695040888963407ULL;
+		int k = (int)((rnd >> 33) % n);
+		OddKey ok = { (uint32_t)k, (uint32_t)k * 7, 3 };
+		if (expected[k] < 0) {
+			m.insert((uint64_t)k * 0x10000, iter);
+			odd.insert(ok, iter);
+			expected[k] = iter;
+		} else if ((rnd >> 20) & 1) {
+			m.remove((uint64_t)k * 0x10000);
+			odd.remove(ok);
+			expected[k] = -1;
+		} else {
+			REQUIRE(m.get((uint64_t)k * 0x10000) == expected[k]);
+			REQUIRE(odd.get(ok) == expected[k]);
+		}
+	}
+
+	int count = 0;
+	for (int k = 0; k < n; ++k) {
+		OddKey ok = { (uint32_t)k, (uint32_t)k * 7, 3 };
+		if (expected[k] < 0) {
+			REQUIRE(!m.has((uint64_t)k * 0x10000));
+			REQUIRE(!odd.has(ok));
+		} else {
+			REQUIRE(*m.try_get((uint64_t)k * 0x10000) == expected[k]);
+			REQUIRE(*odd.try_get(ok) == expected[k]);
+			++count;
+		}
+	}
+	REQUIRE(m.count() == count);
+	REQUIRE(odd.count() == count);
+
+	m.clear();
+	REQUIRE(m.count() == 0);
+	REQUIRE(!m.has(0));
+	m.insert(5, 5);
+	REQUIRE(m.get(5) == 5);
+
+	cf_free(expected);
+
+	return true;
+}
+
+/* Batched lookups and inserts agree with their one-at-a-time counterparts. */
+TEST_CASE(test_hashtable_batch)
+{
+	const int n = 1000;
+	uint64_t* keys = (uint64_t*)cf_alloc(sizeof(uint64_t) * n * 2);
+	int* vals = (int*)cf_alloc(sizeof(int) * n * 2);
+	for (int i = 0; i < n * 2; ++i) {
+		keys[i] = (uint64_t)i * 0x9E3779B9ULL;
+		vals[i] = i + 1;
+	}
+
+	// Only the first half of the keys are inserted, the rest are misses.
+	htbl int* h = NULL;
+	hset_many(h, keys, vals, n);
+	REQUIRE(hcount(h) == n);
+	for (int i = 0; i < n; ++i) {
+		REQUIRE(hget(h, keys[i]) == i + 1);
+	}
+
+	int* out = (int*)cf_alloc(sizeof(int) * n * 2);
+	hget_many(h, keys, n * 2, out);
+	for (int i = 0; i < n * 2; ++i) {
+		REQUIRE(out[i] == (i < n ? i + 1 : 0));
+	}
+
+	// Updating existing keys through a batch keeps the count.
+	for (int i = 0; i < n; ++i) vals[i] = -vals[i];
+	hset_many(h, keys, vals, n);
+	REQUIRE(hcount(h) == n);
+	REQUIRE(hget(h, keys[17]) == -18);
+	hfree(h);
+
+	// A NULL table reads back all zeroes.
+	out[0] = 5;
+	hget_many(h, keys, 1, out);
+	REQUIRE(out[0] == 0);
+
+	// Growing a small table part way through a batch keeps every item.
+	hset(h, keys[0], 1);
+	hset_many(h, keys + 1, vals + 1, n - 1);
+	REQUIRE(hcount(h) == n);
+	for (int i = 1; i < n; ++i) {
+		REQUIRE(hget(h, keys[i]) == -(i + 1));
+	}
+	hfree(h);
+
+	Map<uint64_t, int> m;
+	for (int i = 0; i < n; ++i) m.insert(keys[i], i);
+	int** ptrs = (int**)cf_alloc(sizeof(int*) * n * 2);
+	m.find_batch(keys, n * 2, ptrs);
+	for (int i = 0; i < n * 2; ++i) {
+		if (i < n) {
+			REQUIRE(ptrs[i] && *ptrs[i] == i);
+		} else {
+			REQUIRE(!ptrs[i]);
+		}
+	}
+
+	cf_free(ptrs);
+	cf_free(out);
+	cf_free(vals);
+	cf_free(keys);
+
+	return true;
+}
+
 TEST_SUITE(test_hashtable)
 {
 	RUN_TEST_CASE(test_hashtable_macros);
+	RUN_TEST_CASE(test_hashtable_has);
+	RUN_TEST_CASE(test_hashtable_churn);
+	RUN_TEST_CASE(test_hashtable_batch);
 }
@@ -0,0 +1,365 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include "test_harness.h"
+
+#include <cute.h>
+
+#include <atomic>
+
+using namespace Cute;
+
+static void s_count_job(void* udata)
+{
+	((std::atomic<int>*)udata)->fetch_add(1);
+}
+
+/* Run a pile of independent jobs and wait on all of them. */
+TEST_CASE(test_job_system_basic)
+{
+	JobSystem* jobs = make_job_system(3);
+	REQUIRE(job_system_thread_count(jobs) == 3);
+
+	std::atomic<int> count(0);
+	Job handles[1000];
+	for (int i = 0; i < 1000; ++i) {
+		handles[i] = job_run(jobs, s_count_job, &count);
+	}
+	for (int i = 0; i < 1000; ++i) {
+		job_wait(jobs, handles[i]);
+		REQUIRE(job_is_done(jobs, handles[i]));
+	}
+	REQUIRE(count.load() == 1000);
+
+	Job none = { };
+	REQUIRE(job_is_done(jobs, none));
+	job_wait(jobs, none);
+
+	destroy_job_system(jobs);
+	return true;
+}
+
+struct Link
+{
+	std::atomic<int>* order;
+	int index;
+	int seen;
+};
+
+static void s_link_job(void* udata)
+{
+	Link* link = (Link*)udata;
+	link->seen = link->order->fetch_add(1);
+}
+
+/* Dependencies run strictly before the jobs waiting on them. */
+TEST_CASE(test_job_system_dependencies)
+{
+	JobSystem* jobs = make_job_system(3, 64);
+
+	// A long chain, each link depending on the one before.
+	std::atomic<int> order(0);
+	Link links[200];
+	Job previous = { };
+	for (int i = 0; i < 200; ++i) {
+		links[i] = { &order, i, -1 };
+		previous = job_run_after(jobs, s_link_job, links + i, &previous, 1);
+	}
+	job_wait(jobs, previous);
+	for (int i = 0; i < 200; ++i) {
+		REQUIRE(links[i].seen == i);
+	}
+
+	// A diamond, with a join job that has no function.
+	order = 0;
+	Link top = { &order, 0, -1 };
+	Link left = { &order, 1, -1 };
+	Link right = { &order, 2, -1 };
+	Link bottom = { &order, 3, -1 };
+	Job a = job_run(jobs, s_link_job, &top);
+	Job b = job_run_after(jobs, s_link_job, &left, &a, 1);
+	Job c = job_run_after(jobs, s_link_job, &right, &a, 1);
+	Job bc[2] = { b, c };
+	Job d = job_run_after(jobs, s_link_job, &bottom, bc, 2);
+	Job join = job_run_after(jobs, NULL, NULL, &d, 1);
+	job_wait(jobs, join);
+	REQUIRE(top.seen == 0);
+	REQUIRE(left.seen >= 1 && left.seen <= 2);
+	REQUIRE(right.seen >= 1 && right.seen <= 2);
+	REQUIRE(bottom.seen == 3);
+
+	// Depending on jobs that have long finished, or on empty handles, runs right away.
+	std::atomic<int> count(0);
+	Job done[3] = { a, d, { } };
+	job_wait(jobs, job_run_after(jobs, s_count_job, &count, done, 3));
+	REQUIRE(count.load() == 1);
+
+	destroy_job_system(jobs);
+	return true;
+}
+
+struct Fib
+{
+	JobSystem* jobs;
+	int n;
+	int result;
+};
+
+static void s_fib_job(void* udata)
+{
+	Fib* fib = (Fib*)udata;
+	if (fib->n < 2) {
+		fib->result = fib->n;
+		return;
+	}
+	Fib a = { fib->jobs, fib->n - 1, 0 };
+	Fib b = { fib->jobs, fib->n - 2, 0 };
+	Job job = job_run(fib->jobs, s_fib_job, &a);
+	s_fib_job(&b);
+	job_wait(fib->jobs, job);
+	fib->result = a.result + b.result;
+}
+
+/* Jobs starting and waiting on more jobs, recursively. */
+TEST_CASE(test_job_system_nested)
+{
+	JobSystem* jobs = make_job_system(3, 256);
+	Fib fib = { jobs, 20, 0 };
+	job_wait(jobs, job_run(jobs, s_fib_job, &fib));
+	REQUIRE(fib.result == 6765);
+	destroy_job_system(jobs);
+	return true;
+}
+
+struct Submitter
+{
+	JobSystem* jobs;
+	std::atomic<int>* count;
+};
+
+static int s_submit_thread(void* udata)
+{
+	Submitter* submitter = (Submitter*)udata;
+	Job previous = { };
+	for (int i = 0; i < 500; ++i) {
+		Job job = job_run(submitter->jobs, s_count_job, submitter->count);
+		Job both[2] = { previous, job };
+		previous = job_run_after(submitter->jobs, s_count_job, submitter->count, both, 2);
+	}
+	job_wait(submitter->jobs, previous);
+	return 0;
+}
+
+/* Threads outside the job system can start and wait on jobs too, even when there are far more jobs than slots. */
+TEST_CASE(test_job_system_external_threads)
+{
+	JobSystem* jobs = make_job_system(2, 16);
+	std::atomic<int> count(0);
+	Submitter submitter = { jobs, &count };
+	CF_Thread* threads[3];
+	for (int i = 0; i < 3; ++i) {
+		threads[i] = cf_thread_create(s_submit_thread, "Submitter", &submitter);
+	}
+	s_submit_thread(&submitter);
+	for (int i = 0; i < 3; ++i) {
+		cf_thread_wait(threads[i]);
+	}
+	REQUIRE(count.load() == 4 * 1000);
+	destroy_job_system(jobs);
+	return true;
+}
+
+struct Visits
+{
+	std::atomic<int>* counts;
+	std::atomic<int> chunks;
+	int min_batch;
+	bool ok;
+};
+
+static void s_visit(int begin, int end, void* udata)
+{
+	Visits* visits = (Visits*)udata;
+	if (end - begin < visits->min_batch) visits->ok = false;
+	visits->chunks.fetch_add(1);
+	for (int i = begin; i < end; ++i) {
+		visits->counts[i].fetch_add(1);
+	}
+}
+
+/* Every index is visited exactly once, and chunks are never smaller than the minimum batch. */
+TEST_CASE(test_parallel_for)
+{
+	JobSystem* jobs = make_job_system(3);
+	const int max_count = 100000;
+	std::atomic<int>* counts = (std::atomic<int>*)cf_alloc(sizeof(std::atomic<int>) * max_count);
+
+	int sizes[] = { 0, 1, 7, 64, 1000, 4099, max_count };
+	int batches[] = { 1, 16, 1000 };
+	for (int count : sizes) {
+		for (int min_batch : batches) {
+			for (JobSystem* system : { (JobSystem*)NULL, jobs }) {
+				for (int i = 0; i < count; ++i) CF_PLACEMENT_NEW(counts + i) std::atomic<int>(0);
+				Visits visits;
+				visits.counts = counts;
+				visits.chunks = 0;
+				visits.min_batch = cf_min(min_batch, count);
+				visits.ok = true;
+				parallel_for(system, count, min_batch, s_visit, &visits);
+				REQUIRE(visits.ok);
+				if (!system && count) REQUIRE(visits.chunks.load() == 1);
+				bool once = true;
+				for (int i = 0; i < count; ++i) once = once && counts[i].load() == 1;
+				REQUIRE(once);
+			}
+		}
+	}
+
+	// The lambda version, nested within itself.
+	std::atomic<int> total(0);
+	parallel_for(jobs, 100, 1, [&](int i) {
+		parallel_for(jobs, 1000, 10, [&](int j) {
+			total.fetch_add(1, std::memory_order_relaxed);
+		});
+	});
+	REQUIRE(total.load() == 100 * 1000);
+
+	cf_free(counts);
+	destroy_job_system(jobs);
+	return true;
+}
+
+struct Chain
+{
+	JobSystem* jobs;
+	int depth;
+	int* deepest;
+};
+
+static void s_chain_job(void* udata)
+{
+	Chain* chain = (Chain*)udata;
+	*chain->deepest = cf_max(*chain->deepest, chain->depth);
+	if (chain->depth == 200) return;
+	Chain next = { chain->jobs, chain->depth + 1, chain->deepest };
+	job_wait(chain->jobs, job_run(chain->jobs, s_chain_job, &next));
+}
+
+struct Loader
+{
+	JobSystem* jobs;
+	CF_AtomicInt* reads_left;
+	CF_AtomicInt* polls;
+	bool loaded;
+};
+
+static void s_loader_job(void* udata)
+{
+	Loader* loader = (Loader*)udata;
+	job_wait_counter(loader->jobs, loader->reads_left, 0);
+	loader->loaded = true;
+	cf_atomic_add(loader->polls, 1);
+}
+
+static int s_io_thread(void* udata)
+{
+	CF_AtomicInt* reads_left = (CF_AtomicInt*)udata;
+	while (cf_atomic_get(reads_left) > 0) {
+		cf_atomic_add(reads_left, -1);
+	}
+	return 0;
+}
+
+/* Jobs on fibers suspend while waiting, whether on other jobs or on counters, and fall back to plain waits when out of fibers. */
+TEST_CASE(test_job_system_fibers)
+{
+	for (int fiber_count : { 4, 0 }) {
+		JobSystem* jobs = make_fiber_job_system(3, 256, fiber_count, 32 * 1024);
+
+		Fib fib = { jobs, 18, 0 };
+		job_wait(jobs, job_run(jobs, s_fib_job, &fib));
+		REQUIRE(fib.result == 2584);
+
+		// Each job waits on the next, far deeper than there are fibers.
+		int deepest = 0;
+		Chain chain = { jobs, 0, &deepest };
+		job_wait(jobs, job_run(jobs, s_chain_job, &chain));
+		REQUIRE(deepest == 200);
+
+		// Jobs waiting on work finishing outside of the job system.
+		CF_AtomicInt reads_left = cf_atomic_zero();
+		CF_AtomicInt polls = cf_atomic_zero();
+		cf_atomic_set(&reads_left, 1000);
+		Loader loaders[8];
+		Job handles[8];
+		for (int i = 0; i < 8; ++i) {
+			loaders[i] = { jobs, &reads_left, &polls, false };
+			handles[i] = job_run(jobs, s_loader_job, loaders + i);
+		}
+		CF_Thread* io = cf_thread_create(s_io_thread, "IO", &reads_left);
+		for (int i = 0; i < 8; ++i) {
+			job_wait(jobs, handles[i]);
+			REQUIRE(loaders[i].loaded);
+		}
+		cf_thread_wait(io);
+		REQUIRE(cf_atomic_get(&polls) == 8);
+
+		std::atomic<int> total(0);
+		parallel_for(jobs, 50, 1, [&](int i) {
+			job_yield(jobs);
+			parallel_for(jobs, 100, 4, [&](int j) { total.fetch_add(1); });
+		});
+		REQUIRE(total.load() == 50 * 100);
+
+		destroy_job_system(jobs);
+	}
+	return true;
+}
+
+static int s_destroy_job_system_thread(void* udata)
+{
+	destroy_job_system((JobSystem*)udata);
+	return 0;
+}
+
+static bool s_run_count_jobs(JobSystem* jobs)
+{
+	std::atomic<int> count(0);
+	Job handles[100];
+	for (int i = 0; i < 100; ++i) handles[i] = job_run(jobs, s_count_job, &count);
+	for (int i = 0; i < 100; ++i) job_wait(jobs, handles[i]);
+	return count.load() == 100;
+}
+
+/* A system can be destroyed from a thread other than the one which made it, and that thread can keep making systems. */
+TEST_CASE(test_job_system_destroy_elsewhere)
+{
+	JobSystem* a = make_job_system(2);
+	JobSystem* b = make_job_system(2);
+	REQUIRE(s_run_count_jobs(a));
+	REQUIRE(s_run_count_jobs(b));
+
+	cf_thread_wait(cf_thread_create(s_destroy_job_system_thread, "destroy jobs", a));
+	REQUIRE(s_run_count_jobs(b));
+
+	JobSystem* c = make_job_system(2);
+	REQUIRE(s_run_count_jobs(c));
+	destroy_job_system(c);
+	destroy_job_system(b);
+	return true;
+}
+
+TEST_SUITE(test_job_system)
+{
+	RUN_TEST_CASE(test_job_system_basic);
+	RUN_TEST_CASE(test_job_system_dependencies);
+	RUN_TEST_CASE(test_job_system_nested);
+	RUN_TEST_CASE(test_job_system_external_threads);
+	RUN_TEST_CASE(test_parallel_for);
+	RUN_TEST_CASE(test_job_system_fibers);
+	RUN_TEST_CASE(test_job_system_destroy_elsewhere);
+}
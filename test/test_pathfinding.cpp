@@ -0,0 +1,374 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include "test_harness.h"
+
+#include <cute.h>
+#include <cute_pathfinding.h>
+
+using namespace Cute;
+
+// Walks the path cell by cell, making sure it only crosses open cells, never cuts corners, and has the reported length.
+static bool s_path_is_valid(const CF_PathGrid* grid, const CF_PathRequest& request)
+{
+	if (request.path[0].x != request.start.x || request.path[0].y != request.start.y) return false;
+	CF_PathPoint last = request.path[request.path_count - 1];
+	if (last.x != request.goal.x || last.y != request.goal.y) return false;
+	float length = 0;
+	for (int i = 0; i < request.path_count - 1; ++i) {
+		CF_PathPoint a = request.path[i];
+		CF_PathPoint b = request.path[i + 1];
+		int dx = b.x - a.x, dy = b.y - a.y;
+		int adx = dx < 0 ? -dx : dx, ady = dy < 0 ? -dy : dy;
+		if (adx && ady && adx != ady) return false;
+		int sx = (dx > 0) - (dx < 0), sy = (dy > 0) - (dy < 0);
+		int steps = adx > ady ? adx : ady;
+		for (int s = 0; s < steps; ++s) {
+			int x = a.x + sx * s, y = a.y + sy * s;
+			if (cf_path_grid_is_blocked(grid, x + sx, y + sy)) return false;
+			if (sx && sy && (cf_path_grid_is_blocked(grid, x + sx, y) || cf_path_grid_is_blocked(grid, x, y + sy))) return false;
+		}
+		length += (sx && sy) ? steps * 1.41421356f : (float)steps;
+	}
+	return CF_FABSF(length - request.cost) < 0.01f;
+}
+
+/* Find a path around a wall, and fail to find one through a closed wall. */
+TEST_CASE(test_path_find_basic)
+{
+	CF_PathGrid* grid = cf_make_path_grid(64, 64);
+	for (int y = 0; y < 60; ++y) cf_path_grid_set_blocked(grid, 32, y, true);
+	CF_PathContext* ctx = cf_make_path_context(grid);
+
+	CF_PathPoint points[64];
+	CF_PathRequest request = { };
+	request.start = { 2, 2 };
+	request.goal = { 60, 2 };
+	request.path = points;
+	request.path_capacity = 64;
+	REQUIRE(cf_path_find(ctx, &request));
+	REQUIRE(request.found);
+	REQUIRE(request.path_count >= 3);
+	REQUIRE(s_path_is_valid(grid, request));
+
+	// The same search again reuses the context.
+	float cost = request.cost;
+	REQUIRE(cf_path_find(ctx, &request));
+	REQUIRE(request.cost == cost);
+
+	// Straight line needs only the two end points.
+	request.goal = { 20, 20 };
+	REQUIRE(cf_path_find(ctx, &request));
+	REQUIRE(request.path_count == 2);
+
+	// Close the gap in the wall.
+	for (int y = 60; y < 64; ++y) cf_path_grid_set_blocked(grid, 32, y, true);
+	request.goal = { 60, 2 };
+	REQUIRE(!cf_path_find(ctx, &request));
+	REQUIRE(!request.found);
+
+	// Blocked or out of bounds end points.
+	request.goal = { 32, 5 };
+	REQUIRE(!cf_path_find(ctx, &request));
+	request.goal = { -1, 5 };
+	REQUIRE(!cf_path_find(ctx, &request));
+
+	cf_destroy_path_context(ctx);
+	cf_destroy_path_grid(grid);
+
+	return true;
+}
+
+/* Jump Point Search must find paths exactly as short as plain A* on random maps. */
+TEST_CASE(test_path_find_jps_matches_astar)
+{
+	CF_Rnd rnd = rnd_seed(42);
+	for (int map = 0; map < 8; ++map) {
+		int w = rnd_range(rnd, 8, 80), h = rnd_range(rnd, 8, 80);
+		CF_PathGrid* grid = cf_make_path_grid(w, h);
+		int density = rnd_range(rnd, 5, 35);
+		for (int y = 0; y < h; ++y) {
+			for (int x = 0; x < w; ++x) {
+				if (rnd_range(rnd, 0, 99) < density) cf_path_grid_set_blocked(grid, x, y, true);
+			}
+		}
+		CF_PathContext* ctx = cf_make_path_context(grid);
+		CF_PathPoint points[2][1024];
+		for (int i = 0; i < 100; ++i) {
+			CF_PathRequest a = { };
+			a.start = { rnd_range(rnd, 0, w - 1), rnd_range(rnd, 0, h - 1) };
+			a.goal = { rnd_range(rnd, 0, w - 1), rnd_range(rnd, 0, h - 1) };
+			a.path = points[0];
+			a.path_capacity = 1024;
+			CF_PathRequest b = a;
+			b.path = points[1];
+			b.astar_only = true;
+			cf_path_find(ctx, &a);
+			cf_path_find(ctx, &b);
+			REQUIRE(a.found == b.found);
+			if (a.found) {
+				REQUIRE(CF_FABSF(a.cost - b.cost) < 0.01f);
+				REQUIRE(s_path_is_valid(grid, a));
+				REQUIRE(s_path_is_valid(grid, b));
+			}
+		}
+		cf_destroy_path_context(ctx);
+		cf_destroy_path_grid(grid);
+	}
+
+	return true;
+}
+
+/* Solving a batch on a threadpool gives the same answers as one at a time. */
+TEST_CASE(test_path_find_batch)
+{
+	CF_Rnd rnd = rnd_seed(7);
+	int w = 128, h = 128;
+	CF_PathGrid* grid = cf_make_path_grid(w, h);
+	for (int y = 0; y < h; ++y) {
+		for (int x = 0; x < w; ++x) {
+			if (rnd_range(rnd, 0, 99) < 20) cf_path_grid_set_blocked(grid, x, y, true);
+		}
+	}
+
+	const int thread_count = 3;
+	CF_Threadpool* pool = cf_make_threadpool(thread_count);
+	CF_PathContext* contexts[thread_count + 1];
+	for (int i = 0; i < thread_count + 1; ++i) contexts[i] = cf_make_path_context(grid);
+
+	const int count = 200;
+	Array<CF_PathRequest> requests;
+	Array<CF_PathPoint> points;
+	points.ensure_count(count * 256);
+	for (int i = 0; i < count; ++i) {
+		CF_PathRequest r = { };
+		r.start = { rnd_range(rnd, 0, w - 1), rnd_range(rnd, 0, h - 1) };
+		r.goal = { rnd_range(rnd, 0, w - 1), rnd_range(rnd, 0, h - 1) };
+		r.path = points + i * 256;
+		r.path_capacity = 256;
+		requests.add(r);
+	}
+	cf_path_find_batch(contexts, thread_count + 1, pool, requests.data(), count);
+
+	for (int i = 0; i < count; ++i) {
+		CF_PathRequest r = requests[i];
+		CF_PathPoint path[256];
+		r.path = path;
+		cf_path_find(contexts[0], &r);
+		REQUIRE(r.found == requests[i].found);
+		REQUIRE(r.cost == requests[i].cost);
+		if (r.found) REQUIRE(s_path_is_valid(grid, requests[i]));
+	}
+
+	// Same again through a hierarchy.
+	CF_PathHierarchy* hierarchy = cf_make_path_hierarchy(grid, 16);
+	cf_path_find_hierarchical_batch(contexts, thread_count + 1, pool, hierarchy, requests.data(), count);
+	for (int i = 0; i < count; ++i) {
+		CF_PathRequest r = requests[i];
+		CF_PathPoint path[256];
+		r.path = path;
+		cf_path_find_hierarchical(contexts[0], hierarchy, &r);
+		REQUIRE(r.found == requests[i].found);
+		REQUIRE(r.cost == requests[i].cost);
+		if (r.found) REQUIRE(s_path_is_valid(grid, requests[i]));
+	}
+	cf_destroy_path_hierarchy(hierarchy);
+
+	for (int i = 0; i < thread_count + 1; ++i) cf_destroy_path_context(contexts[i]);
+	cf_destroy_threadpool(pool);
+	cf_destroy_path_grid(grid);
+
+	return true;
+}
+
+static void s_block_random(CF_Rnd* rnd, CF_PathGrid* grid, int density)
+{
+	int w = cf_path_grid_width(grid), h = cf_path_grid_height(grid);
+	for (int y = 0; y < h; ++y) {
+		for (int x = 0; x < w; ++x) {
+			if (rnd_range(*rnd, 0, 99) < density) cf_path_grid_set_blocked(grid, x, y, true);
+		}
+	}
+}
+
+/* Hierarchical searches find a path whenever one exists, and one nearly as short as the best. */
+TEST_CASE(test_path_find_hierarchical)
+{
+	CF_Rnd rnd = rnd_seed(11);
+	for (int map = 0; map < 8; ++map) {
+		int w = rnd_range(rnd, 8, 120), h = rnd_range(rnd, 8, 120);
+		CF_PathGrid* grid = cf_make_path_grid(w, h);
+		s_block_random(&rnd, grid, rnd_range(rnd, 5, 35));
+		CF_PathHierarchy* hierarchy = cf_make_path_hierarchy(grid, rnd_range(rnd, 4, 16));
+		CF_PathContext* ctx = cf_make_path_context(grid);
+		CF_PathPoint points[2][1024];
+		for (int i = 0; i < 100; ++i) {
+			CF_PathRequest a = { };
+			a.start = { rnd_range(rnd, 0, w - 1), rnd_range(rnd, 0, h - 1) };
+			a.goal = { rnd_range(rnd, 0, w - 1), rnd_range(rnd, 0, h - 1) };
+			a.path = points[0];
+			a.path_capacity = 1024;
+			CF_PathRequest b = a;
+			b.path = points[1];
+			cf_path_find(ctx, &a);
+			cf_path_find_hierarchical(ctx, hierarchy, &b);
+			REQUIRE(a.found == b.found);
+			if (b.found) {
+				REQUIRE(s_path_is_valid(grid, b));
+				REQUIRE(b.cost >= a.cost - 0.01f);
+				REQUIRE(b.cost <= a.cost * 1.5f + 4.0f);
+			}
+		}
+		cf_destroy_path_context(ctx);
+		cf_destroy_path_hierarchy(hierarchy);
+		cf_destroy_path_grid(grid);
+	}
+
+	return true;
+}
+
+/* Updating after edits only rebuilds the clusters touched, and gives the same answers as building from scratch. */
+TEST_CASE(test_path_hierarchy_update)
+{
+	CF_Rnd rnd = rnd_seed(3);
+	int w = 96, h = 80;
+	CF_PathGrid* grid = cf_make_path_grid(w, h);
+	s_block_random(&rnd, grid, 20);
+	CF_PathHierarchy* hierarchy = cf_make_path_hierarchy(grid, 16);
+	CF_PathContext* ctx = cf_make_path_context(grid);
+	REQUIRE(cf_path_hierarchy_update(hierarchy) == 0);
+
+	// Cells inside a cluster touch only that cluster, cells along an edge touch the neighbor too.
+	cf_path_grid_set_blocked(grid, 20, 20, !cf_path_grid_is_blocked(grid, 20, 20));
+	REQUIRE(cf_path_hierarchy_update(hierarchy) == 1);
+	cf_path_grid_set_blocked(grid, 31, 20, !cf_path_grid_is_blocked(grid, 31, 20));
+	REQUIRE(cf_path_hierarchy_update(hierarchy) == 2);
+	cf_path_grid_set_blocked(grid, 32, 47, !cf_path_grid_is_blocked(grid, 32, 47));
+	REQUIRE(cf_path_hierarchy_update(hierarchy) == 3);
+	// Setting a cell to what it already is changes nothing.
+	cf_path_grid_set_blocked(grid, 32, 47, cf_path_grid_is_blocked(grid, 32, 47));
+	REQUIRE(cf_path_hierarchy_update(hierarchy) == 0);
+
+	for (int round = 0; round < 10; ++round) {
+		// Scribble a few walls and holes about.
+		for (int i = 0; i < 30; ++i) {
+			int x = rnd_range(rnd, 0, w - 1), y = rnd_range(rnd, 0, h - 1);
+			cf_path_grid_set_blocked(grid, x, y, rnd_range(rnd, 0, 1) == 0);
+		}
+		cf_path_hierarchy_update(hierarchy);
+
+		CF_PathGrid* fresh_grid = cf_make_path_grid(w, h);
+		for (int y = 0; y < h; ++y) {
+			for (int x = 0; x < w; ++x) {
+				cf_path_grid_set_blocked(fresh_grid, x, y, cf_path_grid_is_blocked(grid, x, y));
+			}
+		}
+		CF_PathHierarchy* fresh = cf_make_path_hierarchy(fresh_grid, 16);
+		CF_PathContext* fresh_ctx = cf_make_path_context(fresh_grid);
+		for (int i = 0; i < 50; ++i) {
+			CF_PathPoint points[2][1024];
+			CF_PathRequest a = { };
+			a.start = { rnd_range(rnd, 0, w - 1), rnd_range(rnd, 0, h - 1) };
+			a.goal = { rnd_range(rnd, 0, w - 1), rnd_range(rnd, 0, h - 1) };
+			a.path = points[0];
+			a.path_capacity = 1024;
+			CF_PathRequest b = a;
+			b.path = points[1];
+			cf_path_find_hierarchical(ctx, hierarchy, &a);
+			cf_path_find_hierarchical(fresh_ctx, fresh, &b);
+			REQUIRE(a.found == b.found);
+			if (a.found) {
+				REQUIRE(CF_FABSF(a.cost - b.cost) < 0.01f);
+				REQUIRE(s_path_is_valid(grid, a));
+			}
+		}
+		cf_destroy_path_context(fresh_ctx);
+		cf_destroy_path_hierarchy(fresh);
+		cf_destroy_path_grid(fresh_grid);
+	}
+
+	cf_destroy_path_context(ctx);
+	cf_destroy_path_hierarchy(hierarchy);
+	cf_destroy_path_grid(grid);
+
+	return true;
+}
+
+/* Searches stop as soon as everything they're looking for is reached, instead of flooding the whole cluster. */
+TEST_CASE(test_path_find_early_exit)
+{
+	// Two 64x64 clusters joined by a single three cell gap, so the left cluster has one entrance at (63, 31).
+	CF_PathGrid* grid = cf_make_path_grid(128, 64);
+	for (int y = 0; y < 64; ++y) {
+		if (y < 30 || y > 32) cf_path_grid_set_blocked(grid, 64, y, true);
+	}
+	CF_PathHierarchy* hierarchy = cf_make_path_hierarchy(grid, 64);
+	CF_PathContext* ctx = cf_make_path_context(grid);
+
+	// The start's flood has to reach both the entrance right next to it and the goal a few cells away. Both are found
+	// within a few cells, far fewer than the 4096 in the cluster.
+	CF_PathRequest request = { };
+	request.start = { 62, 31 };
+	request.goal = { 59, 31 };
+	REQUIRE(cf_path_find_hierarchical(ctx, hierarchy, &request));
+	REQUIRE(CF_FABSF(request.cost - 3.0f) < 0.01f);
+	REQUIRE(request.expanded_count > 0);
+	REQUIRE(request.expanded_count < 400);
+
+	// Plain searches count their work too.
+	CF_PathRequest flat = request;
+	flat.astar_only = true;
+	REQUIRE(cf_path_find(ctx, &flat));
+	REQUIRE(flat.expanded_count > 0);
+	REQUIRE(flat.expanded_count < 100);
+
+	cf_destroy_path_context(ctx);
+	cf_destroy_path_hierarchy(hierarchy);
+	cf_destroy_path_grid(grid);
+
+	return true;
+}
+
+/* Hierarchies and hierarchical searches only hold memory for one cluster, not one node per cell of the whole grid. */
+TEST_CASE(test_path_context_memory)
+{
+	// One node per cell of this grid would take 16mb.
+	CF_PathGrid* grid = cf_make_path_grid(1024, 1024);
+	CF_MemoryStats before = cf_memory_stats(CF_MEMORY_TAG_GENERAL);
+	CF_PathHierarchy* hierarchy = cf_make_path_hierarchy(grid, 32);
+	CF_PathContext* ctx = cf_make_path_context(grid);
+	CF_PathRequest request = { };
+	request.start = { 3, 5 };
+	request.goal = { 1000, 1020 };
+	REQUIRE(cf_path_find_hierarchical(ctx, hierarchy, &request));
+	CF_MemoryStats after = cf_memory_stats(CF_MEMORY_TAG_GENERAL);
+	if (cf_memory_tracking_enabled()) {
+		REQUIRE(after.live_bytes - before.live_bytes < 8 * 1024 * 1024);
+	}
+
+	// A flat search still works with the same context, allocating its nodes on first use.
+	CF_PathRequest flat = request;
+	REQUIRE(cf_path_find(ctx, &flat));
+	REQUIRE(flat.cost <= request.cost + 0.01f);
+
+	cf_destroy_path_context(ctx);
+	cf_destroy_path_hierarchy(hierarchy);
+	cf_destroy_path_grid(grid);
+
+	return true;
+}
+
+TEST_SUITE(test_pathfinding)
+{
+	RUN_TEST_CASE(test_path_find_basic);
+	RUN_TEST_CASE(test_path_find_jps_matches_astar);
+	RUN_TEST_CASE(test_path_find_batch);
+	RUN_TEST_CASE(test_path_find_hierarchical);
+	RUN_TEST_CASE(test_path_hierarchy_update);
+	RUN_TEST_CASE(test_path_find_early_exit);
+	RUN_TEST_CASE(test_path_context_memory);
+}
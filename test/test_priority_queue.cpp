@@ -0,0 +1,194 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include "test_harness.h"
+
+#include <cute.h>
+#include <cute_priority_queue.h>
+
+using namespace Cute;
+
+/* Push, decrease, update and remove a handful of items by hand. */
+TEST_CASE(test_indexed_priority_queue_basic)
+{
+	IndexedPriorityQueue<int> q;
+	q.reserve(16);
+	REQUIRE(q.empty());
+	REQUIRE(!q.pop());
+
+	int a = q.push(100, 10.0f);
+	int b = q.push(200, 5.0f);
+	int c = q.push(300, 7.0f);
+	REQUIRE(q.count() == 3);
+	REQUIRE(q.contains(a) && q.contains(b) && q.contains(c));
+
+	int value;
+	float cost;
+	int handle;
+	REQUIRE(q.peek(&value, &cost, &handle));
+	REQUIRE(value == 200 && cost == 5.0f && handle == b);
+
+	q.decrease_key(a, 1.0f);
+	REQUIRE(q.peek(&value));
+	REQUIRE(value == 100);
+	REQUIRE(q.cost(a) == 1.0f);
+
+	q.update(a, 20.0f);
+	REQUIRE(q.peek(&value));
+	REQUIRE(value == 200);
+
+	REQUIRE(q.remove(b, &value));
+	REQUIRE(value == 200);
+	REQUIRE(!q.contains(b));
+	REQUIRE(!q.remove(b));
+
+	REQUIRE(q.pop(&value, &cost));
+	REQUIRE(value == 300 && cost == 7.0f);
+	REQUIRE(q.pop(&value, &cost, &handle));
+	REQUIRE(value == 100 && cost == 20.0f && handle == a);
+	REQUIRE(q.empty());
+
+	// Handles are recycled.
+	int d = q.push(400, 0);
+	REQUIRE(d == a || d == b || d == c);
+	REQUIRE(q.value(d) == 400);
+
+	return true;
+}
+
+struct PQReference
+{
+	float cost;
+	int value;
+	bool alive;
+};
+
+/* Random operations checked against a brute force reference. */
+TEST_CASE(test_indexed_priority_queue_fuzz)
+{
+	CF_Rnd rnd = rnd_seed(1234);
+	IndexedPriorityQueue<int> q;
+	Array<PQReference> ref;
+	Array<int> live;
+	for (int iter = 0; iter < 20000; ++iter) {
+		int op = rnd_range(rnd, 0, 9);
+		if (op <= 3 || live.count() == 0) {
+			// Few distinct costs, so plenty of ties.
+			float cost = (float)rnd_range(rnd, 0, 50);
+			int handle = q.push(iter, cost);
+			while (ref.count() <= handle) ref.add({ 0, 0, false });
+			REQUIRE(!ref[handle].alive);
+			ref[handle] = { cost, iter, true };
+			live.add(handle);
+		} else if (op <= 5) {
+			int value, handle;
+			float cost;
+			REQUIRE(q.pop(&value, &cost, &handle));
+			REQUIRE(ref[handle].alive && ref[handle].value == value && ref[handle].cost == cost);
+			for (int i = 0; i < live.count(); ++i) {
+				REQUIRE(ref[live[i]].cost >= cost);
+			}
+			ref[handle].alive = false;
+			for (int i = 0; i < live.count(); ++i) if (live[i] == handle) { live.unordered_remove(i); break; }
+		} else if (op == 6) {
+			int i = rnd_range(rnd, 0, live.count() - 1);
+			int handle = live[i];
+			float cost = ref[handle].cost - (float)rnd_range(rnd, 0, 20);
+			q.decrease_key(handle, cost);
+			ref[handle].cost = cost;
+		} else if (op == 7) {
+			int i = rnd_range(rnd, 0, live.count() - 1);
+			int handle = live[i];
+			float cost = (float)rnd_range(rnd, -20, 70);
+			q.update(handle, cost);
+			ref[handle].cost = cost;
+		} else {
+			int i = rnd_range(rnd, 0, live.count() - 1);
+			int handle = live[i];
+			int value;
+			REQUIRE(q.remove(handle, &value));
+			REQUIRE(value == ref[handle].value);
+			ref[handle].alive = false;
+			live.unordered_remove(i);
+		}
+		REQUIRE(q.count() == live.count());
+	}
+
+	// Drain everything, costs must come out in order.
+	float prev, cost;
+	if (q.pop(NULL, &prev)) {
+		while (q.pop(NULL, &cost)) {
+			REQUIRE(cost >= prev);
+			prev = cost;
+		}
+	}
+
+	return true;
+}
+
+/* PriorityQueue pops come out in cost order for both the min and max variants, with pushes mixed in between. */
+TEST_CASE(test_priority_queue_order)
+{
+	CF_Rnd rnd = rnd_seed(4321);
+	PriorityQueue<int> lo, hi;
+	for (int round = 0; round < 50; ++round) {
+		// Few distinct costs, so plenty of ties. Values are the costs, to check they travel together.
+		int push_count = rnd_range(rnd, 1, 100);
+		for (int i = 0; i < push_count; ++i) {
+			int cost = rnd_range(rnd, 0, 50);
+			lo.push_min(cost, (float)cost);
+			hi.push_max(cost, (float)cost);
+		}
+		int pop_count = rnd_range(rnd, 0, lo.count());
+		int value;
+		float prev, cost;
+		if (pop_count && lo.pop_min(&value, &prev)) {
+			REQUIRE(value == (int)prev);
+			for (int i = 1; i < pop_count; ++i) {
+				REQUIRE(lo.pop_min(&value, &cost));
+				REQUIRE(value == (int)cost);
+				REQUIRE(cost >= prev);
+				prev = cost;
+			}
+		}
+		if (pop_count && hi.pop_max(&value, &prev)) {
+			REQUIRE(value == (int)prev);
+			for (int i = 1; i < pop_count; ++i) {
+				REQUIRE(hi.pop_max(&value, &cost));
+				REQUIRE(value == (int)cost);
+				REQUIRE(cost <= prev);
+				prev = cost;
+			}
+		}
+		REQUIRE(lo.count() == hi.count());
+	}
+
+	// Drain everything.
+	float prev, cost;
+	if (lo.pop_min(NULL, &prev)) {
+		while (lo.pop_min(NULL, &cost)) {
+			REQUIRE(cost >= prev);
+			prev = cost;
+		}
+	}
+	if (hi.pop_max(NULL, &prev)) {
+		while (hi.pop_max(NULL, &cost)) {
+			REQUIRE(cost <= prev);
+			prev = cost;
+		}
+	}
+	REQUIRE(lo.count() == 0 && hi.count() == 0);
+
+	return true;
+}
+
+TEST_SUITE(test_priority_queue)
+{
+	RUN_TEST_CASE(test_indexed_priority_queue_basic);
+	RUN_TEST_CASE(test_indexed_priority_queue_fuzz);
+	RUN_TEST_CASE(test_priority_queue_order);
+}
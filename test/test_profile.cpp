@@ -0,0 +1,111 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include "test_harness.h"
+
+#include <cute.h>
+
+using namespace Cute;
+
+static int s_occurrences(const char* s, const char* pattern)
+{
+	int count = 0;
+	size_t len = CF_STRLEN(pattern);
+	while ((s = CF_STRSTR(s, pattern))) {
+		++count;
+		s += len;
+	}
+	return count;
+}
+
+static void s_nested()
+{
+	ProfileScope outer("outer");
+	for (int i = 0; i < 3; ++i) {
+		ProfileScope inner("inner");
+	}
+}
+
+static int s_profile_thread(void* udata)
+{
+	profile_begin("thread \"quoted\"");
+	s_nested();
+	profile_end();
+	return 0;
+}
+
+/* Nested regions on several threads come out as matching begin and end events. */
+TEST_CASE(test_profile_trace)
+{
+	profile_clear();
+
+	// An end without a begin, the region started before the clear.
+	profile_end();
+	s_nested();
+	CF_Thread* thread = cf_thread_create(s_profile_thread, "Profiled", NULL);
+	cf_thread_wait(thread);
+
+	char* trace = profile_trace();
+	REQUIRE(CF_STRSTR(trace, "{\"traceEvents\":[") == trace);
+	REQUIRE(s_occurrences(trace, "\"name\":\"outer\",\"ph\":\"B\"") == 2);
+	REQUIRE(s_occurrences(trace, "\"name\":\"outer\",\"ph\":\"E\"") == 2);
+	REQUIRE(s_occurrences(trace, "\"name\":\"inner\",\"ph\":\"B\"") == 6);
+	REQUIRE(s_occurrences(trace, "\"name\":\"inner\",\"ph\":\"E\"") == 6);
+	REQUIRE(s_occurrences(trace, "\"name\":\"thread \\\"quoted\\\"\",\"ph\":\"B\"") == 1);
+	REQUIRE(s_occurrences(trace, "\"name\":\"thread \\\"quoted\\\"\",\"ph\":\"E\"") == 1);
+	REQUIRE(s_occurrences(trace, "\"ph\":\"E\"") == s_occurrences(trace, "\"ph\":\"B\""));
+	sfree(trace);
+
+	// Clearing drops everything recorded so far.
+	cf_sleep(1);
+	profile_clear();
+	trace = profile_trace();
+	REQUIRE(s_occurrences(trace, "\"ph\":") == 0);
+	sfree(trace);
+	return true;
+}
+
+static int s_overflow_thread(void* udata)
+{
+	for (int i = 0; i < 100000; ++i) {
+		profile_begin("a");
+		profile_begin("b");
+		profile_end();
+		profile_end();
+	}
+	return 0;
+}
+
+/* Rings overwrite their oldest events once full, and the trace never ends regions that no longer have a beginning. */
+TEST_CASE(test_profile_overflow)
+{
+	profile_clear();
+	CF_Thread* thread = cf_thread_create(s_overflow_thread, "Overflow", NULL);
+
+	// Reading traces while the thread is still writing.
+	for (int i = 0; i < 4; ++i) {
+		char* trace = profile_trace();
+		REQUIRE(s_occurrences(trace, "\"ph\":\"E\"") <= s_occurrences(trace, "\"ph\":\"B\""));
+		sfree(trace);
+	}
+	cf_thread_wait(thread);
+
+	char* trace = profile_trace();
+	int begins = s_occurrences(trace, "\"ph\":\"B\"");
+	int ends = s_occurrences(trace, "\"ph\":\"E\"");
+	REQUIRE(begins > 0 && begins <= 1 << 15);
+	REQUIRE(ends <= begins && ends >= begins - 1);
+	sfree(trace);
+	profile_clear();
+	return true;
+}
+
+TEST_SUITE(test_profile)
+{
+	RUN_TEST_CASE(test_profile_trace);
+	RUN_TEST_CASE(test_profile_overflow);
+}
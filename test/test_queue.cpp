@@ -0,0 +1,181 @@
+/*
+	Cute Framework
+	Copyright (C) 2024 Randy Gaul https://randygaul.github.io/
+
+	This software is dual-licensed with zlib or Unlicense, check LICENSE.txt for more info
+*/
+
+#include "test_harness.h"
+
+#include <cute.h>
+
+#include <thread>
+
+using namespace Cute;
+
+struct Message
+{
+	int producer;
+	int sequence;
+	uint64_t payload;
+};
+
+/* Pushing until full and popping until empty, on a single thread. */
+TEST_CASE(test_queue_basic)
+{
+	SPSCQueue<Message> spsc(5);
+	MPMCQueue<Message> mpmc(5);
+	Message m;
+	REQUIRE(!spsc.pop(&m));
+	REQUIRE(!mpmc.pop(&m));
+
+	// Capacity rounds up to 8. Go around the ring a few times to cover wrapping.
+	for (int lap = 0; lap < 3; ++lap) {
+		for (int i = 0; i < 8; ++i) {
+			REQUIRE(spsc.push({ 0, i, (uint64_t)i * 3 }));
+			REQUIRE(mpmc.push({ 0, i, (uint64_t)i * 3 }));
+		}
+		REQUIRE(!spsc.push({ 0, 8, 0 }));
+		REQUIRE(!mpmc.push({ 0, 8, 0 }));
+		REQUIRE(spsc.count() == 8);
+		REQUIRE(mpmc.count() == 8);
+		for (int i = 0; i < 8; ++i) {
+			REQUIRE(spsc.pop(&m) && m.sequence == i && m.payload == (uint64_t)i * 3);
+			REQUIRE(mpmc.pop(&m) && m.sequence == i && m.payload == (uint64_t)i * 3);
+		}
+		REQUIRE(!spsc.pop(&m));
+		REQUIRE(!mpmc.pop(&m));
+		REQUIRE(spsc.count() == 0);
+		REQUIRE(mpmc.count() == 0);
+	}
+
+	// Destroying NULL is a no-op.
+	cf_destroy_spsc_queue(NULL);
+	cf_destroy_mpmc_queue(NULL);
+	return true;
+}
+
+#define QUEUE_STRESS_COUNT 100000
+
+struct SPSCStress
+{
+	SPSCQueue<Message>* queue;
+	bool ok;
+};
+
+static int s_spsc_consumer(void* udata)
+{
+	SPSCStress* stress = (SPSCStress*)udata;
+	Message m;
+	for (int i = 0; i < QUEUE_STRESS_COUNT; ++i) {
+		while (!stress->queue->pop(&m)) std::this_thread::yield();
+		if (m.sequence != i || m.payload != (uint64_t)i * 7) stress->ok = false;
+	}
+	return 0;
+}
+
+/* Everything pushed by the producer arrives at the consumer intact and in order, through a queue far smaller than the stream. */
+TEST_CASE(test_spsc_queue_stress)
+{
+	SPSCQueue<Message> queue(64);
+	SPSCStress stress = { &queue, true };
+	CF_Thread* consumer = cf_thread_create(s_spsc_consumer, "Consumer", &stress);
+	for (int i = 0; i < QUEUE_STRESS_COUNT; ++i) {
+		while (!queue.push({ 0, i, (uint64_t)i * 7 })) std::this_thread::yield();
+	}
+	cf_thread_wait(consumer);
+	REQUIRE(stress.ok);
+	REQUIRE(queue.count() == 0);
+	return true;
+}
+
+#define MPMC_PRODUCERS 4
+#define MPMC_CONSUMERS 4
+
+struct MPMCStress
+{
+	MPMCQueue<Message>* queue;
+	CF_AtomicInt popped;
+	CF_AtomicInt sum;
+	bool ok[MPMC_CONSUMERS];
+};
+
+struct MPMCThread
+{
+	MPMCStress* stress;
+	int id;
+};
+
+static int s_mpmc_producer(void* udata)
+{
+	MPMCThread* thread = (MPMCThread*)udata;
+	for (int i = 0; i < QUEUE_STRESS_COUNT; ++i) {
+		while (!thread->stress->queue->push({ thread->id, i, (uint64_t)i })) std::this_thread::yield();
+	}
+	return 0;
+}
+
+static int s_mpmc_consumer(void* udata)
+{
+	MPMCThread* thread = (MPMCThread*)udata;
+	MPMCStress* stress = thread->stress;
+	// Items from any single producer must come out in the order they went in.
+	int last[MPMC_PRODUCERS];
+	for (int i = 0; i < MPMC_PRODUCERS; ++i) last[i] = -1;
+	int sum = 0;
+	Message m;
+	while (cf_atomic_get(&stress->popped) < MPMC_PRODUCERS * QUEUE_STRESS_COUNT) {
+		if (!stress->queue->pop(&m)) {
+			std::this_thread::yield();
+			continue;
+		}
+		if (m.sequence <= last[m.producer] || m.payload != (uint64_t)m.sequence) stress->ok[thread->id] = false;
+		last[m.producer] = m.sequence;
+		sum += m.sequence & 0xFF;
+		cf_atomic_add(&stress->popped, 1);
+	}
+	cf_atomic_add(&stress->sum, sum);
+	return 0;
+}
+
+/* Many producers and consumers at once, every item is popped exactly once. */
+TEST_CASE(test_mpmc_queue_stress)
+{
+	MPMCQueue<Message> queue(128);
+	MPMCStress stress;
+	stress.queue = &queue;
+	stress.popped = cf_atomic_zero();
+	stress.sum = cf_atomic_zero();
+	MPMCThread producers[MPMC_PRODUCERS];
+	MPMCThread consumers[MPMC_CONSUMERS];
+	CF_Thread* threads[MPMC_PRODUCERS + MPMC_CONSUMERS];
+	for (int i = 0; i < MPMC_CONSUMERS; ++i) {
+		stress.ok[i] = true;
+		consumers[i] = { &stress, i };
+		threads[i] = cf_thread_create(s_mpmc_consumer, "Consumer", consumers + i);
+	}
+	for (int i = 0; i < MPMC_PRODUCERS; ++i) {
+		producers[i] = { &stress, i };
+		threads[MPMC_CONSUMERS + i] = cf_thread_create(s_mpmc_producer, "Producer", producers + i);
+	}
+	for (int i = 0; i < MPMC_PRODUCERS + MPMC_CONSUMERS; ++i) {
+		cf_thread_wait(threads[i]);
+	}
+
+	int expected = 0;
+	for (int i = 0; i < QUEUE_STRESS_COUNT; ++i) expected += i & 0xFF;
+	REQUIRE(cf_atomic_get(&stress.popped) == MPMC_PRODUCERS * QUEUE_STRESS_COUNT);
+	REQUIRE(cf_atomic_get(&stress.sum) == expected * MPMC_PRODUCERS);
+	for (int i = 0; i < MPMC_CONSUMERS; ++i) {
+		REQUIRE(stress.ok[i]);
+	}
+	REQUIRE(queue.count() == 0);
+	return true;
+}
+
+TEST_SUITE(test_queue)
+{
+	RUN_TEST_CASE(test_queue_basic);
+	RUN_TEST_CASE(test_spsc_queue_stress);
+	RUN_TEST_CASE(test_mpmc_queue_stress);
+}
@@ -273,6 +273,231 @@ TEST_CASE(test_dictionary_and_interning)
 	return true;
 }
 
+struct InternStress
+{
+	const char** results;
+	int id;
+};
+
+static int s_intern_stress(void* udata)
+{
+	InternStress* stress = (InternStress*)udata;
+	char buf[32];
+	for (int i = 0; i < 4000; ++i) {
+		// Walk the keys in a different order per thread, so threads race to intern the same strings.
+		int key = (i * 7 + stress->id * 1013) % 4000;
+		snprintf(buf, sizeof(buf), "key_%d", key);
+		stress->results[key] = sintern(buf);
+	}
+	return 0;
+}
+
+/* Many threads interning the same strings always get back the same pointers. */
+TEST_CASE(test_string_interning_threads)
+{
+	const int thread_count = 8;
+	InternStress stress[thread_count];
+	CF_Thread* threads[thread_count];
+	for (int i = 0; i < thread_count; ++i) {
+		stress[i].results = (const char**)cf_calloc(sizeof(const char*), 4000);
+		stress[i].id = i;
+		threads[i] = cf_thread_create(s_intern_stress, "intern stress", stress + i);
+	}
+	for (int i = 0; i < thread_count; ++i) {
+		cf_thread_wait(threads[i]);
+	}
+
+	char buf[32];
+	for (int key = 0; key < 4000; ++key) {
+		snprintf(buf, sizeof(buf), "key_%d", key);
+		const char* s = sintern(buf);
+		REQUIRE(!CF_STRCMP(s, buf));
+		for (int i = 0; i < thread_count; ++i) {
+			REQUIRE(stress[i].results[key] == s);
+		}
+	}
+	for (int i = 0; i < thread_count; ++i) {
+		cf_free(stress[i].results);
+	}
+
+	// Very long strings are supported too.
+	char* big = NULL;
+	for (int i = 0; i < 200000; ++i) spush(big, 'a' + i % 26);
+	const char* ibig = sintern(big);
+	REQUIRE(silen(ibig) == 200000);
+	REQUIRE(sintern(big) == ibig);
+	sfree(big);
+
+	// Nuking the table invalidates all previous strings, interning starts fresh afterwards.
+	sinuke();
+	const char* s = sintern("key_17");
+	REQUIRE(!CF_STRCMP(s, "key_17"));
+	REQUIRE(sintern("key_17") == s);
+
+	return true;
+}
+
+/* String builder appends across chunks, formats, joins and flattens. */
+TEST_CASE(test_string_builder)
+{
+	StringBuilder sb(16);
+	REQUIRE(sb.empty());
+	REQUIRE(!CF_STRCMP(sb.c_str(), ""));
+
+	// Small enough to stay in one chunk, which is returned in-place.
+	sb.append("hello").add(' ').fmt("%d", 42);
+	REQUIRE(sb.len() == 8);
+	REQUIRE(!CF_STRCMP(sb.c_str(), "hello 42"));
+
+	// Spill over many chunks, including a formatted string larger than a chunk.
+	sb.append(", and a much longer string");
+	sb.fmt(" %s %d", "with formatting that needs its own chunk", 7);
+	const char* expected = "hello 42, and a much longer string with formatting that needs its own chunk 7";
+	REQUIRE(sb.len() == (int)CF_STRLEN(expected));
+	String copy = sb.to_string();
+	REQUIRE(copy == expected);
+	REQUIRE(!CF_STRCMP(sb.c_str(), expected));
+
+	// Appending after flattening keeps going.
+	sb += "!";
+	REQUIRE(sb.len() == (int)CF_STRLEN(expected) + 1);
+	REQUIRE(sb.c_str()[sb.len() - 1] == '!');
+
+	// Joining moves all text from one builder onto another.
+	StringBuilder other(16);
+	for (int i = 0; i < 100; ++i) other.fmt("%d,", i);
+	int other_len = other.len();
+	sb.clear();
+	sb.append("numbers: ");
+	sb.join(other);
+	REQUIRE(other.empty());
+	REQUIRE(sb.len() == 9 + other_len);
+	String numbers = "numbers: ";
+	for (int i = 0; i < 100; ++i) numbers.fmt_append("%d,", i);
+	REQUIRE(numbers == sb.c_str());
+
+	// Cleared chunks are reused.
+	sb.clear();
+	REQUIRE(sb.empty());
+	sb.append("reuse");
+	REQUIRE(!CF_STRCMP(sb.c_str(), "reuse"));
+
+	return true;
+}
+
+/* Short strings live inline within the String itself, and spill onto the heap once they grow. */
+TEST_CASE(test_string_small_buffer)
+{
+	String empty;
+	REQUIRE(empty.c_str() == NULL);
+	REQUIRE(!empty.is_inline());
+	empty.add('x');
+	REQUIRE(empty.is_inline());
+	REQUIRE(empty == "x");
+
+	String s = "hello";
+	REQUIRE(s.is_inline());
+	REQUIRE(s == "hello");
+	REQUIRE(s.len() == 5);
+	REQUIRE(slen(s.c_str()) == 5);
+
+	s.append(" world");
+	REQUIRE(s.is_inline());
+	s.append(", this is a longer string");
+	REQUIRE(!s.is_inline());
+	REQUIRE(s == "hello world, this is a longer string");
+
+	// Copies and moves of inline strings.
+	String a = "abc";
+	String b = a;
+	REQUIRE(b.is_inline());
+	REQUIRE(b.c_str() != a.c_str());
+	b.add('d');
+	REQUIRE(a == "abc");
+	REQUIRE(b == "abcd");
+	String c = cf_move(b);
+	REQUIRE(c == "abcd");
+	REQUIRE(b.c_str() == NULL);
+	c = cf_move(s);
+	REQUIRE(c == "hello world, this is a longer string");
+
+	// Stolen inline strings are returned as heap strings for the C API.
+	String d = "steal me";
+	char* stolen = d.steal();
+	REQUIRE(!CF_STRCMP(stolen, "steal me"));
+	sappend(stolen, " and keep growing past the inline buffer");
+	REQUIRE(!CF_STRCMP(stolen, "steal me and keep growing past the inline buffer"));
+	sfree(stolen);
+
+	// Strings must survive being relocated by containers.
+	Array<String> strings;
+	for (int i = 0; i < 100; ++i) {
+		strings.add(String(i));
+	}
+	for (int i = 0; i < 100; ++i) {
+		REQUIRE(strings[i].to_int() == i);
+	}
+
+	Map<int, String> map;
+	for (int i = 0; i < 100; ++i) {
+		map.add(i, String(i));
+	}
+	for (int i = 0; i < 100; i += 2) {
+		map.remove(i);
+	}
+	for (int i = 1; i < 100; i += 2) {
+		REQUIRE(map.get(i).to_int() == i);
+		REQUIRE(slen(map.get(i).c_str()) == slen(String(i).c_str()));
+	}
+
+	return true;
+}
+
+/* Bulk decoding must match decoding one codepoint at a time. */
+TEST_CASE(test_decode_UTF8_bulk)
+{
+	// Mix of ASCII runs longer than a SIMD step, 2/3/4 byte characters, and invalid bytes.
+	const char* text =
+		"The quick brown fox jumps over the lazy dog. \xC3\xA9t\xC3\xA9 "
+		"\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E\xE3\x81\xAE\xE3\x83\x86\xE3\x82\xAD\xE3\x82\xB9\xE3\x83\x88 "
+		"\xF0\x9F\x98\x80 bad: \x80\xBF\xC0\xAF\xE0\x80\x80 and some trailing ASCII text to finish up.";
+	int byte_count = (int)CF_STRLEN(text);
+
+	int expected[256];
+	int expected_count = 0;
+	const char* tmp = text;
+	while (*tmp) tmp = cf_decode_UTF8(tmp, expected + expected_count++);
+
+	int cps[256];
+	int count = 0;
+	const char* end = cf_decode_UTF8_bulk(text, -1, cps, 256, &count);
+	REQUIRE(end == text + byte_count);
+	REQUIRE(count == expected_count);
+	REQUIRE(!CF_MEMCMP(cps, expected, sizeof(int) * count));
+
+	// Decoding in small chunks picks up where the last call left off.
+	for (int capacity = 1; capacity < 40; ++capacity) {
+		int total = 0;
+		tmp = text;
+		while (tmp < text + byte_count) {
+			tmp = cf_decode_UTF8_bulk(tmp, (int)(text + byte_count - tmp), cps + total, capacity, &count);
+			REQUIRE(count > 0 && count <= capacity);
+			total += count;
+		}
+		REQUIRE(total == expected_count);
+		REQUIRE(!CF_MEMCMP(cps, expected, sizeof(int) * total));
+	}
+
+	// Characters cut off by the end of the input decode as a single replacement character.
+	const char* cut = "ab\xE6\x97";
+	end = cf_decode_UTF8_bulk(cut, 4, cps, 256, &count);
+	REQUIRE(end == cut + 4);
+	REQUIRE(count == 3);
+	REQUIRE(cps[0] == 'a' && cps[1] == 'b' && cps[2] == 0xFFFD);
+
+	return true;
+}
+
 TEST_CASE(test_split_for_memleaks)
 {
 	const char* data = "asdf,fa;sdf,a,f,q2,1,d,afs;d,a,1,,a,sa,d,v,,";
@@ -291,5 +516,9 @@ TEST_SUITE(test_string)
  	RUN_TEST_CASE(test_string_macros_advanced);
 	RUN_TEST_CASE(test_string_interning);
 	RUN_TEST_CASE(test_dictionary_and_interning);
+	RUN_TEST_CASE(test_string_interning_threads);
+	RUN_TEST_CASE(test_string_builder);
+	RUN_TEST_CASE(test_string_small_buffer);
+	RUN_TEST_CASE(test_decode_UTF8_bulk);
 	RUN_TEST_CASE(test_split_for_memleaks);
 }